@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "CollectionUtils.h"
+#include "StringUtils.h"
+#include "Assets/EntityDefinition.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBaseClasses = 50;
+        static constexpr size_t NumPointClasses = 2000;
+        static constexpr size_t NumSolidClasses = 1000;
+
+        static String makeFgd() {
+            StringStream str;
+            for (size_t i = 0; i < NumBaseClasses; ++i) {
+                str << "@BaseClass = Base" << i << " [\n";
+                str << "    targetname(target_source) : \"Name\"\n";
+                str << "    target(target_destination) : \"Target\"\n";
+                str << "    delay" << i << "(float) : \"Delay\" : \"0.5\"\n";
+                str << "    count" << i << "(integer) : \"Count\" : 1\n";
+                str << "    spawnflags(Flags) =\n    [\n";
+                str << "        1 : \"Flag 1\" : 0\n";
+                str << "        2 : \"Flag 2\" : 1\n";
+                str << "        4 : \"Flag 3\" : 0\n";
+                str << "    ]\n";
+                str << "]\n";
+            }
+
+            for (size_t i = 0; i < NumPointClasses; ++i) {
+                str << "@PointClass base(Base" << (i % NumBaseClasses) << ", Base" << ((i + 1) % NumBaseClasses) << ") color(255 128 0) size(-16 -16 -24, 16 16 32) ";
+                str << "model({ 'path': 'progs/model" << i << ".mdl', 'skin': skin, 'frame': frame }) = point_" << i << " : \"Point entity " << i << "\"\n";
+                str << "[\n";
+                str << "    style(choices) : \"Style\" : 0 =\n    [\n";
+                str << "        0 : \"Normal\"\n";
+                str << "        1 : \"Flicker\"\n";
+                str << "        2 : \"Pulse\"\n";
+                str << "    ]\n";
+                str << "    message(string) : \"Message\"\n";
+                str << "]\n";
+            }
+
+            for (size_t i = 0; i < NumSolidClasses; ++i) {
+                str << "@SolidClass base(Base" << (i % NumBaseClasses) << ") color(0 128 255) = solid_" << i << " : \"Solid entity " << i << "\"\n";
+                str << "[\n";
+                str << "    speed(integer) : \"Speed\" : 100\n";
+                str << "    wait(float) : \"Wait\" : \"3\"\n";
+                str << "]\n";
+            }
+            return str.str();
+        }
+
+        TEST(EntityDefinitionCacheBenchmark, loadDefinitionsFromCache) {
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            const String data = makeFgd();
+            const Path definitionPath("/defs/benchmark.fgd");
+            const uint64_t definitionHash = EntityDefinitionCache::hash(data.data(), data.data() + data.size());
+
+            Assets::EntityDefinitionList parsed;
+            timeLambda([&]() {
+                TestParserStatus status;
+                FgdParser parser(data, defaultColor);
+                parsed = parser.parseDefinitions(status);
+            }, "parse " + std::to_string(NumPointClasses + NumSolidClasses) + " entity definitions");
+
+            const Path path("entity_definition_cache_benchmark.tbcache");
+            EntityDefinitionCache::write(parsed, { { definitionPath, definitionHash } }, defaultColor, path);
+
+            std::ifstream stream(path.asString().c_str(), std::ios::in | std::ios::binary);
+            const String cache((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            stream.close();
+            std::remove(path.asString().c_str());
+
+            const auto hashFile = [&](const Path&) { return definitionHash; };
+
+            Assets::EntityDefinitionList cached;
+            bool success = false;
+            timeLambda([&]() {
+                success = EntityDefinitionCache::read(cache.data(), cache.data() + cache.size(), defaultColor, hashFile, cached);
+            }, "read entity definition cache");
+
+            ASSERT_TRUE(success);
+            ASSERT_EQ(parsed.size(), cached.size());
+
+            VectorUtils::clearAndDelete(parsed);
+            VectorUtils::clearAndDelete(cached);
+        }
+    }
+}
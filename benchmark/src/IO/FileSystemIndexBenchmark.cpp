@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/ImageFileSystem.h"
+#include "IO/Path.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumPackages = 32;
+        static constexpr size_t NumFilesPerPackage = 1'000;
+        static constexpr size_t NumLookups = 100'000;
+
+        class BenchmarkImageFileSystem : public ImageFileSystemBase {
+        private:
+            size_t m_package;
+        public:
+            BenchmarkImageFileSystem(std::shared_ptr<FileSystem> next, const size_t package) :
+            ImageFileSystemBase(std::move(next), Path("/pak" + std::to_string(package))),
+            m_package(package) {
+                initialize();
+            }
+        private:
+            void doReadDirectory() override {
+                for (size_t i = 0; i < NumFilesPerPackage; ++i) {
+                    const Path path("textures/pak" + std::to_string(m_package) + "/texture" + std::to_string(i) + ".wal");
+                    m_root.addFile(path, std::make_shared<OwningBufferFile>(path, std::make_unique<char[]>(1), 1));
+                }
+            }
+        };
+
+        TEST(FileSystemIndexBenchmark, lookupFiles) {
+            std::shared_ptr<FileSystem> fileSystem;
+            for (size_t i = 0; i < NumPackages; ++i)
+                fileSystem = std::make_shared<BenchmarkImageFileSystem>(fileSystem, i);
+
+            // look up files from all packages, and some that don't exist
+            std::vector<Path> paths;
+            for (size_t i = 0; i < NumLookups; ++i) {
+                const size_t package = i % (NumPackages + 1);
+                paths.emplace_back("textures/pak" + std::to_string(package) + "/TEXTURE" + std::to_string(i % NumFilesPerPackage) + ".wal");
+            }
+
+            size_t chainedCount = 0;
+            timeLambda([&]() {
+                for (const Path& path : paths) {
+                    if (fileSystem->fileExists(path))
+                        ++chainedCount;
+                }
+            }, "look up " + std::to_string(NumLookups) + " files in " + std::to_string(NumPackages) + " chained packages");
+
+            timeLambda([&]() {
+                fileSystem->buildIndex();
+            }, "index " + std::to_string(NumPackages) + " packages");
+
+            size_t indexedCount = 0;
+            timeLambda([&]() {
+                for (const Path& path : paths) {
+                    if (fileSystem->fileExists(path))
+                        ++indexedCount;
+                }
+            }, "look up " + std::to_string(NumLookups) + " files in " + std::to_string(NumPackages) + " indexed packages");
+
+            ASSERT_EQ(chainedCount, indexedCount);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "StringUtils.h"
+#include "IO/MapCache.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t BrushesPerAxis = 24;
+
+        static String makeBrushGrid() {
+            StringStream str;
+            str << "{\n\"classname\" \"worldspawn\"\n";
+            for (size_t x = 0; x < BrushesPerAxis; ++x) {
+                for (size_t y = 0; y < BrushesPerAxis; ++y) {
+                    for (size_t z = 0; z < BrushesPerAxis / 4; ++z) {
+                        const auto x0 = static_cast<int>(x) * 64, x1 = x0 + 32;
+                        const auto y0 = static_cast<int>(y) * 64, y1 = y0 + 32;
+                        const auto z0 = static_cast<int>(z) * 64, z1 = z0 + 32;
+                        str << "{\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) ( " << x1 << " " << y0 << " " << z0 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) tex 0 0 0 1 1\n";
+                        str << "}\n";
+                    }
+                }
+            }
+            str << "}\n";
+            return str.str();
+        }
+
+        TEST(MapCacheBenchmark, loadMapFromCache) {
+            const vm::bbox3 worldBounds(8192.0);
+            const String data = makeBrushGrid();
+            const uint64_t mapHash = MapCache::hash(data.data(), data.data() + data.size());
+
+            std::unique_ptr<Model::World> parsed;
+            timeLambda([&]() {
+                TestParserStatus status;
+                WorldReader reader(data);
+                parsed = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            }, "parse map text");
+
+            const Path path("map_cache_benchmark.tbcache");
+            MapCache::write(*parsed, worldBounds, mapHash, path);
+
+            std::ifstream stream(path.asString().c_str(), std::ios::in | std::ios::binary);
+            const String cache((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            stream.close();
+            std::remove(path.asString().c_str());
+
+            std::unique_ptr<Model::World> cached;
+            timeLambda([&]() {
+                cached = MapCache::read(cache.data(), cache.data() + cache.size(), mapHash, Model::MapFormat::Standard, worldBounds);
+            }, "read map cache");
+
+            ASSERT_NE(nullptr, cached);
+            ASSERT_EQ(parsed->defaultLayer()->childCount(), cached->defaultLayer()->childCount());
+        }
+    }
+}
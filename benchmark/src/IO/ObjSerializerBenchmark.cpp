@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/NodeWriter.h"
+#include "IO/ObjSerializer.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t GridSize = 100;
+
+        TEST(ObjSerializerBenchmark, benchExportObj) {
+            const vm::bbox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, worldBounds);
+
+            // adjacent brushes so that most vertices are shared
+            Model::BrushBuilder builder(&world, worldBounds);
+            for (size_t x = 0; x < GridSize; ++x) {
+                for (size_t y = 0; y < GridSize; ++y) {
+                    const vm::vec3 min(static_cast<FloatType>(x) * 16.0, static_cast<FloatType>(y) * 16.0, 0.0);
+                    world.defaultLayer()->addChild(builder.createCuboid(vm::bbox3(min, min + vm::vec3(16.0, 16.0, 16.0)), "texture"));
+                }
+            }
+
+            FILE* stream = std::tmpfile();
+            ASSERT_NE(nullptr, stream);
+
+            timeLambda([&]() {
+                NodeWriter(world, new ObjFileSerializer(stream)).writeMap();
+                std::fflush(stream);
+            }, "export " + std::to_string(GridSize * GridSize) + " brushes as OBJ");
+
+            const auto size = std::ftell(stream);
+            std::fclose(stream);
+            std::printf("wrote %ld bytes\n", static_cast<long>(size));
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "Logger.h"
+
+#include "IO/DiskIO.h"
+#include "IO/FileMatcher.h"
+#include "IO/Path.h"
+#include "IO/Quake3ShaderFileSystem.h"
+#include "IO/ZipFileSystem.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <miniz/miniz.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumShaderFiles = 400;
+        static constexpr size_t NumShadersPerFile = 100;
+
+        static std::string makeShaderName(const size_t fileIndex, const size_t shaderIndex) {
+            return "textures/set" + std::to_string(fileIndex) + "/shader" + std::to_string(shaderIndex);
+        }
+
+        static std::string makeShaderFile(const size_t fileIndex) {
+            std::string result;
+            for (size_t i = 0; i < NumShadersPerFile; ++i) {
+                const auto name = makeShaderName(fileIndex, i);
+                result += name + "\n{\n";
+                result += "\tqer_editorimage " + name + ".tga\n";
+                result += "\tsurfaceparm nomarks\n";
+                result += "\t{\n\t\tmap $lightmap\n\t\trgbGen identity\n\t}\n";
+                result += "\t{\n\t\tmap " + name + ".tga\n\t\tblendFunc GL_DST_COLOR GL_ZERO\n\t}\n";
+                result += "}\n\n";
+            }
+            return result;
+        }
+
+        /**
+         * Writes a pk3 with the shader scripts and an empty image for every other shader, so that half of the shaders
+         * are linked to textures and the other half are standalone shaders.
+         */
+        static void writePk3(const Path& path) {
+            mz_zip_archive archive;
+            mz_zip_zero_struct(&archive);
+            EXPECT_TRUE(mz_zip_writer_init_file(&archive, path.asString().c_str(), 0));
+
+            for (size_t i = 0; i < NumShaderFiles; ++i) {
+                const auto filePath = Path("scripts/set" + std::to_string(i) + ".shader");
+                const auto contents = makeShaderFile(i);
+                EXPECT_TRUE(mz_zip_writer_add_mem(&archive, filePath.asString('/').c_str(), contents.data(), contents.size(), MZ_DEFAULT_LEVEL));
+
+                for (size_t j = 0; j < NumShadersPerFile; j += 2) {
+                    const auto imagePath = makeShaderName(i, j) + ".tga";
+                    EXPECT_TRUE(mz_zip_writer_add_mem(&archive, imagePath.c_str(), "", 0, MZ_DEFAULT_LEVEL));
+                }
+            }
+
+            EXPECT_TRUE(mz_zip_writer_finalize_archive(&archive));
+            EXPECT_TRUE(mz_zip_writer_end(&archive));
+        }
+
+        TEST(Quake3ShaderFileSystemBenchmark, benchLoadShaders) {
+            const auto pk3Path = Disk::getCurrentWorkingDir() + Path("shader_benchmark.pk3");
+            writePk3(pk3Path);
+
+            {
+                NullLogger logger;
+                std::shared_ptr<FileSystem> fs = std::make_shared<ZipFileSystem>(pk3Path);
+
+                timeLambda([&]() {
+                    fs = std::make_shared<Quake3ShaderFileSystem>(fs, Path("scripts"), Path::List{ Path("textures") }, logger);
+                }, "load and link " + std::to_string(NumShaderFiles * NumShadersPerFile) + " shaders from " + std::to_string(NumShaderFiles) + " files");
+
+                const auto shaders = fs->findItemsRecursively(Path("textures"), FileExtensionMatcher(""));
+                ASSERT_EQ(NumShaderFiles * NumShadersPerFile, shaders.size());
+            }
+
+            std::remove(pk3Path.asString().c_str());
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "StringUtils.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumEntities = 500;
+        static constexpr size_t BrushesPerEntity = 8;
+
+        static void writeBrush(StringStream& str, const int x0, const int y0, const int z0) {
+            const auto x1 = x0 + 32, y1 = y0 + 32, z1 = z0 + 32;
+            str << "{\n";
+            str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) ( " << x1 << " " << y0 << " " << z0 << " ) tex 0 0 0 1 1\n";
+            str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) tex 0 0 0 1 1\n";
+            str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) tex 0 0 0 1 1\n";
+            str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) tex 0 0 0 1 1\n";
+            str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) tex 0 0 0 1 1\n";
+            str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) tex 0 0 0 1 1\n";
+            str << "}\n";
+        }
+
+        /**
+         * Creates a map with a worldspawn and a number of brush entities that have as many brushes in total.
+         */
+        static String makeMap() {
+            StringStream str;
+            str << "{\n\"classname\" \"worldspawn\"\n";
+            for (size_t i = 0; i < NumEntities * BrushesPerEntity; ++i)
+                writeBrush(str, static_cast<int>(i % 64) * 64, static_cast<int>(i / 64) * 64, 0);
+            str << "}\n";
+
+            for (size_t i = 0; i < NumEntities; ++i) {
+                str << "{\n\"classname\" \"func_detail\"\n";
+                for (size_t j = 0; j < BrushesPerEntity; ++j)
+                    writeBrush(str, static_cast<int>(i % 64) * 64, static_cast<int>(i / 64) * 64, static_cast<int>(j + 1) * 64);
+                str << "}\n";
+            }
+            return str.str();
+        }
+
+        TEST(WorldReaderBenchmark, readMap) {
+            const vm::bbox3 worldBounds(8192.0);
+            const String data = makeMap();
+
+            std::unique_ptr<Model::World> world;
+            timeLambda([&]() {
+                TestParserStatus status;
+                WorldReader reader(data);
+                world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            }, "read map with " + std::to_string(2 * NumEntities * BrushesPerEntity) + " brushes");
+
+            ASSERT_EQ(NumEntities * BrushesPerEntity + NumEntities, world->defaultLayer()->childCount());
+        }
+    }
+}
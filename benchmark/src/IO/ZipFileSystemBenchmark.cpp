@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/ZipFileSystem.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <miniz/miniz.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumShaderFiles = 1'000;
+        static constexpr size_t NumShadersPerFile = 200;
+
+        static std::string makeShaderFile(const size_t fileIndex) {
+            std::string result;
+            for (size_t i = 0; i < NumShadersPerFile; ++i) {
+                const auto name = "textures/set" + std::to_string(fileIndex) + "/shader" + std::to_string(i);
+                result += name + "\n{\n";
+                result += "\tqer_editorimage " + name + ".tga\n";
+                result += "\tsurfaceparm nomarks\n";
+                result += "\t{\n\t\tmap $lightmap\n\t\trgbGen identity\n\t}\n";
+                result += "\t{\n\t\tmap " + name + ".tga\n\t\tblendFunc GL_DST_COLOR GL_ZERO\n\t}\n";
+                result += "}\n\n";
+            }
+            return result;
+        }
+
+        static Path::List writePk3(const Path& path) {
+            mz_zip_archive archive;
+            mz_zip_zero_struct(&archive);
+            EXPECT_TRUE(mz_zip_writer_init_file(&archive, path.asString().c_str(), 0));
+
+            Path::List result;
+            for (size_t i = 0; i < NumShaderFiles; ++i) {
+                const auto filePath = Path("scripts/set" + std::to_string(i) + ".shader");
+                const auto contents = makeShaderFile(i);
+                EXPECT_TRUE(mz_zip_writer_add_mem(&archive, filePath.asString('/').c_str(), contents.data(), contents.size(), MZ_DEFAULT_LEVEL));
+                result.push_back(filePath);
+            }
+
+            EXPECT_TRUE(mz_zip_writer_finalize_archive(&archive));
+            EXPECT_TRUE(mz_zip_writer_end(&archive));
+            return result;
+        }
+
+        TEST(ZipFileSystemBenchmark, benchOpenFiles) {
+            const auto pk3Path = Disk::getCurrentWorkingDir() + Path("zip_benchmark.pk3");
+            const auto paths = writePk3(pk3Path);
+
+            {
+                const ZipFileSystem fs(pk3Path, 0u);
+                size_t totalSize = 0;
+                timeLambda([&]() {
+                    for (const auto& path : paths) {
+                        totalSize += fs.openFile(path)->size();
+                    }
+                }, "open " + std::to_string(paths.size()) + " files one by one");
+                printf("Total size of the decompressed files: %zu bytes\n", totalSize);
+
+                timeLambda([&]() {
+                    const auto files = fs.openFiles(paths);
+                    ASSERT_EQ(paths.size(), files.size());
+                }, "open " + std::to_string(paths.size()) + " files at once");
+            }
+
+            {
+                const ZipFileSystem fs(pk3Path);
+                const auto cachedPaths = Path::List(std::begin(paths), std::begin(paths) + static_cast<long>(paths.size() / 4u));
+                fs.openFiles(cachedPaths);
+
+                timeLambda([&]() {
+                    for (const auto& path : cachedPaths) {
+                        fs.openFile(path);
+                    }
+                }, "reopen " + std::to_string(cachedPaths.size()) + " cached files");
+            }
+
+            std::remove(pk3Path.asString().c_str());
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 10'000;
+
+        static std::vector<Brush*> createGroupedBrushes(World& world, const vm::bbox3& worldBounds) {
+            Group* group = world.createGroup("group");
+            world.defaultLayer()->addChild(group);
+
+            BrushBuilder builder(&world, worldBounds);
+            std::vector<Brush*> brushes;
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                const auto x = static_cast<FloatType>(i % 100) * 32.0;
+                const auto y = static_cast<FloatType>(i / 100) * 32.0;
+                const vm::bbox3 bounds(vm::vec3(x, y, 0.0), vm::vec3(x + 16.0, y + 16.0, 16.0));
+
+                Brush* brush = builder.createCuboid(bounds, "texture");
+                group->addChild(brush);
+                brushes.push_back(brush);
+            }
+            return brushes;
+        }
+
+        static void translate(const std::vector<Brush*>& brushes, const vm::bbox3& worldBounds) {
+            const vm::mat4x4 transformation = vm::translationMatrix(vm::vec3(8.0, 8.0, 8.0));
+            for (Brush* brush : brushes)
+                brush->transform(transformation, false, worldBounds);
+        }
+
+        TEST(BoundsUpdateBenchmark, transformGroupedBrushes) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            const std::vector<Brush*> brushes = createGroupedBrushes(world, worldBounds);
+
+            timeLambda([&]() {
+                translate(brushes, worldBounds);
+            }, "transform " + std::to_string(NumBrushes) + " grouped brushes with immediate bounds updates");
+
+            timeLambda([&]() {
+                const World::DeferBoundsUpdates deferBoundsUpdates(&world);
+                translate(brushes, worldBounds);
+            }, "transform " + std::to_string(NumBrushes) + " grouped brushes with deferred bounds updates");
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/BrushFaceAttributes.h"
+
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumFaces = 300'000;
+
+        TEST(BrushFaceAttributesBenchmark, bytesPerFace) {
+            const std::vector<String> textureNames {
+                "base_wall/concrete_dark", "base_floor/diamond2c", "base_trim/pewter_shiney", "common/caulk",
+                "gothic_block/blocks18c", "gothic_trim/metalsupport4", "sfx/fan3", "skies/tim_hell"
+            };
+
+            const size_t internedCount = BrushFaceAttributes::internedCount();
+            std::vector<BrushFaceAttributes> faces;
+            faces.reserve(NumFaces);
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumFaces; ++i) {
+                    BrushFaceAttributes attribs(textureNames[i % textureNames.size()]);
+                    attribs.setOffset(vm::vec2f(static_cast<float>((i / 8) % 4) * 16.0f, 0.0f));
+                    attribs.intern();
+                    faces.push_back(attribs);
+                }
+            }, "create and intern attributes of " + std::to_string(NumFaces) + " faces");
+
+            const size_t distinctCount = BrushFaceAttributes::internedCount() - internedCount;
+            size_t ownedBytes = 0;
+            size_t sharedBytes = 0;
+            for (size_t i = 0; i < distinctCount; ++i)
+                sharedBytes += faces[i].sharedSize();
+            for (const BrushFaceAttributes& attribs : faces)
+                ownedBytes += sizeof(BrushFaceAttributes) + attribs.sharedSize();
+            sharedBytes += NumFaces * sizeof(BrushFaceAttributes);
+
+            std::printf("%zu distinct attribute blocks for %zu faces\n", distinctCount, NumFaces);
+            std::printf("bytes per face if every face owns its attributes: %.1f\n", static_cast<double>(ownedBytes) / NumFaces);
+            std::printf("bytes per face with interned attributes: %.1f\n", static_cast<double>(sharedBytes) / NumFaces);
+
+            std::vector<BrushFaceAttributes> snapshots;
+            snapshots.reserve(NumFaces);
+            timeLambda([&]() {
+                for (const BrushFaceAttributes& attribs : faces)
+                    snapshots.push_back(attribs.takeSnapshot());
+            }, "snapshot attributes of " + std::to_string(NumFaces) + " faces");
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushGeometry.h"
+#include "Model/CollectMatchingNodesInParallel.h"
+#include "Model/EditorContext.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t GridSize = 64;
+
+        TEST(BrushIntersectionBenchmark, benchSelectTouchingAndInside) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            EditorContext editorContext;
+            BrushBuilder builder(&world, worldBounds);
+
+            // rotated brushes, so that the bounds of neighbouring brushes overlap but most of the brushes don't
+            BrushList brushes;
+            for (size_t x = 0; x < GridSize; ++x) {
+                for (size_t y = 0; y < GridSize; ++y) {
+                    Brush* brush = builder.createCube(24.0, "texture");
+                    const FloatType angle = vm::toRadians(static_cast<FloatType>((x * 7 + y * 13) % 90));
+                    brush->transform(vm::rotationMatrix(vm::vec3::pos_z, angle), false, worldBounds);
+                    brush->transform(vm::translationMatrix(vm::vec3(static_cast<FloatType>(x) * 28.0, static_cast<FloatType>(y) * 28.0, 0.0)), false, worldBounds);
+                    world.defaultLayer()->addChild(brush);
+                    brushes.push_back(brush);
+                }
+            }
+
+            BrushList queries;
+            for (size_t i = 0; i < 8; ++i) {
+                Brush* query = builder.createCube(256.0, "texture");
+                query->transform(vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(30.0)), false, worldBounds);
+                query->transform(vm::translationMatrix(vm::vec3(static_cast<FloatType>(i) * 224.0, static_cast<FloatType>(i) * 224.0, 0.0)), false, worldBounds);
+                world.defaultLayer()->addChild(query);
+                queries.push_back(query);
+            }
+
+            std::vector<std::unique_ptr<BrushGeometry>> geometries;
+            for (const Brush* brush : brushes)
+                geometries.push_back(std::make_unique<BrushGeometry>(brush->vertexPositions()));
+
+            const std::string count = std::to_string(brushes.size());
+
+            size_t expected = 0, actual = 0;
+            timeLambda([&]() {
+                for (size_t i = 0; i + 1 < brushes.size(); ++i) {
+                    if (geometries[i]->intersects(*geometries[i + 1]))
+                        ++expected;
+                    if (brushes[i]->bounds().intersects(brushes[i + 1]->bounds()) && geometries[i]->contains(*geometries[i + 1]))
+                        ++expected;
+                }
+            }, "test " + count + " neighbouring brush pairs with polyhedron queries");
+            timeLambda([&]() {
+                for (size_t i = 0; i + 1 < brushes.size(); ++i) {
+                    if (brushes[i]->intersectsBrush(brushes[i + 1]))
+                        ++actual;
+                    if (brushes[i]->containsBrush(brushes[i + 1]))
+                        ++actual;
+                }
+            }, "test " + count + " neighbouring brush pairs with separating axes");
+            ASSERT_EQ(expected, actual);
+
+            NodeList nodes;
+            timeLambda([&]() {
+                nodes = findTouchingNodes(&world, queries, editorContext);
+            }, "select touching of " + count + " brushes");
+            ASSERT_FALSE(nodes.empty());
+
+            timeLambda([&]() {
+                nodes = findContainedNodes(&world, queries, editorContext);
+            }, "select inside of " + count + " brushes");
+            ASSERT_FALSE(nodes.empty());
+        }
+    }
+}
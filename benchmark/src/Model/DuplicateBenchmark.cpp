@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "CollectionUtils.h"
+#include "StringUtils.h"
+#include "IO/NodeReader.h"
+#include "IO/NodeWriter.h"
+#include "IO/TestParserStatus.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CloneNodesInParallel.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 10'000;
+
+        TEST(DuplicateBenchmark, duplicateAndPasteGroup) {
+            const vm::bbox3 worldBounds(65536.0);
+            World world(MapFormat::Standard, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+
+            Group* group = world.createGroup("group");
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                const auto x = static_cast<FloatType>(i % 100) * 32.0;
+                const auto y = static_cast<FloatType>(i / 100) * 32.0;
+                group->addChild(builder.createCuboid(vm::bbox3(vm::vec3(x, y, 0.0), vm::vec3(x + 16.0, y + 16.0, 16.0)), "texture"));
+            }
+            world.defaultLayer()->addChild(group);
+
+            const String description = " a group of " + std::to_string(NumBrushes) + " brushes";
+
+            NodeList rebuilt;
+            timeLambda([&]() {
+                for (const Node* child : group->children()) {
+                    const Brush* brush = static_cast<const Brush*>(child);
+                    rebuilt.push_back(world.createBrush(worldBounds, brush->cloneFaces()));
+                }
+            }, "rebuild the geometry of" + description);
+            VectorUtils::clearAndDelete(rebuilt);
+
+            NodeList clones;
+            timeLambda([&]() {
+                clones = cloneRecursivelyInParallel(worldBounds, NodeList { group });
+            }, "duplicate" + description);
+            ASSERT_EQ(NumBrushes, clones.front()->childCount());
+            VectorUtils::clearAndDelete(clones);
+
+            StringStream str;
+            IO::NodeWriter writer(world, str);
+            writer.writeNodes(NodeList { group });
+
+            NodeList pasted;
+            timeLambda([&]() {
+                IO::TestParserStatus status;
+                pasted = IO::NodeReader::read(str.str(), world, worldBounds, status);
+            }, "paste" + description);
+            ASSERT_EQ(1u, pasted.size());
+            ASSERT_EQ(NumBrushes, pasted.front()->childCount());
+            VectorUtils::clearAndDelete(pasted);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "IO/ELParser.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumEntities = 20'000;
+        static constexpr size_t NumRepetitions = 10;
+
+        TEST(EntityAttributesBenchmark, benchAttributeAccess) {
+            const vm::bbox3 worldBounds(8192.0);
+            Assets::PointEntityDefinition definition("monster_army", Color(), vm::bbox3(16.0), "", Assets::AttributeDefinitionList(),
+                Assets::ModelDefinition(IO::ELParser::parseStrict("{ 'path': 'progs/soldier.mdl', 'skin': skin, 'frame': frame }")));
+
+            std::vector<std::unique_ptr<Entity>> entities;
+            entities.reserve(NumEntities);
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumEntities; ++i) {
+                    const auto index = std::to_string(i);
+                    auto entity = std::make_unique<Entity>();
+                    entity->setAttributes({
+                        EntityAttribute(AttributeNames::Classname, "monster_army"),
+                        EntityAttribute(AttributeNames::Origin, std::to_string(i % 512) + " " + std::to_string(i / 512) + " 24"),
+                        EntityAttribute(AttributeNames::Angle, std::to_string(i % 360)),
+                        EntityAttribute(AttributeNames::Spawnflags, "1"),
+                        EntityAttribute(AttributeNames::Targetname, "t" + index),
+                        EntityAttribute(AttributeNames::Target, "t" + std::to_string(i + 1)),
+                        EntityAttribute("skin", std::to_string(i % 3)),
+                        EntityAttribute("_color", "1 0.5 0.25"),
+                        EntityAttribute("message", "entity " + index)
+                    });
+                    entity->setDefinition(&definition);
+                    entities.push_back(std::move(entity));
+                }
+            }, "create " + std::to_string(NumEntities) + " entities with 9 attributes");
+
+            size_t count = 0;
+            timeLambda([&]() {
+                for (size_t r = 0; r < NumRepetitions; ++r) {
+                    for (const auto& entity : entities) {
+                        if (entity->hasAttribute(AttributeNames::Targetname) &&
+                            entity->hasNumberedAttribute(AttributeNames::Target, entity->attribute(AttributeNames::Target)) &&
+                            entity->attribute(AttributeNames::Spawnflags) == "1") {
+                            ++count;
+                        }
+                    }
+                }
+            }, "look up attributes of all entities " + std::to_string(NumRepetitions) + " times");
+            ASSERT_EQ(NumEntities * NumRepetitions, count);
+
+            size_t skins = 0;
+            timeLambda([&]() {
+                for (size_t r = 0; r < NumRepetitions; ++r) {
+                    for (const auto& entity : entities) {
+                        skins += entity->modelSpecification().skinIndex;
+                    }
+                }
+            }, "get the model of all entities " + std::to_string(NumRepetitions) + " times");
+            ASSERT_LT(0u, skins);
+
+            timeLambda([&]() {
+                for (auto& entity : entities) {
+                    entity->addOrUpdateAttribute("message", "changed");
+                    entity->transform(vm::translationMatrix(vm::vec3(16, 0, 0)), false, worldBounds);
+                }
+            }, "change the message and origin of all entities");
+
+            timeLambda([&]() {
+                const auto rotation = vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(90.0));
+                for (auto& entity : entities) {
+                    entity->transform(rotation, false, worldBounds);
+                }
+            }, "rotate all entities");
+
+            for (auto& entity : entities) {
+                entity->setDefinition(nullptr);
+            }
+        }
+    }
+}
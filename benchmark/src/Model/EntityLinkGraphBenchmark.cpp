@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Entity.h"
+#include "Model/EntityLinkGraph.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumTargets = 5'000;
+        static constexpr size_t NumSources = 16;
+
+        TEST(EntityLinkGraphBenchmark, benchRenameTargetname) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            for (size_t i = 0; i < NumSources; ++i) {
+                Entity* source = world.createEntity();
+                source->addOrUpdateAttribute(AttributeNames::Target, "target_name");
+                source->addOrUpdateAttribute(AttributeNames::Killtarget, "renamed_target_name");
+                world.defaultLayer()->addChild(source);
+            }
+
+            std::vector<Entity*> targets;
+            for (size_t i = 0; i < NumTargets; ++i) {
+                Entity* target = world.createEntity();
+                target->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+                world.defaultLayer()->addChild(target);
+                targets.push_back(target);
+            }
+
+            timeLambda([&]() {
+                for (Entity* target : targets)
+                    target->addOrUpdateAttribute(AttributeNames::Targetname, "renamed_target_name");
+            }, "rename targetname of " + std::to_string(NumTargets) + " entities");
+
+            size_t linkCount = 0;
+            timeLambda([&]() {
+                const auto countLink = [&linkCount](const AttributableNode*, const AttributableNode*) { ++linkCount; };
+                world.entityLinkGraph().forEachLink(countLink, countLink);
+            }, "enumerate all links");
+            ASSERT_EQ(NumSources * NumTargets, linkCount);
+
+            timeLambda([&]() {
+                for (Entity* target : targets)
+                    ASSERT_FALSE(target->hasMissingSources());
+            }, "check " + std::to_string(NumTargets) + " entities for missing link sources");
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/EditorContext.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitQuery.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t GridSize = 64;
+        static constexpr size_t GridLevels = 2;
+        static constexpr size_t NumRays = 32;
+
+        TEST(PickBenchmark, benchHoverPick) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            EditorContext editorContext;
+            BrushBuilder builder(&world, worldBounds);
+
+            for (size_t x = 0; x < GridSize; ++x) {
+                for (size_t y = 0; y < GridSize; ++y) {
+                    for (size_t z = 0; z < GridLevels; ++z) {
+                        Brush* brush = builder.createCube(24.0, "texture");
+                        brush->transform(vm::translationMatrix(vm::vec3(static_cast<FloatType>(x), static_cast<FloatType>(y), static_cast<FloatType>(z)) * 32.0), false, worldBounds);
+                        world.defaultLayer()->addChild(brush);
+                    }
+                }
+            }
+
+            // hover rays from a camera above one corner of the map that sweep the map at a shallow angle
+            const auto origin = vm::vec3(-256.0, -256.0, 256.0);
+            std::vector<vm::ray3> rays;
+            for (size_t i = 0; i < NumRays; ++i) {
+                for (size_t j = 0; j < NumRays; ++j) {
+                    const auto target = vm::vec3(static_cast<FloatType>(i), static_cast<FloatType>(j), 0.0) * (static_cast<FloatType>(GridSize * 32) / static_cast<FloatType>(NumRays));
+                    rays.emplace_back(origin, vm::normalize(target - origin));
+                }
+            }
+
+            const auto pickFull = [&](const vm::ray3& ray) {
+                auto pickResult = PickResult::byDistance(editorContext);
+                world.pick(ray, pickResult);
+                return hitToNode(pickResult.query().pickable().type(Brush::BrushHit).occluded().first());
+            };
+
+            const auto pickFirst = [&](const vm::ray3& ray) {
+                auto pickResult = PickResult::byDistance(editorContext);
+                const auto query = pickResult.query().pickable().type(Brush::BrushHit).occluded();
+                world.pickFirst(ray, pickResult, query);
+                return hitToNode(query.first());
+            };
+
+            const std::string count = std::to_string(rays.size()) + " hover rays over " + std::to_string(GridSize * GridSize * GridLevels) + " brushes";
+
+            std::vector<Node*> expected, actual;
+            timeLambda([&]() {
+                for (const auto& ray : rays)
+                    expected.push_back(pickFull(ray));
+            }, "pick all hits of " + count);
+            timeLambda([&]() {
+                for (const auto& ray : rays)
+                    actual.push_back(pickFirst(ray));
+            }, "pick first hit of " + count);
+
+            ASSERT_EQ(expected, actual);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/Layer.h"
+#include "Model/PlanePointFinder.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t Repetitions = 8;
+
+        TEST(PlanePointFinderBenchmark, benchFindIntegerPlanePoints) {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/PlanePointFinder/rotated_brushes.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+
+            const vm::bbox3 worldBounds(8192.0);
+            auto world = worldReader.read(MapFormat::Standard, worldBounds, status);
+
+            BrushList brushes;
+            for (Node* node : world->defaultLayer()->children())
+                brushes.push_back(static_cast<Brush*>(node));
+
+            // the brushes of the fixture are repeated to simulate a large legacy map
+            std::vector<vm::plane3> planes;
+            std::vector<vm::vec3> points;
+            for (size_t i = 0; i < Repetitions; ++i) {
+                for (const Brush* brush : brushes) {
+                    for (const BrushFace* face : brush->faces()) {
+                        planes.push_back(face->boundary());
+                        points.insert(std::end(points), std::begin(face->points()), std::end(face->points()));
+                    }
+                }
+            }
+
+            const std::string count = std::to_string(planes.size());
+
+            std::vector<vm::vec3> expected = points;
+            timeLambda([&]() {
+                for (size_t i = 0; i < planes.size(); ++i) {
+                    BrushFace::Points facePoints = { expected[3 * i], expected[3 * i + 1], expected[3 * i + 2] };
+                    PlanePointFinder::findPoints(planes[i], facePoints, 3);
+                    for (size_t j = 0; j < 3; ++j)
+                        expected[3 * i + j] = facePoints[j];
+                }
+            }, "find integer plane points of " + count + " faces one at a time");
+
+            std::vector<vm::vec3> actual = points;
+            timeLambda([&]() {
+                PlanePointFinder::findPoints(planes, actual);
+            }, "find integer plane points of " + count + " faces in a batch");
+            ASSERT_EQ(expected, actual);
+
+            timeLambda([&]() {
+                Brush::findIntegerPlanePoints(brushes, worldBounds);
+            }, "find integer plane points of " + std::to_string(brushes.size()) + " brushes and rebuild them");
+
+            for (const Brush* brush : brushes) {
+                for (const BrushFace* face : brush->faces()) {
+                    for (size_t i = 0; i < 3; ++i)
+                        ASSERT_TRUE(vm::isIntegral(face->points()[i]));
+                }
+            }
+        }
+    }
+}
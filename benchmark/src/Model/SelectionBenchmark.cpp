@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/CollectMatchingNodesInParallel.h"
+#include "Model/CollectSelectableNodesVisitor.h"
+#include "Model/CollectTouchingNodesVisitor.h"
+#include "Model/EditorContext.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t GridSize = 48;
+
+        TEST(SelectionBenchmark, benchCollectMatchingNodes) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            EditorContext editorContext;
+            BrushBuilder builder(&world, worldBounds);
+
+            for (size_t x = 0; x < GridSize; ++x) {
+                for (size_t y = 0; y < GridSize; ++y) {
+                    const vm::vec3 min(static_cast<FloatType>(x) * 32.0, static_cast<FloatType>(y) * 32.0, 0.0);
+                    world.defaultLayer()->addChild(builder.createCuboid(vm::bbox3(min, min + vm::vec3(16.0, 16.0, 16.0)), "texture"));
+                }
+            }
+
+            BrushList queries;
+            for (size_t i = 0; i < 8; ++i) {
+                const vm::vec3 min(static_cast<FloatType>(i) * 160.0, static_cast<FloatType>(i) * 160.0, -8.0);
+                queries.push_back(builder.createCuboid(vm::bbox3(min, min + vm::vec3(128.0, 128.0, 32.0)), "texture"));
+            }
+            for (Brush* query : queries)
+                world.defaultLayer()->addChild(query);
+
+            const std::string count = std::to_string(GridSize * GridSize);
+
+            NodeList expected, actual;
+            timeLambda([&]() {
+                CollectSelectableNodesVisitor visitor(editorContext);
+                world.recurse(visitor);
+                expected = visitor.nodes();
+            }, "select all of " + count + " brushes with a visitor");
+            timeLambda([&]() {
+                actual = collectMatchingNodesInParallel(world.children(),
+                    [](const Node*) { return true; },
+                    [&](const Node* node) { return editorContext.selectable(node); });
+            }, "select all of " + count + " brushes in parallel");
+            ASSERT_EQ(expected, actual);
+
+            timeLambda([&]() {
+                CollectTouchingNodesVisitor<BrushList::const_iterator> visitor(std::begin(queries), std::end(queries), editorContext);
+                world.acceptAndRecurse(visitor);
+                expected = visitor.nodes();
+            }, "select touching of " + count + " brushes with a visitor");
+            timeLambda([&]() {
+                actual = findTouchingNodes(&world, queries, editorContext);
+            }, "select touching of " + count + " brushes in parallel");
+            ASSERT_EQ(expected, actual);
+
+            timeLambda([&]() {
+                CollectContainedNodesVisitor<BrushList::const_iterator> visitor(std::begin(queries), std::end(queries), editorContext);
+                world.acceptAndRecurse(visitor);
+                expected = visitor.nodes();
+            }, "select inside of " + count + " brushes with a visitor");
+            timeLambda([&]() {
+                actual = findContainedNodes(&world, queries, editorContext);
+            }, "select inside of " + count + " brushes in parallel");
+            ASSERT_EQ(expected, actual);
+        }
+    }
+}
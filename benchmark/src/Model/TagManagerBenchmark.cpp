@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/Tag.h"
+#include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
+#include "Model/World.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 20'000;
+
+        TEST(TagManagerBenchmark, updateFaceTags) {
+            // the brush face tags of the Quake 3 game configuration
+            TagManager tagManager;
+            tagManager.registerSmartTag(SmartTag("Clip", {}, std::make_unique<SurfaceParmTagMatcher>("playerclip")));
+            tagManager.registerSmartTag(SmartTag("Caulk", {}, std::make_unique<TextureNameTagMatcher>("caulk")));
+            tagManager.registerSmartTag(SmartTag("Skip", {}, std::make_unique<TextureNameTagMatcher>("skip")));
+            tagManager.registerSmartTag(SmartTag("Hint", {}, std::make_unique<TextureNameTagMatcher>("hint*")));
+            tagManager.registerSmartTag(SmartTag("Detail", {}, std::make_unique<ContentFlagsTagMatcher>(1 << 27)));
+            tagManager.registerSmartTag(SmartTag("Liquid", {}, std::make_unique<ContentFlagsTagMatcher>(8 | 16 | 32)));
+            tagManager.registerSmartTag(SmartTag("Sound", {}, std::make_unique<SurfaceFlagsTagMatcher>(0xFF << 20)));
+            tagManager.registerSmartTag(SmartTag("Transparent", {}, std::make_unique<SurfaceFlagsTagMatcher>(16 | 32)));
+
+            const std::vector<String> textureNames {
+                "base_wall/concrete_dark", "base_floor/diamond2c", "base_trim/pewter_shiney", "common/caulk",
+                "gothic_block/blocks18c", "gothic_trim/metalsupport4", "sfx/fan3", "skies/tim_hell",
+                "common/weapclip", "common/hint", "common/skip", "liquids/clear_calm1"
+            };
+
+            std::vector<std::unique_ptr<Assets::Texture>> textures;
+            for (const String& textureName : textureNames) {
+                textures.push_back(std::make_unique<Assets::Texture>(textureName, 64, 64));
+            }
+            textures[8]->setSurfaceParms({ "playerclip", "nodraw" });
+
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Quake3, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+
+            BrushFaceList faces;
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                Brush* brush = builder.createCube(32.0, textureNames.front());
+                world.defaultLayer()->addChild(brush);
+                for (BrushFace* face : brush->faces()) {
+                    face->setTexture(textures[faces.size() % textures.size()].get());
+                    faces.push_back(face);
+                }
+            }
+
+            timeLambda([&]() {
+                for (BrushFace* face : faces) {
+                    for (const SmartTag& tag : tagManager.smartTags()) {
+                        tag.update(*face);
+                    }
+                }
+            }, "evaluate all smart tag matchers for " + std::to_string(faces.size()) + " faces");
+
+            timeLambda([&]() {
+                for (BrushFace* face : faces) {
+                    face->initializeTags(tagManager);
+                }
+            }, "initialize tags of " + std::to_string(faces.size()) + " faces");
+
+            timeLambda([&]() {
+                for (BrushFace* face : faces) {
+                    face->updateTags(tagManager);
+                }
+            }, "update tags of " + std::to_string(faces.size()) + " faces");
+
+            const SmartTag& caulk = tagManager.smartTag("Caulk");
+            const SmartTag& clip = tagManager.smartTag("Clip");
+            ASSERT_TRUE(faces[3]->hasTag(caulk));
+            ASSERT_FALSE(faces[3]->hasTag(clip));
+            ASSERT_TRUE(faces[8]->hasTag(clip));
+            ASSERT_FALSE(faces[0]->hasAnyTag());
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumVertices = 1'000'000;
+
+        static void benchTextureCoords(const MapFormat format, const String& formatName) {
+            const vm::bbox3 worldBounds(8192.0);
+            Assets::Texture texture("texture", 64, 64);
+            World world(format, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush = builder.createCube(128.0, "texture");
+
+            std::vector<vm::vec3> positions;
+            positions.reserve(NumVertices);
+            for (size_t i = 0; i < NumVertices; ++i) {
+                const auto x = static_cast<FloatType>(i % 1024) * 8.0 - 4096.0;
+                const auto y = static_cast<FloatType>((i / 1024) % 1024) * 8.0 - 4096.0;
+                positions.push_back(vm::vec3(x, y, static_cast<FloatType>(i % 7) * 16.0));
+            }
+
+            const auto& faces = brush->faces();
+            for (BrushFace* face : faces) {
+                face->setTexture(&texture);
+                face->setRotation(15.0f);
+            }
+
+            std::vector<vm::vec2f> texCoords;
+            texCoords.reserve(NumVertices);
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumVertices; ++i) {
+                    texCoords.push_back(faces[i % faces.size()]->textureCoords(positions[i]));
+                }
+            }, "compute " + std::to_string(NumVertices) + " " + formatName + " texture coordinates per vertex");
+
+            std::vector<vm::vec2f> projectedTexCoords;
+            projectedTexCoords.reserve(NumVertices);
+            timeLambda([&]() {
+                // one projection per face, applied to a face sized batch of vertices at a time
+                const size_t batchSize = 8;
+                std::vector<vm::vec3> batch;
+                for (size_t i = 0; i < NumVertices; i += batchSize) {
+                    batch.assign(std::begin(positions) + static_cast<long>(i), std::begin(positions) + static_cast<long>(std::min(i + batchSize, NumVertices)));
+                    faces[(i / batchSize) % faces.size()]->textureCoordProjection().project(batch, projectedTexCoords);
+                }
+            }, "compute " + std::to_string(NumVertices) + " " + formatName + " texture coordinates per face");
+
+            ASSERT_EQ(NumVertices, projectedTexCoords.size());
+            delete brush;
+        }
+
+        TEST(TexCoordBenchmark, paraxialTextureCoords) {
+            benchTextureCoords(MapFormat::Standard, "paraxial");
+        }
+
+        TEST(TexCoordBenchmark, parallelTextureCoords) {
+            benchTextureCoords(MapFormat::Valve, "parallel");
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/Snapshot.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 500;
+        static constexpr size_t NumTransforms = 1'000;
+
+        TEST(UndoHistoryBenchmark, transformLargeSelection) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            NodeList nodes;
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                const auto x = static_cast<FloatType>(i % 25) * 32.0;
+                const auto y = static_cast<FloatType>(i / 25) * 32.0;
+                const vm::bbox3 bounds(vm::vec3(x, y, 0.0), vm::vec3(x + 16.0, y + 16.0, 16.0));
+
+                Brush* brush = builder.createCuboid(bounds, "texture");
+                world.defaultLayer()->addChild(brush);
+                nodes.push_back(brush);
+            }
+            const vm::bbox3 originalBounds = nodes.front()->bounds();
+
+            std::vector<std::unique_ptr<Snapshot>> history;
+            timeLambda([&]() {
+                const vm::mat4x4 transformation = vm::translationMatrix(vm::vec3(1.0, 0.0, 0.0));
+                for (size_t i = 0; i < NumTransforms; ++i) {
+                    const World::DeferBoundsUpdates deferBoundsUpdates(&world);
+                    history.push_back(std::make_unique<Snapshot>(std::begin(nodes), std::end(nodes)));
+                    for (Node* node : nodes)
+                        static_cast<Brush*>(node)->transform(transformation, true, worldBounds);
+                }
+            }, "take snapshots of and transform " + std::to_string(NumBrushes) + " brushes " + std::to_string(NumTransforms) + " times");
+
+            size_t memorySize = 0;
+            for (const auto& snapshot : history)
+                memorySize += snapshot->memorySize();
+
+            const size_t numFaces = NumTransforms * NumBrushes * 6u;
+            std::printf("undo history uses %zu KiB, %.1f bytes per recorded face\n", memorySize / 1024u, static_cast<double>(memorySize) / static_cast<double>(numFaces));
+
+            timeLambda([&]() {
+                while (!history.empty()) {
+                    const World::DeferBoundsUpdates deferBoundsUpdates(&world);
+                    history.back()->restoreNodes(worldBounds);
+                    history.pop_back();
+                }
+            }, "restore " + std::to_string(NumTransforms) + " snapshots");
+
+            ASSERT_EQ(originalBounds, nodes.front()->bounds());
+        }
+    }
+}
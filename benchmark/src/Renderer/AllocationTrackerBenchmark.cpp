@@ -0,0 +1,176 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Renderer/AllocationTracker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t NumBrushes = 64'000;
+        static constexpr size_t NumEdits = 2'000;
+        static constexpr size_t MaxBrushesPerEdit = 200;
+        static constexpr size_t MaxMovesPerValidation = 256;
+
+        /**
+         * One step of an allocation trace. A negative size frees the block allocated by the step with the given
+         * index, otherwise a block of the given size is allocated.
+         */
+        struct TraceStep {
+            size_t allocation;
+            long size;
+        };
+
+        // between 12 and 140, inclusive, i.e. the edge index counts of typical brushes
+        static long getBrushSize(std::mt19937& engine) {
+            return static_cast<long>(12 + (4 * (engine() % 33)));
+        }
+
+        /**
+         * Simulates the index array allocations of the brush renderer while editing a map: the map is loaded, and then
+         * groups of brushes which were created close together (and are therefore close together in the array) are
+         * selected and modified repeatedly. Each modification removes the selected brushes from the renderer and
+         * adds them again with a slightly changed size, as when vertices are added or removed. Finally, every other
+         * brush is deleted.
+         *
+         * Uses std::mt19937 directly so that the trace is the same on all C++ implementations.
+         */
+        static std::vector<TraceStep> makeEditingTrace() {
+            std::mt19937 engine;
+
+            std::vector<TraceStep> trace;
+            std::vector<size_t> brushes;
+            std::vector<long> sizes;
+
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                const auto size = getBrushSize(engine);
+                brushes.push_back(trace.size());
+                sizes.push_back(size);
+                trace.push_back(TraceStep{0, size});
+            }
+
+            for (size_t i = 0; i < NumEdits; ++i) {
+                const size_t count = 1 + engine() % MaxBrushesPerEdit;
+                const size_t first = engine() % (NumBrushes - count);
+
+                for (size_t j = first; j < first + count; ++j) {
+                    trace.push_back(TraceStep{brushes[j], -1});
+                }
+                for (size_t j = first; j < first + count; ++j) {
+                    const long delta = 4 * (static_cast<long>(engine() % 5) - 2);
+                    sizes[j] = std::max(12l, sizes[j] + delta);
+                    brushes[j] = trace.size();
+                    trace.push_back(TraceStep{0, sizes[j]});
+                }
+            }
+
+            for (size_t i = 0; i < NumBrushes; i += 2) {
+                trace.push_back(TraceStep{brushes[i], -1});
+            }
+
+            return trace;
+        }
+
+        static void ignoreMove(const AllocationTracker::Block*, const size_t) {}
+
+        static void compactIfFragmented(AllocationTracker& tracker) {
+            const auto stats = tracker.statistics();
+            if (stats.freeBlockCount > 1 && 4 * (stats.freeSize - stats.largestFreeBlock) > stats.capacity) {
+                tracker.compact(MaxMovesPerValidation, ignoreMove);
+            }
+        }
+
+        /**
+         * Replays the given trace, growing the tracker like BrushIndexArray does. If compact is true, then the
+         * tracker is compacted after every edit in the same way as BrushRenderer does it.
+         */
+        static void replay(const std::vector<TraceStep>& trace, AllocationTracker& tracker, size_t& expandCount, const bool compact) {
+            std::vector<AllocationTracker::Block*> blocks(trace.size(), nullptr);
+            bool freeing = false;
+
+            for (size_t i = 0; i < trace.size(); ++i) {
+                const auto& step = trace[i];
+                if (step.size < 0) {
+                    freeing = true;
+                    tracker.free(blocks[step.allocation]);
+                    blocks[step.allocation] = nullptr;
+                } else {
+                    if (freeing && compact) {
+                        compactIfFragmented(tracker);
+                    }
+                    freeing = false;
+
+                    const auto size = static_cast<size_t>(step.size);
+                    auto* block = tracker.allocate(size);
+                    if (block == nullptr) {
+                        tracker.expand(std::max(2 * tracker.capacity(), tracker.capacity() + size));
+                        ++expandCount;
+                        block = tracker.allocate(size);
+                    }
+                    ASSERT_NE(nullptr, block);
+                    blocks[i] = block;
+                }
+            }
+
+            if (compact) {
+                compactIfFragmented(tracker);
+            }
+        }
+
+        static void printStatistics(const AllocationTracker& tracker, const size_t expandCount) {
+            const auto stats = tracker.statistics();
+            std::printf("  capacity %zu, used %zu in %zu blocks, free %zu in %zu blocks, largest free block %zu, fragmentation %.3f, %zu expansions\n",
+                        stats.capacity, stats.usedSize, stats.usedBlockCount, stats.freeSize, stats.freeBlockCount,
+                        stats.largestFreeBlock, stats.fragmentation(), expandCount);
+        }
+
+        TEST(AllocationTrackerBenchmark, benchEditingTrace) {
+            const auto trace = makeEditingTrace();
+
+            {
+                AllocationTracker tracker;
+                size_t expandCount = 0;
+                timeLambda([&]() { replay(trace, tracker, expandCount, false); },
+                           "replay editing trace with " + std::to_string(trace.size()) + " steps");
+                printStatistics(tracker, expandCount);
+
+                timeLambda([&]() {
+                    while (!tracker.compact(MaxMovesPerValidation, ignoreMove));
+                }, "compact fully after replaying the trace");
+                printStatistics(tracker, expandCount);
+            }
+
+            {
+                AllocationTracker tracker;
+                size_t expandCount = 0;
+                timeLambda([&]() { replay(trace, tracker, expandCount, true); },
+                           "replay editing trace with " + std::to_string(trace.size()) + " steps and incremental compaction");
+                printStatistics(tracker, expandCount);
+            }
+        }
+    }
+}
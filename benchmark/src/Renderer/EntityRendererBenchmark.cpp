@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "CollectionUtils.h"
+#include "Logger.h"
+#include "Assets/EntityModelManager.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "Renderer/EntityRenderer.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t NumPointEntities = 8'000;
+        static constexpr size_t NumBrushEntities = 1'000;
+
+        /**
+         * The returned entities need to be freed with VectorUtils::clearAndDelete
+         */
+        static Model::EntityList makeEntities() {
+            const vm::bbox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, worldBounds);
+            Model::BrushBuilder builder(&world, worldBounds);
+
+            Model::EntityList result;
+            for (size_t i = 0; i < NumPointEntities; ++i) {
+                auto* entity = new Model::Entity();
+                entity->addOrUpdateAttribute(Model::AttributeNames::Classname, "light");
+                entity->addOrUpdateAttribute(Model::AttributeNames::Origin, std::to_string((i % 100) * 32) + " " + std::to_string((i / 100) * 32) + " 0");
+                result.push_back(entity);
+            }
+
+            for (size_t i = 0; i < NumBrushEntities; ++i) {
+                auto* entity = new Model::Entity();
+                entity->addOrUpdateAttribute(Model::AttributeNames::Classname, "func_door");
+                entity->addChild(builder.createCube(64.0, ""));
+                result.push_back(entity);
+            }
+
+            return result;
+        }
+
+        TEST(EntityRendererBenchmark, benchEntityRenderer) {
+            auto entities = makeEntities();
+
+            NullLogger logger;
+            Assets::EntityModelManager entityModelManager(0, 0, logger);
+            Model::EditorContext editorContext;
+            EntityRenderer r(entityModelManager, editorContext);
+
+            timeLambda([&](){ r.setEntities(entities); }, "add " + std::to_string(entities.size()) + " entities to EntityRenderer");
+            timeLambda([&](){
+                if (!r.valid()) {
+                    r.validate();
+                }
+            }, "validate after adding " + std::to_string(entities.size()) + " entities to EntityRenderer");
+
+            // Tiny change: move a single light
+            Model::Entity* light = entities.front();
+            light->addOrUpdateAttribute(Model::AttributeNames::Origin, "16 0 0");
+
+            timeLambda([&](){
+                r.invalidateEntities(Model::EntityList { light });
+                if (!r.valid()) {
+                    r.validate();
+                }
+            }, "invalidate and validate one moved entity");
+
+            timeLambda([&](){
+                r.invalidate();
+                if (!r.valid()) {
+                    r.validate();
+                }
+            }, "invalidate and validate all " + std::to_string(entities.size()) + " entities");
+
+            // Tiny change: remove the last entity
+            Model::EntityList entitiesMinusOne = entities;
+            entitiesMinusOne.resize(entities.size() - 1);
+
+            timeLambda([&](){ r.setEntities(entitiesMinusOne); }, "setEntities to " + std::to_string(entitiesMinusOne.size()) + " (removing one)");
+            timeLambda([&](){
+                if (!r.valid()) {
+                    r.validate();
+                }
+            }, "validate after removing one entity");
+
+            // Large change: keep every second entity
+            Model::EntityList entitiesToKeep;
+            for (size_t i = 0; i < entities.size(); ++i) {
+                if ((i % 2) == 0) {
+                    entitiesToKeep.push_back(entities.at(i));
+                }
+            }
+
+            timeLambda([&](){ r.setEntities(entitiesToKeep); },
+                       "set entities from " + std::to_string(entities.size()) +
+                       " to " + std::to_string(entitiesToKeep.size()));
+
+            timeLambda([&](){
+                           if (!r.valid()) {
+                               r.validate();
+                           }
+                       }, "validate with " + std::to_string(entitiesToKeep.size()) + " entities");
+
+            r.clear();
+            VectorUtils::clearAndDelete(entities);
+        }
+    }
+}
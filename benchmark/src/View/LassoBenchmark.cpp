@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Renderer/PerspectiveCamera.h"
+#include "View/Lasso.h"
+
+#include <vecmath/vec.h>
+
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t NumHandles = 100'000;
+        static constexpr size_t NumQueries = 100;
+
+        TEST(LassoBenchmark, benchLassoSelect) {
+            std::mt19937 random(0);
+            std::uniform_real_distribution<FloatType> coord(-2048.0, 2048.0);
+
+            std::vector<vm::vec3> handles;
+            handles.reserve(NumHandles);
+            for (size_t i = 0; i < NumHandles; ++i) {
+                handles.push_back(vm::vec3(coord(random), coord(random), coord(random)));
+            }
+
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, viewport, vm::vec3f(-3072.0f, -3072.0f, 3072.0f), normalize(vm::vec3f(1.0f, 1.0f, -1.0f)), vm::vec3f::pos_z);
+
+            const FloatType distance = 64.0;
+            const auto origin = vm::vec3(camera.defaultPoint(static_cast<float>(distance)));
+            const auto right = vm::vec3(camera.right());
+            const auto up = vm::vec3(camera.up());
+
+            // the lasso selects its handles once, when the drag ends; this evaluates lassos of increasing size
+            size_t selected = 0;
+            timeLambda([&]() {
+                for (size_t i = 1; i <= NumQueries; ++i) {
+                    const auto offset = static_cast<FloatType>(i) * 16.0 / static_cast<FloatType>(NumQueries);
+                    Lasso lasso(camera, distance, origin);
+                    lasso.update(origin + offset * right + offset * up);
+
+                    std::vector<vm::vec3> result;
+                    lasso.selected(std::begin(handles), std::end(handles), std::back_inserter(result));
+                    selected += result.size();
+                }
+            }, std::to_string(NumQueries) + " lasso selections over " + std::to_string(NumHandles) + " handles");
+            ASSERT_LT(0u, selected);
+        }
+    }
+}
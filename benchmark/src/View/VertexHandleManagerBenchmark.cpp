@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t NumPicks = 1'000;
+
+        TEST(VertexHandleManagerBenchmark, benchPick) {
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, viewport, vm::vec3f(-512.0f, -512.0f, 1024.0f), normalize(vm::vec3f(1.0f, 1.0f, -1.0f)), vm::vec3f::pos_z);
+            const auto origin = vm::vec3(camera.position());
+
+            for (const size_t gridSize : { 16u, 32u, 64u }) {
+                const vm::bbox3 worldBounds(16384.0);
+                Model::World world(Model::MapFormat::Standard, worldBounds);
+                Model::BrushBuilder builder(&world, worldBounds);
+
+                VertexHandleManager manager;
+                for (size_t x = 0; x < gridSize; ++x) {
+                    for (size_t y = 0; y < gridSize; ++y) {
+                        const auto min = vm::vec3(static_cast<FloatType>(x) * 96.0, static_cast<FloatType>(y) * 96.0, 0.0);
+                        Model::Brush* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(64, 64, 64)), "texture");
+                        world.defaultLayer()->addChild(brush);
+                        manager.addHandles(brush);
+                    }
+                }
+
+                const auto handles = manager.allHandles();
+                std::vector<vm::ray3> pickRays;
+                for (size_t i = 0; i < NumPicks; ++i) {
+                    const auto& target = handles[(i * 7919u) % handles.size()];
+                    pickRays.push_back(vm::ray3(origin, normalize(target + vm::vec3(1.0, 1.0, 0.0) - origin)));
+                }
+
+                // build the spatial index outside of the timed sections
+                Model::PickResult warmup;
+                manager.pick(pickRays.front(), camera, warmup);
+
+                const auto handleCount = std::to_string(manager.totalHandleCount());
+                size_t indexedHits = 0;
+                timeLambda([&]() {
+                    for (const auto& pickRay : pickRays) {
+                        Model::PickResult pickResult;
+                        manager.pick(pickRay, camera, pickResult);
+                        indexedHits += pickResult.size();
+                    }
+                }, std::to_string(NumPicks) + " indexed picks among " + handleCount + " handles");
+
+                size_t linearHits = 0;
+                const auto handleRadius = pref(Preferences::HandleRadius);
+                timeLambda([&]() {
+                    for (const auto& pickRay : pickRays) {
+                        for (const auto& handle : handles) {
+                            if (!vm::isnan(camera.pickPointHandle(pickRay, handle, handleRadius))) {
+                                ++linearHits;
+                            }
+                        }
+                    }
+                }, std::to_string(NumPicks) + " linear picks among " + handleCount + " handles");
+
+                ASSERT_EQ(linearHits, indexedHits);
+            }
+        }
+    }
+}
@@ -25,7 +25,7 @@ IF(common_TYPE STREQUAL "SHARED_LIBRARY")
         TARGET_LINK_LIBRARIES(common asan)
     ENDIF()
 
-    TARGET_LINK_LIBRARIES(common glew ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz)
+    TARGET_LINK_LIBRARIES(common glew ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz ${CMAKE_THREAD_LIBS_INIT})
 ENDIF()
 
 INCLUDE_DIRECTORIES(${COMMON_SOURCE_DIR})
@@ -102,7 +102,7 @@ IF(COMPILER_IS_GNU AND TB_ENABLE_ASAN)
     TARGET_LINK_LIBRARIES(TrenchBroom asan)
 ENDIF()
 
-TARGET_LINK_LIBRARIES(TrenchBroom glew ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz)
+TARGET_LINK_LIBRARIES(TrenchBroom glew ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz ${CMAKE_THREAD_LIBS_INIT})
 IF (COMPILER_IS_MSVC)
     TARGET_LINK_LIBRARIES(TrenchBroom stackwalker)
 ENDIF()
@@ -29,8 +29,8 @@ ENDIF()
 ADD_TARGET_PROPERTY(TrenchBroom-Test INCLUDE_DIRECTORIES "${TEST_SOURCE_DIR}")
 ADD_TARGET_PROPERTY(TrenchBroom-Benchmark INCLUDE_DIRECTORIES "${BENCHMARK_SOURCE_DIR}")
 
-TARGET_LINK_LIBRARIES(TrenchBroom-Test glew gtest gmock ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz)
-TARGET_LINK_LIBRARIES(TrenchBroom-Benchmark glew gtest gmock ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz)
+TARGET_LINK_LIBRARIES(TrenchBroom-Test glew gtest gmock ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz ${CMAKE_THREAD_LIBS_INIT})
+TARGET_LINK_LIBRARIES(TrenchBroom-Benchmark glew gtest gmock ${FREEIMAGE_LIBRARIES} ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} vecmath tinyxml2 miniz ${CMAKE_THREAD_LIBS_INIT})
 
 SET_TARGET_PROPERTIES(TrenchBroom-Test PROPERTIES COMPILE_DEFINITIONS "GLEW_STATIC")
 SET_TARGET_PROPERTIES(TrenchBroom-Benchmark PROPERTIES COMPILE_DEFINITIONS "GLEW_STATIC")
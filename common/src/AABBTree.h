@@ -26,10 +26,14 @@
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 /**
  * An axis aligned bounding box tree that allows for quick ray intersection queries.
@@ -252,6 +256,24 @@ private:
             return newTreeRoot;
         }
 
+        /**
+         * Returns the left child of this node.
+         *
+         * @return the left child
+         */
+        const Node* left() const {
+            return m_left;
+        }
+
+        /**
+         * Returns the right child of this node.
+         *
+         * @return the right child
+         */
+        const Node* right() const {
+            return m_right;
+        }
+
     public: // Node overrides
         ~InnerNode() override {
             delete m_left;
@@ -472,18 +494,71 @@ public:
     }
 
     /**
-     * Clears this tree and rebuilds it by inserting given objects.
+     * Clears this tree and rebuilds it from the given objects.
+     *
+     * The tree is built top down by recursively splitting the objects at the median of their centers along the axis
+     * where the centers are spread the widest. This yields a balanced tree regardless of the order of the given
+     * objects, whereas inserting the objects one by one may produce a degenerate tree, e.g. if the bounds of one
+     * object contain the bounds of many others.
      *
      * @param objects the objects to insert, a list of DataType
      * @param getBounds a function from DataType -> Box to compute the bounds of each object
+     *
+     * @throws NodeTreeException if the given objects contain duplicates, or if any bounds contain NaN
      */
     template <typename DataList, typename GetBounds>
     void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
         clear();
-        for (const U& object : objects) {
-            insert(getBounds(object), object);
+
+        std::vector<LeafNode*> leafs;
+        try {
+            for (const U& object : objects) {
+                const Box bounds = getBounds(object);
+                check(bounds, object);
+
+                auto* leaf = new LeafNode(bounds, object);
+                leafs.push_back(leaf);
+                if (!m_leafForData.emplace(object, leaf).second) {
+                    NodeTreeException ex;
+                    ex << "data already in tree: " << object;
+                    throw ex;
+                }
+            }
+        } catch (...) {
+            for (auto* leaf : leafs) {
+                delete leaf;
+            }
+            m_leafForData.clear();
+            throw;
+        }
+
+        if (!leafs.empty()) {
+            m_root = build(std::begin(leafs), std::end(leafs));
         }
     }
+private:
+    using LeafIterator = typename std::vector<LeafNode*>::iterator;
+
+    static Node* build(LeafIterator first, LeafIterator last) {
+        const auto count = std::distance(first, last);
+        if (count == 1) {
+            return *first;
+        }
+
+        typename Box::builder centers;
+        for (auto it = first; it != last; ++it) {
+            centers.add((*it)->bounds().center());
+        }
+        const auto axis = vm::majorComponent(centers.bounds().size(), 0);
+
+        const auto mid = first + count / 2;
+        std::nth_element(first, mid, last, [axis](const LeafNode* lhs, const LeafNode* rhs) {
+            return lhs->bounds().center()[axis] < rhs->bounds().center()[axis];
+        });
+
+        return new InnerNode(build(first, mid), build(mid, last));
+    }
+public:
 
     /**
      * Insert a node with the given bounds and data into this tree.
@@ -563,6 +638,22 @@ private:
             throw ex;
         }
     }
+
+    /**
+     * Returns the distance at which the given ray enters the given bounding box, or 0 if the box contains the ray
+     * origin.
+     *
+     * @param ray the ray to test
+     * @param bounds the bounding box to test
+     * @return the entry distance or NaN if the ray misses the box
+     */
+    static T entryDistance(const vm::ray<T,S>& ray, const Box& bounds) {
+        if (bounds.contains(ray.origin)) {
+            return static_cast<T>(0.0);
+        } else {
+            return vm::intersectRayAndBBox(ray, bounds);
+        }
+    }
 public:
     /**
      * Clears this node tree.
@@ -572,6 +663,7 @@ public:
             delete m_root;
             m_root = nullptr;
         }
+        m_leafForData.clear();
     }
 
     /**
@@ -647,6 +739,92 @@ public:
         }
     }
 
+    /**
+     * Visits every data item in this tree whose bounding box intersects with the given ray in the order in which the
+     * ray enters the bounding boxes, beginning with the closest one. A bounding box that contains the ray origin is
+     * entered at distance 0.
+     *
+     * The visitor is passed each data item and the distance at which the ray enters its bounding box. It returns
+     * whether the traversal should continue, so the caller can stop once it knows that no data item further along
+     * the ray is of interest. Subtrees that are further away than the returned items are not visited at all.
+     *
+     * @tparam F the type of the visitor, a function that takes a data item and a distance and returns a boolean value
+     * @param ray the ray to test
+     * @param visitor the visitor to call
+     */
+    template <typename F>
+    void visitIntersectorsInOrder(const vm::ray<T,S>& ray, const F& visitor) const {
+        if (!empty()) {
+            // a min heap of the nodes whose bounds the ray intersects, ordered by entry distance
+            using Entry = std::pair<T, const Node*>;
+            const auto compare = [](const Entry& lhs, const Entry& rhs) { return lhs.first > rhs.first; };
+            std::vector<Entry> heap;
+
+            const auto push = [&](const Node* node) {
+                const auto distance = entryDistance(ray, node->bounds());
+                if (!vm::isnan(distance)) {
+                    heap.emplace_back(distance, node);
+                    std::push_heap(std::begin(heap), std::end(heap), compare);
+                }
+            };
+
+            auto distance = static_cast<T>(0.0);
+            auto proceed = true;
+            LambdaVisitor expand(
+                    [&](const InnerNode* innerNode) {
+                        // the children cannot be entered before their parent, so the heap order is maintained
+                        push(innerNode->left());
+                        push(innerNode->right());
+                        return false;
+                    },
+                    [&](const LeafNode* leaf) {
+                        proceed = visitor(leaf->data(), distance);
+                    }
+            );
+
+            push(m_root);
+            while (proceed && !heap.empty()) {
+                std::pop_heap(std::begin(heap), std::end(heap), compare);
+                const auto* node = heap.back().second;
+                distance = heap.back().first;
+                heap.pop_back();
+
+                node->accept(expand);
+            }
+        }
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box passes the given test and appends it to the given output
+     * iterator.
+     *
+     * The test is applied to the bounds of the inner nodes, too, and a subtree is skipped if its bounds fail the test.
+     * Therefore, the test must be conservative: if it fails for a bounding box, then it must also fail for every
+     * bounding box contained in it.
+     *
+     * @tparam P the type of the test, a unary predicate on bounding boxes
+     * @tparam O the output iterator type
+     * @param test the test to apply
+     * @param out the output iterator to append to
+     */
+    template <typename P, typename O>
+    void findMatching(const P& test, O out) const {
+        if (!empty()) {
+            LambdaVisitor visitor(
+                    [&](const InnerNode* innerNode) {
+                        return test(innerNode->bounds());
+                    },
+                    [&](const LeafNode* leaf) {
+                        if (test(leaf->bounds())) {
+                            out = leaf->data();
+                            ++out;
+                        }
+                    }
+            );
+            m_root->accept(visitor);
+        }
+    }
+
     /**
      * Finds every data item in this tree whose bounding box contains the given point and returns a list of those items.
      *
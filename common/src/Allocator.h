@@ -23,7 +23,7 @@
 #include <cassert>
 #include <iostream>
 #include <limits>
-#include <stack>
+#include <mutex>
 #include <vector>
 
 // Undefine this to prevent false positives when looking for memory leaks.
@@ -90,12 +90,47 @@ private:
     };
 
     using ChunkList = std::vector<Chunk*>;
-    using Pool = std::stack<T*>;
+    using BlockList = std::vector<T*>;
+
+    /**
+     * Every thread keeps up to 2 * PoolSize free blocks of its own, so that it only needs to lock the shared chunk
+     * lists once per PoolSize allocations or deallocations. A block may be released on a different thread than the
+     * one that allocated it, since blocks only return to their chunks through the shared lists.
+     */
+    class LocalPool {
+    private:
+        BlockList m_blocks;
+    public:
+        ~LocalPool() {
+            std::lock_guard<std::mutex> lock(mutex());
+            for (T* t : m_blocks)
+                deallocateShared(t);
+            localPoolDestroyed() = true;
+        }
 
-    static Pool& pool() {
-        static Pool p;
-        return p;
-    }
+        T* allocate() {
+            if (m_blocks.empty()) {
+                std::lock_guard<std::mutex> lock(mutex());
+                for (size_t i = 0; i < PoolSize; ++i)
+                    m_blocks.push_back(allocateShared());
+            }
+
+            T* t = m_blocks.back();
+            m_blocks.pop_back();
+            return t;
+        }
+
+        void deallocate(T* t) {
+            m_blocks.push_back(t);
+            if (m_blocks.size() > 2 * PoolSize) {
+                std::lock_guard<std::mutex> lock(mutex());
+                while (m_blocks.size() > PoolSize) {
+                    deallocateShared(m_blocks.back());
+                    m_blocks.pop_back();
+                }
+            }
+        }
+    };
 
     static ChunkList& fullChunks() {
         static ChunkList chunks;
@@ -111,17 +146,29 @@ private:
         static ChunkList chunks;
         return chunks;
     }
-public:
-#ifdef TB_ENABLE_ALLOCATOR
-    void* operator new(size_t size) {
-        assert(size == sizeof(T));
 
-        if (!pool().empty()) {
-            T* t = pool().top();
-            pool().pop();
-            return t;
-        }
+    // guards the chunk lists, since objects may be created and deleted on several threads at once, e.g. when brush
+    // geometry is built while a map is loaded
+    static std::mutex& mutex() {
+        static std::mutex m;
+        return m;
+    }
 
+    static bool& localPoolDestroyed() {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    // returns null if the pooling is disabled or if this thread's pool has already been destroyed during thread exit
+    static LocalPool* localPool() {
+        if (PoolSize == 0 || localPoolDestroyed())
+            return nullptr;
+        static thread_local LocalPool pool;
+        return &pool;
+    }
+
+    // the caller must hold the mutex
+    static T* allocateShared() {
         Chunk* chunk = nullptr;
         if (mixedChunks().empty()) {
             if (!emptyChunks().empty()) {
@@ -146,14 +193,8 @@ public:
         return block;
     }
 
-    void operator delete(void* block) {
-        T* t = reinterpret_cast<T*>(block);
-
-        if (PoolSize > 0 && pool().size() < PoolSize) {
-            pool().push(t);
-            return;
-        }
-
+    // the caller must hold the mutex
+    static void deallocateShared(T* t) {
         typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
         fullIt = fullChunks().rbegin();
         fullEnd = fullChunks().rend();
@@ -197,6 +238,29 @@ public:
                     delete chunk;
         }
     }
+public:
+#ifdef TB_ENABLE_ALLOCATOR
+    void* operator new(size_t size) {
+        assert(size == sizeof(T));
+        LocalPool* pool = localPool();
+        if (pool != nullptr)
+            return pool->allocate();
+
+        std::lock_guard<std::mutex> lock(mutex());
+        return allocateShared();
+    }
+
+    void operator delete(void* block) {
+        T* t = reinterpret_cast<T*>(block);
+        LocalPool* pool = localPool();
+        if (pool != nullptr) {
+            pool->deallocate(t);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex());
+        deallocateShared(t);
+    }
 #endif
 };
 
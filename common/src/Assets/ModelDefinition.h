@@ -57,6 +57,8 @@ namespace TrenchBroom {
 
             void append(const ModelDefinition& other);
 
+            const EL::Expression& expression() const;
+
             ModelSpecification modelSpecification(const Model::EntityAttributes& attributes) const;
             ModelSpecification defaultModelSpecification() const;
         private:
@@ -72,6 +72,8 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_tagGeneration(0),
+        m_tagMask(0),
         m_textureId(0) {
             assert(m_width > 0);
             assert(m_height > 0);
@@ -91,6 +93,8 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_tagGeneration(0),
+        m_tagMask(0),
         m_textureId(0),
         m_buffers(buffers) {
             assert(m_width > 0);
@@ -117,6 +121,8 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_tagGeneration(0),
+        m_tagMask(0),
         m_textureId(0) {}
 
         Texture::~Texture() {
@@ -160,6 +166,7 @@ namespace TrenchBroom {
 
         void Texture::setSurfaceParms(const StringSet& surfaceParms) {
             m_surfaceParms = surfaceParms;
+            m_tagGeneration = 0;
         }
 
         TextureCulling Texture::culling() const {
@@ -180,6 +187,19 @@ namespace TrenchBroom {
             m_blendFunc.destFactor = destFactor;
         }
 
+        bool Texture::cachedTagMask(const size_t generation, unsigned long& mask) const {
+            if (m_tagGeneration == 0 || m_tagGeneration != generation) {
+                return false;
+            }
+            mask = m_tagMask;
+            return true;
+        }
+
+        void Texture::setCachedTagMask(const size_t generation, const unsigned long mask) const {
+            m_tagGeneration = generation;
+            m_tagMask = mask;
+        }
+
         size_t Texture::usageCount() const {
             return m_usageCount;
         }
@@ -87,6 +87,11 @@ namespace TrenchBroom {
             // Quake 3 blend function, move to materials
             TextureBlendFunc m_blendFunc;
 
+            // The texture dependent smart tags matching this texture, cached by the tag manager. A generation of 0
+            // indicates that no tags are cached.
+            mutable size_t m_tagGeneration;
+            mutable unsigned long m_tagMask;
+
             mutable GLuint m_textureId;
             mutable TextureBuffer::List m_buffers;
         public:
@@ -114,6 +119,16 @@ namespace TrenchBroom {
             const TextureBlendFunc& blendFunc() const;
             void setBlendFunc(GLenum srcFactor, GLenum destFactor);
 
+            /**
+             * Retrieves the smart tag mask cached for the given generation of smart tags.
+             *
+             * @param generation the generation of the smart tags
+             * @param mask set to the cached mask if there is one
+             * @return true if a mask is cached for the given generation and false otherwise
+             */
+            bool cachedTagMask(size_t generation, unsigned long& mask) const;
+            void setCachedTagMask(size_t generation, unsigned long mask) const;
+
             size_t usageCount() const;
             void incUsageCount();
             void decUsageCount();
@@ -0,0 +1,480 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityDefinitionCache.h"
+
+#include "Exceptions.h"
+#include "Assets/AttributeDefinition.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "EL/Expression.h"
+#include "IO/ELParser.h"
+#include "IO/MapCache.h"
+#include "IO/Reader.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace EntityDefinitionCache {
+            static const char Magic[4] = { 'T', 'B', 'E', 'D' };
+            static const uint32_t Version = 1;
+
+            enum AttributeKind : uint8_t {
+                AttributeKind_Plain,
+                AttributeKind_String,
+                AttributeKind_Unknown,
+                AttributeKind_Boolean,
+                AttributeKind_Integer,
+                AttributeKind_Float,
+                AttributeKind_Choice,
+                AttributeKind_Flags
+            };
+
+            enum DefinitionType : uint8_t {
+                DefinitionType_Point,
+                DefinitionType_Brush
+            };
+
+            Path cachePath(const Path& cacheDirectory, const Path& definitionPath) {
+                const String pathString = definitionPath.asString();
+                StringStream name;
+                name << definitionPath.lastComponent().asString() << "-"
+                     << std::hex << std::setw(16) << std::setfill('0') << hash(pathString.data(), pathString.data() + pathString.size())
+                     << ".tbcache";
+                return cacheDirectory + Path(name.str());
+            }
+
+            uint64_t hash(const char* begin, const char* end) {
+                return MapCache::hash(begin, end);
+            }
+
+            /**
+             * Serializes the attribute definitions and the entity definitions into a buffer. Every attribute
+             * definition is written only once and is referenced by its index in the attribute definition table.
+             */
+            class DefinitionWriter {
+            private:
+                String m_attributes;
+                String m_definitions;
+                size_t m_attributeCount;
+                std::unordered_map<const Assets::AttributeDefinition*, uint32_t> m_attributeIndices;
+                size_t m_definitionCount;
+            public:
+                DefinitionWriter() :
+                m_attributeCount(0),
+                m_definitionCount(0) {}
+
+                void writeDefinition(const Assets::EntityDefinition* definition) {
+                    switch (definition->type()) {
+                        case Assets::EntityDefinition::Type_PointEntity:
+                            write<uint8_t>(m_definitions, DefinitionType_Point);
+                            break;
+                        case Assets::EntityDefinition::Type_BrushEntity:
+                            write<uint8_t>(m_definitions, DefinitionType_Brush);
+                            break;
+                        switchDefault()
+                    }
+
+                    writeString(m_definitions, definition->name());
+                    for (size_t i = 0; i < 4; ++i)
+                        write<float>(m_definitions, definition->color()[i]);
+                    writeString(m_definitions, definition->description());
+
+                    const Assets::AttributeDefinitionList& attributes = definition->attributeDefinitions();
+                    write<uint32_t>(m_definitions, static_cast<uint32_t>(attributes.size()));
+                    for (const Assets::AttributeDefinitionPtr& attribute : attributes)
+                        write<uint32_t>(m_definitions, attributeIndex(attribute.get()));
+
+                    if (definition->type() == Assets::EntityDefinition::Type_PointEntity) {
+                        const auto* pointDefinition = static_cast<const Assets::PointEntityDefinition*>(definition);
+                        for (size_t i = 0; i < 3; ++i)
+                            write<double>(m_definitions, pointDefinition->bounds().min[i]);
+                        for (size_t i = 0; i < 3; ++i)
+                            write<double>(m_definitions, pointDefinition->bounds().max[i]);
+                        writeString(m_definitions, modelExpression(pointDefinition));
+                    }
+
+                    ++m_definitionCount;
+                }
+
+                void writeTo(std::ostream& stream) const {
+                    writeValue<uint32_t>(stream, static_cast<uint32_t>(m_attributeCount));
+                    stream.write(m_attributes.data(), static_cast<std::streamsize>(m_attributes.size()));
+                    writeValue<uint32_t>(stream, static_cast<uint32_t>(m_definitionCount));
+                    stream.write(m_definitions.data(), static_cast<std::streamsize>(m_definitions.size()));
+                }
+
+                static void writeHeader(std::ostream& stream, const SourceFileList& sourceFiles, const Color& defaultEntityColor) {
+                    stream.write(Magic, sizeof(Magic));
+                    writeValue<uint32_t>(stream, Version);
+                    for (size_t i = 0; i < 4; ++i)
+                        writeValue<float>(stream, defaultEntityColor[i]);
+
+                    writeValue<uint32_t>(stream, static_cast<uint32_t>(sourceFiles.size()));
+                    for (const SourceFile& sourceFile : sourceFiles) {
+                        const String path = sourceFile.path.asString();
+                        writeValue<uint32_t>(stream, static_cast<uint32_t>(path.size()));
+                        stream.write(path.data(), static_cast<std::streamsize>(path.size()));
+                        writeValue<uint64_t>(stream, sourceFile.hash);
+                    }
+                }
+            private:
+                uint32_t attributeIndex(const Assets::AttributeDefinition* attribute) {
+                    const auto it = m_attributeIndices.find(attribute);
+                    if (it != std::end(m_attributeIndices))
+                        return it->second;
+
+                    writeAttribute(attribute);
+
+                    const auto index = static_cast<uint32_t>(m_attributeCount++);
+                    m_attributeIndices.emplace(attribute, index);
+                    return index;
+                }
+
+                void writeAttribute(const Assets::AttributeDefinition* attribute) {
+                    const AttributeKind kind = attributeKind(attribute);
+                    write<uint8_t>(m_attributes, kind);
+                    write<uint8_t>(m_attributes, static_cast<uint8_t>(attribute->type()));
+                    writeString(m_attributes, attribute->name());
+                    writeString(m_attributes, attribute->shortDescription());
+                    writeString(m_attributes, attribute->longDescription());
+                    write<uint8_t>(m_attributes, attribute->readOnly());
+
+                    switch (kind) {
+                        case AttributeKind_Plain:
+                            break;
+                        case AttributeKind_String:
+                        case AttributeKind_Unknown:
+                            writeDefaultValue(static_cast<const Assets::StringAttributeDefinition*>(attribute), &DefinitionWriter::writeString);
+                            break;
+                        case AttributeKind_Boolean:
+                            writeDefaultValue(static_cast<const Assets::BooleanAttributeDefinition*>(attribute), &DefinitionWriter::write<uint8_t>);
+                            break;
+                        case AttributeKind_Integer:
+                            writeDefaultValue(static_cast<const Assets::IntegerAttributeDefinition*>(attribute), &DefinitionWriter::write<int32_t>);
+                            break;
+                        case AttributeKind_Float:
+                            writeDefaultValue(static_cast<const Assets::FloatAttributeDefinition*>(attribute), &DefinitionWriter::write<float>);
+                            break;
+                        case AttributeKind_Choice: {
+                            const auto* choiceAttribute = static_cast<const Assets::ChoiceAttributeDefinition*>(attribute);
+                            write<uint32_t>(m_attributes, static_cast<uint32_t>(choiceAttribute->options().size()));
+                            for (const Assets::ChoiceAttributeOption& option : choiceAttribute->options()) {
+                                writeString(m_attributes, option.value());
+                                writeString(m_attributes, option.description());
+                            }
+                            writeDefaultValue(choiceAttribute, &DefinitionWriter::writeString);
+                            break;
+                        }
+                        case AttributeKind_Flags: {
+                            const auto* flagsAttribute = static_cast<const Assets::FlagsAttributeDefinition*>(attribute);
+                            write<uint32_t>(m_attributes, static_cast<uint32_t>(flagsAttribute->options().size()));
+                            for (const Assets::FlagsAttributeOption& option : flagsAttribute->options()) {
+                                write<int32_t>(m_attributes, option.value());
+                                writeString(m_attributes, option.shortDescription());
+                                writeString(m_attributes, option.longDescription());
+                                write<uint8_t>(m_attributes, option.isDefault());
+                            }
+                            break;
+                        }
+                        switchDefault()
+                    }
+                }
+
+                template <typename A, typename W>
+                void writeDefaultValue(const A* attribute, W writeValue) {
+                    write<uint8_t>(m_attributes, attribute->hasDefaultValue());
+                    if (attribute->hasDefaultValue())
+                        writeValue(m_attributes, attribute->defaultValue());
+                }
+
+                static AttributeKind attributeKind(const Assets::AttributeDefinition* attribute) {
+                    // check the most derived types first
+                    if (dynamic_cast<const Assets::UnknownAttributeDefinition*>(attribute) != nullptr)
+                        return AttributeKind_Unknown;
+                    if (dynamic_cast<const Assets::StringAttributeDefinition*>(attribute) != nullptr)
+                        return AttributeKind_String;
+                    if (dynamic_cast<const Assets::BooleanAttributeDefinition*>(attribute) != nullptr)
+                        return AttributeKind_Boolean;
+                    if (dynamic_cast<const Assets::IntegerAttributeDefinition*>(attribute) != nullptr)
+                        return AttributeKind_Integer;
+                    if (dynamic_cast<const Assets::FloatAttributeDefinition*>(attribute) != nullptr)
+                        return AttributeKind_Float;
+                    if (dynamic_cast<const Assets::ChoiceAttributeDefinition*>(attribute) != nullptr)
+                        return AttributeKind_Choice;
+                    if (dynamic_cast<const Assets::FlagsAttributeDefinition*>(attribute) != nullptr)
+                        return AttributeKind_Flags;
+                    if (typeid(*attribute) == typeid(Assets::AttributeDefinition))
+                        return AttributeKind_Plain;
+                    throw AssetException() << "Cannot cache attribute definition '" << attribute->name() << "'";
+                }
+
+                /**
+                 * Returns the model expression of the given definition as a string, checking that parsing the string
+                 * again yields the same expression. A definition without a model is written as an empty string
+                 * because the undefined literal cannot be parsed.
+                 */
+                static String modelExpression(const Assets::PointEntityDefinition* definition) {
+                    const String expression = definition->modelDefinition().expression().asString();
+                    if (expression == "undefined")
+                        return "";
+
+                    try {
+                        auto reparsed = ELParser::parseStrict(expression);
+                        reparsed.optimize();
+                        if (reparsed.asString() == expression)
+                            return expression;
+                    } catch (const ParserException&) {}
+                    throw AssetException() << "Cannot cache model definition of entity definition '" << definition->name() << "'";
+                }
+
+                static void writeString(String& buffer, const String& str) {
+                    write<uint32_t>(buffer, static_cast<uint32_t>(str.size()));
+                    buffer.append(str);
+                }
+
+                template <typename T>
+                static void write(String& buffer, const T value) {
+                    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+                }
+
+                template <typename T>
+                static void writeValue(std::ostream& stream, const T value) {
+                    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+                }
+            };
+
+            void write(const Assets::EntityDefinitionList& definitions, const SourceFileList& sourceFiles, const Color& defaultEntityColor, const Path& path) {
+                DefinitionWriter writer;
+                for (const Assets::EntityDefinition* definition : definitions)
+                    writer.writeDefinition(definition);
+
+                std::ofstream stream(path.asString().c_str(), std::ios::out | std::ios::binary);
+                if (!stream.is_open())
+                    throw FileSystemException("Cannot open file: " + path.asString());
+
+                DefinitionWriter::writeHeader(stream, sourceFiles, defaultEntityColor);
+                writer.writeTo(stream);
+
+                if (!stream)
+                    throw FileSystemException("Cannot write entity definition cache: " + path.asString());
+            }
+
+            // the minimum sizes of the records in the cache, used to reject corrupt counts before allocating
+            static const size_t MinAttributeSize = 2 * sizeof(uint8_t) + 3 * sizeof(uint32_t) + sizeof(uint8_t);
+            static const size_t MinDefinitionSize = sizeof(uint8_t) + sizeof(uint32_t) + 4 * sizeof(float) + 2 * sizeof(uint32_t);
+            static const size_t AttributeIndexSize = sizeof(uint32_t);
+            static const size_t MinChoiceOptionSize = 2 * sizeof(uint32_t);
+
+            /**
+             * Reads the number of the following records and checks that the remaining data can hold that many records
+             * of the given minimum size.
+             */
+            static size_t readCount(Reader& reader, const size_t minRecordSize) {
+                const size_t count = reader.readSize<uint32_t>();
+                if (count > (reader.size() - reader.position()) / minRecordSize)
+                    throw ReaderException() << "Record count " << count << " exceeds the remaining data";
+                return count;
+            }
+
+            class DefinitionReader {
+            private:
+                Reader m_reader;
+                Assets::AttributeDefinitionList m_attributes;
+            public:
+                explicit DefinitionReader(Reader reader) :
+                m_reader(std::move(reader)) {}
+
+                void read(Assets::EntityDefinitionList& result) {
+                    const size_t attributeCount = readCount(m_reader, MinAttributeSize);
+                    m_attributes.reserve(attributeCount);
+                    for (size_t i = 0; i < attributeCount; ++i)
+                        m_attributes.push_back(readAttribute());
+
+                    const size_t definitionCount = readCount(m_reader, MinDefinitionSize);
+                    Assets::EntityDefinitionList definitions;
+                    definitions.reserve(definitionCount);
+                    try {
+                        for (size_t i = 0; i < definitionCount; ++i)
+                            definitions.push_back(readDefinition());
+                    } catch (...) {
+                        VectorUtils::clearAndDelete(definitions);
+                        throw;
+                    }
+
+                    if (!m_reader.eof()) {
+                        VectorUtils::clearAndDelete(definitions);
+                        throw ReaderException("Unexpected data after entity definitions");
+                    }
+
+                    VectorUtils::append(result, definitions);
+                }
+            private:
+                Assets::EntityDefinition* readDefinition() {
+                    const auto type = m_reader.read<uint8_t, DefinitionType>();
+                    const String name = readString();
+                    const Color color(m_reader.readVec<float, 4>());
+                    const String description = readString();
+
+                    const size_t attributeCount = readCount(m_reader, AttributeIndexSize);
+                    Assets::AttributeDefinitionList attributes;
+                    attributes.reserve(attributeCount);
+                    for (size_t i = 0; i < attributeCount; ++i) {
+                        const size_t index = m_reader.readSize<uint32_t>();
+                        if (index >= m_attributes.size())
+                            throw ReaderException() << "Attribute definition index " << index << " is out of range";
+                        attributes.push_back(m_attributes[index]);
+                    }
+
+                    switch (type) {
+                        case DefinitionType_Point: {
+                            const auto min = m_reader.readVec<double, 3>();
+                            const auto max = m_reader.readVec<double, 3>();
+                            const Assets::ModelDefinition modelDefinition = readModelDefinition();
+                            return new Assets::PointEntityDefinition(name, color, vm::bbox3(min, max), description, attributes, modelDefinition);
+                        }
+                        case DefinitionType_Brush:
+                            return new Assets::BrushEntityDefinition(name, color, description, attributes);
+                        default:
+                            throw ReaderException() << "Unexpected entity definition type " << static_cast<int>(type);
+                    }
+                }
+
+                Assets::ModelDefinition readModelDefinition() {
+                    const String str = readString();
+                    if (str.empty())
+                        return Assets::ModelDefinition();
+
+                    try {
+                        auto expression = ELParser::parseStrict(str);
+                        expression.optimize();
+                        return Assets::ModelDefinition(expression);
+                    } catch (const ParserException& e) {
+                        throw ReaderException() << "Invalid model expression: " << e.what();
+                    }
+                }
+
+                Assets::AttributeDefinitionPtr readAttribute() {
+                    const auto kind = m_reader.read<uint8_t, AttributeKind>();
+                    const auto type = m_reader.read<uint8_t, Assets::AttributeDefinition::Type>();
+                    const String name = readString();
+                    const String shortDescription = readString();
+                    const String longDescription = readString();
+                    const bool readOnly = m_reader.readBool<uint8_t>();
+
+                    switch (kind) {
+                        case AttributeKind_Plain:
+                            return std::make_shared<Assets::AttributeDefinition>(name, type, shortDescription, longDescription, readOnly);
+                        case AttributeKind_String:
+                            return std::make_shared<Assets::StringAttributeDefinition>(name, shortDescription, longDescription, readOnly, readDefaultValue([&]() { return readString(); }));
+                        case AttributeKind_Unknown:
+                            return std::make_shared<Assets::UnknownAttributeDefinition>(name, shortDescription, longDescription, readOnly, readDefaultValue([&]() { return readString(); }));
+                        case AttributeKind_Boolean:
+                            return std::make_shared<Assets::BooleanAttributeDefinition>(name, shortDescription, longDescription, readOnly, readDefaultValue([&]() { return m_reader.readBool<uint8_t>(); }));
+                        case AttributeKind_Integer:
+                            return std::make_shared<Assets::IntegerAttributeDefinition>(name, shortDescription, longDescription, readOnly, readDefaultValue([&]() { return m_reader.readInt<int32_t>(); }));
+                        case AttributeKind_Float:
+                            return std::make_shared<Assets::FloatAttributeDefinition>(name, shortDescription, longDescription, readOnly, readDefaultValue([&]() { return m_reader.readFloat<float>(); }));
+                        case AttributeKind_Choice: {
+                            const size_t optionCount = readCount(m_reader, MinChoiceOptionSize);
+                            Assets::ChoiceAttributeOption::List options;
+                            options.reserve(optionCount);
+                            for (size_t i = 0; i < optionCount; ++i) {
+                                const String value = readString();
+                                const String description = readString();
+                                options.push_back(Assets::ChoiceAttributeOption(value, description));
+                            }
+                            return std::make_shared<Assets::ChoiceAttributeDefinition>(name, shortDescription, longDescription, options, readOnly, readDefaultValue([&]() { return readString(); }));
+                        }
+                        case AttributeKind_Flags: {
+                            auto flags = std::make_shared<Assets::FlagsAttributeDefinition>(name);
+                            const size_t optionCount = m_reader.readSize<uint32_t>();
+                            for (size_t i = 0; i < optionCount; ++i) {
+                                const int value = m_reader.readInt<int32_t>();
+                                const String optionShortDescription = readString();
+                                const String optionLongDescription = readString();
+                                const bool isDefault = m_reader.readBool<uint8_t>();
+                                flags->addOption(value, optionShortDescription, optionLongDescription, isDefault);
+                            }
+
+                            if (shortDescription.empty() && longDescription.empty() && !readOnly)
+                                return flags;
+                            return Assets::AttributeDefinitionPtr(flags->clone(name, shortDescription, longDescription, readOnly));
+                        }
+                        default:
+                            throw ReaderException() << "Unexpected attribute definition kind " << static_cast<int>(kind);
+                    }
+                }
+
+                template <typename F>
+                auto readDefaultValue(F readValue) -> nonstd::optional<decltype(readValue())> {
+                    if (m_reader.readBool<uint8_t>())
+                        return readValue();
+                    return nonstd::nullopt;
+                }
+
+                String readString() {
+                    return m_reader.readString(readCount(m_reader, 1));
+                }
+            };
+
+            bool read(const char* begin, const char* end, const Color& defaultEntityColor, const HashFile& hashFile, Assets::EntityDefinitionList& result) {
+                try {
+                    Reader reader = Reader::from(begin, end);
+
+                    char magic[sizeof(Magic)];
+                    reader.read(magic, sizeof(magic));
+                    if (std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+                        reader.read<uint32_t, uint32_t>() != Version ||
+                        reader.readVec<float, 4>() != defaultEntityColor) {
+                        return false;
+                    }
+
+                    const size_t sourceFileCount = reader.readSize<uint32_t>();
+                    for (size_t i = 0; i < sourceFileCount; ++i) {
+                        const Path path(reader.readString(readCount(reader, 1)));
+                        const auto expectedHash = reader.read<uint64_t, uint64_t>();
+                        if (hashFile(path) != expectedHash)
+                            return false;
+                    }
+
+                    DefinitionReader definitionReader(reader.subReaderFromCurrent(reader.size() - reader.position()));
+                    definitionReader.read(result);
+                    return true;
+                } catch (const ReaderException&) {
+                    return false;
+                } catch (const FileNotFoundException&) {
+                    // a source file was removed
+                    return false;
+                } catch (const FileSystemException&) {
+                    return false;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EntityDefinitionCache
+#define TrenchBroom_EntityDefinitionCache
+
+#include "Color.h"
+#include "Assets/AssetTypes.h"
+#include "IO/Path.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * A binary cache of the entity definitions parsed from an entity definition file, so that the file and the
+         * files it includes need not be parsed again as long as none of them change.
+         *
+         * The cache stores the paths and content hashes of all files that the definitions were parsed from, the
+         * default entity color that was used, a table of attribute definitions, and the entity definitions, which
+         * refer to the attribute definitions by index so that attribute definitions that are shared between entity
+         * definitions remain shared. Model definitions are stored as EL expressions and are parsed when the cache is
+         * read. All values are stored in native byte order.
+         */
+        namespace EntityDefinitionCache {
+            /**
+             * A file that entity definitions were parsed from, along with the hash of its contents.
+             */
+            struct SourceFile {
+                Path path;
+                uint64_t hash;
+            };
+
+            using SourceFileList = std::vector<SourceFile>;
+
+            /**
+             * Returns the hash of the current contents of the file at the given path.
+             *
+             * @throws FileNotFoundException or FileSystemException if the file cannot be read
+             */
+            using HashFile = std::function<uint64_t(const Path& path)>;
+
+            /**
+             * Returns the path of the cache file for the entity definition file with the given absolute path. The
+             * cache file is placed in the given directory, and its name is derived from the entity definition file's
+             * name and path.
+             */
+            Path cachePath(const Path& cacheDirectory, const Path& definitionPath);
+
+            /**
+             * Computes the hash of the given file contents which is stored in and compared against the cache.
+             */
+            uint64_t hash(const char* begin, const char* end);
+
+            /**
+             * Writes the given entity definitions, which were parsed from the given source files using the given
+             * default entity color, to a cache file at the given path.
+             *
+             * @throws FileSystemException if the file cannot be written
+             * @throws AssetException if any of the definitions cannot be stored in a cache
+             */
+            void write(const Assets::EntityDefinitionList& definitions, const SourceFileList& sourceFiles, const Color& defaultEntityColor, const Path& path);
+
+            /**
+             * Reads entity definitions from the given cache file contents.
+             *
+             * @param begin the beginning of the cache file contents
+             * @param end the end of the cache file contents
+             * @param defaultEntityColor the default entity color, which must match the one the cache was written with
+             * @param hashFile used to compute the current hashes of the source files stored in the cache
+             * @param result the definitions read from the cache are appended to this list, which becomes their owner
+             * @return true if the definitions were read, and false if the cache was written for different source
+             * files, a different default entity color, or if the cache is invalid
+             */
+            bool read(const char* begin, const char* end, const Color& defaultEntityColor, const HashFile& hashFile, Assets::EntityDefinitionList& result);
+        }
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityDefinitionCache) */
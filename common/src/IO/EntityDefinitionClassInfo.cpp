@@ -155,7 +155,13 @@ namespace TrenchBroom {
                         }
                     }
 
-                    m_modelDefinition.append(baseClass.modelDefinition());
+                    if (baseClass.hasModelDefinition()) {
+                        // don't add undefined cases to the model definition, they are skipped anyway
+                        if (hasModelDefinition())
+                            m_modelDefinition.append(baseClass.modelDefinition());
+                        else
+                            setModelDefinition(baseClass.modelDefinition());
+                    }
                 }
             }
         }
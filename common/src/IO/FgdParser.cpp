@@ -122,6 +122,7 @@ namespace TrenchBroom {
 
         FgdParser::FgdParser(const char* begin, const char* end, const Color& defaultEntityColor, const Path& path) :
         m_defaultEntityColor(defaultEntityColor),
+        m_allIncludesFound(true),
         m_tokenizer(FgdTokenizer(begin, end)) {
             if (!path.isEmpty()) {
                 pushIncludePath(path);
@@ -131,6 +132,14 @@ namespace TrenchBroom {
         FgdParser::FgdParser(const String& str, const Color& defaultEntityColor, const Path& path) :
         FgdParser(str.c_str(), str.c_str() + str.size(), defaultEntityColor, path) {}
 
+        const Path::List& FgdParser::includedFiles() const {
+            return m_includedFiles;
+        }
+
+        bool FgdParser::allIncludesFound() const {
+            return m_allIncludesFound;
+        }
+
         FgdParser::TokenNameMap FgdParser::tokenNames() const {
             using namespace FgdToken;
 
@@ -708,6 +717,10 @@ namespace TrenchBroom {
                 const auto filePath = file->path();
                 status.debug(m_tokenizer.line(), "Resolved '" + path.asString() + "' to '" + filePath.asString() + "'");
 
+                if (!VectorUtils::contains(m_includedFiles, filePath)) {
+                    m_includedFiles.push_back(filePath);
+                }
+
                 if (!isRecursiveInclude(filePath)) {
                     const PushIncludePath pushIncludePath(this, filePath);
                     auto reader = file->reader().buffer();
@@ -719,6 +732,8 @@ namespace TrenchBroom {
                     status.error(m_tokenizer.line(), str.str());
                 }
             } catch (const Exception &e) {
+                m_allIncludesFound = false;
+
                 auto str = StringStream();
                 str << "Failed to parse included file: " << e.what();
                 status.error(m_tokenizer.line(), str.str());
@@ -72,12 +72,26 @@ namespace TrenchBroom {
 
             std::list<Path> m_paths;
             std::shared_ptr<FileSystem> m_fs;
+            Path::List m_includedFiles;
+            bool m_allIncludesFound;
 
             FgdTokenizer m_tokenizer;
             EntityDefinitionClassInfoMap m_baseClasses;
         public:
             FgdParser(const char* begin, const char* end, const Color& defaultEntityColor, const Path& path = Path(""));
             FgdParser(const String& str, const Color& defaultEntityColor, const Path& path = Path(""));
+
+            /**
+             * Returns the absolute paths of the files that were included while parsing, in the order in which they
+             * were first included.
+             */
+            const Path::List& includedFiles() const;
+
+            /**
+             * Indicates whether every included file could be found and parsed. If not, the parsed definitions may
+             * change even if none of the included files change.
+             */
+            bool allIncludesFound() const;
         private:
             class PushIncludePath;
             void pushIncludePath(const Path& path);
@@ -22,6 +22,11 @@
 #include "Exceptions.h"
 #include "CollectionUtils.h"
 #include "IO/FileMatcher.h"
+#include "IO/FileSystemIndex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
 
 namespace TrenchBroom {
     namespace IO {
@@ -42,9 +47,20 @@ namespace TrenchBroom {
         }
 
         std::shared_ptr<FileSystem> FileSystem::releaseNext() {
+            m_index.reset();
             return std::move(m_next);
         }
 
+        void FileSystem::buildIndex() {
+            m_index = std::make_unique<FileSystemIndex>(*this);
+        }
+
+        void FileSystem::updateIndex(const FileSystem& fileSystem) {
+            if (m_index) {
+                m_index->update(fileSystem);
+            }
+        }
+
         bool FileSystem::canMakeAbsolute(const Path& path) const {
             return !path.isAbsolute();
         }
@@ -139,6 +155,48 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<std::shared_ptr<File>> FileSystem::openFiles(const Path::List& paths) const {
+            // group the paths by the file system that contains them, preserving the order of first appearance
+            std::vector<std::pair<const FileSystem*, std::vector<size_t>>> groups;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                const auto& path = paths[i];
+                try {
+                    if (path.isAbsolute()) {
+                        throw FileSystemException("Path is absolute: '" + path.asString() + "'");
+                    }
+
+                    const auto* fileSystem = _findFileSystem(path);
+                    if (fileSystem == nullptr) {
+                        throw FileSystemException("File not found: '" + path.asString() + "'");
+                    }
+
+                    auto it = std::find_if(std::begin(groups), std::end(groups), [&](const auto& group) { return group.first == fileSystem; });
+                    if (it == std::end(groups)) {
+                        it = groups.insert(std::end(groups), std::make_pair(fileSystem, std::vector<size_t>()));
+                    }
+                    it->second.push_back(i);
+                } catch (const PathException& e) {
+                    throw FileSystemException("Invalid path: '" + path.asString() + "'", e);
+                }
+            }
+
+            std::vector<std::shared_ptr<File>> result(paths.size());
+            for (const auto& group : groups) {
+                Path::List groupPaths;
+                groupPaths.reserve(group.second.size());
+                for (const auto index : group.second) {
+                    groupPaths.push_back(paths[index]);
+                }
+
+                auto files = group.first->doOpenFiles(groupPaths);
+                assert(files.size() == groupPaths.size());
+                for (size_t i = 0; i < files.size(); ++i) {
+                    result[group.second[i]] = std::move(files[i]);
+                }
+            }
+            return result;
+        }
+
         Path FileSystem::_makeAbsolute(const Path& path) const {
             if (doFileExists(path) || doDirectoryExists(path)) {
                 // If the file is present in this file system, make it absolute here.
@@ -158,6 +216,9 @@ namespace TrenchBroom {
         }
 
         bool FileSystem::_fileExists(const Path& path) const {
+            if (m_index) {
+                return m_index->fileExists(path);
+            }
             return doFileExists(path) || (m_next && m_next->_fileExists(path));
         }
 
@@ -172,7 +233,9 @@ namespace TrenchBroom {
         }
 
         std::shared_ptr<File> FileSystem::_openFile(const Path& path) const {
-            if (doFileExists(path)) {
+            if (m_index) {
+                return m_index->openFile(path);
+            } else if (doFileExists(path)) {
                 return doOpenFile(path);
             } else if (m_next) {
                 return m_next->_openFile(path);
@@ -181,6 +244,18 @@ namespace TrenchBroom {
             }
         }
 
+        const FileSystem* FileSystem::_findFileSystem(const Path& path) const {
+            if (m_index) {
+                return m_index->findFileSystem(path);
+            } else if (doFileExists(path)) {
+                return this;
+            } else if (m_next) {
+                return m_next->_findFileSystem(path);
+            } else {
+                return nullptr;
+            }
+        }
+
         bool FileSystem::doCanMakeAbsolute(const Path& path) const {
             return false;
         }
@@ -189,6 +264,15 @@ namespace TrenchBroom {
             throw FileSystemException("Cannot make absolute path of '" + path.asString() + "'");
         }
 
+        std::vector<std::shared_ptr<File>> FileSystem::doOpenFiles(const Path::List& paths) const {
+            std::vector<std::shared_ptr<File>> result;
+            result.reserve(paths.size());
+            for (const auto& path : paths) {
+                result.push_back(doOpenFile(path));
+            }
+            return result;
+        }
+
         WritableFileSystem::WritableFileSystem() = default;
         WritableFileSystem::~WritableFileSystem() = default;
 
@@ -28,10 +28,12 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
         class File;
+        class FileSystemIndex;
         class Path;
 
         class FileSystem {
@@ -47,6 +49,8 @@ namespace TrenchBroom {
              * so std::unique_ptr isn't usable with this design.)
              */
             std::shared_ptr<FileSystem> m_next;
+        private:
+            std::unique_ptr<FileSystemIndex> m_index;
         public: // public API
             explicit FileSystem(std::shared_ptr<FileSystem> next = std::shared_ptr<FileSystem>());
             virtual ~FileSystem();
@@ -55,6 +59,25 @@ namespace TrenchBroom {
             const FileSystem& next() const;
             std::shared_ptr<FileSystem> releaseNext();
 
+            /**
+             * Builds an index of the files in this file system and all file systems that follow it in the search
+             * path. Once the index exists, file lookups are answered by the index instead of by walking the search
+             * path.
+             *
+             * The index must be rebuilt whenever the search path changes. It is discarded when the next file system
+             * is released.
+             */
+            void buildIndex();
+
+            /**
+             * Updates the index after the contents of the given file system, which must be part of the search path,
+             * have changed. Does nothing if no index exists.
+             *
+             * @param fileSystem the file system to reindex
+             */
+            void updateIndex(const FileSystem& fileSystem);
+        public:
+
             bool canMakeAbsolute(const Path& path) const;
             Path makeAbsolute(const Path& path) const;
 
@@ -114,6 +137,18 @@ namespace TrenchBroom {
 
             Path::List getDirectoryContents(const Path& directoryPath) const;
             std::shared_ptr<File> openFile(const Path& path) const;
+
+            /**
+             * Opens the files at the given paths. The files are grouped by the file system that contains them, and each
+             * file system opens its files in one batch, which allows file systems that decompress their files to do so
+             * concurrently.
+             *
+             * @param paths the paths of the files to open
+             * @return the opened files, in the order of the given paths
+             *
+             * @throw FileSystemException if any of the given paths is invalid or if any of the files cannot be found
+             */
+            std::vector<std::shared_ptr<File>> openFiles(const Path::List& paths) const;
         private: // private API to be used for chaining, avoids multiple checks of parameters
             bool _canMakeAbsolute(const Path& path) const;
             Path _makeAbsolute(const Path& path) const;
@@ -121,6 +156,7 @@ namespace TrenchBroom {
             bool _fileExists(const Path& path) const;
             Path::List _getDirectoryContents(const Path& directoryPath) const;
             std::shared_ptr<File> _openFile(const Path& path) const;
+            const FileSystem* _findFileSystem(const Path& path) const;
 
             /**
              * Finds all items matching the given matcher at the given search path, optionally recursively. This method
@@ -208,6 +244,14 @@ namespace TrenchBroom {
             virtual Path::List doGetDirectoryContents(const Path& path) const = 0;
 
             virtual std::shared_ptr<File> doOpenFile(const Path& path) const = 0;
+
+            /**
+             * Opens the given files, all of which exist in this file system. The default implementation opens the files
+             * one by one.
+             */
+            virtual std::vector<std::shared_ptr<File>> doOpenFiles(const Path::List& paths) const;
+
+            friend class FileSystemIndex;
         };
 
         class WritableFileSystem {
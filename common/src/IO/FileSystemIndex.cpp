@@ -0,0 +1,151 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileSystemIndex.h"
+
+#include "Ensure.h"
+#include "Exceptions.h"
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/Path.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace IO {
+        FileSystemIndex::FileSystemIndex(const FileSystem& fileSystem) {
+            for (const FileSystem* current = &fileSystem; current != nullptr; current = current->m_next.get()) {
+                m_fileSystems.push_back(current);
+                m_imageFileSystems.push_back(dynamic_cast<const ImageFileSystemBase*>(current));
+            }
+
+            for (size_t rank = 0; rank < m_fileSystems.size(); ++rank) {
+                if (m_imageFileSystems[rank] != nullptr) {
+                    addEntries(rank);
+                } else {
+                    m_unindexedRanks.push_back(rank);
+                }
+            }
+        }
+
+        bool FileSystemIndex::fileExists(const Path& path) const {
+            const auto it = m_entries.find(makeKey(path));
+            const Entry* entry = it != std::end(m_entries) ? &it->second : nullptr;
+            return entry != nullptr || findUnindexedFileSystem(path, entry) != nullptr;
+        }
+
+        std::shared_ptr<File> FileSystemIndex::openFile(const Path& path) const {
+            const auto it = m_entries.find(makeKey(path));
+            const Entry* entry = it != std::end(m_entries) ? &it->second : nullptr;
+
+            const FileSystem* fileSystem = findUnindexedFileSystem(path, entry);
+            if (fileSystem != nullptr) {
+                return fileSystem->doOpenFile(path);
+            } else if (entry != nullptr) {
+                return entry->file->open();
+            } else {
+                throw FileSystemException("File not found: '" + path.asString() + "'");
+            }
+        }
+
+        const FileSystem* FileSystemIndex::findFileSystem(const Path& path) const {
+            const auto it = m_entries.find(makeKey(path));
+            const Entry* entry = it != std::end(m_entries) ? &it->second : nullptr;
+
+            const FileSystem* fileSystem = findUnindexedFileSystem(path, entry);
+            if (fileSystem != nullptr) {
+                return fileSystem;
+            } else if (entry != nullptr) {
+                return m_fileSystems[entry->rank];
+            } else {
+                return nullptr;
+            }
+        }
+
+        void FileSystemIndex::update(const FileSystem& fileSystem) {
+            const auto it = std::find(std::begin(m_fileSystems), std::end(m_fileSystems), &fileSystem);
+            ensure(it != std::end(m_fileSystems), "file system is not indexed");
+
+            const auto rank = static_cast<size_t>(std::distance(std::begin(m_fileSystems), it));
+            if (m_imageFileSystems[rank] == nullptr) {
+                // the contents of this file system are queried directly
+                return;
+            }
+
+            StringList removedKeys;
+            for (auto cur = std::begin(m_entries); cur != std::end(m_entries); ) {
+                if (cur->second.rank == rank) {
+                    removedKeys.push_back(cur->first);
+                    cur = m_entries.erase(cur);
+                } else {
+                    ++cur;
+                }
+            }
+
+            addEntries(rank);
+
+            // files that were shadowed by removed files are visible again
+            for (const auto& key : removedKeys) {
+                if (m_entries.count(key) > 0) {
+                    continue;
+                }
+
+                const Path path(key);
+                for (size_t lowerRank = rank + 1; lowerRank < m_imageFileSystems.size(); ++lowerRank) {
+                    const auto* imageFileSystem = m_imageFileSystems[lowerRank];
+                    if (imageFileSystem != nullptr && imageFileSystem->m_root.fileExists(path)) {
+                        m_entries.emplace(key, Entry{ lowerRank, &imageFileSystem->m_root.findFile(path) });
+                        break;
+                    }
+                }
+            }
+        }
+
+        const FileSystem* FileSystemIndex::findUnindexedFileSystem(const Path& path, const Entry* entry) const {
+            // only file systems that precede the indexed file can shadow it
+            const auto maxRank = entry != nullptr ? entry->rank : m_fileSystems.size();
+            for (const auto rank : m_unindexedRanks) {
+                if (rank > maxRank) {
+                    break;
+                }
+
+                const FileSystem* fileSystem = m_fileSystems[rank];
+                if (fileSystem->doFileExists(path)) {
+                    return fileSystem;
+                }
+            }
+            return nullptr;
+        }
+
+        void FileSystemIndex::addEntries(const size_t rank) {
+            const auto* imageFileSystem = m_imageFileSystems[rank];
+            imageFileSystem->m_root.forEachFile([&](const Path& path, const ImageFileSystemBase::FileEntry& file) {
+                const auto result = m_entries.emplace(makeKey(path), Entry{ rank, &file });
+                if (!result.second && result.first->second.rank > rank) {
+                    result.first->second = Entry{ rank, &file };
+                }
+            });
+        }
+
+        String FileSystemIndex::makeKey(const Path& path) {
+            return path.makeLowerCase().makeCanonical().asString('/');
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_FileSystemIndex
+#define TrenchBroom_FileSystemIndex
+
+#include "Macros.h"
+#include "StringUtils.h"
+#include "IO/ImageFileSystem.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        class File;
+        class FileSystem;
+        class Path;
+
+        /**
+         * A flattened index of the files in a chain of file systems.
+         *
+         * The files of all image file systems in the chain are stored in a single hash map that is keyed by the
+         * lower case canonical file path and maps to the file entry of the file system with the highest precedence.
+         * The contents of other file systems, e.g. disk file systems, may change at any time and cannot be indexed,
+         * so these are still queried directly, but only if they precede the indexed entry in the search path.
+         */
+        class FileSystemIndex {
+        private:
+            struct Entry {
+                size_t rank;
+                const ImageFileSystemBase::FileEntry* file;
+            };
+
+            std::vector<const FileSystem*> m_fileSystems;
+            std::vector<const ImageFileSystemBase*> m_imageFileSystems;
+            std::vector<size_t> m_unindexedRanks;
+            std::unordered_map<String, Entry> m_entries;
+        public:
+            /**
+             * Creates an index of the given file system and all file systems that follow it in the search path.
+             *
+             * @param fileSystem the first file system in the search path
+             */
+            explicit FileSystemIndex(const FileSystem& fileSystem);
+
+            bool fileExists(const Path& path) const;
+            std::shared_ptr<File> openFile(const Path& path) const;
+
+            /**
+             * Returns the file system that contains the file with the given path and that has the highest precedence,
+             * or null if no such file system exists.
+             */
+            const FileSystem* findFileSystem(const Path& path) const;
+
+            /**
+             * Reindexes the given file system after its contents have changed. Only the entries of the given file
+             * system and the entries that it shadows are updated.
+             *
+             * @param fileSystem the file system to reindex, must be part of the indexed search path
+             */
+            void update(const FileSystem& fileSystem);
+        private:
+            const FileSystem* findUnindexedFileSystem(const Path& path, const Entry* entry) const;
+            void addEntries(size_t rank);
+            static String makeKey(const Path& path);
+
+            deleteCopyAndMove(FileSystemIndex)
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_FileSystemIndex) */
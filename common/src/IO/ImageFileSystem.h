@@ -85,6 +85,20 @@ namespace TrenchBroom {
                 const Directory& findDirectory(const Path& path) const;
                 const FileEntry& findFile(const Path& path) const;
                 Path::List contents() const;
+
+                /**
+                 * Calls the given function for every file in this directory and its sub directories, passing the
+                 * path of the file relative to the root directory and the file entry.
+                 */
+                template <typename F>
+                void forEachFile(const F& f) const {
+                    for (const auto& entry : m_files) {
+                        f(m_path + entry.first, *entry.second);
+                    }
+                    for (const auto& entry : m_directories) {
+                        entry.second->forEachFile(f);
+                    }
+                }
             private:
                 Directory& findOrCreateDirectory(const Path& path);
             };
@@ -99,7 +113,7 @@ namespace TrenchBroom {
             void initialize();
         public:
             /**
-             * Reload this file system.
+             * Reload this file system. If this file system is indexed, the index must be updated afterwards.
              */
             void reload();
         private:
@@ -110,6 +124,8 @@ namespace TrenchBroom {
             std::shared_ptr<File> doOpenFile(const Path& path) const override;
         private:
             virtual void doReadDirectory() = 0;
+
+            friend class FileSystemIndex;
         };
 
         class ImageFileSystem : public ImageFileSystemBase {
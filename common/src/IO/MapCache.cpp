@@ -0,0 +1,449 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Exceptions.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace MapCache {
+            static const char Magic[4] = { 'T', 'B', 'M', 'C' };
+            static const uint32_t Version = 1;
+
+            // the minimum sizes of the records in the node data, used to reject corrupt counts before allocating
+            static const size_t MinStringSize = sizeof(uint32_t);
+            static const size_t VertexSize = 3 * sizeof(double);
+            static const size_t MinFaceSize = 2 * sizeof(uint32_t) + 15 * sizeof(double) + sizeof(uint32_t) + 10 * sizeof(float) + 2 * sizeof(int32_t) + sizeof(uint32_t);
+            static const size_t VertexIndexSize = sizeof(uint32_t);
+
+            enum NodeType : uint8_t {
+                NodeType_World,
+                NodeType_Layer,
+                NodeType_Group,
+                NodeType_Entity,
+                NodeType_Brush
+            };
+
+            Path cachePath(const Path& mapPath) {
+                return mapPath.addExtension("tbcache");
+            }
+
+            uint64_t hash(const char* begin, const char* end) {
+                // 64 bit FNV-1a
+                uint64_t result = 14695981039346656037ull;
+                for (const char* cur = begin; cur != end; ++cur) {
+                    result ^= static_cast<unsigned char>(*cur);
+                    result *= 1099511628211ull;
+                }
+                return result;
+            }
+
+            /**
+             * Serializes the node tree into a buffer and collects the strings it references in a table. The
+             * strings are referenced by their index in the table.
+             */
+            class NodeWriter : public Model::ConstNodeVisitor {
+            private:
+                String m_nodes;
+                std::vector<const String*> m_strings;
+                std::unordered_map<String, uint32_t> m_stringIndices;
+            public:
+                const String& nodes() const {
+                    return m_nodes;
+                }
+
+                const std::vector<const String*>& strings() const {
+                    return m_strings;
+                }
+            private:
+                void doVisit(const Model::World* world) override {
+                    writeNode(NodeType_World, world);
+                    writeAttributes(world->attributes());
+
+                    const Model::LayerList customLayers = world->customLayers();
+                    write<uint32_t>(static_cast<uint32_t>(customLayers.size() + 1));
+                    world->defaultLayer()->accept(*this);
+                    for (const Model::Layer* layer : customLayers)
+                        layer->accept(*this);
+                }
+
+                void doVisit(const Model::Layer* layer) override {
+                    writeNode(NodeType_Layer, layer);
+                    writeString(layer->name());
+                    writeChildren(layer);
+                }
+
+                void doVisit(const Model::Group* group) override {
+                    writeNode(NodeType_Group, group);
+                    writeString(group->name());
+                    writeChildren(group);
+                }
+
+                void doVisit(const Model::Entity* entity) override {
+                    writeNode(NodeType_Entity, entity);
+                    writeAttributes(entity->attributes());
+                    writeChildren(entity);
+                }
+
+                void doVisit(const Model::Brush* brush) override {
+                    writeNode(NodeType_Brush, brush);
+
+                    std::unordered_map<const Model::BrushVertex*, uint32_t> vertexIndices;
+                    write<uint32_t>(static_cast<uint32_t>(brush->vertexCount()));
+                    for (const Model::BrushVertex* vertex : brush->vertices()) {
+                        vertexIndices.emplace(vertex, static_cast<uint32_t>(vertexIndices.size()));
+                        writeVec(vertex->position());
+                    }
+
+                    const Model::BrushFaceList& faces = brush->faces();
+                    write<uint32_t>(static_cast<uint32_t>(faces.size()));
+                    for (const Model::BrushFace* face : faces) {
+                        write<uint32_t>(static_cast<uint32_t>(face->lineNumber()));
+                        write<uint32_t>(static_cast<uint32_t>(face->lineCount()));
+
+                        for (const vm::vec3& point : face->points())
+                            writeVec(point);
+                        writeVec(face->textureXAxis());
+                        writeVec(face->textureYAxis());
+
+                        const Model::BrushFaceAttributes& attribs = face->attribs();
+                        writeString(attribs.textureName());
+                        write<float>(attribs.xOffset());
+                        write<float>(attribs.yOffset());
+                        write<float>(attribs.rotation());
+                        write<float>(attribs.xScale());
+                        write<float>(attribs.yScale());
+                        write<int32_t>(attribs.surfaceContents());
+                        write<int32_t>(attribs.surfaceFlags());
+                        write<float>(attribs.surfaceValue());
+                        for (size_t i = 0; i < 4; ++i)
+                            write<float>(attribs.color()[i]);
+
+                        const Model::BrushFace::VertexList vertices = face->vertices();
+                        write<uint32_t>(static_cast<uint32_t>(vertices.size()));
+                        for (const Model::BrushVertex* vertex : vertices)
+                            write<uint32_t>(vertexIndices.at(vertex));
+                    }
+                }
+
+                void writeNode(const NodeType type, const Model::Node* node) {
+                    write<uint8_t>(type);
+                    write<uint32_t>(static_cast<uint32_t>(node->lineNumber()));
+                    write<uint32_t>(static_cast<uint32_t>(node->lineCount()));
+                }
+
+                void writeChildren(const Model::Node* node) {
+                    write<uint32_t>(static_cast<uint32_t>(node->childCount()));
+                    for (const Model::Node* child : node->children())
+                        child->accept(*this);
+                }
+
+                void writeAttributes(const Model::EntityAttribute::List& attributes) {
+                    write<uint32_t>(static_cast<uint32_t>(attributes.size()));
+                    for (const Model::EntityAttribute& attribute : attributes) {
+                        writeString(attribute.name());
+                        writeString(attribute.value());
+                    }
+                }
+
+                void writeString(const String& str) {
+                    const auto result = m_stringIndices.emplace(str, static_cast<uint32_t>(m_strings.size()));
+                    if (result.second)
+                        m_strings.push_back(&result.first->first);
+                    write<uint32_t>(result.first->second);
+                }
+
+                void writeVec(const vm::vec3& vec) {
+                    for (size_t i = 0; i < 3; ++i)
+                        write<double>(vec[i]);
+                }
+
+                template <typename T>
+                void write(const T value) {
+                    m_nodes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+                }
+            };
+
+            template <typename T>
+            static void writeValue(std::ostream& stream, const T value) {
+                stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            void write(const Model::World& world, const vm::bbox3& worldBounds, const uint64_t mapHash, const Path& path) {
+                NodeWriter nodeWriter;
+                world.accept(nodeWriter);
+
+                std::ofstream stream(path.asString().c_str(), std::ios::out | std::ios::binary);
+                if (!stream.is_open())
+                    throw FileSystemException("Cannot open file: " + path.asString());
+
+                stream.write(Magic, sizeof(Magic));
+                writeValue<uint32_t>(stream, Version);
+                writeValue<uint32_t>(stream, static_cast<uint32_t>(world.format()));
+                writeValue<uint64_t>(stream, mapHash);
+                for (size_t i = 0; i < 3; ++i)
+                    writeValue<double>(stream, worldBounds.min[i]);
+                for (size_t i = 0; i < 3; ++i)
+                    writeValue<double>(stream, worldBounds.max[i]);
+
+                writeValue<uint32_t>(stream, static_cast<uint32_t>(nodeWriter.strings().size()));
+                for (const String* str : nodeWriter.strings()) {
+                    writeValue<uint32_t>(stream, static_cast<uint32_t>(str->size()));
+                    stream.write(str->data(), static_cast<std::streamsize>(str->size()));
+                }
+
+                const String& nodes = nodeWriter.nodes();
+                stream.write(nodes.data(), static_cast<std::streamsize>(nodes.size()));
+
+                if (!stream)
+                    throw FileSystemException("Cannot write map cache: " + path.asString());
+            }
+
+            class NodeReader {
+            private:
+                Reader m_reader;
+                Model::World* m_world;
+                vm::bbox3 m_worldBounds;
+                std::vector<String> m_strings;
+            public:
+                NodeReader(Reader reader, Model::World* world, const vm::bbox3& worldBounds) :
+                m_reader(std::move(reader)),
+                m_world(world),
+                m_worldBounds(worldBounds) {}
+
+                void read() {
+                    const size_t stringCount = readCount(MinStringSize);
+                    m_strings.reserve(stringCount);
+                    for (size_t i = 0; i < stringCount; ++i)
+                        m_strings.push_back(m_reader.readString(readCount(1)));
+
+                    expectType(NodeType_World);
+                    readFilePosition(m_world);
+                    m_world->setAttributes(readAttributes());
+
+                    const size_t layerCount = m_reader.readSize<uint32_t>();
+                    for (size_t i = 0; i < layerCount; ++i) {
+                        expectType(NodeType_Layer);
+                        if (i == 0) {
+                            Model::Layer* layer = m_world->defaultLayer();
+                            readFilePosition(layer);
+                            readString();
+                            readChildren(layer);
+                        } else {
+                            const size_t lineNumber = m_reader.readSize<uint32_t>();
+                            const size_t lineCount = m_reader.readSize<uint32_t>();
+                            Model::Layer* layer = m_world->createLayer(readString(), m_worldBounds);
+                            layer->setFilePosition(lineNumber, lineCount);
+                            m_world->addChild(layer);
+                            readChildren(layer);
+                        }
+                    }
+
+                    if (!m_reader.eof())
+                        throw ReaderException("Unexpected data after node tree");
+                }
+            private:
+                void readChildren(Model::Node* parent) {
+                    const size_t childCount = m_reader.readSize<uint32_t>();
+                    for (size_t i = 0; i < childCount; ++i)
+                        parent->addChild(readNode());
+                }
+
+                Model::Node* readNode() {
+                    const auto type = m_reader.read<uint8_t, NodeType>();
+                    const size_t lineNumber = m_reader.readSize<uint32_t>();
+                    const size_t lineCount = m_reader.readSize<uint32_t>();
+
+                    std::unique_ptr<Model::Node> node;
+                    switch (type) {
+                        case NodeType_Group:
+                            node.reset(m_world->createGroup(readString()));
+                            break;
+                        case NodeType_Entity: {
+                            std::unique_ptr<Model::Entity> entity(m_world->createEntity());
+                            entity->setAttributes(readAttributes());
+                            node = std::move(entity);
+                            break;
+                        }
+                        case NodeType_Brush:
+                            node.reset(readBrush());
+                            break;
+                        case NodeType_World:
+                        case NodeType_Layer:
+                        default:
+                            throw ReaderException() << "Unexpected node type " << static_cast<int>(type);
+                    }
+
+                    node->setFilePosition(lineNumber, lineCount);
+                    if (type != NodeType_Brush)
+                        readChildren(node.get());
+                    return node.release();
+                }
+
+                Model::Brush* readBrush() {
+                    const size_t vertexCount = readCount(VertexSize);
+                    std::vector<vm::vec3> vertexPositions;
+                    vertexPositions.reserve(vertexCount);
+                    for (size_t i = 0; i < vertexCount; ++i)
+                        vertexPositions.push_back(m_reader.readVec<double, 3>());
+
+                    const size_t faceCount = readCount(MinFaceSize);
+                    Model::BrushFaceList faces;
+                    std::vector<std::vector<size_t>> faceVertices(faceCount);
+                    faces.reserve(faceCount);
+
+                    try {
+                        for (size_t i = 0; i < faceCount; ++i) {
+                            faces.push_back(readFace());
+
+                            const size_t faceVertexCount = readCount(VertexIndexSize);
+                            faceVertices[i].reserve(faceVertexCount);
+                            for (size_t j = 0; j < faceVertexCount; ++j)
+                                faceVertices[i].push_back(m_reader.readSize<uint32_t>());
+                        }
+                    } catch (...) {
+                        VectorUtils::clearAndDelete(faces);
+                        throw;
+                    }
+
+                    // the brush deletes the faces if its geometry is invalid
+                    return new Model::Brush(m_worldBounds, faces, vertexPositions, faceVertices);
+                }
+
+                Model::BrushFace* readFace() {
+                    const size_t lineNumber = m_reader.readSize<uint32_t>();
+                    const size_t lineCount = m_reader.readSize<uint32_t>();
+
+                    const auto point1 = m_reader.readVec<double, 3>();
+                    const auto point2 = m_reader.readVec<double, 3>();
+                    const auto point3 = m_reader.readVec<double, 3>();
+                    const auto texAxisX = m_reader.readVec<double, 3>();
+                    const auto texAxisY = m_reader.readVec<double, 3>();
+
+                    Model::BrushFaceAttributes attribs(readString());
+                    attribs.setXOffset(m_reader.readFloat<float>());
+                    attribs.setYOffset(m_reader.readFloat<float>());
+                    attribs.setRotation(m_reader.readFloat<float>());
+                    attribs.setXScale(m_reader.readFloat<float>());
+                    attribs.setYScale(m_reader.readFloat<float>());
+                    attribs.setSurfaceContents(m_reader.readInt<int32_t>());
+                    attribs.setSurfaceFlags(m_reader.readInt<int32_t>());
+                    attribs.setSurfaceValue(m_reader.readFloat<float>());
+                    attribs.setColor(Color(m_reader.readVec<float, 4>()));
+
+                    Model::BrushFace* face = m_world->createFace(point1, point2, point3, attribs, texAxisX, texAxisY);
+                    face->setFilePosition(lineNumber, lineCount);
+                    return face;
+                }
+
+                Model::EntityAttribute::List readAttributes() {
+                    const size_t count = m_reader.readSize<uint32_t>();
+                    Model::EntityAttribute::List result;
+                    for (size_t i = 0; i < count; ++i) {
+                        const String& name = readString();
+                        const String& value = readString();
+                        result.push_back(Model::EntityAttribute(name, value));
+                    }
+                    return result;
+                }
+
+                const String& readString() {
+                    const size_t index = m_reader.readSize<uint32_t>();
+                    if (index >= m_strings.size())
+                        throw ReaderException() << "String index " << index << " is out of range";
+                    return m_strings[index];
+                }
+
+                /**
+                 * Reads the number of the following records and checks that the remaining data can hold that many
+                 * records of the given minimum size.
+                 */
+                size_t readCount(const size_t minRecordSize) {
+                    const size_t count = m_reader.readSize<uint32_t>();
+                    if (count > (m_reader.size() - m_reader.position()) / minRecordSize)
+                        throw ReaderException() << "Record count " << count << " exceeds the remaining data";
+                    return count;
+                }
+
+                void readFilePosition(Model::Node* node) {
+                    const size_t lineNumber = m_reader.readSize<uint32_t>();
+                    const size_t lineCount = m_reader.readSize<uint32_t>();
+                    node->setFilePosition(lineNumber, lineCount);
+                }
+
+                void expectType(const NodeType expected) {
+                    const auto type = m_reader.read<uint8_t, NodeType>();
+                    if (type != expected)
+                        throw ReaderException() << "Unexpected node type " << static_cast<int>(type);
+                }
+            };
+
+            std::unique_ptr<Model::World> read(const char* begin, const char* end, const uint64_t mapHash, const Model::MapFormat format, const vm::bbox3& worldBounds) {
+                try {
+                    Reader reader = Reader::from(begin, end);
+
+                    char magic[sizeof(Magic)];
+                    reader.read(magic, sizeof(magic));
+                    if (std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+                        reader.read<uint32_t, uint32_t>() != Version ||
+                        reader.read<uint32_t, uint32_t>() != static_cast<uint32_t>(format) ||
+                        reader.read<uint64_t, uint64_t>() != mapHash ||
+                        reader.readVec<double, 3>() != worldBounds.min ||
+                        reader.readVec<double, 3>() != worldBounds.max) {
+                        return nullptr;
+                    }
+
+                    auto world = std::make_unique<Model::World>(format, worldBounds);
+                    world->disableNodeTreeUpdates();
+
+                    NodeReader nodeReader(reader.subReaderFromCurrent(reader.size() - reader.position()), world.get(), worldBounds);
+                    nodeReader.read();
+
+                    world->rebuildNodeTree();
+                    world->enableNodeTreeUpdates();
+                    return world;
+                } catch (const ReaderException&) {
+                    return nullptr;
+                } catch (const GeometryException&) {
+                    return nullptr;
+                }
+            }
+        }
+    }
+}
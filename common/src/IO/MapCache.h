@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapCache
+#define TrenchBroom_MapCache
+
+#include "Model/MapFormat.h"
+#include "Model/ModelTypes.h"
+
+#include <vecmath/forward.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        class Path;
+
+        /**
+         * A binary sidecar file that stores a world with its brush geometry, so that a map can be reopened without
+         * parsing its text and without intersecting the face boundaries of its brushes.
+         *
+         * The cache stores the hash of the map file it was written for and is only read if the map file still has
+         * that hash. It consists of a header, a table of all strings, i.e. attribute names and values, layer and
+         * group names and texture names, and the node tree in depth first order. All values are stored in native
+         * byte order.
+         */
+        namespace MapCache {
+            /**
+             * Returns the path of the cache file for the map file with the given path.
+             */
+            Path cachePath(const Path& mapPath);
+
+            /**
+             * Computes the hash of the given map file contents which is stored in and compared against the cache.
+             */
+            uint64_t hash(const char* begin, const char* end);
+
+            /**
+             * Writes the given world, whose brushes were built with the given world bounds, to a cache file at the given
+             * path.
+             *
+             * @throws FileSystemException if the file cannot be written
+             */
+            void write(const Model::World& world, const vm::bbox3& worldBounds, uint64_t mapHash, const Path& path);
+
+            /**
+             * Reads a world from the given cache file contents.
+             *
+             * @return the world, or null if the cache was not written for a map with the given hash, format and world
+             * bounds, or if it is invalid
+             */
+            std::unique_ptr<Model::World> read(const char* begin, const char* end, uint64_t mapHash, Model::MapFormat format, const vm::bbox3& worldBounds);
+        }
+    }
+}
+
+#endif /* defined(TrenchBroom_MapCache) */
@@ -20,6 +20,7 @@
 #include "MapReader.h"
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "Logger.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
@@ -28,6 +29,12 @@
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/ModelFactory.h"
+#include "Parallel.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace TrenchBroom {
     namespace IO {
@@ -55,6 +62,173 @@ namespace TrenchBroom {
             return m_id;
         }
 
+        /**
+         * Builds the geometry of parsed brushes on worker threads while the parser goes on reading the file.
+         *
+         * Every node that is read is appended to a batch, and each full batch is queued for the workers. The parser
+         * blocks while the number of queued batches is at capacity. Built batches are retired on the parser thread
+         * in file order, so nodes are passed on in the same order as if every brush had been built immediately, and
+         * all messages are reported on the parser thread. If only one hardware thread is available, every batch is
+         * built and retired on the parser thread right away.
+         */
+        class MapReader::NodeBuilder {
+        private:
+            static const size_t BatchSize = 64;
+
+            struct Batch {
+                std::vector<PendingNode> nodes;
+                bool built;
+            };
+
+            const Model::ModelFactory& m_factory;
+            const vm::bbox3 m_worldBounds;
+            const size_t m_workerCount;
+            const size_t m_capacity;
+
+            std::vector<PendingNode> m_current;
+
+            std::deque<std::unique_ptr<Batch>> m_batches; // all batches that have not been retired, in file order
+            std::deque<Batch*> m_queue; // the batches that no worker has taken yet
+            std::mutex m_mutex;
+            std::condition_variable m_batchQueued;
+            std::condition_variable m_batchBuilt;
+            bool m_stopped;
+
+            std::vector<std::thread> m_workers;
+        public:
+            NodeBuilder(const Model::ModelFactory& factory, const vm::bbox3& worldBounds) :
+            m_factory(factory),
+            m_worldBounds(worldBounds),
+            m_workerCount(parallelThreadCount() - 1),
+            m_capacity(2 * m_workerCount),
+            m_stopped(false) {}
+
+            ~NodeBuilder() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopped = true;
+                }
+                m_batchQueued.notify_all();
+                for (auto& worker : m_workers)
+                    worker.join();
+
+                for (auto& batch : m_batches)
+                    discard(batch->nodes);
+                discard(m_current);
+            }
+
+            void add(PendingNode pendingNode, MapReader& reader, ParserStatus& status) {
+                m_current.push_back(std::move(pendingNode));
+                if (m_current.size() >= BatchSize)
+                    submit(reader, status);
+            }
+
+            void finish(MapReader& reader, ParserStatus& status) {
+                if (!m_current.empty())
+                    submit(reader, status);
+                retire(0, reader, status);
+            }
+        private:
+            void submit(MapReader& reader, ParserStatus& status) {
+                if (m_workerCount == 0) {
+                    build(m_current);
+                    retire(m_current, reader, status);
+                    return;
+                }
+
+                if (m_workers.empty()) {
+                    for (size_t i = 0; i < m_workerCount; ++i)
+                        m_workers.emplace_back([this]() { work(); });
+                }
+
+                retire(m_capacity - 1, reader, status);
+
+                auto batch = std::make_unique<Batch>();
+                batch->nodes = std::move(m_current);
+                batch->built = false;
+                m_current.clear();
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_queue.push_back(batch.get());
+                    m_batches.push_back(std::move(batch));
+                }
+                m_batchQueued.notify_one();
+            }
+
+            /**
+             * Retires the built batches at the front of the queue, and waits for more batches to be built until at
+             * most the given number of batches remain.
+             */
+            void retire(const size_t maxRemaining, MapReader& reader, ParserStatus& status) {
+                while (true) {
+                    std::unique_ptr<Batch> batch;
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        if (m_batches.empty() || (m_batches.size() <= maxRemaining && !m_batches.front()->built))
+                            return;
+                        m_batchBuilt.wait(lock, [this]() { return m_batches.front()->built; });
+                        batch = std::move(m_batches.front());
+                        m_batches.pop_front();
+                    }
+                    retire(batch->nodes, reader, status);
+                }
+            }
+
+            static void retire(std::vector<PendingNode>& nodes, MapReader& reader, ParserStatus& status) {
+                for (auto& pendingNode : nodes)
+                    reader.attachNode(pendingNode, status);
+                nodes.clear();
+            }
+
+            void work() {
+                while (true) {
+                    Batch* batch;
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_batchQueued.wait(lock, [this]() { return m_stopped || !m_queue.empty(); });
+                        if (m_stopped)
+                            return;
+                        batch = m_queue.front();
+                        m_queue.pop_front();
+                    }
+
+                    build(batch->nodes);
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        batch->built = true;
+                    }
+                    m_batchBuilt.notify_all();
+                }
+            }
+
+            void build(std::vector<PendingNode>& nodes) const {
+                for (auto& pendingNode : nodes) {
+                    if (pendingNode.type == PendingNode::Type_Brush) {
+                        try {
+                            pendingNode.node = m_factory.createBrush(m_worldBounds, pendingNode.faces);
+                        } catch (const GeometryException& e) {
+                            pendingNode.error = e.what();
+                        }
+                        // the faces are owned by the brush now, or they have been deleted by the brush's constructor
+                        pendingNode.faces.clear();
+                    }
+                }
+            }
+
+            /**
+             * Deletes the given nodes. None of them can have children because the nodes are attached in file order.
+             */
+            static void discard(std::vector<PendingNode>& nodes) {
+                for (auto& pendingNode : nodes) {
+                    delete pendingNode.node;
+                    VectorUtils::clearAndDelete(pendingNode.faces);
+                }
+                nodes.clear();
+            }
+        };
+
         MapReader::MapReader(const char* begin, const char* end) :
         StandardMapParser(begin, end),
         m_factory(nullptr),
@@ -68,18 +242,31 @@ namespace TrenchBroom {
         m_currentNode(nullptr) {}
 
         MapReader::~MapReader() {
+            m_nodeBuilder.reset();
             VectorUtils::clearAndDelete(m_faces);
         }
 
         void MapReader::readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(format, status);
+            try {
+                parseEntities(format, status);
+                finishNodes(status);
+            } catch (...) {
+                discardNodes();
+                throw;
+            }
             resolveNodes(status);
         }
 
         void MapReader::readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseBrushes(format, status);
+            try {
+                parseBrushes(format, status);
+                finishNodes(status);
+            } catch (...) {
+                discardNodes();
+                throw;
+            }
         }
 
         void MapReader::readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -89,6 +276,7 @@ namespace TrenchBroom {
 
         void MapReader::onFormatSet(const Model::MapFormat format) {
             m_factory = &initialize(format, m_worldBounds);
+            m_nodeBuilder = std::make_unique<NodeBuilder>(*m_factory, m_worldBounds);
         }
 
         void MapReader::onBeginEntity(const size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) {
@@ -165,7 +353,8 @@ namespace TrenchBroom {
             setExtraAttributes(layer, extraAttributes);
             m_layers.insert(std::make_pair(layerId, layer));
 
-            onLayer(layer, status);
+            PendingNode pendingNode { PendingNode::Type_Layer, nullptr, layer, {}, 0, 0, {}, "" };
+            m_nodeBuilder->add(std::move(pendingNode), *this, status);
 
             m_currentNode = layer;
             m_brushParent = layer;
@@ -223,20 +412,50 @@ namespace TrenchBroom {
         }
 
         void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
-            try {
-                Model::Brush* brush = m_factory->createBrush(m_worldBounds, m_faces);
-                setFilePosition(brush, startLine, lineCount);
-                setExtraAttributes(brush, extraAttributes);
+            PendingNode pendingNode { PendingNode::Type_Brush, m_brushParent, nullptr, std::move(m_faces), startLine, lineCount, extraAttributes, "" };
+            m_faces.clear();
+            m_nodeBuilder->add(std::move(pendingNode), *this, status);
+        }
 
-                onBrush(m_brushParent, brush, status);
-                m_faces.clear();
-            } catch (GeometryException& e) {
-                StringStream msg;
-                msg << "Skipping brush: " << e.what();
-                status.error(startLine, msg.str());
-                m_faces.clear(); // the faces will have been deleted by the brush's constructor
+        void MapReader::addNode(Model::Node* parent, Model::Node* node, ParserStatus& status) {
+            PendingNode pendingNode { PendingNode::Type_Node, parent, node, {}, 0, 0, {}, "" };
+            m_nodeBuilder->add(std::move(pendingNode), *this, status);
+        }
+
+        void MapReader::finishNodes(ParserStatus& status) {
+            if (m_nodeBuilder != nullptr) {
+                m_nodeBuilder->finish(*this, status);
+                m_nodeBuilder.reset();
             }
+        }
+
+        void MapReader::discardNodes() {
+            // the parents of the pending nodes may be deleted by the caller, so the nodes must not be attached
+            m_nodeBuilder.reset();
+        }
 
+        void MapReader::attachNode(PendingNode& pendingNode, ParserStatus& status) {
+            switch (pendingNode.type) {
+                case PendingNode::Type_Layer:
+                    onLayer(static_cast<Model::Layer*>(pendingNode.node), status);
+                    break;
+                case PendingNode::Type_Node:
+                    onNode(pendingNode.parent, pendingNode.node, status);
+                    break;
+                case PendingNode::Type_Brush:
+                    if (pendingNode.node != nullptr) {
+                        Model::Brush* brush = static_cast<Model::Brush*>(pendingNode.node);
+                        setFilePosition(brush, pendingNode.startLine, pendingNode.lineCount);
+                        setExtraAttributes(brush, pendingNode.extraAttributes);
+                        onBrush(pendingNode.parent, brush, status);
+                    } else {
+                        StringStream msg;
+                        msg << "Skipping brush: " << pendingNode.error;
+                        status.error(pendingNode.startLine, msg.str());
+                    }
+                    break;
+                switchDefault();
+            }
         }
 
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes, ParserStatus& status) {
@@ -247,7 +466,7 @@ namespace TrenchBroom {
                     const Model::IdType layerId = static_cast<Model::IdType>(rawId);
                     Model::Layer* layer = MapUtils::find(m_layers, layerId, static_cast<Model::Layer*>(nullptr));
                     if (layer != nullptr)
-                        onNode(layer, node, status);
+                        addNode(layer, node, status);
                     else
                         m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::layer(layerId)));
                     return ParentInfo::Type_Layer;
@@ -264,7 +483,7 @@ namespace TrenchBroom {
                         const Model::IdType groupId = static_cast<Model::IdType>(rawId);
                         Model::Group* group = MapUtils::find(m_groups, groupId, static_cast<Model::Group*>(nullptr));
                         if (group != nullptr)
-                            onNode(group, node, status);
+                            addNode(group, node, status);
                         else
                             m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::group(groupId)));
                         return ParentInfo::Type_Group;
@@ -276,7 +495,7 @@ namespace TrenchBroom {
                 }
             }
 
-            onNode(nullptr, node, status);
+            addNode(nullptr, node, status);
             return ParentInfo::Type_None;
         }
 
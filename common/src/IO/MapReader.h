@@ -27,6 +27,8 @@
 #include <vecmath/forward.h>
 #include <vecmath/bbox.h>
 
+#include <memory>
+
 namespace TrenchBroom {
     namespace Model {
         class ModelFactory;
@@ -71,6 +73,29 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            /**
+             * A node that has been read, but not yet been passed to the subclass. Brush geometry is built before a
+             * pending brush is passed on.
+             */
+            struct PendingNode {
+                typedef enum {
+                    Type_Layer,
+                    Type_Node,
+                    Type_Brush
+                } Type;
+
+                Type type;
+                Model::Node* parent;
+                Model::Node* node;
+                Model::BrushFaceList faces;
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+                String error;
+            };
+
+            class NodeBuilder;
+
             vm::bbox3 m_worldBounds;
             Model::ModelFactory* m_factory;
 
@@ -81,6 +106,8 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+
+            std::unique_ptr<NodeBuilder> m_nodeBuilder;
         protected:
             MapReader(const char* begin, const char* end);
             explicit MapReader(const String& str);
@@ -102,6 +129,10 @@ namespace TrenchBroom {
             void createGroup(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void addNode(Model::Node* parent, Model::Node* node, ParserStatus& status);
+            void finishNodes(ParserStatus& status);
+            void discardNodes();
+            void attachNode(PendingNode& pendingNode, ParserStatus& status);
 
             ParentInfo::Type storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes, ParserStatus& status);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
@@ -19,7 +19,7 @@
 
 #include "ObjSerializer.h"
 
-#include "CollectionUtils.h"
+#include "Parallel.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
@@ -34,102 +34,131 @@ namespace TrenchBroom {
         normal(i_normal) {}
 
         ObjFileSerializer::ObjFileSerializer(FILE* stream) :
-        m_stream(stream),
-        m_currentObject({ 0, 0, {} }) {
+        m_stream(stream) {
             ensure(m_stream != nullptr, "stream is null");
+            m_objects.reserve(ChunkSize);
         }
 
         void ObjFileSerializer::doBeginFile() {}
 
         void ObjFileSerializer::doEndFile() {
-            writeVertices();
-            std::fprintf(m_stream, "\n");
-            writeTexCoords();
-            std::fprintf(m_stream, "\n");
-            writeNormals();
-            std::fprintf(m_stream, "\n");
-            writeObjects();
+            writeChunk();
         }
 
-        void ObjFileSerializer::writeVertices() {
-            std::fprintf(m_stream, "# vertices\n");
-            for (const vm::vec3& elem : m_vertices.list())
-                std::fprintf(m_stream, "v %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
-        }
+        void ObjFileSerializer::writeChunk() {
+            parallelFor(m_objects.size(), [&](const size_t i) { gatherGeometry(m_objects[i]); }, 16);
 
-        void ObjFileSerializer::writeTexCoords() {
-            std::fprintf(m_stream, "# texture coordinates\n");
-            for (const vm::vec2f& elem : m_texCoords.list()) {
-                std::fprintf(m_stream, "vt %.17g %.17g\n", elem.x(), elem.y());
-            }
+            // indices must be assigned in the order in which the brushes are written
+            for (Object& object : m_objects)
+                indexObject(object);
+
+            parallelFor(m_objects.size(), [&](const size_t i) { formatObject(m_objects[i]); }, 16);
+
+            for (const Object& object : m_objects)
+                std::fwrite(object.text.data(), 1, object.text.size(), m_stream);
+            m_objects.clear();
         }
 
-        void ObjFileSerializer::writeNormals() {
-            std::fprintf(m_stream, "# face normals\n");
-            for (const vm::vec3& elem : m_normals.list()) {
-                std::fprintf(m_stream, "vn %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
+        void ObjFileSerializer::indexObject(Object& object) {
+            object.faces.reserve(object.geometry.size());
+            for (const FaceGeometry& face : object.geometry) {
+                const auto normal = m_normals.index(face.normal);
+                if (normal.second)
+                    object.addedNormals.push_back(face.normal);
+
+                IndexedVertexList indexedVertices;
+                indexedVertices.reserve(face.positions.size());
+
+                for (size_t i = 0; i < face.positions.size(); ++i) {
+                    const auto vertex = m_vertices.index(face.positions[i]);
+                    if (vertex.second)
+                        object.addedVertices.push_back(face.positions[i]);
+
+                    const auto texCoords = m_texCoords.index(face.texCoords[i]);
+                    if (texCoords.second)
+                        object.addedTexCoords.push_back(face.texCoords[i]);
+
+                    indexedVertices.push_back(IndexedVertex(vertex.first, texCoords.first, normal.first));
+                }
+
+                object.faces.push_back(std::move(indexedVertices));
             }
+            object.geometry.clear();
         }
 
-        void ObjFileSerializer::writeObjects() {
-            std::fprintf(m_stream, "# objects\n");
-            for (const Object& object : m_objects) {
-                std::fprintf(m_stream, "o entity%lu_brush%lu\n",
-                             static_cast<unsigned long>(object.entityNo),
-                             static_cast<unsigned long>(object.brushNo));
+        void ObjFileSerializer::gatherGeometry(Object& object) {
+            const Model::BrushFaceList& faces = object.brush->faces();
+            object.geometry.reserve(faces.size());
+
+            for (const Model::BrushFace* face : faces) {
+                FaceGeometry geometry;
+                geometry.normal = face->boundary().normal;
 
-                writeFaces(object.faces);
-                std::fprintf(m_stream, "\n");
+                const Model::BrushFace::VertexList vertices = face->vertices();
+                for (const Model::BrushVertex* vertex : vertices) {
+                    geometry.positions.push_back(vertex->position());
+                }
+                face->textureCoordProjection().project(geometry.positions, geometry.texCoords);
+
+                object.geometry.push_back(std::move(geometry));
             }
         }
 
-        void ObjFileSerializer::writeFaces(const FaceList& faces) {
-            for (const IndexedVertexList& face : faces) {
-                std::fprintf(m_stream, "f");
+        void ObjFileSerializer::formatObject(Object& object) {
+            String& text = object.text;
+            char buffer[128];
+            const auto append = [&](const int length) {
+                assert(length >= 0 && static_cast<size_t>(length) < sizeof(buffer));
+                text.append(buffer, static_cast<size_t>(length));
+            };
+
+            // no idea why I have to switch Y and Z
+            for (const vm::vec3& elem : object.addedVertices)
+                append(std::snprintf(buffer, sizeof(buffer), "v %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()));
+            for (const vm::vec2f& elem : object.addedTexCoords)
+                append(std::snprintf(buffer, sizeof(buffer), "vt %.17g %.17g\n", elem.x(), elem.y()));
+            for (const vm::vec3& elem : object.addedNormals)
+                append(std::snprintf(buffer, sizeof(buffer), "vn %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()));
+
+            append(std::snprintf(buffer, sizeof(buffer), "o entity%lu_brush%lu\n",
+                                 static_cast<unsigned long>(object.entityNo),
+                                 static_cast<unsigned long>(object.brushNo)));
+
+            for (const IndexedVertexList& face : object.faces) {
+                text.push_back('f');
                 for (const IndexedVertex& vertex : face) {
-                    std::fprintf(m_stream, " %lu/%lu/%lu",
-                                 static_cast<unsigned long>(vertex.vertex) + 1,
-                                 static_cast<unsigned long>(vertex.texCoords) + 1,
-                                 static_cast<unsigned long>(vertex.normal) + 1);
+                    append(std::snprintf(buffer, sizeof(buffer), " %lu/%lu/%lu",
+                                         static_cast<unsigned long>(vertex.vertex) + 1,
+                                         static_cast<unsigned long>(vertex.texCoords) + 1,
+                                         static_cast<unsigned long>(vertex.normal) + 1));
                 }
-                std::fprintf(m_stream, "\n");
+                text.push_back('\n');
             }
+            text.push_back('\n');
+
+            object.addedVertices.clear();
+            object.addedTexCoords.clear();
+            object.addedNormals.clear();
+            object.faces.clear();
         }
 
         void ObjFileSerializer::doBeginEntity(const Model::Node* /* node */) {}
         void ObjFileSerializer::doEndEntity(Model::Node* /* node */) {}
-        void ObjFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {}
-
-        void ObjFileSerializer::doBeginBrush(const Model::Brush* /* brush */) {
-            m_currentObject.entityNo = entityNo();
-            m_currentObject.brushNo = brushNo();
-        }
-
-        void ObjFileSerializer::doEndBrush(Model::Brush* /* brush */) {
-            m_objects.push_back(m_currentObject);
-            m_currentObject.faces.clear();
-        }
+        void ObjFileSerializer::doEntityAttribute(const Model::EntityAttribute& /* attribute */) {}
 
-        void ObjFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const vm::vec3& normal = face->boundary().normal;
-            const size_t normalIndex = m_normals.index(normal);
+        void ObjFileSerializer::doBeginBrush(const Model::Brush* /* brush */) {}
 
-            const Model::BrushFace::VertexList vertices = face->vertices();
-            IndexedVertexList indexedVertices;
-            indexedVertices.reserve(vertices.size());
+        void ObjFileSerializer::doEndBrush(Model::Brush* brush) {
+            Object object;
+            object.entityNo = entityNo();
+            object.brushNo = brushNo();
+            object.brush = brush;
+            m_objects.push_back(std::move(object));
 
-            for (const Model::BrushVertex* vertex : vertices) {
-                Model::BrushFace::VertexList::const_iterator it, end;
-                const vm::vec3& position = vertex->position();
-                const vm::vec2f texCoords = face->textureCoords(position);
-
-                const size_t vertexIndex = m_vertices.index(position);
-                const size_t texCoordsIndex = m_texCoords.index(texCoords);
-
-                indexedVertices.push_back(IndexedVertex(vertexIndex, texCoordsIndex, normalIndex));
-            }
-
-            m_currentObject.faces.push_back(indexedVertices);
+            if (m_objects.size() == ChunkSize)
+                writeChunk();
         }
+
+        void ObjFileSerializer::doBrushFace(Model::BrushFace* /* face */) {}
     }
 }
@@ -24,35 +24,52 @@
 #include "Model/ModelTypes.h"
 
 #include <vecmath/forward.h>
+#include <vecmath/vec.h>
 
 #include <cstdio>
-#include <list>
-#include <map>
+#include <functional>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Writes the brushes of a map as Wavefront OBJ objects.
+         *
+         * The brushes are collected in chunks of ChunkSize brushes. When a chunk is full, the geometry of its brushes
+         * is gathered in parallel, the vertices, texture coordinates and normals are deduplicated against those of
+         * all previous chunks, and the text of every brush is formatted in parallel. Every brush is preceded by the
+         * vertices, texture coordinates and normals that it is the first to use, so the chunk can be written to the
+         * stream and released right away.
+         */
         class ObjFileSerializer : public NodeSerializer {
+        public:
+            static const size_t ChunkSize = 1024;
         private:
+            template <typename V>
+            struct Hash {
+                size_t operator()(const V& v) const {
+                    const std::hash<typename V::type> hash;
+                    size_t result = 0;
+                    for (size_t i = 0; i < V::size; ++i)
+                        result ^= hash(v[i]) + 0x9e3779b9 + (result << 6) + (result >> 2);
+                    return result;
+                }
+            };
+
             template <typename V>
             class IndexMap {
-            public:
-                using List = std::vector<V>;
             private:
-                using Map = std::map<V, size_t>;
+                using Map = std::unordered_map<V, size_t, Hash<V>>;
                 Map m_map;
-                List m_list;
             public:
-                const List& list() const {
-                    return m_list;
-                }
-
-                size_t index(const V& v) {
-                    typename Map::iterator indexIt = MapUtils::findOrInsert(m_map, v, m_list.size());
-                    const size_t index = indexIt->second;
-                    if (index == m_list.size())
-                        m_list.push_back(v);
-                    return index;
+                /**
+                 * Returns the index of the given value and whether the value was added with this call.
+                 */
+                std::pair<size_t, bool> index(const V& v) {
+                    const auto result = m_map.emplace(v, m_map.size());
+                    return std::make_pair(result.first->second, result.second);
                 }
             };
 
@@ -65,15 +82,29 @@ namespace TrenchBroom {
             };
 
             using IndexedVertexList = std::vector<IndexedVertex>;
-            using FaceList = std::list<IndexedVertexList>;
+
+            struct FaceGeometry {
+                vm::vec3 normal;
+                std::vector<vm::vec3> positions;
+                std::vector<vm::vec2f> texCoords;
+            };
 
             struct Object {
                 size_t entityNo;
                 size_t brushNo;
-                FaceList faces;
+                const Model::Brush* brush;
+
+                std::vector<FaceGeometry> geometry;
+
+                std::vector<vm::vec3> addedVertices;
+                std::vector<vm::vec2f> addedTexCoords;
+                std::vector<vm::vec3> addedNormals;
+                std::vector<IndexedVertexList> faces;
+
+                String text;
             };
 
-            using ObjectList = std::list<Object>;
+            using ObjectList = std::vector<Object>;
 
             FILE* m_stream;
 
@@ -81,7 +112,6 @@ namespace TrenchBroom {
             IndexMap<vm::vec2f> m_texCoords;
             IndexMap<vm::vec3> m_normals;
 
-            Object m_currentObject;
             ObjectList m_objects;
         public:
             explicit ObjFileSerializer(FILE* stream);
@@ -89,11 +119,10 @@ namespace TrenchBroom {
             void doBeginFile() override;
             void doEndFile() override;
 
-            void writeVertices();
-            void writeTexCoords();
-            void writeNormals();
-            void writeObjects();
-            void writeFaces(const FaceList& faces);
+            void writeChunk();
+            void indexObject(Object& object);
+            static void gatherGeometry(Object& object);
+            static void formatObject(Object& object);
 
             void doBeginEntity(const Model::Node* node) override;
             void doEndEntity(Model::Node* node) override;
@@ -20,12 +20,15 @@
 #include "Quake3ShaderFileSystem.h"
 
 #include "CollectionUtils.h"
+#include "Parallel.h"
 #include "Assets/Quake3Shader.h"
 #include "IO/File.h"
+#include "IO/ParserStatus.h"
 #include "IO/Quake3ShaderParser.h"
-#include "IO/SimpleParserStatus.h"
 
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 namespace TrenchBroom {
     namespace IO {
@@ -44,21 +47,69 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Records the messages of a parser running on a worker thread so that they can be passed to the logger on the
+         * calling thread afterwards.
+         */
+        class ShaderFileParserStatus : public ParserStatus {
+        private:
+            std::vector<std::pair<Logger::LogLevel, String>> m_messages;
+        public:
+            ShaderFileParserStatus(Logger& logger, String prefix) :
+            ParserStatus(logger, std::move(prefix)) {}
+
+            void replay(Logger& logger) const {
+                for (const auto& message : m_messages) {
+                    logger.log(message.first, message.second);
+                }
+            }
+        private:
+            void doProgress(const double /* progress */) override {}
+
+            void doLog(const Logger::LogLevel level, const String& str) override {
+                m_messages.emplace_back(level, str);
+            }
+        };
+
+        struct ShaderFileResult {
+            std::vector<Assets::Quake3Shader> shaders;
+            std::unique_ptr<ShaderFileParserStatus> status;
+            String error;
+        };
+
         std::vector<Assets::Quake3Shader> Quake3ShaderFileSystem::loadShaders() const {
             auto result = std::vector<Assets::Quake3Shader>();
 
             if (next().directoryExists(m_shaderSearchPath)) {
                 const auto paths = next().findItems(m_shaderSearchPath, FileExtensionMatcher("shader"));
-                for (const auto& path : paths) {
-                    const auto file = next().openFile(path);
-                    auto bufferedReader = file->reader().buffer();
+                const auto files = next().openFiles(paths);
+
+                // the shader files are parsed concurrently, and their messages and shaders are collected per file
+                auto fileResults = std::vector<ShaderFileResult>(files.size());
+                parallelFor(files.size(), [&](const size_t i) {
+                    const auto& file = files[i];
+                    auto& fileResult = fileResults[i];
+                    fileResult.status = std::make_unique<ShaderFileParserStatus>(m_logger, file->path().asString());
 
                     try {
+                        auto bufferedReader = file->reader().buffer();
                         Quake3ShaderParser parser(std::begin(bufferedReader), std::end(bufferedReader));
-                        SimpleParserStatus status(m_logger, file->path().asString());
-                        VectorUtils::append(result, parser.parse(status));
+                        fileResult.shaders = parser.parse(*fileResult.status);
                     } catch (const ParserException& e) {
-                        m_logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
+                        fileResult.shaders.clear();
+                        fileResult.error = e.what();
+                    }
+                });
+
+                // the results are merged in the order of the files, so that the precedence of the shaders does not
+                // depend on which file was parsed first
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    auto& fileResult = fileResults[i];
+                    fileResult.status->replay(m_logger);
+                    if (fileResult.error.empty()) {
+                        VectorUtils::append(result, fileResult.shaders);
+                    } else {
+                        m_logger.warn() << "Skipping malformed shader file " << paths[i] << ": " << fileResult.error;
                     }
                 }
             }
@@ -84,24 +135,31 @@ namespace TrenchBroom {
 
         void Quake3ShaderFileSystem::linkTextures(const Path::List& textures, std::vector<Assets::Quake3Shader>& shaders) {
             m_logger.debug() << "Linking textures...";
+
+            // maps each shader path to the first shader with that path
+            auto shaderIndex = std::unordered_map<String, size_t>();
+            shaderIndex.reserve(shaders.size());
+            for (size_t i = 0; i < shaders.size(); ++i) {
+                shaderIndex.emplace(shaders[i].shaderPath.asString('/'), i);
+            }
+
+            auto linked = std::vector<bool>(shaders.size(), false);
             for (const auto& texture : textures) {
                 const auto shaderPath = texture.deleteExtension();
 
                 // Only link a shader if it has not been linked yet.
                 if (!fileExists(shaderPath)) {
-                    const auto shaderIt = std::find_if(std::begin(shaders), std::end(shaders), [&shaderPath](const auto& shader){
-                        return shaderPath == shader.shaderPath;
-                    });
-
-                    if (shaderIt != std::end(shaders)) {
+                    const auto shaderIt = shaderIndex.find(shaderPath.asString('/'));
+                    if (shaderIt != std::end(shaderIndex)) {
                         // Found a matching shader.
-                        auto& shader = *shaderIt;
+                        const auto index = shaderIt->second;
+                        auto& shader = shaders[index];
 
                         auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
                         m_root.addFile(shaderPath, shaderFile);
 
-                        // Remove the shader so that we don't revisit it when linking standalone shaders.
-                        shaders.erase(shaderIt);
+                        // Mark the shader so that we don't revisit it when linking standalone shaders.
+                        linked[index] = true;
                     } else {
                         // No matching shader found, generate one.
                         auto shader = Assets::Quake3Shader();
@@ -113,6 +171,18 @@ namespace TrenchBroom {
                     }
                 }
             }
+
+            // Remove the linked shaders, keeping the order of the remaining ones.
+            size_t count = 0;
+            for (size_t i = 0; i < shaders.size(); ++i) {
+                if (!linked[i]) {
+                    if (count != i) {
+                        shaders[count] = std::move(shaders[i]);
+                    }
+                    ++count;
+                }
+            }
+            shaders.erase(std::next(std::begin(shaders), static_cast<std::ptrdiff_t>(count)), std::end(shaders));
         }
 
         void Quake3ShaderFileSystem::linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders) {
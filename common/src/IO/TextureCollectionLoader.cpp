@@ -80,6 +80,12 @@ namespace TrenchBroom {
         TextureCollectionLoader::FileList DirectoryTextureCollectionLoader::doFindTextures(const Path& path, const StringList& extensions) {
             const auto texturePaths = m_gameFS.findItems(path, FileExtensionMatcher(extensions));
 
+            try {
+                return m_gameFS.openFiles(texturePaths);
+            } catch (const std::exception&) {
+                // open the files one by one to skip and report only the files that cannot be opened
+            }
+
             FileList result;
             result.reserve(texturePaths.size());
 
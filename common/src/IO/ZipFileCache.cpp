@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ZipFileCache.h"
+
+#include "IO/File.h"
+
+#include <cassert>
+#include <functional>
+
+namespace TrenchBroom {
+    namespace IO {
+        size_t ZipFileCache::KeyHash::operator()(const Key& key) const {
+            const auto h = std::hash<const ZipFileSystem*>()(key.first);
+            return h ^ (std::hash<size_t>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+        }
+
+        ZipFileCache::ZipFileCache(const size_t capacity) :
+        m_capacity(capacity),
+        m_size(0) {}
+
+        size_t ZipFileCache::size() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_size;
+        }
+
+        std::shared_ptr<File> ZipFileCache::find(const ZipFileSystem* owner, const size_t fileIndex) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(Key(owner, fileIndex));
+            if (it == std::end(m_entries)) {
+                return nullptr;
+            }
+
+            auto& entry = it->second;
+            m_order.splice(std::begin(m_order), m_order, entry.position);
+            return entry.file;
+        }
+
+        void ZipFileCache::insert(const ZipFileSystem* owner, const size_t fileIndex, std::shared_ptr<File> file) {
+            const auto size = file->size();
+            const auto key = Key(owner, fileIndex);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (size > m_capacity || m_entries.count(key) > 0) {
+                return;
+            }
+
+            // evict the least recently used files until the new file fits
+            while (m_size + size > m_capacity) {
+                const auto it = m_entries.find(m_order.back());
+                assert(it != std::end(m_entries));
+                m_size -= it->second.file->size();
+                m_entries.erase(it);
+                m_order.pop_back();
+            }
+
+            m_order.push_front(key);
+            m_entries.emplace(key, Entry { std::move(file), std::begin(m_order) });
+            m_size += size;
+        }
+
+        void ZipFileCache::remove(const ZipFileSystem* owner) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto it = std::begin(m_order); it != std::end(m_order);) {
+                if (it->first == owner) {
+                    const auto entry = m_entries.find(*it);
+                    assert(entry != std::end(m_entries));
+                    m_size -= entry->second.file->size();
+                    m_entries.erase(entry);
+                    it = m_order.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+}
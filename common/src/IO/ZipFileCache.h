@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRENCHBROOM_ZIPFILECACHE_H
+#define TRENCHBROOM_ZIPFILECACHE_H
+
+#include "Macros.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace IO {
+        class File;
+        class ZipFileSystem;
+
+        /**
+         * Keeps the decompressed files of one or more zip file systems up to a maximum total size. A game shares one
+         * cache between all of its packages so that the budget does not grow with the number of packages. When a file
+         * does not fit, the least recently used files are evicted.
+         *
+         * All accesses are synchronized, so the file systems may open files from several threads.
+         */
+        class ZipFileCache {
+        public:
+            /**
+             * The default maximum total size of the cached files, in bytes.
+             */
+            static constexpr size_t DefaultCapacity = 32u * 1024u * 1024u;
+        private:
+            using Key = std::pair<const ZipFileSystem*, size_t>;
+
+            struct KeyHash {
+                size_t operator()(const Key& key) const;
+            };
+
+            struct Entry {
+                std::shared_ptr<File> file;
+                std::list<Key>::iterator position;
+            };
+
+            size_t m_capacity;
+            size_t m_size;
+            std::list<Key> m_order; // most recently used first
+            std::unordered_map<Key, Entry, KeyHash> m_entries;
+            mutable std::mutex m_mutex;
+        public:
+            explicit ZipFileCache(size_t capacity = DefaultCapacity);
+
+            /**
+             * Returns the total size of the cached files, in bytes.
+             */
+            size_t size() const;
+
+            /**
+             * Returns the file with the given index of the given file system and marks it as most recently used, or
+             * null if the file is not cached.
+             */
+            std::shared_ptr<File> find(const ZipFileSystem* owner, size_t fileIndex);
+
+            /**
+             * Adds the given file unless it is cached already or larger than the capacity of this cache.
+             */
+            void insert(const ZipFileSystem* owner, size_t fileIndex, std::shared_ptr<File> file);
+
+            /**
+             * Removes all files of the given file system.
+             */
+            void remove(const ZipFileSystem* owner);
+
+            deleteCopyAndMove(ZipFileCache)
+        };
+    }
+}
+
+#endif //TRENCHBROOM_ZIPFILECACHE_H
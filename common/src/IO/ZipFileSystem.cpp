@@ -20,9 +20,12 @@
 #include "ZipFileSystem.h"
 
 #include "CollectionUtils.h"
+#include "Ensure.h"
+#include "Parallel.h"
 #include "IO/File.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/IOUtils.h"
+#include "IO/ZipFileCache.h"
 
 #include <cassert>
 #include <cstring>
@@ -37,40 +40,41 @@ namespace TrenchBroom {
         m_owner(owner),
         m_fileIndex(fileIndex) {}
 
-        std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
-            const auto path = Path(m_owner->filename(m_fileIndex));
-
-            mz_zip_archive_file_stat stat;
-            if (!mz_zip_reader_file_stat(&m_owner->m_archive, m_fileIndex, &stat)) {
-                throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
-            }
-
-            const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
-            auto data = std::make_unique<char[]>(uncompressedSize);
-            auto* begin = data.get();
-
-            if (!mz_zip_reader_extract_to_mem(&m_owner->m_archive, m_fileIndex, begin, uncompressedSize, 0)) {
-                throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
-            }
+        mz_uint ZipFileSystem::ZipCompressedFile::fileIndex() const {
+            return m_fileIndex;
+        }
 
-            return std::make_shared<OwningBufferFile>(path, std::move(data), uncompressedSize);
+        std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
+            return m_owner->openEntry(m_fileIndex);
         }
 
         // ZipFileSystem
 
-        ZipFileSystem::ZipFileSystem(const Path& path) :
-        ZipFileSystem(nullptr, path) {}
+        ZipFileSystem::ZipFileSystem(const Path& path, const size_t cacheCapacity) :
+        ZipFileSystem(nullptr, path, std::make_shared<ZipFileCache>(cacheCapacity)) {}
 
-        ZipFileSystem::ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
-        ImageFileSystem(std::move(next), path) {
+        ZipFileSystem::ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path, std::shared_ptr<ZipFileCache> cache) :
+        ImageFileSystem(std::move(next), path),
+        m_cache(std::move(cache)) {
+            ensure(m_cache != nullptr, "cache is null");
             initialize();
         }
 
         ZipFileSystem::~ZipFileSystem() {
+            // another file system could be created at the same address and must not find our files
+            m_cache->remove(this);
             mz_zip_reader_end(&m_archive);
         }
 
+        size_t ZipFileSystem::cacheSize() const {
+            return m_cache->size();
+        }
+
         void ZipFileSystem::doReadDirectory() {
+            // the file indices change when the archive is read again
+            m_cache->remove(this);
+
+            std::lock_guard<std::mutex> lock(m_archiveMutex);
             mz_zip_zero_struct(&m_archive);
 
             if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
@@ -91,10 +95,104 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<std::shared_ptr<File>> ZipFileSystem::doOpenFiles(const Path::List& paths) const {
+            std::vector<mz_uint> fileIndices;
+            fileIndices.reserve(paths.size());
+
+            for (const auto& path : paths) {
+                // all file entries of this file system are zip entries
+                const auto& entry = static_cast<const ZipCompressedFile&>(m_root.findFile(path));
+                fileIndices.push_back(entry.fileIndex());
+            }
+
+            return openEntries(fileIndices);
+        }
+
+        std::shared_ptr<File> ZipFileSystem::openEntry(const mz_uint fileIndex) const {
+            auto file = m_cache->find(this, fileIndex);
+            if (file == nullptr) {
+                auto entry = readEntry(fileIndex);
+                file = makeFile(entry);
+                m_cache->insert(this, fileIndex, file);
+            }
+            return file;
+        }
+
+        std::vector<std::shared_ptr<File>> ZipFileSystem::openEntries(const std::vector<mz_uint>& fileIndices) const {
+            std::vector<std::shared_ptr<File>> result(fileIndices.size());
+
+            // the archive can only be read by one thread at a time, so the entries are read sequentially
+            std::vector<size_t> missing;
+            std::vector<EntryData> entries;
+            for (size_t i = 0; i < fileIndices.size(); ++i) {
+                result[i] = m_cache->find(this, fileIndices[i]);
+                if (result[i] == nullptr) {
+                    missing.push_back(i);
+                    entries.push_back(readEntry(fileIndices[i]));
+                }
+            }
+
+            // the entries can then be inflated concurrently
+            std::vector<std::shared_ptr<File>> files(entries.size());
+            parallelFor(entries.size(), [&](const size_t i) {
+                files[i] = makeFile(entries[i]);
+            });
+
+            for (size_t i = 0; i < missing.size(); ++i) {
+                const auto index = missing[i];
+                result[index] = files[i];
+                m_cache->insert(this, fileIndices[index], std::move(files[i]));
+            }
+
+            return result;
+        }
+
+        ZipFileSystem::EntryData ZipFileSystem::readEntry(const mz_uint fileIndex) const {
+            std::lock_guard<std::mutex> lock(m_archiveMutex);
+            const auto path = Path(filename(fileIndex));
+
+            mz_zip_archive_file_stat stat;
+            if (!mz_zip_reader_file_stat(&m_archive, fileIndex, &stat)) {
+                throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
+            }
+
+            const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
+            const auto deflated = stat.m_method == MZ_DEFLATED && stat.m_comp_size > 0;
+            const auto size = deflated ? static_cast<size_t>(stat.m_comp_size) : uncompressedSize;
+            const auto flags = deflated ? static_cast<mz_uint>(MZ_ZIP_FLAG_COMPRESSED_DATA) : 0u;
+
+            auto data = std::make_unique<char[]>(size);
+            if (!mz_zip_reader_extract_to_mem(&m_archive, fileIndex, data.get(), size, flags)) {
+                throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
+            }
+
+            return EntryData { path, fileIndex, deflated, uncompressedSize, stat.m_crc32, std::move(data), size };
+        }
+
+        std::shared_ptr<File> ZipFileSystem::makeFile(EntryData& entry) {
+            if (!entry.deflated) {
+                return std::make_shared<OwningBufferFile>(entry.path, std::move(entry.data), entry.size);
+            }
+
+            auto data = std::make_unique<char[]>(entry.uncompressedSize);
+            const auto size = tinfl_decompress_mem_to_mem(data.get(), entry.uncompressedSize, entry.data.get(), entry.size, 0);
+            if (size != entry.uncompressedSize) {
+                throw FileSystemException("Failed to inflate " + entry.path.asString());
+            }
+
+            const auto checksum = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const mz_uint8*>(data.get()), size);
+            if (checksum != entry.checksum) {
+                throw FileSystemException("CRC check failed for " + entry.path.asString());
+            }
+
+            entry.data.reset();
+            return std::make_shared<OwningBufferFile>(entry.path, std::move(data), size);
+        }
+
         /**
          * Helper to get the filename of a file in the zip archive
          */
-        std::string ZipFileSystem::filename(const mz_uint fileIndex) {
+        std::string ZipFileSystem::filename(const mz_uint fileIndex) const {
             // nameLen includes space for the null-terminator byte
             const mz_uint nameLen = mz_zip_reader_get_filename(&m_archive, fileIndex, nullptr, 0);
             if (nameLen == 0) {
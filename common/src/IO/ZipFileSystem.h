@@ -23,16 +23,30 @@
 #include "StringUtils.h"
 #include "IO/ImageFileSystem.h"
 #include "IO/Path.h"
+#include "IO/ZipFileCache.h"
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <miniz/miniz.h>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * A file system backed by a zip archive.
+         *
+         * Decompressed files are kept in a cache of bounded size, so that opening a file that was opened recently
+         * returns the same buffer instead of decompressing the file again. The cache can be shared with other zip
+         * file systems. When several files are opened at once, their compressed data is read from the archive
+         * sequentially and then decompressed concurrently.
+         *
+         * Files may be opened from several threads, the accesses to the archive are synchronized.
+         */
         class ZipFileSystem : public ImageFileSystem {
         private:
-            mz_zip_archive m_archive;
+            mutable mz_zip_archive m_archive;
+            mutable std::mutex m_archiveMutex;
         private:
             class ZipCompressedFile : public FileEntry {
             private:
@@ -40,18 +54,57 @@ namespace TrenchBroom {
                 mz_uint m_fileIndex;
             public:
                 ZipCompressedFile(ZipFileSystem* owner, mz_uint fileIndex);
+
+                mz_uint fileIndex() const;
             private:
                 std::shared_ptr<File> doOpen() const override;
             };
             friend class ZipCompressedFile;
+
+            /**
+             * The data of a file as it was read from the archive. If the file is deflated, the data is still
+             * compressed and must be inflated before it can be used.
+             */
+            struct EntryData {
+                Path path;
+                mz_uint fileIndex;
+                bool deflated;
+                size_t uncompressedSize;
+                mz_uint32 checksum;
+                std::unique_ptr<char[]> data;
+                size_t size;
+            };
+
+            std::shared_ptr<ZipFileCache> m_cache;
         public:
-            explicit ZipFileSystem(const Path& path);
-            ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
+            /**
+             * Creates a file system with its own cache of the given capacity in bytes.
+             */
+            explicit ZipFileSystem(const Path& path, size_t cacheCapacity = ZipFileCache::DefaultCapacity);
+
+            /**
+             * Creates a file system that keeps its decompressed files in the given cache.
+             */
+            ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path, std::shared_ptr<ZipFileCache> cache);
             ~ZipFileSystem() override;
+
+            /**
+             * Returns the total size of the decompressed files in this file system's cache, in bytes. This includes
+             * the files of other file systems that share the cache.
+             */
+            size_t cacheSize() const;
         private:
             void doReadDirectory() override;
+            std::vector<std::shared_ptr<File>> doOpenFiles(const Path::List& paths) const override;
         private:
-            std::string filename(mz_uint fileIndex);
+            std::shared_ptr<File> openEntry(mz_uint fileIndex) const;
+            std::vector<std::shared_ptr<File>> openEntries(const std::vector<mz_uint>& fileIndices) const;
+
+            EntryData readEntry(mz_uint fileIndex) const;
+            static std::shared_ptr<File> makeFile(EntryData& entry);
+
+
+            std::string filename(mz_uint fileIndex) const;
         };
     }
 }
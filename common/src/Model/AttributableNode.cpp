@@ -20,6 +20,7 @@
 #include "AttributableNode.h"
 
 #include "Assets/AttributeDefinition.h"
+#include "Model/EntityLinkGraph.h"
 
 namespace TrenchBroom {
     namespace Model {
@@ -166,6 +167,14 @@ namespace TrenchBroom {
             return *value;
         }
 
+        vm::vec3 AttributableNode::vectorAttribute(const AttributeName& name, const vm::vec3& defaultValue) const {
+            return m_attributes.vectorAttribute(name, defaultValue);
+        }
+
+        FloatType AttributableNode::numberAttribute(const AttributeName& name, const FloatType defaultValue) const {
+            return m_attributes.numberAttribute(name, defaultValue);
+        }
+
         const AttributeValue& AttributableNode::classname(const AttributeValue& defaultClassname) const {
             return m_classname.empty() ? defaultClassname : m_classname;
         }
@@ -186,12 +195,10 @@ namespace TrenchBroom {
             if (oldValue != nullptr) {
                 attributeWillChangeNotifier(this, name);
                 removeAttributeFromIndex(name, *oldValue);
-                removeLinks(name, *oldValue);
             }
 
             m_attributes.addOrUpdateAttribute(name, value, definition);
             addAttributeToIndex(name, value);
-            addLinks(name, value);
 
             if (oldValue == nullptr)
                 attributeWasAddedNotifier(this, name);
@@ -219,7 +226,6 @@ namespace TrenchBroom {
             m_attributes.renameAttribute(name, newName, newDefinition);
 
             updateAttributeIndex(name, value, newName, value);
-            updateLinks(name, value, newName, value);
             attributeWasAddedNotifier(this, newName);
         }
 
@@ -239,7 +245,6 @@ namespace TrenchBroom {
             m_attributes.removeAttribute(name);
 
             removeAttributeFromIndex(name, value);
-            removeLinks(name, value);
         }
 
         void AttributableNode::removeNumberedAttribute(const AttributeName& prefix) {
@@ -254,7 +259,6 @@ namespace TrenchBroom {
                     attributeWillBeRemovedNotifier(this, name);
                     m_attributes.removeAttribute(name);
                     removeAttributeFromIndex(name, value);
-                    removeLinks(name, value);
                 }
             }
         }
@@ -355,20 +359,28 @@ namespace TrenchBroom {
             addToIndex(this, newName, newValue);
         }
 
-        const AttributableNodeList& AttributableNode::linkSources() const {
-            return m_linkSources;
+        AttributableNodeList AttributableNode::linkSources() const {
+            AttributableNodeList result;
+            findSources(AttributeNames::Target, result);
+            return result;
         }
 
-        const AttributableNodeList& AttributableNode::linkTargets() const {
-            return m_linkTargets;
+        AttributableNodeList AttributableNode::linkTargets() const {
+            AttributableNodeList result;
+            findTargets(AttributeNames::Target, result);
+            return result;
         }
 
-        const AttributableNodeList& AttributableNode::killSources() const {
-            return m_killSources;
+        AttributableNodeList AttributableNode::killSources() const {
+            AttributableNodeList result;
+            findSources(AttributeNames::Killtarget, result);
+            return result;
         }
 
-        const AttributableNodeList& AttributableNode::killTargets() const {
-            return m_killTargets;
+        AttributableNodeList AttributableNode::killTargets() const {
+            AttributableNodeList result;
+            findTargets(AttributeNames::Killtarget, result);
+            return result;
         }
 
         vm::vec3 AttributableNode::linkSourceAnchor() const {
@@ -380,9 +392,12 @@ namespace TrenchBroom {
         }
 
         bool AttributableNode::hasMissingSources() const {
-            return (m_linkSources.empty() &&
-                    m_killSources.empty() &&
-                    hasAttribute(AttributeNames::Targetname));
+            const AttributeValue* targetname = m_attributes.attribute(AttributeNames::Targetname);
+            if (targetname == nullptr)
+                return false;
+
+            const EntityLinkGraph* linkGraph = findEntityLinkGraph();
+            return linkGraph == nullptr || !linkGraph->hasSources(*targetname);
         }
 
         AttributeNameList AttributableNode::findMissingLinkTargets() const {
@@ -397,271 +412,48 @@ namespace TrenchBroom {
             return result;
         }
 
-        void AttributableNode::findMissingTargets(const AttributeName& prefix, AttributeNameList& result) const {
-            for (const EntityAttribute& attribute : m_attributes.numberedAttributes(prefix)) {
-                const AttributeValue& targetname = attribute.value();
-                if (targetname.empty()) {
-                    result.push_back(attribute.name());
-                } else {
-                    AttributableNodeList linkTargets;
-                    findAttributableNodesWithAttribute(AttributeNames::Targetname, targetname, linkTargets);
-                    if (linkTargets.empty())
-                        result.push_back(attribute.name());
-                }
-            }
-        }
-
-        void AttributableNode::addLinks(const AttributeName& name, const AttributeValue& value) {
-            if (isNumberedAttribute(AttributeNames::Target, name)) {
-                addLinkTargets(value);
-            } else if (isNumberedAttribute(AttributeNames::Killtarget, name)) {
-                addKillTargets(value);
-            } else if (name == AttributeNames::Targetname) {
-                addAllLinkSources(value);
-                addAllKillSources(value);
-            }
-        }
-
-        void AttributableNode::removeLinks(const AttributeName& name, const AttributeValue& value) {
-            if (isNumberedAttribute(AttributeNames::Target, name)) {
-                removeLinkTargets(value);
-            } else if (isNumberedAttribute(AttributeNames::Killtarget, name)) {
-                removeKillTargets(value);
-            } else if (name == AttributeNames::Targetname) {
-                removeAllLinkSources();
-                removeAllKillSources();
-            }
-        }
-
-        void AttributableNode::updateLinks(const AttributeName& oldName, const AttributeName& oldValue, const AttributeName& newName, const AttributeValue& newValue) {
-            removeLinks(oldName, oldValue);
-            addLinks(newName, newValue);
-        }
-
-        void AttributableNode::addLinkTargets(const AttributeValue& targetname) {
-            if (!targetname.empty()) {
-                AttributableNodeList targets;
-                findAttributableNodesWithAttribute(AttributeNames::Targetname, targetname, targets);
-                addLinkTargets(targets);
-            }
-        }
-
-        void AttributableNode::addKillTargets(const AttributeValue& targetname) {
-            if (!targetname.empty()) {
-                AttributableNodeList targets;
-                findAttributableNodesWithAttribute(AttributeNames::Targetname, targetname, targets);
-                addKillTargets(targets);
-            }
-        }
-
-        void AttributableNode::removeLinkTargets(const AttributeValue& targetname) {
-            if (!targetname.empty()) {
-                AttributableNodeList::iterator rem = std::end(m_linkTargets);
-                AttributableNodeList::iterator it = std::begin(m_linkTargets);
-                while (it != rem) {
-                    AttributableNode* target = *it;
-                    const AttributeValue& targetTargetname = target->attribute(AttributeNames::Targetname);
-                    if (targetTargetname == targetname) {
-                        target->removeLinkSource(this);
-                        --rem;
-                        std::iter_swap(it, rem);
-                    } else {
-                        ++it;
-                    }
-                }
-                m_linkTargets.erase(rem, std::end(m_linkTargets));
-            }
-        }
-
-        void AttributableNode::removeKillTargets(const AttributeValue& targetname) {
-            if (!targetname.empty()) {
-                AttributableNodeList::iterator rem = std::end(m_killTargets);
-                AttributableNodeList::iterator it = std::begin(m_killTargets);
-                while (it != rem) {
-                    AttributableNode* target = *it;
-                    const AttributeValue& targetTargetname = target->attribute(AttributeNames::Targetname);
-                    if (targetTargetname == targetname) {
-                        target->removeKillSource(this);
-                        --rem;
-                        std::iter_swap(it, rem);
-                    } else {
-                        ++it;
-                    }
-                }
-                m_killTargets.erase(rem, std::end(m_killTargets));
-            }
-        }
-
-        void AttributableNode::addAllLinkSources(const AttributeValue& targetname) {
-            if (!targetname.empty()) {
-                AttributableNodeList linkSources;
-                findAttributableNodesWithNumberedAttribute(AttributeNames::Target, targetname, linkSources);
-                addLinkSources(linkSources);
-            }
-        }
-
-        void AttributableNode::addAllLinkTargets() {
-            for (const EntityAttribute& attribute : m_attributes.numberedAttributes(AttributeNames::Target)) {
-                const String& targetname = attribute.value();
-                if (!targetname.empty()) {
-                    AttributableNodeList linkTargets;
-                    findAttributableNodesWithAttribute(AttributeNames::Targetname, targetname, linkTargets);
-                    addLinkTargets(linkTargets);
-                }
-            }
-        }
-
-        void AttributableNode::addAllKillSources(const AttributeValue& targetname) {
-            if (!targetname.empty()) {
-                AttributableNodeList killSources;
-                findAttributableNodesWithNumberedAttribute(AttributeNames::Killtarget, targetname, killSources);
-                addKillSources(killSources);
-            }
-        }
-
-        void AttributableNode::addAllKillTargets() {
-            for (const EntityAttribute& attribute : m_attributes.numberedAttributes(AttributeNames::Killtarget)) {
-                const String& targetname = attribute.value();
-                if (!targetname.empty()) {
-                    AttributableNodeList killTargets;
-                    findAttributableNodesWithAttribute(AttributeNames::Targetname, targetname, killTargets);
-                    addKillTargets(killTargets);
-                }
-            }
-        }
+        void AttributableNode::findSources(const AttributeName& prefix, AttributableNodeList& result) const {
+            const AttributeValue* targetname = m_attributes.attribute(AttributeNames::Targetname);
+            if (targetname == nullptr || targetname->empty())
+                return;
 
-        void AttributableNode::addLinkTargets(const AttributableNodeList& targets) {
-            m_linkTargets.reserve(m_linkTargets.size() + targets.size());
-            for (AttributableNode* target : targets) {
-                target->addLinkSource(this);
-                m_linkTargets.push_back(target);
-            }
-            invalidateIssues();
-        }
+            const EntityLinkGraph* linkGraph = findEntityLinkGraph();
+            if (linkGraph == nullptr)
+                return;
 
-        void AttributableNode::addKillTargets(const AttributableNodeList& targets) {
-            m_killTargets.reserve(m_killTargets.size() + targets.size());
-            for (AttributableNode* target : targets) {
-                target->addKillSource(this);
-                m_killTargets.push_back(target);
-            }
-            invalidateIssues();
+            if (prefix == AttributeNames::Target)
+                linkGraph->findLinkSources(*targetname, result);
+            else
+                linkGraph->findKillSources(*targetname, result);
         }
 
-        void AttributableNode::addLinkSources(const AttributableNodeList& sources) {
-            m_linkSources.reserve(m_linkSources.size() + sources.size());
-            for (AttributableNode* linkSource : sources) {
-                linkSource->addLinkTarget(this);
-                m_linkSources.push_back(linkSource);
-            }
-            invalidateIssues();
-        }
+        void AttributableNode::findTargets(const AttributeName& prefix, AttributableNodeList& result) const {
+            const EntityLinkGraph* linkGraph = findEntityLinkGraph();
+            if (linkGraph == nullptr)
+                return;
 
-        void AttributableNode::addKillSources(const AttributableNodeList& sources) {
-            m_killSources.reserve(m_killSources.size() + sources.size());
-            for (AttributableNode* killSource : sources) {
-                killSource->addKillTarget(this);
-                m_killSources.push_back(killSource);
+            for (const EntityAttribute& attribute : m_attributes.numberedAttributes(prefix)) {
+                const AttributeValue& targetname = attribute.value();
+                if (!targetname.empty())
+                    linkGraph->findTargets(targetname, result);
             }
-            invalidateIssues();
-        }
-
-        void AttributableNode::removeAllLinkSources() {
-            for (AttributableNode* linkSource : m_linkSources)
-                linkSource->removeLinkTarget(this);
-            m_linkSources.clear();
-            invalidateIssues();
-        }
-
-        void AttributableNode::removeAllLinkTargets() {
-            for (AttributableNode* linkTarget : m_linkTargets)
-                linkTarget->removeLinkSource(this);
-            m_linkTargets.clear();
-            invalidateIssues();
-        }
-
-        void AttributableNode::removeAllKillSources() {
-            for (AttributableNode* killSource : m_killSources)
-                killSource->removeKillTarget(this);
-            m_killSources.clear();
-            invalidateIssues();
-        }
-
-        void AttributableNode::removeAllKillTargets() {
-            for (AttributableNode* killTarget : m_killTargets)
-                killTarget->removeKillSource(this);
-            m_killTargets.clear();
-            invalidateIssues();
         }
 
-        void AttributableNode::removeAllLinks() {
-            removeAllLinkSources();
-            removeAllLinkTargets();
-            removeAllKillSources();
-            removeAllKillTargets();
-        }
-
-        void AttributableNode::addAllLinks() {
-            addAllLinkTargets();
-            addAllKillTargets();
-
-            const AttributeValue* targetname = m_attributes.attribute(AttributeNames::Targetname);
-            if (targetname != nullptr && !targetname->empty()) {
-                addAllLinkSources(*targetname);
-                addAllKillSources(*targetname);
+        void AttributableNode::findMissingTargets(const AttributeName& prefix, AttributeNameList& result) const {
+            const EntityLinkGraph* linkGraph = findEntityLinkGraph();
+            for (const EntityAttribute& attribute : m_attributes.numberedAttributes(prefix)) {
+                const AttributeValue& targetname = attribute.value();
+                if (targetname.empty() || linkGraph == nullptr || !linkGraph->hasTargets(targetname))
+                    result.push_back(attribute.name());
             }
         }
 
         void AttributableNode::doAncestorWillChange() {
-            removeAllLinks();
             removeAttributesFromIndex();
         }
 
         void AttributableNode::doAncestorDidChange() {
             addAttributesToIndex();
-            addAllLinks();
-        }
-
-        void AttributableNode::addLinkSource(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            m_linkSources.push_back(attributable);
-            invalidateIssues();
-        }
-
-        void AttributableNode::addLinkTarget(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            m_linkTargets.push_back(attributable);
-            invalidateIssues();
-        }
-
-        void AttributableNode::addKillSource(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            m_killSources.push_back(attributable);
-            invalidateIssues();
-        }
-
-        void AttributableNode::addKillTarget(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            m_killTargets.push_back(attributable);
-            invalidateIssues();
-        }
-
-        void AttributableNode::removeLinkSource(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            VectorUtils::erase(m_linkSources, attributable);
-            invalidateIssues();
-        }
-
-        void AttributableNode::removeLinkTarget(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            VectorUtils::erase(m_linkTargets, attributable);
-            invalidateIssues();
-        }
-
-        void AttributableNode::removeKillSource(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            VectorUtils::erase(m_killSources, attributable);
-            invalidateIssues();
         }
 
         AttributableNode::AttributableNode() :
@@ -672,10 +464,5 @@ namespace TrenchBroom {
             static const String defaultName("<missing classname>");
             return classname(defaultName);
         }
-
-        void AttributableNode::removeKillTarget(AttributableNode* attributable) {
-            ensure(attributable != nullptr, "attributable is null");
-            VectorUtils::erase(m_killTargets, attributable);
-        }
     }
 }
@@ -40,11 +40,6 @@ namespace TrenchBroom {
             Assets::EntityDefinition* m_definition;
             EntityAttributes m_attributes;
 
-            AttributableNodeList m_linkSources;
-            AttributableNodeList m_linkTargets;
-            AttributableNodeList m_killSources;
-            AttributableNodeList m_killTargets;
-
             // cache the classname for faster access
             AttributeValue m_classname;
         public:
@@ -77,6 +72,8 @@ namespace TrenchBroom {
             EntityAttribute::List numberedAttributes(const String& prefix) const;
 
             const AttributeValue& attribute(const AttributeName& name, const AttributeValue& defaultValue = DefaultAttributeValue) const;
+            vm::vec3 vectorAttribute(const AttributeName& name, const vm::vec3& defaultValue) const;
+            FloatType numberAttribute(const AttributeName& name, FloatType defaultValue) const;
             const AttributeValue& classname(const AttributeValue& defaultClassname = AttributeValues::NoClassname) const;
 
             EntityAttributeSnapshot attributeSnapshot(const AttributeName& name) const;
@@ -135,10 +132,10 @@ namespace TrenchBroom {
             void removeAttributeFromIndex(const AttributeName& name, const AttributeValue& value);
             void updateAttributeIndex(const AttributeName& oldName, const AttributeValue& oldValue, const AttributeName& newName, const AttributeValue& newValue);
         public: // link management
-            const AttributableNodeList& linkSources() const;
-            const AttributableNodeList& linkTargets() const;
-            const AttributableNodeList& killSources() const;
-            const AttributableNodeList& killTargets() const;
+            AttributableNodeList linkSources() const;
+            AttributableNodeList linkTargets() const;
+            AttributableNodeList killSources() const;
+            AttributableNodeList killTargets() const;
 
             vm::vec3 linkSourceAnchor() const;
             vm::vec3 linkTargetAnchor() const;
@@ -147,45 +144,9 @@ namespace TrenchBroom {
             AttributeNameList findMissingLinkTargets() const;
             AttributeNameList findMissingKillTargets() const;
         private: // link management internals
+            void findSources(const AttributeName& prefix, AttributableNodeList& result) const;
+            void findTargets(const AttributeName& prefix, AttributableNodeList& result) const;
             void findMissingTargets(const AttributeName& prefix, AttributeNameList& result) const;
-
-            void addLinks(const AttributeName& name, const AttributeValue& value);
-            void removeLinks(const AttributeName& name, const AttributeValue& value);
-            void updateLinks(const AttributeName& oldName, const AttributeName& oldValue, const AttributeName& newName, const AttributeValue& newValue);
-
-            void addLinkTargets(const AttributeValue& targetname);
-            void addKillTargets(const AttributeValue& targetname);
-
-            void removeLinkTargets(const AttributeValue& targetname);
-            void removeKillTargets(const AttributeValue& targetname);
-
-            void addAllLinkSources(const AttributeValue& targetname);
-            void addAllLinkTargets();
-            void addAllKillSources(const AttributeValue& targetname);
-            void addAllKillTargets();
-
-            void addLinkTargets(const AttributableNodeList& targets);
-            void addKillTargets(const AttributableNodeList& targets);
-            void addLinkSources(const AttributableNodeList& sources);
-            void addKillSources(const AttributableNodeList& sources);
-
-            void removeAllLinkSources();
-            void removeAllLinkTargets();
-            void removeAllKillSources();
-            void removeAllKillTargets();
-
-            void removeAllLinks();
-            void addAllLinks();
-
-            void addLinkSource(AttributableNode* attributable);
-            void addLinkTarget(AttributableNode* attributable);
-            void addKillSource(AttributableNode* attributable);
-            void addKillTarget(AttributableNode* attributable);
-
-            void removeLinkSource(AttributableNode* attributable);
-            void removeLinkTarget(AttributableNode* attributable);
-            void removeKillSource(AttributableNode* attributable);
-            void removeKillTarget(AttributableNode* attributable);
         protected:
             AttributableNode();
         private: // implemenation of node interface
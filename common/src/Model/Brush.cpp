@@ -32,6 +32,7 @@
 #include "Model/IssueGenerator.h"
 #include "Model/NodeVisitor.h"
 #include "Model/PickResult.h"
+#include "Model/PlanePointFinder.h"
 #include "Model/TagVisitor.h"
 #include "Model/World.h"
 
@@ -47,6 +48,9 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace Model {
@@ -152,6 +156,18 @@ namespace TrenchBroom {
             }
         };
 
+        class Brush::BindFacesToGeometryCallback : public BrushGeometry::Callback {
+        private:
+            BrushFaceList::const_iterator m_nextFace;
+        public:
+            explicit BindFacesToGeometryCallback(const BrushFaceList& faces) :
+            m_nextFace(std::begin(faces)) {}
+
+            void faceWasCreated(BrushFaceGeometry* face) override {
+                (*m_nextFace++)->setGeometry(face);
+            }
+        };
+
         class Brush::MoveVerticesCallback : public BrushGeometry::Callback {
         private:
             using IncidenceMap = std::map<vm::vec3, BrushFaceList>;
@@ -291,15 +307,9 @@ namespace TrenchBroom {
             }
         };
 
-        class Brush::QueryCallback : public BrushGeometry::Callback {
-        public:
-            vm::plane3 getPlane(const BrushFaceGeometry* face) const override {
-                return face->payload()->boundary();
-            }
-        };
-
         Brush::Brush(const vm::bbox3& worldBounds, const BrushFaceList& faces) :
-        m_geometry(nullptr) {
+        m_geometry(nullptr),
+        m_separatingAxesValid(false) {
             addFaces(faces);
             try {
                 buildGeometry(worldBounds);
@@ -309,12 +319,25 @@ namespace TrenchBroom {
             }
         }
 
+        Brush::Brush(const vm::bbox3& worldBounds, const BrushFaceList& faces, const std::vector<vm::vec3>& vertexPositions, const std::vector<std::vector<size_t>>& faceVertices) :
+        m_geometry(nullptr),
+        m_separatingAxesValid(false) {
+            addFaces(faces);
+            try {
+                buildGeometry(worldBounds, vertexPositions, faceVertices);
+            } catch (const GeometryException&) {
+                cleanup();
+                throw;
+            }
+        }
+
         Brush::~Brush() {
             cleanup();
         }
 
         void Brush::cleanup() {
-            deleteGeometry();
+            if (m_geometry != nullptr)
+                deleteGeometry();
             VectorUtils::clearAndDelete(m_faces);
         }
 
@@ -322,6 +345,52 @@ namespace TrenchBroom {
             return static_cast<Brush*>(Node::clone(worldBounds));
         }
 
+        BrushFaceList Brush::cloneFaces() const {
+            BrushFaceList faceClones;
+            faceClones.reserve(m_faces.size());
+
+            for (const auto* face : m_faces) {
+                faceClones.push_back(face->clone());
+            }
+            return faceClones;
+        }
+
+        Brush* Brush::clone(const vm::bbox3& worldBounds, const BrushFaceList& faceClones) const {
+            assert(faceClones.size() == m_faces.size());
+
+            // every face of the geometry belongs to a brush face since a brush is always fully specified
+            std::vector<vm::vec3> vertexPositions;
+            std::vector<std::vector<size_t>> faceVertices;
+            collectGeometry(vertexPositions, faceVertices);
+
+            auto* brush = new Brush(worldBounds, faceClones, vertexPositions, faceVertices);
+            cloneAttributes(brush);
+            return brush;
+        }
+
+        void Brush::collectGeometry(std::vector<vm::vec3>& vertexPositions, std::vector<std::vector<size_t>>& faceVertices) const {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            std::unordered_map<const BrushVertex*, size_t> vertexIndices;
+            vertexIndices.reserve(m_geometry->vertexCount());
+            vertexPositions.reserve(m_geometry->vertexCount());
+            for (const auto* vertex : m_geometry->vertices()) {
+                vertexIndices.emplace(vertex, vertexPositions.size());
+                vertexPositions.push_back(vertex->position());
+            }
+
+            // the brush faces need not be in the order of the geometry faces
+            faceVertices.reserve(m_faces.size());
+            for (const auto* face : m_faces) {
+                std::vector<size_t> indices;
+                indices.reserve(face->vertexCount());
+                for (const auto* halfEdge : face->geometry()->boundary()) {
+                    indices.push_back(vertexIndices[halfEdge->origin()]);
+                }
+                faceVertices.push_back(std::move(indices));
+            }
+        }
+
         NodeSnapshot* Brush::doTakeSnapshot() {
             return new BrushSnapshot(this);
         }
@@ -697,6 +766,153 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Computes the range of the distances of the given vertices from the origin along the given axis.
+         */
+        static void projectVertices(const std::vector<FloatType>& x, const std::vector<FloatType>& y, const std::vector<FloatType>& z, const vm::vec3& axis, FloatType& min, FloatType& max) {
+            const size_t count = x.size();
+            const FloatType* xs = x.data();
+            const FloatType* ys = y.data();
+            const FloatType* zs = z.data();
+
+            min = std::numeric_limits<FloatType>::max();
+            max = std::numeric_limits<FloatType>::lowest();
+            for (size_t i = 0; i < count; ++i) {
+                const FloatType distance = axis[0] * xs[i] + axis[1] * ys[i] + axis[2] * zs[i];
+                min = distance < min ? distance : min;
+                max = distance > max ? distance : max;
+            }
+        }
+
+        /**
+         * Indicates whether any face plane of `lhs` has all vertices of `rhs` on or above it, with at least one of
+         * them strictly above it.
+         */
+        bool Brush::separatedByFaces(const SeparatingAxes& lhs, const SeparatingAxes& rhs) {
+            const FloatType epsilon = vm::constants<FloatType>::pointStatusEpsilon();
+            for (size_t i = 0; i < lhs.planeDistance.size(); ++i) {
+                FloatType min, max;
+                projectVertices(rhs.vertexX, rhs.vertexY, rhs.vertexZ, vm::vec3(lhs.planeX[i], lhs.planeY[i], lhs.planeZ[i]), min, max);
+
+                const FloatType distance = lhs.planeDistance[i];
+                if (min >= distance - epsilon && max > distance + epsilon) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Indicates whether any axis perpendicular to an edge of `lhs` and an edge of `rhs` separates the vertices
+         * of both. As for the face planes, vertices that lie on the separating plane do not count as overlapping.
+         */
+        bool Brush::separatedByEdges(const SeparatingAxes& lhs, const SeparatingAxes& rhs) {
+            const FloatType epsilon = vm::constants<FloatType>::pointStatusEpsilon();
+            for (const vm::vec3& lhsDirection : lhs.edgeDirections) {
+                for (const vm::vec3& rhsDirection : rhs.edgeDirections) {
+                    const vm::vec3 axis = vm::cross(lhsDirection, rhsDirection);
+                    const FloatType length = vm::length(axis);
+                    if (length < vm::constants<FloatType>::almostZero()) {
+                        continue;
+                    }
+
+                    const vm::vec3 normal = axis / length;
+                    FloatType lhsMin, lhsMax, rhsMin, rhsMax;
+                    projectVertices(lhs.vertexX, lhs.vertexY, lhs.vertexZ, normal, lhsMin, lhsMax);
+                    projectVertices(rhs.vertexX, rhs.vertexY, rhs.vertexZ, normal, rhsMin, rhsMax);
+
+                    if (rhsMin >= lhsMax - epsilon && rhsMax > lhsMax + epsilon) {
+                        return true;
+                    }
+                    if (rhsMax <= lhsMin + epsilon && rhsMin < lhsMin - epsilon) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        bool Brush::intersectsBrush(const Brush* brush) const {
+            if (!bounds().intersects(brush->bounds())) {
+                return false;
+            }
+
+            const SeparatingAxes& ours = separatingAxes();
+            const SeparatingAxes& theirs = brush->separatingAxes();
+            return !separatedByFaces(ours, theirs) && !separatedByFaces(theirs, ours) && !separatedByEdges(ours, theirs);
+        }
+
+        bool Brush::containsBrush(const Brush* brush) const {
+            if (!bounds().contains(brush->bounds())) {
+                return false;
+            }
+
+            const FloatType epsilon = vm::constants<FloatType>::pointStatusEpsilon();
+            const SeparatingAxes& ours = separatingAxes();
+            const SeparatingAxes& theirs = brush->separatingAxes();
+            for (size_t i = 0; i < ours.planeDistance.size(); ++i) {
+                FloatType min, max;
+                projectVertices(theirs.vertexX, theirs.vertexY, theirs.vertexZ, vm::vec3(ours.planeX[i], ours.planeY[i], ours.planeZ[i]), min, max);
+                if (max > ours.planeDistance[i] + epsilon) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        const Brush::SeparatingAxes& Brush::separatingAxes() const {
+            // the axes are built lazily, but queries may run concurrently, e.g. when selecting touching brushes
+            if (!m_separatingAxesValid.load(std::memory_order_acquire)) {
+                static std::mutex mutex;
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!m_separatingAxesValid.load(std::memory_order_relaxed)) {
+                    buildSeparatingAxes();
+                    m_separatingAxesValid.store(true, std::memory_order_release);
+                }
+            }
+            return m_separatingAxes;
+        }
+
+        void Brush::buildSeparatingAxes() const {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            SeparatingAxes& axes = m_separatingAxes;
+
+            axes.planeX.clear();
+            axes.planeY.clear();
+            axes.planeZ.clear();
+            axes.planeDistance.clear();
+            for (const auto* face : m_faces) {
+                const vm::plane3& boundary = face->boundary();
+                axes.planeX.push_back(boundary.normal[0]);
+                axes.planeY.push_back(boundary.normal[1]);
+                axes.planeZ.push_back(boundary.normal[2]);
+                axes.planeDistance.push_back(boundary.distance);
+            }
+
+            axes.vertexX.clear();
+            axes.vertexY.clear();
+            axes.vertexZ.clear();
+            for (const auto* vertex : m_geometry->vertices()) {
+                const vm::vec3& position = vertex->position();
+                axes.vertexX.push_back(position[0]);
+                axes.vertexY.push_back(position[1]);
+                axes.vertexZ.push_back(position[2]);
+            }
+
+            // parallel edges yield the same axes, so only one edge per direction is kept
+            axes.edgeDirections.clear();
+            for (const auto* edge : m_geometry->edges()) {
+                const vm::vec3 direction = vm::normalize(edge->vector());
+                const auto parallel = [&](const vm::vec3& other) {
+                    return vm::abs(vm::dot(direction, other)) >= static_cast<FloatType>(1.0) - vm::constants<FloatType>::almostZero();
+                };
+                if (std::none_of(std::begin(axes.edgeDirections), std::end(axes.edgeDirections), parallel)) {
+                    axes.edgeDirections.push_back(direction);
+                }
+            }
+        }
+
         BrushFaceList Brush::incidentFaces(const BrushVertex* vertex) const {
             BrushFaceList result;
             result.reserve(m_faces.size());
@@ -1294,6 +1510,17 @@ namespace TrenchBroom {
             }
         }
 
+        void Brush::buildGeometry(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const std::vector<std::vector<size_t>>& faceVertices) {
+            assert(m_geometry == nullptr);
+
+            if (faceVertices.size() != m_faces.size())
+                throw GeometryException("Brush geometry does not match brush faces");
+
+            BindFacesToGeometryCallback callback(m_faces);
+            m_geometry = new BrushGeometry(vertexPositions, faceVertices, callback);
+            updateFacesFromGeometry(worldBounds, *m_geometry);
+        }
+
         void Brush::deleteGeometry() {
             assert(m_geometry != nullptr);
 
@@ -1303,6 +1530,7 @@ namespace TrenchBroom {
             }
             delete m_geometry;
             m_geometry = nullptr;
+            m_separatingAxesValid = false;
         }
 
         bool Brush::checkGeometry() const {
@@ -1328,12 +1556,32 @@ namespace TrenchBroom {
         }
 
         void Brush::findIntegerPlanePoints(const vm::bbox3& worldBounds) {
-            const NotifyNodeChange nodeChange(this);
+            findIntegerPlanePoints(BrushList(1, this), worldBounds);
+        }
 
-            for (auto* face : m_faces) {
-                face->findIntegerPlanePoints();
+        void Brush::findIntegerPlanePoints(const BrushList& brushes, const vm::bbox3& worldBounds) {
+            std::vector<vm::plane3> planes;
+            std::vector<vm::vec3> points;
+            for (const auto* brush : brushes) {
+                for (const auto* face : brush->m_faces) {
+                    planes.push_back(face->boundary());
+                    const auto& facePoints = face->points();
+                    points.insert(std::end(points), std::begin(facePoints), std::end(facePoints));
+                }
+            }
+
+            PlanePointFinder::findPoints(planes, points);
+
+            size_t index = 0;
+            for (auto* brush : brushes) {
+                const NotifyNodeChange nodeChange(brush);
+
+                for (auto* face : brush->m_faces) {
+                    face->setIntegerPlanePoints(points[index], points[index + 1], points[index + 2]);
+                    index += 3;
+                }
+                brush->rebuildGeometry(worldBounds);
             }
-            rebuildGeometry(worldBounds);
         }
 
         const String& Brush::doGetName() const {
@@ -1347,16 +1595,7 @@ namespace TrenchBroom {
         }
 
         Node* Brush::doClone(const vm::bbox3& worldBounds) const {
-            BrushFaceList faceClones;
-            faceClones.reserve(m_faces.size());
-
-            for (const auto* face : m_faces) {
-                faceClones.push_back(face->clone());
-            }
-
-            auto* brush = new Brush(worldBounds, faceClones);
-            cloneAttributes(brush);
-            return brush;
+            return clone(worldBounds, cloneFaces());
         }
 
         bool Brush::doCanAddChild(const Node* child) const {
@@ -1485,7 +1724,7 @@ namespace TrenchBroom {
             }
 
             bool contains(const Brush* brush) const {
-                return m_this->m_geometry->contains(*brush->m_geometry, QueryCallback());
+                return m_this->containsBrush(brush);
             }
         };
 
@@ -1514,7 +1753,7 @@ namespace TrenchBroom {
             }
 
             bool intersects(const Brush* brush) {
-                return m_this->m_geometry->intersects(*brush->m_geometry, QueryCallback());
+                return m_this->intersectsBrush(brush);
             }
         };
 
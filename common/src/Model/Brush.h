@@ -39,6 +39,7 @@
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 
+#include <atomic>
 #include <set>
 #include <vector>
 
@@ -66,11 +67,27 @@ namespace TrenchBroom {
             class AddFaceToGeometryCallback;
             class HealEdgesCallback;
             class AddFacesToGeometry;
+            class BindFacesToGeometryCallback;
             class MoveVerticesCallback;
             using RemoveVertexCallback = MoveVerticesCallback;
-            class QueryCallback;
 
             using VertexSet = std::set<vm::vec3>;
+
+            /**
+             * The face planes, vertex positions and distinct edge directions of the brush geometry in flat arrays.
+             * The planes and vertices are stored component-wise so that projecting all vertices onto an axis is a
+             * tight loop over contiguous values.
+             */
+            struct SeparatingAxes {
+                std::vector<FloatType> planeX;
+                std::vector<FloatType> planeY;
+                std::vector<FloatType> planeZ;
+                std::vector<FloatType> planeDistance;
+                std::vector<FloatType> vertexX;
+                std::vector<FloatType> vertexY;
+                std::vector<FloatType> vertexZ;
+                std::vector<vm::vec3> edgeDirections;
+            };
         public:
             using VertexList = ConstProjectingSequence<BrushVertexList, ProjectToVertex>;
             using EdgeList = ConstProjectingSequence<BrushEdgeList, ProjectToEdge>;
@@ -81,14 +98,51 @@ namespace TrenchBroom {
 
             mutable bool m_transparent;
             mutable Renderer::BrushRendererBrushCache m_brushRendererBrushCache;
+
+            mutable SeparatingAxes m_separatingAxes;
+            mutable std::atomic<bool> m_separatingAxesValid;
         public:
             Brush(const vm::bbox3& worldBounds, const BrushFaceList& faces);
+
+            /**
+             * Creates a brush with the given faces and a precomputed geometry instead of intersecting the face
+             * boundaries. The geometry must have been computed from the same faces, i.e. it is taken from another
+             * brush with these faces, because it is not validated against them. The face at index i is bound to the
+             * geometry face whose vertex indices are at index i.
+             *
+             * @param worldBounds the world bounds
+             * @param faces the faces of the brush
+             * @param vertexPositions the positions of the vertices of the geometry
+             * @param faceVertices for each face, the indices of its vertices in the order of its boundary
+             * @throws GeometryException if the given geometry is not a closed polyhedron with one face per brush face
+             */
+            Brush(const vm::bbox3& worldBounds, const BrushFaceList& faces, const std::vector<vm::vec3>& vertexPositions, const std::vector<std::vector<size_t>>& faceVertices);
             ~Brush() override;
         private:
             void cleanup();
         public:
             Brush* clone(const vm::bbox3& worldBounds) const;
 
+            /**
+             * Returns clones of the faces of this brush, which are owned by the caller.
+             */
+            BrushFaceList cloneFaces() const;
+
+            /**
+             * Creates a clone of this brush with the given face clones, which must have been returned by cloneFaces().
+             * The geometry is copied from this brush instead of intersecting the face boundaries again. Unlike
+             * cloneFaces(), which may change the usage counts of textures, this can be called concurrently for
+             * different face clones.
+             *
+             * @param worldBounds the world bounds
+             * @param faceClones the face clones, the clone takes ownership of them
+             * @return the clone
+             */
+            Brush* clone(const vm::bbox3& worldBounds, const BrushFaceList& faceClones) const;
+        private:
+            void collectGeometry(std::vector<vm::vec3>& vertexPositions, std::vector<std::vector<size_t>>& faceVertices) const;
+        public:
+
             AttributableNode* entity() const;
         public: // face management:
             BrushFace* findFace(const String& textureName) const;
@@ -171,6 +225,32 @@ namespace TrenchBroom {
             EdgeList edges() const;
             bool containsPoint(const vm::vec3& point) const;
 
+            /**
+             * Indicates whether this brush and the given brush overlap. Brushes that only touch each other are not
+             * considered to overlap. The test is a separating axis test on the face planes and edge directions of
+             * both brushes, which are cached until the geometry of a brush changes. It is safe to call this
+             * concurrently as long as neither brush is modified.
+             *
+             * @param brush the brush to test
+             * @return true if the brushes overlap and false otherwise
+             */
+            bool intersectsBrush(const Brush* brush) const;
+
+            /**
+             * Indicates whether this brush contains all vertices of the given brush. The same caching and
+             * concurrency rules as for intersectsBrush apply.
+             *
+             * @param brush the brush to test
+             * @return true if the given brush is contained in this brush and false otherwise
+             */
+            bool containsBrush(const Brush* brush) const;
+        private:
+            const SeparatingAxes& separatingAxes() const;
+            void buildSeparatingAxes() const;
+            static bool separatedByFaces(const SeparatingAxes& lhs, const SeparatingAxes& rhs);
+            static bool separatedByEdges(const SeparatingAxes& lhs, const SeparatingAxes& rhs);
+        public:
+
             BrushFaceList incidentFaces(const BrushVertex* vertex) const;
 
             // vertex operations
@@ -275,10 +355,21 @@ namespace TrenchBroom {
             void rebuildGeometry(const vm::bbox3& worldBounds);
         private:
             void buildGeometry(const vm::bbox3& worldBounds);
+            void buildGeometry(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const std::vector<std::vector<size_t>>& faceVertices);
             void deleteGeometry();
             bool checkGeometry() const;
         public:
             void findIntegerPlanePoints(const vm::bbox3& worldBounds);
+
+            /**
+             * Finds integer plane points for the faces of all given brushes and rebuilds their geometry. The plane
+             * points of all faces are searched concurrently before any brush is changed.
+             *
+             * @param brushes the brushes to change
+             * @param worldBounds the world bounds
+             * @throws GeometryException if the geometry of a brush cannot be rebuilt with the found plane points
+             */
+            static void findIntegerPlanePoints(const BrushList& brushes, const vm::bbox3& worldBounds);
         private: // implement Node interface
             const String& doGetName() const override;
             const vm::bbox3& doGetBounds() const override;
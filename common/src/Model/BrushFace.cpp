@@ -62,6 +62,7 @@ namespace TrenchBroom {
         m_markedToRenderFace(false),
         m_attribs(attribs) {
             ensure(m_texCoordSystem != nullptr, "texCoordSystem is null");
+            m_attribs.intern();
             setPoints(point0, point1, point2);
         }
 
@@ -125,11 +126,19 @@ namespace TrenchBroom {
             return m_texCoordSystem->takeSnapshot();
         }
 
+        std::unique_ptr<TexCoordSystem> BrushFace::cloneTexCoordSystem() const {
+            return m_texCoordSystem->clone();
+        }
+
         void BrushFace::restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot) {
             coordSystemSnapshot.restore(*m_texCoordSystem);
             invalidateVertexCache();
         }
 
+        bool BrushFace::texCoordSystemMatches(const TexCoordSystemSnapshot& coordSystemSnapshot) const {
+            return coordSystemSnapshot.matches(*m_texCoordSystem);
+        }
+
         void BrushFace::copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attribs, const vm::plane3& sourceFacePlane, const WrapStyle wrapStyle) {
             // Get a line, and a reference point, that are on both the source face's plane and our plane
             const auto seam = vm::intersectPlaneAndPlane(sourceFacePlane, m_boundary);
@@ -514,6 +523,10 @@ namespace TrenchBroom {
             setPoints(m_points[0], m_points[1], m_points[2]);
         }
 
+        void BrushFace::setIntegerPlanePoints(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2) {
+            setPoints(point0, point1, point2);
+        }
+
         vm::mat4x4 BrushFace::projectToBoundaryMatrix() const {
             const auto texZAxis = m_texCoordSystem->fromMatrix(vm::vec2f::zero, vm::vec2f::one) * vm::vec3::pos_z;
             const auto worldToPlaneMatrix = planeProjectionMatrix(m_boundary.distance, m_boundary.normal, texZAxis);
@@ -594,6 +607,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -623,6 +640,10 @@ namespace TrenchBroom {
             return m_texCoordSystem->getTexCoords(point, m_attribs);
         }
 
+        TexCoordProjection BrushFace::textureCoordProjection() const {
+            return m_texCoordSystem->getTexCoordProjection(m_attribs);
+        }
+
         FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const {
             ensure(m_geometry != nullptr, "geometry is null");
 
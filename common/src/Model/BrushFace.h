@@ -106,7 +106,9 @@ namespace TrenchBroom {
 
             BrushFaceSnapshot* takeSnapshot();
             std::unique_ptr<TexCoordSystemSnapshot> takeTexCoordSystemSnapshot() const;
+            std::unique_ptr<TexCoordSystem> cloneTexCoordSystem() const;
             void restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot);
+            bool texCoordSystemMatches(const TexCoordSystemSnapshot& coordSystemSnapshot) const;
             void copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attribs, const vm::plane3& sourceFacePlane, WrapStyle wrapStyle);
 
             Brush* brush() const;
@@ -178,6 +180,12 @@ namespace TrenchBroom {
             void snapPlanePointsToInteger();
             void findIntegerPlanePoints();
 
+            /**
+             * Sets plane points that were found for the boundary of this face, e.g. by the batch search of
+             * PlanePointFinder.
+             */
+            void setIntegerPlanePoints(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2);
+
             vm::mat4x4 projectToBoundaryMatrix() const;
             vm::mat4x4 toTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, bool project) const;
             vm::mat4x4 fromTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, bool project) const;
@@ -196,6 +204,7 @@ namespace TrenchBroom {
             void invalidate();
 
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
 
             bool selected() const;
@@ -203,6 +212,11 @@ namespace TrenchBroom {
             void deselect();
 
             vm::vec2f textureCoords(const vm::vec3& point) const;
+            /**
+             * Returns a projection that computes the same texture coordinates as textureCoords, but can be applied to
+             * all vertices of this face at once.
+             */
+            TexCoordProjection textureCoordProjection() const;
 
             FloatType intersectWithRay(const vm::ray3& ray) const;
 
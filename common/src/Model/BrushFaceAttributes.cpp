@@ -23,28 +23,161 @@
 
 #include <vecmath/vec.h>
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
 namespace TrenchBroom {
     namespace Model {
+        class BrushFaceAttributes::Data {
+        public:
+            String textureName;
+            vm::vec2f offset;
+            vm::vec2f scale;
+            float rotation;
+
+            int surfaceContents;
+            int surfaceFlags;
+            float surfaceValue;
+
+            Color color;
+
+            std::atomic<size_t> refCount;
+            bool interned;
+        public:
+            explicit Data(const String& i_textureName) :
+            textureName(i_textureName),
+            offset(vm::vec2f::zero),
+            scale(vm::vec2f(1.0f, 1.0f)),
+            rotation(0.0f),
+            surfaceContents(0),
+            surfaceFlags(0),
+            surfaceValue(0.0f),
+            refCount(1),
+            interned(false) {}
+
+            Data(const Data& other) :
+            textureName(other.textureName),
+            offset(other.offset),
+            scale(other.scale),
+            rotation(other.rotation),
+            surfaceContents(other.surfaceContents),
+            surfaceFlags(other.surfaceFlags),
+            surfaceValue(other.surfaceValue),
+            color(other.color),
+            refCount(1),
+            interned(false) {}
+
+            Data& operator=(const Data& other) = delete;
+
+            bool shared() const {
+                return interned || refCount > 1;
+            }
+
+            Data* acquire() {
+                ++refCount;
+                return this;
+            }
+
+            void release();
+
+            bool operator==(const Data& other) const {
+                return (textureName == other.textureName &&
+                        offset == other.offset &&
+                        scale == other.scale &&
+                        rotation == other.rotation &&
+                        surfaceContents == other.surfaceContents &&
+                        surfaceFlags == other.surfaceFlags &&
+                        surfaceValue == other.surfaceValue &&
+                        color == other.color);
+            }
+
+            size_t hash() const {
+                size_t result = std::hash<String>()(textureName);
+                const auto combine = [&result](const size_t h) { result ^= h + 0x9e3779b9 + (result << 6) + (result >> 2); };
+                const std::hash<float> hashFloat;
+                for (size_t i = 0; i < 2; ++i) {
+                    combine(hashFloat(offset[i]));
+                    combine(hashFloat(scale[i]));
+                }
+                combine(hashFloat(rotation));
+                combine(std::hash<int>()(surfaceContents));
+                combine(std::hash<int>()(surfaceFlags));
+                combine(hashFloat(surfaceValue));
+                for (size_t i = 0; i < 4; ++i)
+                    combine(hashFloat(color[i]));
+                return result;
+            }
+        };
+
+        /**
+         * The table of interned attribute blocks. An interned block is removed from the table when its last reference
+         * is released. Since the table can be accessed from several threads, e.g. when faces are created while a map
+         * is loaded, all accesses are synchronized, including the release of the last reference.
+         */
+        class BrushFaceAttributes::DataTable {
+        private:
+            struct Hash {
+                size_t operator()(const Data* data) const { return data->hash(); }
+            };
+
+            struct Equal {
+                // compare the addresses first, otherwise a block with NaN values is not equal to itself and could not
+                // be erased from the table
+                bool operator()(const Data* lhs, const Data* rhs) const { return lhs == rhs || *lhs == *rhs; }
+            };
+
+            std::unordered_set<Data*, Hash, Equal> m_data;
+            mutable std::mutex m_mutex;
+        public:
+            static DataTable& instance() {
+                // intentionally leaked so that faces can outlive static destruction
+                static DataTable* table = new DataTable();
+                return *table;
+            }
+
+            Data* intern(Data* data) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const auto it = m_data.find(data);
+                if (it != std::end(m_data))
+                    return (*it)->acquire();
+
+                Data* result = new Data(*data);
+                result->interned = true;
+                m_data.insert(result);
+                return result;
+            }
+
+            void release(Data* data) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--data->refCount == 0) {
+                    m_data.erase(data);
+                    delete data;
+                }
+            }
+
+            size_t size() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_data.size();
+            }
+        };
+
+        void BrushFaceAttributes::Data::release() {
+            if (interned) {
+                DataTable::instance().release(this);
+            } else if (--refCount == 0) {
+                delete this;
+            }
+        }
+
         BrushFaceAttributes::BrushFaceAttributes(const String& textureName) :
-        m_textureName(textureName),
-        m_texture(nullptr),
-        m_offset(vm::vec2f::zero),
-        m_scale(vm::vec2f(1.0f, 1.0f)),
-        m_rotation(0.0f),
-        m_surfaceContents(0),
-        m_surfaceFlags(0),
-        m_surfaceValue(0.0f) {}
+        m_data(new Data(textureName)),
+        m_texture(nullptr) {}
 
         BrushFaceAttributes::BrushFaceAttributes(const BrushFaceAttributes& other) :
-        m_textureName(other.m_textureName),
-        m_texture(other.m_texture),
-        m_offset(other.m_offset),
-        m_scale(other.m_scale),
-        m_rotation(other.m_rotation),
-        m_surfaceContents(other.m_surfaceContents),
-        m_surfaceFlags(other.m_surfaceFlags),
-        m_surfaceValue(other.m_surfaceValue),
-        m_color(other.m_color) {
+        m_data(other.m_data->acquire()),
+        m_texture(other.m_texture) {
             if (m_texture != nullptr) {
                 m_texture->incUsageCount();
             }
@@ -54,6 +187,9 @@ namespace TrenchBroom {
             if (m_texture != nullptr) {
                 m_texture->decUsageCount();
             }
+            if (m_data != nullptr) {
+                m_data->release();
+            }
         }
 
         BrushFaceAttributes& BrushFaceAttributes::operator=(BrushFaceAttributes other) {
@@ -64,31 +200,38 @@ namespace TrenchBroom {
 
         void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs) {
             using std::swap;
-            swap(lhs.m_textureName, rhs.m_textureName);
+            swap(lhs.m_data, rhs.m_data);
             swap(lhs.m_texture, rhs.m_texture);
-            swap(lhs.m_offset, rhs.m_offset);
-            swap(lhs.m_scale, rhs.m_scale);
-            swap(lhs.m_rotation, rhs.m_rotation);
-            swap(lhs.m_surfaceContents, rhs.m_surfaceContents);
-            swap(lhs.m_surfaceFlags, rhs.m_surfaceFlags);
-            swap(lhs.m_surfaceValue, rhs.m_surfaceValue);
-            swap(lhs.m_color, rhs.m_color);
         }
 
         BrushFaceAttributes BrushFaceAttributes::takeSnapshot() const {
-            BrushFaceAttributes result(m_textureName);
-            result.m_offset = m_offset;
-            result.m_scale = m_scale;
-            result.m_rotation = m_rotation;
-            result.m_surfaceContents = m_surfaceContents;
-            result.m_surfaceFlags = m_surfaceFlags;
-            result.m_surfaceValue = m_surfaceValue;
-            result.m_color = m_color;
+            BrushFaceAttributes result(*this);
+            result.setTexture(nullptr);
             return result;
         }
 
+        bool BrushFaceAttributes::hasSameValues(const BrushFaceAttributes& other) const {
+            return m_data == other.m_data || *m_data == *other.m_data;
+        }
+
+        void BrushFaceAttributes::intern() {
+            if (!m_data->interned) {
+                Data* interned = DataTable::instance().intern(m_data);
+                m_data->release();
+                m_data = interned;
+            }
+        }
+
+        size_t BrushFaceAttributes::internedCount() {
+            return DataTable::instance().size();
+        }
+
+        size_t BrushFaceAttributes::sharedSize() const {
+            return sizeof(Data) + (m_data->textureName.capacity() > String().capacity() ? m_data->textureName.capacity() + 1 : 0);
+        }
+
         const String& BrushFaceAttributes::textureName() const {
-            return m_textureName;
+            return m_data->textureName;
         }
 
         Assets::Texture* BrushFaceAttributes::texture() const {
@@ -105,15 +248,15 @@ namespace TrenchBroom {
         }
 
         const vm::vec2f& BrushFaceAttributes::offset() const {
-            return m_offset;
+            return m_data->offset;
         }
 
         float BrushFaceAttributes::xOffset() const {
-            return m_offset.x();
+            return m_data->offset.x();
         }
 
         float BrushFaceAttributes::yOffset() const {
-            return m_offset.y();
+            return m_data->offset.y();
         }
 
         vm::vec2f BrushFaceAttributes::modOffset(const vm::vec2f& offset) const {
@@ -121,31 +264,31 @@ namespace TrenchBroom {
         }
 
         const vm::vec2f& BrushFaceAttributes::scale() const {
-            return m_scale;
+            return m_data->scale;
         }
 
         float BrushFaceAttributes::xScale() const {
-            return m_scale.x();
+            return m_data->scale.x();
         }
 
         float BrushFaceAttributes::yScale() const {
-            return m_scale.y();
+            return m_data->scale.y();
         }
 
         float BrushFaceAttributes::rotation() const {
-            return m_rotation;
+            return m_data->rotation;
         }
 
         int BrushFaceAttributes::surfaceContents() const {
-            return m_surfaceContents;
+            return m_data->surfaceContents;
         }
 
         int BrushFaceAttributes::surfaceFlags() const {
-            return m_surfaceFlags;
+            return m_data->surfaceFlags;
         }
 
         float BrushFaceAttributes::surfaceValue() const {
-            return m_surfaceValue;
+            return m_data->surfaceValue;
         }
 
         void BrushFaceAttributes::setTexture(Assets::Texture* texture) {
@@ -155,7 +298,9 @@ namespace TrenchBroom {
             m_texture = texture;
             if (m_texture != nullptr) {
                 m_texture->incUsageCount();
-                m_textureName = m_texture->name();
+                if (m_data->textureName != m_texture->name()) {
+                    mutableData().textureName = m_texture->name();
+                }
             }
         }
 
@@ -164,59 +309,70 @@ namespace TrenchBroom {
                 m_texture->decUsageCount();
             }
             m_texture = nullptr;
-            m_textureName = BrushFace::NoTextureName;
+            if (m_data->textureName != BrushFace::NoTextureName) {
+                mutableData().textureName = BrushFace::NoTextureName;
+            }
         }
 
         bool BrushFaceAttributes::valid() const {
-            return !vm::isZero(m_scale.x(), vm::Cf::almostZero()) && !vm::isZero(m_scale.y(), vm::Cf::almostZero());
+            return !vm::isZero(m_data->scale.x(), vm::Cf::almostZero()) && !vm::isZero(m_data->scale.y(), vm::Cf::almostZero());
         }
 
         void BrushFaceAttributes::setOffset(const vm::vec2f& offset) {
-            m_offset = offset;
+            mutableData().offset = offset;
         }
 
         void BrushFaceAttributes::setXOffset(const float xOffset) {
-            m_offset[0] = xOffset;
+            mutableData().offset[0] = xOffset;
         }
 
         void BrushFaceAttributes::setYOffset(const float yOffset) {
-            m_offset[1] = yOffset;
+            mutableData().offset[1] = yOffset;
         }
 
         void BrushFaceAttributes::setScale(const vm::vec2f& scale) {
-            m_scale = scale;
+            mutableData().scale = scale;
         }
 
         void BrushFaceAttributes::setXScale(const float xScale) {
-            m_scale[0] = xScale;
+            mutableData().scale[0] = xScale;
         }
 
         void BrushFaceAttributes::setYScale(const float yScale) {
-            m_scale[1] = yScale;
+            mutableData().scale[1] = yScale;
         }
 
         void BrushFaceAttributes::setRotation(const float rotation) {
-            m_rotation = rotation;
+            mutableData().rotation = rotation;
         }
 
         void BrushFaceAttributes::setSurfaceContents(const int surfaceContents) {
-            m_surfaceContents = surfaceContents;
+            mutableData().surfaceContents = surfaceContents;
         }
 
         void BrushFaceAttributes::setSurfaceFlags(const int surfaceFlags) {
-            m_surfaceFlags = surfaceFlags;
+            mutableData().surfaceFlags = surfaceFlags;
         }
 
         void BrushFaceAttributes::setSurfaceValue(const float surfaceValue) {
-            m_surfaceValue = surfaceValue;
+            mutableData().surfaceValue = surfaceValue;
         }
 
         const Color& BrushFaceAttributes::color() const {
-            return m_color;
+            return m_data->color;
         }
 
         void BrushFaceAttributes::setColor(const Color& color) {
-            m_color = color;
+            mutableData().color = color;
+        }
+
+        BrushFaceAttributes::Data& BrushFaceAttributes::mutableData() {
+            if (m_data->shared()) {
+                Data* copy = new Data(*m_data);
+                m_data->release();
+                m_data = copy;
+            }
+            return *m_data;
         }
     }
 }
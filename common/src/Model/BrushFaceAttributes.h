@@ -32,20 +32,21 @@ namespace TrenchBroom {
     }
 
     namespace Model {
+        /**
+         * The texture and surface attributes of a brush face.
+         *
+         * Instances have value semantics, but the attribute values are stored in a reference counted block that is
+         * shared by copies and only cloned when a copy is modified. Calling intern() additionally shares the block with
+         * all other interned instances that have equal values, so that faces with the same attributes, which are very
+         * common in a map, need not store their own copy.
+         */
         class BrushFaceAttributes {
         private:
-            String m_textureName;
-            Assets::Texture* m_texture;
-
-            vm::vec2f m_offset;
-            vm::vec2f m_scale;
-            float m_rotation;
-
-            int m_surfaceContents;
-            int m_surfaceFlags;
-            float m_surfaceValue;
+            class Data;
+            class DataTable;
 
-            Color m_color;
+            Data* m_data;
+            Assets::Texture* m_texture;
         public:
             BrushFaceAttributes(const String& textureName);
             BrushFaceAttributes(const BrushFaceAttributes& other);
@@ -55,6 +56,28 @@ namespace TrenchBroom {
 
             BrushFaceAttributes takeSnapshot() const;
 
+            /**
+             * Indicates whether this instance and the given one have equal attribute values. The textures are not
+             * compared, since they are determined by the texture names.
+             */
+            bool hasSameValues(const BrushFaceAttributes& other) const;
+
+            /**
+             * Replaces this instance's attribute values by an interned block with equal values, which is created if
+             * no such block exists.
+             */
+            void intern();
+
+            /**
+             * Returns the number of distinct interned attribute blocks.
+             */
+            static size_t internedCount();
+
+            /**
+             * Returns the number of bytes used by the attribute values shared by this instance and its copies.
+             */
+            size_t sharedSize() const;
+
             const String& textureName() const;
             Assets::Texture* texture() const;
             vm::vec2f textureSize() const;
@@ -92,6 +115,8 @@ namespace TrenchBroom {
 
             const Color& color() const;
             void setColor(const Color& color);
+        private:
+            Data& mutableData();
         };
     }
 }
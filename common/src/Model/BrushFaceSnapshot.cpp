@@ -35,5 +35,12 @@ namespace TrenchBroom {
                 face->restoreTexCoordSystemSnapshot(*m_coordSystemSnapshot);
             }
         }
+
+        size_t BrushFaceSnapshot::memorySize() const {
+            size_t result = sizeof(BrushFaceSnapshot);
+            if (m_coordSystemSnapshot != nullptr)
+                result += m_coordSystemSnapshot->memorySize();
+            return result;
+        }
     }
 }
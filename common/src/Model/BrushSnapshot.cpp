@@ -19,32 +19,197 @@
 
 #include "BrushSnapshot.h"
 
-#include "CollectionUtils.h"
+#include "Ensure.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
+#include "Model/TexCoordSystem.h"
+
+#include <limits>
 
 namespace TrenchBroom {
     namespace Model {
+        BrushSnapshot::FaceRecord::FaceRecord(const BrushFace* face) :
+        points{ face->points()[0], face->points()[1], face->points()[2] },
+        attribs(face->attribs().takeSnapshot()),
+        coordSystemSnapshot(face->takeTexCoordSystemSnapshot()),
+        lineNumber(face->lineNumber()),
+        lineCount(face->lineCount()),
+        selected(face->selected()) {}
+
+        BrushFace* BrushSnapshot::FaceRecord::restore(const BrushFace* prototype) const {
+            // all faces of a brush use the same kind of texture coordinate system, so any face can provide it
+            BrushFace* face = new BrushFace(points[0], points[1], points[2], attribs, prototype->cloneTexCoordSystem());
+            if (coordSystemSnapshot != nullptr)
+                face->restoreTexCoordSystemSnapshot(*coordSystemSnapshot);
+            face->setFilePosition(lineNumber, lineCount);
+            if (selected)
+                face->select();
+            return face;
+        }
+
+        bool BrushSnapshot::FaceRecord::matches(const BrushFace* face) const {
+            const BrushFace::Points& facePoints = face->points();
+            return (points[0] == facePoints[0] &&
+                    points[1] == facePoints[1] &&
+                    points[2] == facePoints[2] &&
+                    attribs.hasSameValues(face->attribs()) &&
+                    (coordSystemSnapshot == nullptr || face->texCoordSystemMatches(*coordSystemSnapshot)) &&
+                    lineNumber == face->lineNumber() &&
+                    lineCount == face->lineCount() &&
+                    selected == face->selected());
+        }
+
+        const size_t BrushSnapshot::RecordedFace = std::numeric_limits<size_t>::max();
+
         BrushSnapshot::BrushSnapshot(Brush* brush) :
         m_brush(brush) {
             takeSnapshot(brush);
         }
 
-        BrushSnapshot::~BrushSnapshot() {
-            VectorUtils::clearAndDelete(m_faces);
-        }
+        BrushSnapshot::~BrushSnapshot() = default;
 
         void BrushSnapshot::takeSnapshot(Brush* brush) {
-            for (BrushFace* face : brush->faces()) {
-                BrushFace *faceClone = face->clone();
-                faceClone->setTexture(nullptr);
-                m_faces.push_back(faceClone);
-            }
+            const BrushFaceList& faces = brush->faces();
+            m_faces.reserve(faces.size());
+            for (const BrushFace* face : faces)
+                m_faces.emplace_back(face);
         }
 
         void BrushSnapshot::doRestore(const vm::bbox3& worldBounds) {
-            m_brush->setFaces(worldBounds, m_faces);
+            ensure(!m_brush->faces().empty(), "brush has no faces");
+            const BrushFace* prototype = m_brush->faces().front();
+
+            BrushFaceList faces;
+            if (m_faceIndices.empty()) {
+                faces.reserve(m_faces.size());
+                for (const FaceRecord& record : m_faces)
+                    faces.push_back(record.restore(prototype));
+            } else {
+                const BrushFaceList& current = m_brush->faces();
+                auto record = std::begin(m_faces);
+
+                faces.reserve(m_faceIndices.size());
+                for (const size_t index : m_faceIndices) {
+                    if (index == RecordedFace) {
+                        assert(record != std::end(m_faces));
+                        faces.push_back(record->restore(prototype));
+                        ++record;
+                    } else {
+                        ensure(index < current.size(), "brush was changed after its snapshot was compacted");
+                        faces.push_back(current[index]->clone());
+                    }
+                }
+            }
+
+            m_brush->setFaces(worldBounds, faces);
             m_faces.clear();
+            m_faceIndices.clear();
+        }
+
+        void BrushSnapshot::doCompact() {
+            assert(m_faceIndices.empty());
+
+            const BrushFaceList& current = m_brush->faces();
+            std::vector<bool> used(current.size(), false);
+
+            std::vector<FaceRecord> changed;
+            std::vector<size_t> indices;
+            indices.reserve(m_faces.size());
+
+            for (size_t i = 0; i < m_faces.size(); ++i) {
+                FaceRecord& record = m_faces[i];
+
+                // most operations keep the order of the faces, so try the face at the same position first
+                size_t index = RecordedFace;
+                if (i < current.size() && !used[i] && record.matches(current[i])) {
+                    index = i;
+                } else {
+                    for (size_t j = 0; j < current.size() && index == RecordedFace; ++j) {
+                        if (!used[j] && record.matches(current[j]))
+                            index = j;
+                    }
+                }
+
+                if (index == RecordedFace) {
+                    changed.push_back(std::move(record));
+                } else {
+                    used[index] = true;
+                }
+                indices.push_back(index);
+            }
+
+            if (changed.size() < m_faces.size()) {
+                m_faces = std::move(changed);
+                m_faces.shrink_to_fit();
+                m_faceIndices = std::move(indices);
+            }
+        }
+
+        void BrushSnapshot::doCollate(const BrushSnapshotMap& nextSnapshots) {
+            if (m_faceIndices.empty())
+                return;
+
+            const auto it = nextSnapshots.find(m_brush);
+            if (it == std::end(nextSnapshots))
+                return;
+
+            // the faces this snapshot refers to are the faces that the next snapshot restores
+            BrushSnapshot& next = *it->second;
+            const size_t nextFaceCount = next.m_faceIndices.empty() ? next.m_faces.size() : next.m_faceIndices.size();
+
+            std::vector<size_t> nextRecords;
+            nextRecords.reserve(nextFaceCount);
+            for (size_t i = 0, record = 0; i < nextFaceCount; ++i) {
+                if (next.m_faceIndices.empty() || next.m_faceIndices[i] == RecordedFace) {
+                    nextRecords.push_back(record++);
+                } else {
+                    nextRecords.push_back(RecordedFace);
+                }
+            }
+
+            std::vector<FaceRecord> faces;
+            std::vector<size_t> indices;
+            indices.reserve(m_faceIndices.size());
+
+            auto record = std::begin(m_faces);
+            bool referencesFaces = false;
+            for (const size_t index : m_faceIndices) {
+                if (index == RecordedFace) {
+                    faces.push_back(std::move(*record));
+                    ++record;
+                    indices.push_back(RecordedFace);
+                } else {
+                    ensure(index < nextFaceCount, "snapshots do not belong to consecutive commands");
+                    if (nextRecords[index] != RecordedFace) {
+                        faces.push_back(std::move(next.m_faces[nextRecords[index]]));
+                        indices.push_back(RecordedFace);
+                    } else {
+                        indices.push_back(next.m_faceIndices[index]);
+                        referencesFaces = true;
+                    }
+                }
+            }
+
+            m_faces = std::move(faces);
+            if (referencesFaces) {
+                m_faceIndices = std::move(indices);
+            } else {
+                m_faceIndices.clear();
+            }
+        }
+
+        void BrushSnapshot::doCollectBrushSnapshots(BrushSnapshotMap& result) {
+            result[m_brush] = this;
+        }
+
+        size_t BrushSnapshot::doGetMemorySize() const {
+            size_t result = sizeof(BrushSnapshot) + m_faces.capacity() * sizeof(FaceRecord);
+            result += m_faceIndices.capacity() * sizeof(size_t);
+            for (const FaceRecord& record : m_faces) {
+                if (record.coordSystemSnapshot != nullptr)
+                    result += record.coordSystemSnapshot->memorySize();
+            }
+            return result;
         }
     }
 }
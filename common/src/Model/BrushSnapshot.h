@@ -20,26 +20,66 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "Model/BrushFaceAttributes.h"
 #include "Model/ModelTypes.h"
 #include "Model/NodeSnapshot.h"
 
+#include <vecmath/vec.h>
+
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         class Brush;
-        class BrushFaceSnapshot;
+        class BrushFace;
+        class TexCoordSystemSnapshot;
 
+        /**
+         * Records the faces of a brush so that they can be restored later.
+         *
+         * Instead of cloning the faces, only the plane points, the attributes and the texture coordinate system
+         * state of each face are stored. The attributes share their values with the brush's faces, so a snapshot
+         * only pays for attributes that change afterwards. The faces are recreated when the snapshot is restored.
+         *
+         * Once the snapshot is compacted, it only keeps the records of the faces that were changed, and refers to
+         * the unchanged faces by their index in the brush. These faces are cloned when the snapshot is restored.
+         */
         class BrushSnapshot : public NodeSnapshot {
         private:
+            struct FaceRecord {
+                vm::vec3 points[3];
+                BrushFaceAttributes attribs;
+                std::unique_ptr<TexCoordSystemSnapshot> coordSystemSnapshot;
+                size_t lineNumber;
+                size_t lineCount;
+                bool selected;
+
+                explicit FaceRecord(const BrushFace* face);
+                BrushFace* restore(const BrushFace* prototype) const;
+                bool matches(const BrushFace* face) const;
+            };
+
+            static const size_t RecordedFace;
+
             Brush* m_brush;
-            BrushFaceList m_faces;
+            std::vector<FaceRecord> m_faces;
+
+            /**
+             * Empty unless the snapshot has been compacted. Otherwise, contains for every face to restore either the
+             * index of the equal face of the brush or RecordedFace if the face is the next one in m_faces.
+             */
+            std::vector<size_t> m_faceIndices;
         public:
             BrushSnapshot(Brush* brush);
             ~BrushSnapshot() override;
         private:
             void takeSnapshot(Brush* brush);
             void doRestore(const vm::bbox3& worldBounds) override;
+            void doCompact() override;
+            void doCollate(const BrushSnapshotMap& nextSnapshots) override;
+            void doCollectBrushSnapshots(BrushSnapshotMap& result) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CloneNodesInParallel.h"
+
+#include "Parallel.h"
+#include "Model/Brush.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Clones the nodes of a forest, leaving a slot for every brush clone to be filled in later.
+         */
+        class ParallelNodeCloner : public ConstNodeVisitor {
+        private:
+            struct BrushClone {
+                const Brush* original;
+                BrushFaceList faceClones;
+                size_t slot;
+            };
+
+            struct ChildSlots {
+                Node* parent;
+                size_t first;
+                size_t count;
+            };
+
+            const vm::bbox3& m_worldBounds;
+            NodeList m_slots;
+            std::vector<ChildSlots> m_childSlots;
+            std::vector<BrushClone> m_brushClones;
+
+            size_t m_currentSlot;
+        public:
+            explicit ParallelNodeCloner(const vm::bbox3& worldBounds) :
+            m_worldBounds(worldBounds),
+            m_currentSlot(0) {}
+
+            NodeList clone(const NodeList& nodes) {
+                cloneChildren(nodes);
+
+                parallelFor(m_brushClones.size(), [&](const size_t i) {
+                    BrushClone& brushClone = m_brushClones[i];
+                    m_slots[brushClone.slot] = brushClone.original->clone(m_worldBounds, brushClone.faceClones);
+                });
+
+                for (const ChildSlots& childSlots : m_childSlots) {
+                    const auto first = std::begin(m_slots) + static_cast<NodeList::difference_type>(childSlots.first);
+                    childSlots.parent->addChildren(NodeList(first, first + static_cast<NodeList::difference_type>(childSlots.count)));
+                }
+
+                return NodeList(std::begin(m_slots), std::begin(m_slots) + static_cast<NodeList::difference_type>(nodes.size()));
+            }
+        private:
+            /**
+             * Reserves consecutive slots for the clones of the given nodes, and clones them into these slots.
+             */
+            size_t cloneChildren(const NodeList& nodes) {
+                const size_t first = m_slots.size();
+                m_slots.resize(first + nodes.size(), nullptr);
+                for (size_t i = 0; i < nodes.size(); ++i) {
+                    m_currentSlot = first + i;
+                    nodes[i]->accept(*this);
+                }
+                return first;
+            }
+
+            void doVisit(const World* world) override {
+                m_slots[m_currentSlot] = world->cloneRecursively(m_worldBounds);
+            }
+
+            void doVisit(const Layer* layer) override   { cloneNode(layer); }
+            void doVisit(const Group* group) override   { cloneNode(group); }
+            void doVisit(const Entity* entity) override { cloneNode(entity); }
+
+            void doVisit(const Brush* brush) override {
+                m_brushClones.push_back(BrushClone { brush, brush->cloneFaces(), m_currentSlot });
+            }
+
+            void cloneNode(const Node* node) {
+                Node* clone = node->clone(m_worldBounds);
+                m_slots[m_currentSlot] = clone;
+
+                if (node->hasChildren()) {
+                    const size_t first = cloneChildren(node->children());
+                    m_childSlots.push_back(ChildSlots { clone, first, node->childCount() });
+                }
+            }
+        };
+
+        NodeList cloneRecursivelyInParallel(const vm::bbox3& worldBounds, const NodeList& nodes) {
+            ParallelNodeCloner cloner(worldBounds);
+            return cloner.clone(nodes);
+        }
+    }
+}
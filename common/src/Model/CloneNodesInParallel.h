@@ -0,0 +1,45 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_CloneNodesInParallel
+#define TrenchBroom_CloneNodesInParallel
+
+#include "Model/ModelTypes.h"
+
+#include <vecmath/forward.h>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Clones the given nodes recursively, like calling cloneRecursively on each of them, and returns the clones in
+         * the same order.
+         *
+         * All nodes other than brushes, as well as the faces of the brushes, are cloned on the calling thread. The
+         * brushes themselves are then created in parallel, and they copy the geometry of the original brushes instead
+         * of building it again. Finally, the clones are added to their parents in their original order.
+         *
+         * @param worldBounds the world bounds
+         * @param nodes the nodes to clone
+         * @return the clones, which are owned by the caller
+         */
+        NodeList cloneRecursivelyInParallel(const vm::bbox3& worldBounds, const NodeList& nodes);
+    }
+}
+
+#endif /* defined(TrenchBroom_CloneNodesInParallel) */
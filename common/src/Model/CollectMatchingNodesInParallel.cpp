@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "CollectMatchingNodesInParallel.h"
+
+#include "Model/Brush.h"
+#include "Model/EditorContext.h"
+#include "Model/World.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace TrenchBroom {
+    namespace Model {
+        static void flattenNode(Node* node, NodeSequence& sequence) {
+            const size_t index = sequence.nodes.size();
+            sequence.nodes.push_back(node);
+            sequence.subtreeEnds.push_back(0);
+
+            for (Node* child : node->children())
+                flattenNode(child, sequence);
+            sequence.subtreeEnds[index] = sequence.nodes.size();
+        }
+
+        NodeSequence flattenNodes(const NodeList& roots) {
+            NodeSequence result;
+            for (Node* root : roots)
+                flattenNode(root, result);
+            return result;
+        }
+
+        /**
+         * Maps every node in the spatial index of the given world whose bounds intersect the bounds of any of the
+         * given brushes to those brushes. Only these nodes can intersect or be contained in the brushes.
+         */
+        static std::unordered_map<const Node*, BrushList> findIntersectionCandidates(const World* world, const BrushList& brushes) {
+            std::unordered_map<const Node*, BrushList> result;
+            NodeList nodes;
+            for (Brush* brush : brushes) {
+                nodes.clear();
+                world->findNodesIntersecting(brush->bounds(), nodes);
+                for (const Node* node : nodes)
+                    result[node].push_back(brush);
+            }
+            return result;
+        }
+
+        NodeList findTouchingNodes(const World* world, const BrushList& brushes, const EditorContext& editorContext) {
+            const auto candidates = findIntersectionCandidates(world, brushes);
+            const std::unordered_set<const Node*> query(std::begin(brushes), std::end(brushes));
+
+            const auto test = [&](const Node* node) {
+                // if `node` is one of the search query nodes, don't count it as touching
+                return candidates.count(node) > 0 && query.count(node) == 0;
+            };
+            const auto touching = [&](const Node* node) {
+                if (!editorContext.selectable(node))
+                    return false;
+                const BrushList& touched = candidates.at(node);
+                return std::any_of(std::begin(touched), std::end(touched), [node](const Brush* brush) { return brush->intersects(node); });
+            };
+            return collectMatchingNodesInParallel(world->children(), test, touching);
+        }
+
+        NodeList findContainedNodes(const World* world, const BrushList& brushes, const EditorContext& editorContext) {
+            const auto candidates = findIntersectionCandidates(world, brushes);
+
+            const auto test = [&](const Node* node) {
+                return candidates.count(node) > 0;
+            };
+            const auto contained = [&](const Node* node) {
+                if (!editorContext.selectable(node))
+                    return false;
+                const BrushList& containing = candidates.at(node);
+                return std::any_of(std::begin(containing), std::end(containing), [node](const Brush* brush) { return brush != node && brush->contains(node); });
+            };
+            return collectMatchingNodesInParallel(world->children(), test, contained);
+        }
+    }
+}
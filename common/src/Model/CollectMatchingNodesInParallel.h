@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TrenchBroom_CollectMatchingNodesInParallel
+#define TrenchBroom_CollectMatchingNodesInParallel
+
+#include "Parallel.h"
+#include "Model/ModelTypes.h"
+#include "Model/Node.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class EditorContext;
+        class World;
+
+        /**
+         * The nodes of one or more subtrees in the order in which a node visitor visits them. The subtree of the
+         * node at index i consists of the nodes at the indices [i, subtreeEnds[i]).
+         */
+        struct NodeSequence {
+            NodeList nodes;
+            std::vector<size_t> subtreeEnds;
+        };
+
+        NodeSequence flattenNodes(const NodeList& roots);
+
+        /**
+         * Collects the nodes in the subtrees of the given roots that match the given predicate, in the order in which
+         * a CollectMatchingNodesVisitor with StopRecursionIfMatched collects them. The descendants of a matching
+         * node are skipped.
+         *
+         * The nodes are first filtered with the given test on the calling thread, which should be cheap, e.g. a
+         * lookup in a set of candidates. The predicate is then evaluated for the remaining nodes in parallel, so it
+         * must be safe to call concurrently. The bounds of the tested nodes are validated beforehand so that the
+         * predicate may use them.
+         *
+         * @param roots the roots of the subtrees to search, which are included in the search
+         * @param test the test that selects the nodes for which the predicate is evaluated
+         * @param predicate the predicate to evaluate
+         * @return the matching nodes
+         */
+        template <typename T, typename P>
+        NodeList collectMatchingNodesInParallel(const NodeList& roots, const T& test, const P& predicate) {
+            const NodeSequence sequence = flattenNodes(roots);
+            const NodeList& nodes = sequence.nodes;
+
+            std::vector<size_t> tested;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (test(nodes[i])) {
+                    nodes[i]->bounds();
+                    tested.push_back(i);
+                }
+            }
+
+            std::vector<char> matches(nodes.size(), 0);
+            parallelFor(tested.size(), [&](const size_t i) {
+                const size_t index = tested[i];
+                matches[index] = predicate(nodes[index]) ? 1 : 0;
+            }, 64);
+
+            NodeList result;
+            size_t i = 0;
+            while (i < nodes.size()) {
+                if (matches[i]) {
+                    result.push_back(nodes[i]);
+                    i = sequence.subtreeEnds[i];
+                } else {
+                    ++i;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Returns the selectable nodes of the given world that intersect any of the given brushes, except for the
+         * brushes themselves, in the order in which CollectTouchingNodesVisitor returns them.
+         */
+        NodeList findTouchingNodes(const World* world, const BrushList& brushes, const EditorContext& editorContext);
+
+        /**
+         * Returns the selectable nodes of the given world that are contained in any of the given brushes, in the
+         * order in which CollectContainedNodesVisitor returns them.
+         */
+        NodeList findContainedNodes(const World* world, const BrushList& brushes, const EditorContext& editorContext);
+    }
+}
+
+#endif /* defined(TrenchBroom_CollectMatchingNodesInParallel) */
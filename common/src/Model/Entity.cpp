@@ -52,6 +52,7 @@ namespace TrenchBroom {
         AttributableNode(),
         Object(),
         m_boundsValid(false),
+        m_modelSpecificationValid(false),
         m_modelFrame(nullptr) {
             cacheAttributes();
         }
@@ -114,7 +115,7 @@ namespace TrenchBroom {
         }
 
         void Entity::cacheAttributes() {
-            m_cachedOrigin = vm::vec3::parse(attribute(AttributeNames::Origin, ""), vm::vec3::zero);
+            m_cachedOrigin = vectorAttribute(AttributeNames::Origin, vm::vec3::zero);
             if (vm::isNaN(m_cachedOrigin)) {
                 m_cachedOrigin = vm::vec3::zero;
             }
@@ -129,13 +130,17 @@ namespace TrenchBroom {
             EntityRotationPolicy::applyRotation(this, transformation);
         }
 
-        Assets::ModelSpecification Entity::modelSpecification() const {
-            if (!hasPointEntityDefinition()) {
-                return Assets::ModelSpecification();
-            } else {
-                auto* pointDefinition = static_cast<Assets::PointEntityDefinition*>(m_definition);
-                return pointDefinition->model(m_attributes);
+        const Assets::ModelSpecification& Entity::modelSpecification() const {
+            if (!m_modelSpecificationValid) {
+                if (!hasPointEntityDefinition()) {
+                    m_cachedModelSpecification = Assets::ModelSpecification();
+                } else {
+                    auto* pointDefinition = static_cast<Assets::PointEntityDefinition*>(m_definition);
+                    m_cachedModelSpecification = pointDefinition->model(m_attributes);
+                }
+                m_modelSpecificationValid = true;
             }
+            return m_cachedModelSpecification;
         }
 
         const vm::bbox3& Entity::modelBounds() const {
@@ -320,6 +325,9 @@ namespace TrenchBroom {
         }
 
         void Entity::doAttributesDidChange(const vm::bbox3& oldBounds) {
+            // the model depends on the attributes and on the entity definition, which is also reported as an attribute change
+            m_modelSpecificationValid = false;
+
             // update m_cachedOrigin and m_cachedRotation. Must be done first because nodeBoundsDidChange() might
             // call origin()
             cacheAttributes();
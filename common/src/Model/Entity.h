@@ -23,6 +23,7 @@
 #include "TrenchBroom.h"
 #include "Hit.h"
 #include "Assets/AssetTypes.h"
+#include "Assets/ModelDefinition.h"
 #include "Model/AttributableNode.h"
 #include "Model/EntityRotationPolicy.h"
 #include "Model/Object.h"
@@ -50,6 +51,8 @@ namespace TrenchBroom {
             mutable bool m_boundsValid;
             mutable vm::vec3 m_cachedOrigin;
             mutable vm::mat4x4 m_cachedRotation;
+            mutable Assets::ModelSpecification m_cachedModelSpecification;
+            mutable bool m_modelSpecificationValid;
 
             const Assets::EntityModelFrame* m_modelFrame;
         public:
@@ -73,7 +76,7 @@ namespace TrenchBroom {
             void setOrigin(const vm::vec3& origin);
             void applyRotation(const vm::mat4x4& transformation);
         public: // entity model
-            Assets::ModelSpecification modelSpecification() const;
+            const Assets::ModelSpecification& modelSpecification() const;
             const vm::bbox3& modelBounds() const;
             const Assets::EntityModelFrame* modelFrame() const;
             void setModelFrame(const Assets::EntityModelFrame* modelFrame);
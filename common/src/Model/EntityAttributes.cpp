@@ -22,6 +22,10 @@
 #include "Exceptions.h"
 #include "Assets/EntityDefinition.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
 namespace TrenchBroom {
     namespace Model {
         const String AttributeEscapeChars = "\"\n\\";
@@ -154,6 +158,47 @@ namespace TrenchBroom {
             return defaultValue;
         }
 
+        /**
+         * Returns whether the value of the attribute with the given name is parsed when it is set.
+         */
+        static bool hasTypedValue(const AttributeName& name) {
+            return name == AttributeNames::Origin ||
+                   name == AttributeNames::Angle ||
+                   name == AttributeNames::Angles ||
+                   name == AttributeNames::Mangle;
+        }
+
+        static size_t hashName(const AttributeName& name) {
+            return std::hash<AttributeName>()(name);
+        }
+
+        static vm::vec3 parseVector(const AttributeValue& value, const vm::vec3& defaultValue) {
+            return vm::vec3::parse(value, defaultValue);
+        }
+
+        static FloatType parseNumber(const AttributeValue& value) {
+            return static_cast<FloatType>(std::atof(value.c_str()));
+        }
+
+        EntityAttributes::IndexEntry::IndexEntry(const size_t i_nameHash, EntityAttribute::List::iterator i_attribute) :
+        nameHash(i_nameHash),
+        attribute(i_attribute),
+        hasTypedValue(Model::hasTypedValue(attribute->name())),
+        isVector(false),
+        vectorValue(vm::vec3::zero),
+        numberValue(0.0) {
+            updateTypedValue();
+        }
+
+        void EntityAttributes::IndexEntry::updateTypedValue() {
+            if (hasTypedValue) {
+                const AttributeValue& value = attribute->value();
+                isVector = vm::vec3::canParse(value);
+                vectorValue = parseVector(value, vm::vec3::zero);
+                numberValue = parseNumber(value);
+            }
+        }
+
         const EntityAttribute::List& EntityAttributes::attributes() const {
             return m_attributes;
         }
@@ -164,14 +209,16 @@ namespace TrenchBroom {
         }
 
         const EntityAttribute& EntityAttributes::addOrUpdateAttribute(const AttributeName& name, const AttributeValue& value, const Assets::AttributeDefinition* definition) {
-            EntityAttribute::List::iterator it = findAttribute(name);
-            if (it != std::end(m_attributes)) {
-                assert(it->definition() == definition);
-                it->setValue(value);
-                return *it;
+            auto entryIt = findIndexEntry(name);
+            if (entryIt != std::end(m_index)) {
+                auto& attribute = *entryIt->attribute;
+                assert(attribute.definition() == definition);
+                attribute.setValue(value);
+                entryIt->updateTypedValue();
+                return attribute;
             } else {
                 m_attributes.push_back(EntityAttribute(name, value, definition));
-                m_index.insert(name, --std::end(m_attributes));
+                m_index.emplace_back(hashName(name), --std::end(m_attributes));
                 return m_attributes.back();
             }
         }
@@ -186,11 +233,12 @@ namespace TrenchBroom {
         }
 
         void EntityAttributes::removeAttribute(const AttributeName& name) {
-            EntityAttribute::List::iterator it = findAttribute(name);
-            if (it == std::end(m_attributes))
+            auto entryIt = findIndexEntry(name);
+            if (entryIt == std::end(m_index))
                 return;
-            m_index.remove(name, it);
-            m_attributes.erase(it);
+
+            m_attributes.erase(entryIt->attribute);
+            m_index.erase(entryIt);
         }
 
         void EntityAttributes::updateDefinitions(const Assets::EntityDefinition* entityDefinition) {
@@ -202,7 +250,7 @@ namespace TrenchBroom {
         }
 
         bool EntityAttributes::hasAttribute(const AttributeName& name) const {
-            return findAttribute(name) != std::end(m_attributes);
+            return findIndexEntry(name) != std::end(m_index);
         }
 
         bool EntityAttributes::hasAttribute(const AttributeName& name, const AttributeValue& value) const {
@@ -213,44 +261,26 @@ namespace TrenchBroom {
         }
 
         bool EntityAttributes::hasAttributeWithPrefix(const AttributeName& prefix, const AttributeValue& value) const {
-            return containsValue(m_index.queryPrefixMatches(prefix), value);
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (StringUtils::isPrefix(attribute.name(), prefix) && attribute.value() == value)
+                    return true;
+            }
+            return false;
         }
 
         bool EntityAttributes::hasNumberedAttribute(const AttributeName& prefix, const AttributeValue& value) const {
-            return containsValue(m_index.queryNumberedMatches(prefix), value);
-        }
-
-        EntityAttributeSnapshot EntityAttributes::snapshot(const AttributeName& name) const {
-            const AttributeIndex::QueryResult matches = m_index.queryExactMatches(name);
-            if (matches.empty())
-                return EntityAttributeSnapshot(name);
-
-            assert(matches.size() == 1);
-            return EntityAttributeSnapshot(name, matches.front()->value());
-        }
-
-        bool EntityAttributes::containsValue(const AttributeIndex::QueryResult& matches, const AttributeValue& value) const {
-            if (matches.empty())
-                return false;
-
-            for (auto attrIt : matches) {
-                const EntityAttribute& attribute = *attrIt;
-                if (attribute.value() == value)
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (isNumberedAttribute(prefix, attribute.name()) && attribute.value() == value)
                     return true;
             }
-
             return false;
         }
 
-        EntityAttribute::List EntityAttributes::listFromQueryResult(const AttributeIndex::QueryResult& matches) const {
-            EntityAttribute::List result;
-
-            for (auto attrIt : matches) {
-                const EntityAttribute& attribute = *attrIt;
-                result.push_back(attribute);
-            }
-
-            return result;
+        EntityAttributeSnapshot EntityAttributes::snapshot(const AttributeName& name) const {
+            const EntityAttribute::List::const_iterator it = findAttribute(name);
+            if (it == std::end(m_attributes))
+                return EntityAttributeSnapshot(name);
+            return EntityAttributeSnapshot(name, it->value());
         }
 
         const AttributeNameSet EntityAttributes::names() const {
@@ -274,12 +304,43 @@ namespace TrenchBroom {
             return *value;
         }
 
+        vm::vec3 EntityAttributes::vectorAttribute(const AttributeName& name, const vm::vec3& defaultValue) const {
+            const auto entryIt = findIndexEntry(name);
+            if (entryIt == std::end(m_index))
+                return defaultValue;
+            if (!entryIt->hasTypedValue)
+                return parseVector(entryIt->attribute->value(), defaultValue);
+            return entryIt->isVector ? entryIt->vectorValue : defaultValue;
+        }
+
+        FloatType EntityAttributes::numberAttribute(const AttributeName& name, const FloatType defaultValue) const {
+            const auto entryIt = findIndexEntry(name);
+            if (entryIt == std::end(m_index))
+                return defaultValue;
+            if (!entryIt->hasTypedValue)
+                return parseNumber(entryIt->attribute->value());
+            return entryIt->numberValue;
+        }
+
         EntityAttribute::List EntityAttributes::attributeWithName(const AttributeName& name) const {
-            return listFromQueryResult(m_index.queryExactMatches(name));
+            EntityAttribute::List result;
+
+            const EntityAttribute::List::const_iterator it = findAttribute(name);
+            if (it != std::end(m_attributes))
+                result.push_back(*it);
+
+            return result;
         }
 
         EntityAttribute::List EntityAttributes::attributesWithPrefix(const AttributeName& prefix) const{
-            return listFromQueryResult(m_index.queryPrefixMatches(prefix));
+            EntityAttribute::List result;
+
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (StringUtils::isPrefix(attribute.name(), prefix))
+                    result.push_back(attribute);
+            }
+
+            return result;
         }
 
         EntityAttribute::List EntityAttributes::numberedAttributes(const String& prefix) const {
@@ -293,30 +354,41 @@ namespace TrenchBroom {
             return result;
         }
 
+        EntityAttributes::AttributeIndex::const_iterator EntityAttributes::findIndexEntry(const AttributeName& name) const {
+            const size_t nameHash = hashName(name);
+            return std::find_if(std::begin(m_index), std::end(m_index), [&](const IndexEntry& entry) {
+                return entry.nameHash == nameHash && entry.attribute->name() == name;
+            });
+        }
+
+        EntityAttributes::AttributeIndex::iterator EntityAttributes::findIndexEntry(const AttributeName& name) {
+            const size_t nameHash = hashName(name);
+            return std::find_if(std::begin(m_index), std::end(m_index), [&](const IndexEntry& entry) {
+                return entry.nameHash == nameHash && entry.attribute->name() == name;
+            });
+        }
+
         EntityAttribute::List::const_iterator EntityAttributes::findAttribute(const AttributeName& name) const {
-            const AttributeIndex::QueryResult matches = m_index.queryExactMatches(name);
-            if (matches.empty())
+            const auto entryIt = findIndexEntry(name);
+            if (entryIt == std::end(m_index))
                 return std::end(m_attributes);
-
-            assert(matches.size() == 1);
-            return matches.front();
+            return entryIt->attribute;
         }
 
         EntityAttribute::List::iterator EntityAttributes::findAttribute(const AttributeName& name) {
-            const AttributeIndex::QueryResult matches = m_index.queryExactMatches(name);
-            if (matches.empty())
+            const auto entryIt = findIndexEntry(name);
+            if (entryIt == std::end(m_index))
                 return std::end(m_attributes);
-
-            assert(matches.size() == 1);
-            return matches.front();
+            return entryIt->attribute;
         }
 
         void EntityAttributes::rebuildIndex() {
             m_index.clear();
+            m_index.reserve(m_attributes.size());
 
             for (auto it = std::begin(m_attributes), end = std::end(m_attributes); it != end; ++it) {
                 const EntityAttribute& attribute = *it;
-                m_index.insert(attribute.name(), it);
+                m_index.emplace_back(hashName(attribute.name()), it);
             }
         }
     }
@@ -21,12 +21,14 @@
 #define TrenchBroom_EntityProperties
 
 #include "StringUtils.h"
-#include "StringMap.h"
 #include "Model/EntityAttributeSnapshot.h"
 #include "Model/ModelTypes.h"
 
+#include <vecmath/vec.h>
+
 #include <map>
 #include <list>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -103,13 +105,30 @@ namespace TrenchBroom {
         bool isWorldspawn(const String& classname, const EntityAttribute::List& attributes);
         const AttributeValue& findAttribute(const EntityAttribute::List& attributes, const AttributeName& name, const AttributeValue& defaultValue = EmptyString);
 
+        /**
+         * Stores the attributes of an entity in the order in which they were added.
+         *
+         * Entities have only a handful of attributes, so they are found by scanning a flat index that stores the hash of
+         * each attribute name. The values of the attributes that are read whenever an entity is rendered or transformed,
+         * such as the origin and the angles, are parsed once when they are set and cached in the index.
+         */
         class EntityAttributes {
         private:
             EntityAttribute::List m_attributes;
 
-            using IndexValue = EntityAttribute::List::iterator;
-            using IndexValueContainer = StringMapValueContainer<IndexValue>;
-            using AttributeIndex = StringMap<IndexValue, IndexValueContainer>;
+            struct IndexEntry {
+                size_t nameHash;
+                EntityAttribute::List::iterator attribute;
+                bool hasTypedValue;
+                bool isVector;
+                vm::vec3 vectorValue;
+                FloatType numberValue;
+
+                IndexEntry(size_t i_nameHash, EntityAttribute::List::iterator i_attribute);
+                void updateTypedValue();
+            };
+
+            using AttributeIndex = std::vector<IndexEntry>;
             AttributeIndex m_index;
         public:
             const EntityAttribute::List& attributes() const;
@@ -126,18 +145,30 @@ namespace TrenchBroom {
             bool hasNumberedAttribute(const AttributeName& prefix, const AttributeValue& value) const;
 
             EntityAttributeSnapshot snapshot(const AttributeName& name) const;
-        private:
-            bool containsValue(const AttributeIndex::QueryResult& matches, const AttributeValue& value) const;
-            EntityAttribute::List listFromQueryResult(const AttributeIndex::QueryResult& matches) const;
         public:
             const AttributeNameSet names() const;
             const AttributeValue* attribute(const AttributeName& name) const;
             const AttributeValue& safeAttribute(const AttributeName& name, const AttributeValue& defaultValue) const;
 
+            /**
+             * Returns the value of the attribute with the given name parsed as a vector, or the given default value if
+             * the attribute does not exist or its value cannot be parsed.
+             */
+            vm::vec3 vectorAttribute(const AttributeName& name, const vm::vec3& defaultValue) const;
+
+            /**
+             * Returns the value of the attribute with the given name parsed as a number, or the given default value if
+             * the attribute does not exist. Values that are not numbers are parsed as 0.
+             */
+            FloatType numberAttribute(const AttributeName& name, FloatType defaultValue) const;
+
             EntityAttribute::List attributeWithName(const AttributeName& name) const;
             EntityAttribute::List attributesWithPrefix(const AttributeName& prefix) const;
             EntityAttribute::List numberedAttributes(const String& prefix) const;
         private:
+            AttributeIndex::const_iterator findIndexEntry(const AttributeName& name) const;
+            AttributeIndex::iterator findIndexEntry(const AttributeName& name);
+
             EntityAttribute::List::const_iterator findAttribute(const AttributeName& name) const;
             EntityAttribute::List::iterator findAttribute(const AttributeName& name);
 
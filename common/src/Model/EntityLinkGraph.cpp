@@ -0,0 +1,194 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityLinkGraph.h"
+
+#include "Model/AttributableNode.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Model {
+        bool EntityLinkGraph::NodeRefs::empty() const {
+            return m_entries.empty();
+        }
+
+        void EntityLinkGraph::NodeRefs::add(AttributableNode* node) {
+            const auto it = m_positions.find(node);
+            if (it != std::end(m_positions)) {
+                ++m_entries[it->second].second;
+            } else {
+                m_positions.emplace(node, m_entries.size());
+                m_entries.emplace_back(node, 1u);
+            }
+        }
+
+        void EntityLinkGraph::NodeRefs::remove(AttributableNode* node) {
+            const auto it = m_positions.find(node);
+            assert(it != std::end(m_positions));
+            if (it == std::end(m_positions))
+                return;
+
+            const size_t index = it->second;
+            if (--m_entries[index].second == 0) {
+                const size_t last = m_entries.size() - 1;
+                if (index != last) {
+                    m_entries[index] = m_entries[last];
+                    m_positions[m_entries[index].first] = index;
+                }
+                m_entries.pop_back();
+                m_positions.erase(it);
+            }
+        }
+
+        void EntityLinkGraph::NodeRefs::appendTo(AttributableNodeList& result) const {
+            forEach([&result](AttributableNode* node) { result.push_back(node); });
+        }
+
+        void EntityLinkGraph::NodeRefs::invalidateIssues() const {
+            for (const auto& entry : m_entries)
+                entry.first->invalidateIssues();
+        }
+
+        bool EntityLinkGraph::Bucket::hasSources() const {
+            return !linkSources.empty() || !killSources.empty();
+        }
+
+        bool EntityLinkGraph::Bucket::empty() const {
+            return targets.empty() && !hasSources();
+        }
+
+        EntityLinkGraph::EntityLinkGraph() = default;
+
+        void EntityLinkGraph::addAttribute(AttributableNode* node, const AttributeName& name, const AttributeValue& value) {
+            if (value.empty())
+                return;
+
+            if (name == AttributeNames::Targetname)
+                addTarget(node, value);
+            else if (isNumberedAttribute(AttributeNames::Target, name))
+                addSource(node, value, &Bucket::linkSources);
+            else if (isNumberedAttribute(AttributeNames::Killtarget, name))
+                addSource(node, value, &Bucket::killSources);
+        }
+
+        void EntityLinkGraph::removeAttribute(AttributableNode* node, const AttributeName& name, const AttributeValue& value) {
+            if (value.empty())
+                return;
+
+            if (name == AttributeNames::Targetname)
+                removeTarget(node, value);
+            else if (isNumberedAttribute(AttributeNames::Target, name))
+                removeSource(node, value, &Bucket::linkSources);
+            else if (isNumberedAttribute(AttributeNames::Killtarget, name))
+                removeSource(node, value, &Bucket::killSources);
+        }
+
+        bool EntityLinkGraph::hasTargets(const AttributeValue& targetname) const {
+            const Bucket* bucket = findBucket(targetname);
+            return bucket != nullptr && !bucket->targets.empty();
+        }
+
+        bool EntityLinkGraph::hasSources(const AttributeValue& targetname) const {
+            const Bucket* bucket = findBucket(targetname);
+            return bucket != nullptr && bucket->hasSources();
+        }
+
+        void EntityLinkGraph::findTargets(const AttributeValue& targetname, AttributableNodeList& result) const {
+            const Bucket* bucket = findBucket(targetname);
+            if (bucket != nullptr)
+                bucket->targets.appendTo(result);
+        }
+
+        void EntityLinkGraph::findLinkSources(const AttributeValue& targetname, AttributableNodeList& result) const {
+            const Bucket* bucket = findBucket(targetname);
+            if (bucket != nullptr)
+                bucket->linkSources.appendTo(result);
+        }
+
+        void EntityLinkGraph::findKillSources(const AttributeValue& targetname, AttributableNodeList& result) const {
+            const Bucket* bucket = findBucket(targetname);
+            if (bucket != nullptr)
+                bucket->killSources.appendTo(result);
+        }
+
+        const EntityLinkGraph::Bucket* EntityLinkGraph::findBucket(const AttributeValue& targetname) const {
+            const auto it = m_buckets.find(targetname);
+            if (it == std::end(m_buckets))
+                return nullptr;
+            return &it->second;
+        }
+
+        void EntityLinkGraph::removeBucketIfEmpty(BucketMap::iterator it) {
+            if (it->second.empty())
+                m_buckets.erase(it);
+        }
+
+        void EntityLinkGraph::addTarget(AttributableNode* node, const AttributeValue& targetname) {
+            Bucket& bucket = m_buckets[targetname];
+            if (bucket.targets.empty()) {
+                // the sources' missing target issues are resolved now
+                bucket.linkSources.invalidateIssues();
+                bucket.killSources.invalidateIssues();
+            }
+            bucket.targets.add(node);
+            node->invalidateIssues();
+        }
+
+        void EntityLinkGraph::removeTarget(AttributableNode* node, const AttributeValue& targetname) {
+            const auto it = m_buckets.find(targetname);
+            assert(it != std::end(m_buckets));
+            if (it == std::end(m_buckets))
+                return;
+
+            Bucket& bucket = it->second;
+            bucket.targets.remove(node);
+            node->invalidateIssues();
+            if (bucket.targets.empty()) {
+                bucket.linkSources.invalidateIssues();
+                bucket.killSources.invalidateIssues();
+            }
+            removeBucketIfEmpty(it);
+        }
+
+        void EntityLinkGraph::addSource(AttributableNode* node, const AttributeValue& targetname, NodeRefs Bucket::*sources) {
+            Bucket& bucket = m_buckets[targetname];
+            if (!bucket.hasSources()) {
+                // the targets' missing source issues are resolved now
+                bucket.targets.invalidateIssues();
+            }
+            (bucket.*sources).add(node);
+            node->invalidateIssues();
+        }
+
+        void EntityLinkGraph::removeSource(AttributableNode* node, const AttributeValue& targetname, NodeRefs Bucket::*sources) {
+            const auto it = m_buckets.find(targetname);
+            assert(it != std::end(m_buckets));
+            if (it == std::end(m_buckets))
+                return;
+
+            Bucket& bucket = it->second;
+            (bucket.*sources).remove(node);
+            node->invalidateIssues();
+            if (!bucket.hasSources())
+                bucket.targets.invalidateIssues();
+            removeBucketIfEmpty(it);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EntityLinkGraph
+#define TrenchBroom_EntityLinkGraph
+
+#include "Macros.h"
+#include "Model/EntityAttributes.h"
+#include "Model/ModelTypes.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Stores the target / killtarget links between attributable nodes, grouped by the targetname that
+         * establishes them.
+         *
+         * The graph is owned by the world and kept up to date from the same attribute notifications that maintain
+         * the attribute index, so nodes and clients can read links without querying the index. Nodes whose link
+         * issues may change are invalidated only when a targetname gains its first or loses its last target or
+         * source.
+         */
+        class EntityLinkGraph {
+        private:
+            /**
+             * A list of nodes with reference counts that supports constant time insertion and removal. A node may
+             * be referenced more than once, e.g. if an entity has a "target" and a "target2" attribute with the
+             * same value.
+             */
+            class NodeRefs {
+            private:
+                using Entry = std::pair<AttributableNode*, size_t>;
+                std::vector<Entry> m_entries;
+                std::unordered_map<AttributableNode*, size_t> m_positions;
+            public:
+                bool empty() const;
+
+                void add(AttributableNode* node);
+                void remove(AttributableNode* node);
+
+                void appendTo(AttributableNodeList& result) const;
+                void invalidateIssues() const;
+
+                template <typename F>
+                void forEach(F&& f) const {
+                    for (const auto& entry : m_entries) {
+                        for (size_t i = 0; i < entry.second; ++i)
+                            f(entry.first);
+                    }
+                }
+            };
+
+            struct Bucket {
+                NodeRefs targets;
+                NodeRefs linkSources;
+                NodeRefs killSources;
+
+                bool hasSources() const;
+                bool empty() const;
+            };
+
+            using BucketMap = std::unordered_map<AttributeValue, Bucket>;
+            BucketMap m_buckets;
+        public:
+            EntityLinkGraph();
+
+            void addAttribute(AttributableNode* node, const AttributeName& name, const AttributeValue& value);
+            void removeAttribute(AttributableNode* node, const AttributeName& name, const AttributeValue& value);
+
+            bool hasTargets(const AttributeValue& targetname) const;
+            bool hasSources(const AttributeValue& targetname) const;
+
+            void findTargets(const AttributeValue& targetname, AttributableNodeList& result) const;
+            void findLinkSources(const AttributeValue& targetname, AttributableNodeList& result) const;
+            void findKillSources(const AttributeValue& targetname, AttributableNodeList& result) const;
+
+            /**
+             * Calls the given functions once for every link and kill link in the graph, passing the source and the
+             * target node.
+             */
+            template <typename L, typename K>
+            void forEachLink(L&& linkFunc, K&& killFunc) const {
+                for (const auto& entry : m_buckets) {
+                    const Bucket& bucket = entry.second;
+                    bucket.targets.forEach([&](AttributableNode* target) {
+                        bucket.linkSources.forEach([&](AttributableNode* source) { linkFunc(source, target); });
+                        bucket.killSources.forEach([&](AttributableNode* source) { killFunc(source, target); });
+                    });
+                }
+            }
+        private:
+            const Bucket* findBucket(const AttributeValue& targetname) const;
+            void removeBucketIfEmpty(BucketMap::iterator it);
+
+            void addTarget(AttributableNode* node, const AttributeValue& targetname);
+            void removeTarget(AttributableNode* node, const AttributeValue& targetname);
+            void addSource(AttributableNode* node, const AttributeValue& targetname, NodeRefs Bucket::*sources);
+            void removeSource(AttributableNode* node, const AttributeValue& targetname, NodeRefs Bucket::*sources);
+
+            deleteCopyAndMove(EntityLinkGraph)
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityLinkGraph) */
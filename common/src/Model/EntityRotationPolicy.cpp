@@ -39,20 +39,18 @@ namespace TrenchBroom {
             const RotationInfo info = rotationInfo(entity);
             switch (info.type) {
                 case RotationType_Angle: {
-                    const auto angleValue = entity->attribute(info.attribute);
-                    if (angleValue.empty()) {
+                    if (entity->attribute(info.attribute).empty()) {
                         return vm::mat4x4::identity;
                     } else {
-                        const auto angle = static_cast<FloatType>(std::atof(angleValue.c_str()));
+                        const auto angle = entity->numberAttribute(info.attribute, 0.0);
                         return vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(angle));
                     }
                 }
                 case RotationType_AngleUpDown: {
-                    const auto angleValue = entity->attribute(info.attribute);
-                    if (angleValue.empty()) {
+                    if (entity->attribute(info.attribute).empty()) {
                         return vm::mat4x4::identity;
                     }
-                    const auto angle = static_cast<FloatType>(std::atof(angleValue.c_str()));
+                    const auto angle = entity->numberAttribute(info.attribute, 0.0);
                     if (angle == -1.0) {
                         return vm::mat4x4::rot_90_y_cw;
                     } else if (angle == -2.0) {
@@ -62,8 +60,7 @@ namespace TrenchBroom {
                     }
                 }
                 case RotationType_Euler: {
-                    const auto angleValue = entity->attribute(info.attribute);
-                    const auto angles = angleValue.empty() ? vm::vec3::zero : vm::vec3::parse(angleValue);
+                    const auto angles = entity->vectorAttribute(info.attribute, vm::vec3::zero);
 
                     // x = -pitch
                     // y =  yaw
@@ -76,8 +73,7 @@ namespace TrenchBroom {
                     return vm::rotationMatrix(roll, pitch, yaw);
                 }
                 case RotationType_Euler_PositivePitchDown: {
-                    const auto angleValue = entity->attribute(info.attribute);
-                    const auto angles = angleValue.empty() ? vm::vec3::zero : vm::vec3::parse(angleValue);
+                    const auto angles = entity->vectorAttribute(info.attribute, vm::vec3::zero);
 
                     // x = pitch
                     // y = yaw
@@ -88,8 +84,7 @@ namespace TrenchBroom {
                     return vm::rotationMatrix(roll, pitch, yaw);
                 }
                 case RotationType_Mangle: {
-                    const auto angleValue = entity->attribute(info.attribute);
-                    const auto angles = angleValue.empty() ? vm::vec3::zero : vm::vec3::parse(angleValue);
+                    const auto angles = entity->vectorAttribute(info.attribute, vm::vec3::zero);
 
                     // x = yaw
                     // y = -pitch
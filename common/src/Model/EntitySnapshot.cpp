@@ -48,5 +48,13 @@ namespace TrenchBroom {
             restoreAttribute(m_entity, m_origin);
             restoreAttribute(m_entity, m_rotation);
         }
+
+        static size_t attributeMemorySize(const EntityAttribute& attribute) {
+            return attribute.name().capacity() + attribute.value().capacity();
+        }
+
+        size_t EntitySnapshot::doGetMemorySize() const {
+            return sizeof(EntitySnapshot) + attributeMemorySize(m_origin) + attributeMemorySize(m_rotation);
+        }
     }
 }
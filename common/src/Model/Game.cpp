@@ -73,6 +73,10 @@ namespace TrenchBroom {
             doWriteMap(world, path);
         }
 
+        void Game::writeMapCache(const World& world, const vm::bbox3& worldBounds, const IO::Path& path) const {
+            doWriteMapCache(world, worldBounds, path);
+        }
+
         void Game::exportMap(World& world, const Model::ExportFormat format, const IO::Path& path) const {
             doExportMap(world, format, path);
         }
@@ -71,6 +71,12 @@ namespace TrenchBroom {
             std::unique_ptr<World> newMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const;
             std::unique_ptr<World> loadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const;
             void writeMap(World& world, const IO::Path& path) const;
+            /**
+             * Writes a binary cache of the given world next to the map file at the given path, which must have been
+             * written before. Loading the map file uses the cache as long as the map file does not change and the map
+             * cache preference is enabled.
+             */
+            void writeMapCache(const World& world, const vm::bbox3& worldBounds, const IO::Path& path) const;
             void exportMap(World& world, Model::ExportFormat format, const IO::Path& path) const;
         public: // parsing and serializing objects
             NodeList parseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const;
@@ -113,6 +119,7 @@ namespace TrenchBroom {
             virtual std::unique_ptr<World> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const = 0;
             virtual std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const = 0;
             virtual void doWriteMap(World& world, const IO::Path& path) const = 0;
+            virtual void doWriteMapCache(const World& world, const vm::bbox3& worldBounds, const IO::Path& path) const = 0;
             virtual void doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const = 0;
 
             virtual NodeList doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const = 0;
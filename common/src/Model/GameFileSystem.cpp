@@ -25,6 +25,7 @@
 #include "IO/DkPakFileSystem.h"
 #include "IO/IdPakFileSystem.h"
 #include "IO/Quake3ShaderFileSystem.h"
+#include "IO/ZipFileCache.h"
 #include "IO/ZipFileSystem.h"
 #include "Model/GameConfig.h"
 
@@ -34,7 +35,8 @@ namespace TrenchBroom {
     namespace Model {
         GameFileSystem::GameFileSystem() :
         FileSystem(),
-        m_shaderFS(nullptr) {}
+        m_shaderFS(nullptr),
+        m_zipCache(std::make_shared<IO::ZipFileCache>()) {}
 
         void GameFileSystem::initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger) {
             // delete the existing file system
@@ -47,11 +49,14 @@ namespace TrenchBroom {
                 addGameFileSystems(config, gamePath, additionalSearchPaths, logger);
                 addShaderFileSystem(config, logger);
             }
+
+            buildIndex();
         }
 
         void GameFileSystem::reloadShaders() {
             if (m_shaderFS != nullptr) {
                 m_shaderFS->reload();
+                updateIndex(*m_shaderFS);
             }
         }
 
@@ -108,7 +113,7 @@ namespace TrenchBroom {
                             m_next = std::make_shared<IO::DkPakFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
                         } else if (StringUtils::caseInsensitiveEqual(packageFormat, "zip")) {
                             logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::ZipFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                            m_next = std::make_shared<IO::ZipFileSystem>(m_next, diskFS.makeAbsolute(packagePath), m_zipCache);
                         }
                     } catch (const std::exception& e) {
                         logger.error() << e.what();
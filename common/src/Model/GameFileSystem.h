@@ -33,6 +33,7 @@ namespace TrenchBroom {
         class FileSystem;
         class Path;
         class Quake3ShaderFileSystem;
+        class ZipFileCache;
     }
 
     namespace Model {
@@ -41,6 +42,7 @@ namespace TrenchBroom {
         class GameFileSystem : public IO::FileSystem {
         private:
             IO::Quake3ShaderFileSystem* m_shaderFS;
+            std::shared_ptr<IO::ZipFileCache> m_zipCache; // shared by all zip packages
         public:
             GameFileSystem();
             void initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger);
@@ -20,6 +20,8 @@
 #include "GameImpl.h"
 
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Assets/Palette.h"
 #include "IO/AseParser.h"
 #include "IO/BrushFaceReader.h"
@@ -27,12 +29,14 @@
 #include "IO/DefParser.h"
 #include "IO/DkmParser.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/EntityDefinitionCache.h"
 #include "IO/EntParser.h"
 #include "IO/FgdParser.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
 #include "IO/IOUtils.h"
+#include "IO/MapCache.h"
 #include "IO/MapParser.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
@@ -134,9 +138,25 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<World> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
-            IO::SimpleParserStatus parserStatus(logger);
-            auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+            const auto mapPath = IO::Disk::fixPath(path);
+            auto file = IO::Disk::openFile(mapPath);
             auto fileReader = file->reader().buffer();
+
+            // disabling the map cache preference turns off reading the cache, too
+            const auto cachePath = IO::MapCache::cachePath(mapPath);
+            if (pref(Preferences::WriteMapCache) && IO::Disk::fileExists(cachePath)) {
+                auto cacheFile = IO::Disk::openFile(cachePath);
+                auto cacheReader = cacheFile->reader().buffer();
+                const auto mapHash = IO::MapCache::hash(std::begin(fileReader), std::end(fileReader));
+                auto world = IO::MapCache::read(std::begin(cacheReader), std::end(cacheReader), mapHash, format, worldBounds);
+                if (world != nullptr) {
+                    logger.debug() << "Loaded map from cache " << cachePath.asString();
+                    return world;
+                }
+                logger.debug() << "Ignoring outdated map cache " << cachePath.asString();
+            }
+
+            IO::SimpleParserStatus parserStatus(logger);
             IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
             return worldReader.read(format, worldBounds, parserStatus);
         }
@@ -151,6 +171,13 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
+        void GameImpl::doWriteMapCache(const World& world, const vm::bbox3& worldBounds, const IO::Path& path) const {
+            auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+            auto fileReader = file->reader().buffer();
+            const auto mapHash = IO::MapCache::hash(std::begin(fileReader), std::end(fileReader));
+            IO::MapCache::write(world, worldBounds, mapHash, IO::MapCache::cachePath(path));
+        }
+
         void GameImpl::doExportMap(World& world, const Model::ExportFormat format, const IO::Path& path) const {
             IO::OpenFile open(path, true);
 
@@ -284,28 +311,73 @@ namespace TrenchBroom {
             }
         }
 
+        static uint64_t hashFile(const IO::Path& path) {
+            auto file = IO::Disk::openFile(path);
+            auto reader = file->reader().buffer();
+            return IO::EntityDefinitionCache::hash(std::begin(reader), std::end(reader));
+        }
+
         Assets::EntityDefinitionList GameImpl::doLoadEntityDefinitions(IO::ParserStatus& status, const IO::Path& path) const {
             const auto extension = path.extension();
             const auto& defaultColor = m_config.entityConfig().defaultColor;
 
+            const auto definitionPath = IO::Disk::fixPath(path);
+            const auto cachePath = IO::EntityDefinitionCache::cachePath(IO::SystemPaths::userDataDirectory() + IO::Path("cache"), definitionPath);
+            if (IO::Disk::fileExists(cachePath)) {
+                auto cacheFile = IO::Disk::openFile(cachePath);
+                auto cacheReader = cacheFile->reader().buffer();
+
+                Assets::EntityDefinitionList definitions;
+                if (IO::EntityDefinitionCache::read(std::begin(cacheReader), std::end(cacheReader), defaultColor, hashFile, definitions)) {
+                    status.debug("Loaded entity definitions from cache " + cachePath.asString());
+                    return definitions;
+                }
+                status.debug("Ignoring outdated entity definition cache " + cachePath.asString());
+            }
+
+            auto file = IO::Disk::openFile(definitionPath);
+            auto reader = file->reader().buffer();
+
+            IO::Path::List includedFiles;
+            auto allIncludesFound = true;
+
+            Assets::EntityDefinitionList definitions;
             if (StringUtils::caseInsensitiveEqual("fgd", extension)) {
-                auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                auto reader = file->reader().buffer();
                 IO::FgdParser parser(std::begin(reader), std::end(reader), defaultColor, file->path());
-                return parser.parseDefinitions(status);
+                definitions = parser.parseDefinitions(status);
+                includedFiles = parser.includedFiles();
+                allIncludesFound = parser.allIncludesFound();
             } else if (StringUtils::caseInsensitiveEqual("def", extension)) {
-                auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                auto reader = file->reader().buffer();
                 IO::DefParser parser(std::begin(reader), std::end(reader), defaultColor);
-                return parser.parseDefinitions(status);
+                definitions = parser.parseDefinitions(status);
             } else if (StringUtils::caseInsensitiveEqual("ent", extension)) {
-                auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                auto reader = file->reader().buffer();
                 IO::EntParser parser(std::begin(reader), std::end(reader), defaultColor);
-                return parser.parseDefinitions(status);
+                definitions = parser.parseDefinitions(status);
             } else {
                 throw GameException("Unknown entity definition format: '" + path.asString() + "'");
             }
+
+            if (allIncludesFound) {
+                writeEntityDefinitionCache(definitions, definitionPath, IO::EntityDefinitionCache::hash(std::begin(reader), std::end(reader)), includedFiles, cachePath, status);
+            }
+            return definitions;
+        }
+
+        void GameImpl::writeEntityDefinitionCache(const Assets::EntityDefinitionList& definitions, const IO::Path& definitionPath, const uint64_t definitionHash, const IO::Path::List& includedFiles, const IO::Path& cachePath, IO::ParserStatus& status) const {
+            try {
+                IO::EntityDefinitionCache::SourceFileList sourceFiles;
+                sourceFiles.push_back({ definitionPath, definitionHash });
+                for (const auto& includedFile : includedFiles) {
+                    if (includedFile != definitionPath) {
+                        sourceFiles.push_back({ includedFile, hashFile(includedFile) });
+                    }
+                }
+
+                IO::Disk::ensureDirectoryExists(cachePath.deleteLastComponent());
+                IO::EntityDefinitionCache::write(definitions, sourceFiles, m_config.entityConfig().defaultColor, cachePath);
+            } catch (const Exception& e) {
+                status.debug("Could not write entity definition cache: " + String(e.what()));
+            }
         }
 
         Assets::EntityDefinitionFileSpec::List GameImpl::doAllEntityDefinitionFiles() const {
@@ -60,6 +60,7 @@ namespace TrenchBroom {
             std::unique_ptr<World> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const override;
             std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const override;
             void doWriteMap(World& world, const IO::Path& path) const override;
+            void doWriteMapCache(const World& world, const vm::bbox3& worldBounds, const IO::Path& path) const override;
             void doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const override;
 
             NodeList doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const override;
@@ -80,6 +81,7 @@ namespace TrenchBroom {
 
             bool doIsEntityDefinitionFile(const IO::Path& path) const override;
             Assets::EntityDefinitionList doLoadEntityDefinitions(IO::ParserStatus& status, const IO::Path& path) const override;
+            void writeEntityDefinitionCache(const Assets::EntityDefinitionList& definitions, const IO::Path& definitionPath, uint64_t definitionHash, const IO::Path::List& includedFiles, const IO::Path& cachePath, IO::ParserStatus& status) const;
             Assets::EntityDefinitionFileSpec::List doAllEntityDefinitionFiles() const override;
             Assets::EntityDefinitionFileSpec doExtractEntityDefinitionFile(const AttributableNode& node) const override;
             Assets::EntityDefinitionFileSpec defaultEntityDefinitionFile() const;
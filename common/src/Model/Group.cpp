@@ -150,7 +150,16 @@ namespace TrenchBroom {
         }
 
         void Group::doChildWasAdded(Node* node) {
-            nodeBoundsDidChange(bounds());
+            const vm::bbox3 oldBounds = bounds();
+
+            // adding a child can only grow our bounds, so there is no need to recompute them from all children
+            m_bounds = childCount() == 1 ? node->bounds() : vm::merge(oldBounds, node->bounds());
+            m_boundsValid = true;
+
+            // store the new bounds first so that ancestors which query them don't recompute them
+            if (m_bounds != oldBounds) {
+                notifyParentOfBoundsChange(oldBounds);
+            }
         }
 
         void Group::doChildWasRemoved(Node* node) {
@@ -48,5 +48,27 @@ namespace TrenchBroom {
             for (NodeSnapshot* snapshot : m_snapshots)
                 snapshot->restore(worldBounds);
         }
+
+        void GroupSnapshot::doCompact() {
+            for (NodeSnapshot* snapshot : m_snapshots)
+                snapshot->compact();
+        }
+
+        void GroupSnapshot::doCollate(const BrushSnapshotMap& nextSnapshots) {
+            for (NodeSnapshot* snapshot : m_snapshots)
+                snapshot->collate(nextSnapshots);
+        }
+
+        void GroupSnapshot::doCollectBrushSnapshots(BrushSnapshotMap& result) {
+            for (NodeSnapshot* snapshot : m_snapshots)
+                snapshot->collectBrushSnapshots(result);
+        }
+
+        size_t GroupSnapshot::doGetMemorySize() const {
+            size_t result = sizeof(GroupSnapshot) + m_snapshots.capacity() * sizeof(NodeSnapshot*);
+            for (const NodeSnapshot* snapshot : m_snapshots)
+                result += snapshot->memorySize();
+            return result;
+        }
     }
 }
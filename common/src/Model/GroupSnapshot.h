@@ -38,6 +38,10 @@ namespace TrenchBroom {
         private:
             void takeSnapshot(Group* group);
             void doRestore(const vm::bbox3& worldBounds) override;
+            void doCompact() override;
+            void doCollate(const BrushSnapshotMap& nextSnapshots) override;
+            void doCollectBrushSnapshots(BrushSnapshotMap& result) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
@@ -140,6 +140,18 @@ namespace TrenchBroom {
             return result;
         }
 
+        bool HitQuery::decides(const Hit& hit) const {
+            if (!visible(hit)) {
+                return false;
+            } else if (m_include->matches(hit)) {
+                // first() only replaces a match by another one with a smaller error
+                return hit.error() <= 0.0;
+            } else {
+                // an occluder stops the search after the hits at its distance
+                return !m_exclude->matches(hit);
+            }
+        }
+
         bool HitQuery::visible(const Hit& hit) const {
             if (m_editorContext == nullptr)
                 return true;
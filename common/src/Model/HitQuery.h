@@ -51,6 +51,16 @@ namespace TrenchBroom {
             bool empty() const;
             const Hit& first() const;
             Hit::List all() const;
+
+            /**
+             * Indicates whether the given hit decides the result of first() if the hits are ordered by distance. This
+             * is the case if the hit is visible and either occludes the hits behind it or matches this query with no
+             * error. Then no hit that is further away than the given hit can change the result of first().
+             *
+             * @param hit the hit to check
+             * @return true if the given hit decides the result of first() and false otherwise
+             */
+            bool decides(const Hit& hit) const;
         private:
             bool visible(const Hit& hit) const;
         };
@@ -335,6 +335,10 @@ namespace TrenchBroom {
         // notice that we take a copy here so that we can safely propagate the old bounds up
         void Node::nodeBoundsDidChange(const vm::bbox3 oldBounds) {
             doNodeBoundsDidChange(oldBounds);
+            notifyParentOfBoundsChange(oldBounds);
+        }
+
+        void Node::notifyParentOfBoundsChange(const vm::bbox3& oldBounds) {
             if (m_parent != nullptr)
                 m_parent->childBoundsDidChange(this, oldBounds);
         }
@@ -366,13 +370,19 @@ namespace TrenchBroom {
         }
 
         void Node::childBoundsDidChange(Node* node, const vm::bbox3& oldBounds) {
-            const vm::bbox3 myOldBounds = bounds();
-            if (!myOldBounds.encloses(oldBounds) && !myOldBounds.encloses(node->bounds())) {
-                // Our bounds will change only if the child's bounds potentially contributed to our own bounds.
-                nodeBoundsDidChange(myOldBounds);
-            }
+            const vm::bbox3* deferredBounds = deferBoundsUpdate(this);
+            if (deferredBounds != nullptr) {
+                // Don't revalidate our bounds now, just drop them and let our ancestors do the same.
+                nodeBoundsDidChange(*deferredBounds);
+            } else {
+                const vm::bbox3 myOldBounds = bounds();
+                if (!myOldBounds.encloses(oldBounds) && !myOldBounds.encloses(node->bounds())) {
+                    // Our bounds will change only if the child's bounds potentially contributed to our own bounds.
+                    nodeBoundsDidChange(myOldBounds);
+                }
 
-            doChildBoundsDidChange(node, oldBounds);
+                doChildBoundsDidChange(node, oldBounds);
+            }
             descendantBoundsDidChange(node, oldBounds, 1);
         }
 
@@ -383,6 +393,10 @@ namespace TrenchBroom {
             }
         }
 
+        const vm::bbox3* Node::deferBoundsUpdate(Node* node) {
+            return doDeferBoundsUpdate(node);
+        }
+
         bool Node::selected() const {
             return m_selected;
         }
@@ -565,6 +579,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t Node::lineCount() const {
+            return m_lineCount;
+        }
+
         void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -625,6 +643,10 @@ namespace TrenchBroom {
             doRemoveFromIndex(attributable, name, value);
         }
 
+        const EntityLinkGraph* Node::findEntityLinkGraph() const {
+            return doFindEntityLinkGraph();
+        }
+
         Node* Node::doCloneRecursively(const vm::bbox3& worldBounds) const {
             Node* clone = Node::clone(worldBounds);
             clone->addChildren(Node::cloneRecursively(worldBounds, children()));
@@ -679,5 +701,17 @@ namespace TrenchBroom {
             if (m_parent != nullptr)
                 m_parent->removeFromIndex(attributable, name, value);
         }
+
+        const EntityLinkGraph* Node::doFindEntityLinkGraph() const {
+            if (m_parent != nullptr)
+                return m_parent->findEntityLinkGraph();
+            return nullptr;
+        }
+
+        const vm::bbox3* Node::doDeferBoundsUpdate(Node* node) {
+            if (m_parent != nullptr)
+                return m_parent->deferBoundsUpdate(node);
+            return nullptr;
+        }
     }
 }
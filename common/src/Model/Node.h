@@ -25,6 +25,7 @@
 
 namespace TrenchBroom {
     namespace Model {
+        class EntityLinkGraph;
         class IssueGeneratorRegistry;
         class PickResult;
 
@@ -192,6 +193,12 @@ namespace TrenchBroom {
             void nodeDidChange();
 
             void nodeBoundsDidChange(vm::bbox3 oldBounds);
+
+            /**
+             * Notifies the parent that this node's bounds changed, but unlike nodeBoundsDidChange, does not notify this
+             * node itself. Use this if this node has already stored its new bounds.
+             */
+            void notifyParentOfBoundsChange(const vm::bbox3& oldBounds);
         private:
             void childWillChange(Node* node);
             void childDidChange(Node* node);
@@ -200,6 +207,8 @@ namespace TrenchBroom {
 
             void childBoundsDidChange(Node* node, const vm::bbox3& oldBounds);
             void descendantBoundsDidChange(Node* node, const vm::bbox3& oldBounds, size_t depth);
+
+            const vm::bbox3* deferBoundsUpdate(Node* node);
         public: // selection
             bool selected() const;
             void select();
@@ -251,6 +260,7 @@ namespace TrenchBroom {
             FloatType intersectWithRay(const vm::ray3& ray) const;
         public: // file position
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
             bool containsLine(size_t lineNumber) const;
         public: // issue management
@@ -399,6 +409,8 @@ namespace TrenchBroom {
 
             void addToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
             void removeFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+
+            const EntityLinkGraph* findEntityLinkGraph() const;
         private: // subclassing interface
             virtual const String& doGetName() const = 0;
             virtual const vm::bbox3& doGetBounds() const = 0;
@@ -454,6 +466,8 @@ namespace TrenchBroom {
 
             virtual void doAddToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
             virtual void doRemoveFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+            virtual const EntityLinkGraph* doFindEntityLinkGraph() const;
+            virtual const vm::bbox3* doDeferBoundsUpdate(Node* node);
         };
     }
 }
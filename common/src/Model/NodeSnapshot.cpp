@@ -28,5 +28,27 @@ namespace TrenchBroom {
         void NodeSnapshot::restore(const vm::bbox3& worldBounds) {
             doRestore(worldBounds);
         }
+
+        void NodeSnapshot::compact() {
+            doCompact();
+        }
+
+        void NodeSnapshot::collate(const BrushSnapshotMap& nextSnapshots) {
+            doCollate(nextSnapshots);
+        }
+
+        void NodeSnapshot::collectBrushSnapshots(BrushSnapshotMap& result) {
+            doCollectBrushSnapshots(result);
+        }
+
+        size_t NodeSnapshot::memorySize() const {
+            return doGetMemorySize();
+        }
+
+        void NodeSnapshot::doCompact() {}
+
+        void NodeSnapshot::doCollate(const BrushSnapshotMap& nextSnapshots) {}
+
+        void NodeSnapshot::doCollectBrushSnapshots(BrushSnapshotMap& result) {}
     }
 }
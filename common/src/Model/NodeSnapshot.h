@@ -22,18 +22,47 @@
 
 #include "TrenchBroom.h"
 
+#include <map>
+
 namespace TrenchBroom {
     namespace Model {
         class Brush;
+        class BrushSnapshot;
         class Entity;
         class Group;
 
         class NodeSnapshot {
+        public:
+            using BrushSnapshotMap = std::map<const Brush*, BrushSnapshot*>;
         public:
             virtual ~NodeSnapshot();
             void restore(const vm::bbox3& worldBounds);
+
+            /**
+             * Replaces the recorded state that equals the current state of the node by a reference to the current
+             * state. This must be called at most once, after the node has been changed. Afterwards, this snapshot
+             * may only be restored while the node is in the state it had when this function was called.
+             */
+            void compact();
+
+            /**
+             * Makes this compacted snapshot refer to the state after a further change instead of the state before
+             * it. The given snapshots must have been taken before that change and compacted after it. Records that
+             * this snapshot needs are moved out of them, so they must not be restored afterwards.
+             */
+            void collate(const BrushSnapshotMap& nextSnapshots);
+            void collectBrushSnapshots(BrushSnapshotMap& result);
+
+            /**
+             * Returns the approximate number of bytes used by this snapshot.
+             */
+            size_t memorySize() const;
         private:
             virtual void doRestore(const vm::bbox3& worldBounds) = 0;
+            virtual void doCompact();
+            virtual void doCollate(const BrushSnapshotMap& nextSnapshots);
+            virtual void doCollectBrushSnapshots(BrushSnapshotMap& result);
+            virtual size_t doGetMemorySize() const = 0;
         };
     }
 }
@@ -44,6 +44,14 @@ namespace TrenchBroom {
             return std::make_unique<ParallelTexCoordSystemSnapshot>(m_xAxis, m_yAxis);
         }
 
+        size_t ParallelTexCoordSystemSnapshot::doGetMemorySize() const {
+            return sizeof(ParallelTexCoordSystemSnapshot);
+        }
+
+        bool ParallelTexCoordSystemSnapshot::doMatches(const TexCoordSystem& coordSystem) const {
+            return coordSystem.xAxis() == m_xAxis && coordSystem.yAxis() == m_yAxis;
+        }
+
         void ParallelTexCoordSystemSnapshot::doRestore(ParallelTexCoordSystem& coordSystem) const {
             coordSystem.m_xAxis = m_xAxis;
             coordSystem.m_yAxis = m_yAxis;
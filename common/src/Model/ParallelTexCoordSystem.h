@@ -43,6 +43,8 @@ namespace TrenchBroom {
             ParallelTexCoordSystemSnapshot(ParallelTexCoordSystem* coordSystem);
         private:
             std::unique_ptr<TexCoordSystemSnapshot> doClone() const override;
+            size_t doGetMemorySize() const override;
+            bool doMatches(const TexCoordSystem& coordSystem) const override;
             void doRestore(ParallelTexCoordSystem& coordSystem) const override;
             void doRestore(ParaxialTexCoordSystem& coordSystem) const override;
         };
@@ -20,11 +20,14 @@
 #include "PlanePointFinder.h"
 
 #include "TrenchBroom.h"
+#include "Parallel.h"
 
 #include <vecmath/constants.h>
 #include <vecmath/vec.h>
 #include <vecmath/plane.h>
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         class GridSearchCursor {
@@ -90,9 +93,28 @@ namespace TrenchBroom {
             }
 
             size_t moveCursor(const size_t direction) {
-                m_position = m_position + MoveOffsets[direction];
-                updateErrors();
-                return findSmallestError();
+                const auto& offset = MoveOffsets[direction];
+                m_position = m_position + offset;
+                m_errors[Center] = m_errors[direction];
+
+                // The cursor moves to the location with the smallest error, so none of the locations that were
+                // already around the previous position can have a smaller error than the new position. Only the
+                // locations that enter the window need to be evaluated.
+                auto smallest = Center;
+                for (size_t i = 0; i < 9; ++i) {
+                    if (enteredWindow(i, offset)) {
+                        m_errors[i] = computeError(i);
+                        if (m_errors[i] < m_errors[smallest]) {
+                            smallest = i;
+                        }
+                    }
+                }
+                return smallest;
+            }
+
+            static bool enteredWindow(const size_t location, const vm::vec2& offset) {
+                const auto previous = MoveOffsets[location] + offset;
+                return std::abs(previous.x()) > 1.0 || std::abs(previous.y()) > 1.0;
             }
 
             void updateErrors() {
@@ -201,11 +223,15 @@ namespace TrenchBroom {
                 points[0] = cursor.findMinimum(points[0]);
             }
 
+            // the second point must be searched again if the search moved it onto the first point, so remember
+            // whether it was given as an integer point
+            const bool searchSecondPoint = numPoints < 2 || !isIntegral(points[1]);
+
             vm::vec3 v1, v2;
             FloatType cos;
             size_t count = 0;
             do {
-                if (numPoints < 2 || !isIntegral(points[1])) {
+                if (searchSecondPoint) {
                     points[1] = cursor.findMinimum(points[0] + FloatType(0.33) * multiplier * pointDistance * vm::vec3::pos_x);
                 }
                 points[2] = cursor.findMinimum(points[0] + multiplier * (pointDistance * vm::vec3::pos_y - pointDistance / FloatType(2.0) * vm::vec3::pos_x));
@@ -225,5 +251,17 @@ namespace TrenchBroom {
                 points[i] = unswizzle(points[i], axis);
             }
         }
+
+        void PlanePointFinder::findPoints(const std::vector<vm::plane3>& planes, std::vector<vm::vec3>& points) {
+            assert(points.size() == 3 * planes.size());
+
+            parallelFor(planes.size(), [&](const size_t i) {
+                BrushFace::Points planePoints = { points[3 * i], points[3 * i + 1], points[3 * i + 2] };
+                findPoints(planes[i], planePoints, 3);
+                for (size_t j = 0; j < 3; ++j) {
+                    points[3 * i + j] = planePoints[j];
+                }
+            }, 64);
+        }
     }
 }
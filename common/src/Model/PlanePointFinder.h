@@ -23,11 +23,23 @@
 #include "TrenchBroom.h"
 #include "Model/BrushFace.h"
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         class PlanePointFinder {
         public:
             static void findPoints(const vm::plane3& plane, BrushFace::Points& points, size_t numPoints);
+
+            /**
+             * Finds integer plane points for each of the given planes concurrently. The current points of the plane at
+             * index i are at the indices 3 * i to 3 * i + 2 of the given points. They are replaced with the points
+             * that findPoints(plane, points, 3) finds for that plane.
+             *
+             * @param planes the planes
+             * @param points the current points of the planes, three for each plane
+             */
+            static void findPoints(const std::vector<vm::plane3>& planes, std::vector<vm::vec3>& points);
         };
     }
 }
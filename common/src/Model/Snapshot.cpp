@@ -41,6 +41,30 @@ namespace TrenchBroom {
                 snapshot->restore();
         }
 
+        void Snapshot::compact() {
+            for (NodeSnapshot* snapshot : m_nodeSnapshots)
+                snapshot->compact();
+        }
+
+        void Snapshot::collate(Snapshot& next) {
+            NodeSnapshot::BrushSnapshotMap nextSnapshots;
+            for (NodeSnapshot* snapshot : next.m_nodeSnapshots)
+                snapshot->collectBrushSnapshots(nextSnapshots);
+            for (NodeSnapshot* snapshot : m_nodeSnapshots)
+                snapshot->collate(nextSnapshots);
+        }
+
+        size_t Snapshot::memorySize() const {
+            size_t result = sizeof(Snapshot);
+            result += m_nodeSnapshots.capacity() * sizeof(NodeSnapshot*);
+            result += m_brushFaceSnapshots.capacity() * sizeof(BrushFaceSnapshot*);
+            for (const NodeSnapshot* snapshot : m_nodeSnapshots)
+                result += snapshot->memorySize();
+            for (const BrushFaceSnapshot* snapshot : m_brushFaceSnapshots)
+                result += snapshot->memorySize();
+            return result;
+        }
+
         void Snapshot::takeSnapshot(Node* node) {
             NodeSnapshot* snapshot = node->takeSnapshot();
             if (snapshot != nullptr)
@@ -46,6 +46,23 @@ namespace TrenchBroom {
 
             void restoreNodes(const vm::bbox3& worldBounds);
             void restoreBrushFaces();
+
+            /**
+             * Compacts the node snapshots, see NodeSnapshot::compact. This must be called once the command that took
+             * this snapshot has changed the nodes.
+             */
+            void compact();
+
+            /**
+             * Merges the given snapshot, which was taken by a command that has been collated into the command that
+             * took this snapshot, see NodeSnapshot::collate.
+             */
+            void collate(Snapshot& next);
+
+            /**
+             * Returns the approximate number of bytes used by this snapshot.
+             */
+            size_t memorySize() const;
         private:
             void takeSnapshot(Node* node);
             void takeSnapshot(BrushFace* face);
@@ -195,6 +195,14 @@ namespace TrenchBroom {
 
         TagMatcher::~TagMatcher() = default;
 
+        bool TagMatcher::dependsOnTextureOnly() const {
+            return false;
+        }
+
+        bool TagMatcher::matchesTexture(const Assets::Texture& /* texture */) const {
+            return false;
+        }
+
         void TagMatcher::enable(TagMatcherCallback& callback, MapFacade& facade) const {}
         void TagMatcher::disable(TagMatcherCallback& callback, MapFacade& facade) const {}
 
@@ -230,6 +238,14 @@ namespace TrenchBroom {
             return m_matcher->matches(taggable) ;
         }
 
+        bool SmartTag::dependsOnTextureOnly() const {
+            return m_matcher->dependsOnTextureOnly();
+        }
+
+        bool SmartTag::matchesTexture(const Assets::Texture& texture) const {
+            return m_matcher->matchesTexture(texture);
+        }
+
         void SmartTag::update(Taggable& taggable) const {
             if (matches(taggable)) {
                 taggable.addTag(*this);
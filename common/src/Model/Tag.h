@@ -25,6 +25,10 @@
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace IO {
         class Path;
     }
@@ -295,6 +299,24 @@ namespace TrenchBroom {
              */
             virtual bool matches(const Taggable& taggable) const = 0;
 
+            /**
+             * Indicates whether this matcher only ever matches brush faces and whether its result for a brush face
+             * depends on nothing but the face's texture. If so, the result can be computed once per texture by
+             * calling matchesTexture and reused for every face that uses that texture.
+             *
+             * @return true if this matcher only depends on a brush face's texture and false otherwise
+             */
+            virtual bool dependsOnTextureOnly() const;
+
+            /**
+             * Evaluates this tag matcher against a brush face with the given texture. Only called if
+             * dependsOnTextureOnly returns true.
+             *
+             * @param texture the texture to match against
+             * @return true if this matcher matches every brush face with the given texture and false otherwise
+             */
+            virtual bool matchesTexture(const Assets::Texture& texture) const;
+
             /**
              * Modifies the current selection so that this tag matcher would match it.
              *
@@ -361,6 +383,21 @@ namespace TrenchBroom {
              */
             bool matches(const Taggable& taggable) const;
 
+            /**
+             * Indicates whether this smart tag's matcher only depends on the texture of brush faces.
+             *
+             * @see TagMatcher::dependsOnTextureOnly
+             */
+            bool dependsOnTextureOnly() const;
+
+            /**
+             * Indicates whether this smart tag matches brush faces with the given texture.
+             *
+             * @param texture the texture to match
+             * @return true if this smart tag matches brush faces with the given texture and false otherwise
+             */
+            bool matchesTexture(const Assets::Texture& texture) const;
+
             /**
              * Updates the given tag depending on whether or not the matcher matches against it.
              *
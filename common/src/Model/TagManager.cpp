@@ -19,9 +19,13 @@
 
 #include "TagManager.h"
 
+#include "Assets/Texture.h"
+#include "Model/BrushFace.h"
 #include "Model/Tag.h"
+#include "Model/TagVisitor.h"
 
 #include <algorithm>
+#include <atomic>
 #include <stdexcept>
 
 namespace TrenchBroom {
@@ -45,8 +49,39 @@ namespace TrenchBroom {
             }
         };
 
+        class TagManager::FaceTextureVisitor : public ConstTagVisitor {
+        private:
+            bool m_isFace;
+            const Assets::Texture* m_texture;
+        public:
+            FaceTextureVisitor() :
+            m_isFace(false),
+            m_texture(nullptr) {}
+
+            bool isFace() const {
+                return m_isFace;
+            }
+
+            const Assets::Texture* texture() const {
+                return m_texture;
+            }
+
+            void visit(const BrushFace& face) override {
+                m_isFace = true;
+                m_texture = face.texture();
+            }
+        };
+
+        static size_t nextGeneration() {
+            // shared by all tag managers because textures may be shared by several documents
+            static std::atomic<size_t> generation(0);
+            return ++generation;
+        }
+
         TagManager::TagManager() :
-        m_currentTagTypeIndex(0) {}
+        m_currentTagTypeIndex(0),
+        m_textureTagTypes(0),
+        m_generation(nextGeneration()) {}
 
         const std::list<SmartTag>& TagManager::smartTags() const {
             return m_smartTags;
@@ -94,15 +129,33 @@ namespace TrenchBroom {
             } else {
                 throw std::logic_error("Smart tag already registered");
             }
+            smartTagsDidChange();
         }
 
         void TagManager::clearSmartTags() {
             m_smartTags.clear();
+            smartTagsDidChange();
         }
 
         void TagManager::updateTags(Taggable& taggable) const {
-            for (const auto& tag : m_smartTags) {
-                tag.update(taggable);
+            FaceTextureVisitor visitor;
+            taggable.accept(visitor);
+
+            if (visitor.isFace() && visitor.texture() != nullptr) {
+                const auto textureMask = textureTagMask(*visitor.texture());
+                for (const auto& tag : m_smartTags) {
+                    if ((m_textureTagTypes & tag.type()) == 0) {
+                        tag.update(taggable);
+                    } else if ((textureMask & tag.type()) != 0) {
+                        taggable.addTag(tag);
+                    } else {
+                        taggable.removeTag(tag);
+                    }
+                }
+            } else {
+                for (const auto& tag : m_smartTags) {
+                    tag.update(taggable);
+                }
             }
         }
 
@@ -112,5 +165,28 @@ namespace TrenchBroom {
             ensure(m_currentTagTypeIndex <= Bits, "no more tag types");
             return m_currentTagTypeIndex++;
         }
+
+        void TagManager::smartTagsDidChange() {
+            m_textureTagTypes = 0;
+            for (const auto& tag : m_smartTags) {
+                if (tag.dependsOnTextureOnly()) {
+                    m_textureTagTypes |= tag.type();
+                }
+            }
+            m_generation = nextGeneration();
+        }
+
+        Tag::TagType TagManager::textureTagMask(const Assets::Texture& texture) const {
+            Tag::TagType mask = 0;
+            if (!texture.cachedTagMask(m_generation, mask)) {
+                for (const auto& tag : m_smartTags) {
+                    if ((m_textureTagTypes & tag.type()) != 0 && tag.matchesTexture(texture)) {
+                        mask |= tag.type();
+                    }
+                }
+                texture.setCachedTagMask(m_generation, mask);
+            }
+            return mask;
+        }
     }
 }
@@ -34,7 +34,18 @@ namespace TrenchBroom {
         private:
             size_t m_currentTagTypeIndex;
             std::list<SmartTag> m_smartTags;
+            /**
+             * The types of the registered smart tags that only depend on the texture of brush faces.
+             */
+            Tag::TagType m_textureTagTypes;
+            /**
+             * Identifies the current set of smart tags. Textures cache which of the texture dependent smart tags
+             * match them together with this generation, and the cached value is discarded once the generation
+             * changes.
+             */
+            size_t m_generation;
             class TagCmp;
+            class FaceTextureVisitor;
         public:
             /**
              * Creates a new instance.
@@ -104,6 +115,13 @@ namespace TrenchBroom {
             void updateTags(Taggable& taggable) const;
         private:
             size_t freeTagIndex();
+            void smartTagsDidChange();
+
+            /**
+             * Returns a mask of the texture dependent smart tags that match brush faces with the given texture. The
+             * mask is cached on the texture.
+             */
+            Tag::TagType textureTagMask(const Assets::Texture& texture) const;
         };
     }
 }
@@ -60,7 +60,8 @@ namespace TrenchBroom {
         }
 
         TextureNameTagMatcher::TextureNameTagMatcher(String pattern) :
-        m_pattern(std::move(pattern)) {}
+        m_pattern(std::move(pattern)),
+        m_compiledPattern(m_pattern, false) {}
 
         std::unique_ptr<TagMatcher> TextureNameTagMatcher::clone() const {
             return std::make_unique<TextureNameTagMatcher>(m_pattern);
@@ -75,6 +76,14 @@ namespace TrenchBroom {
             return visitor.matches();
         }
 
+        bool TextureNameTagMatcher::dependsOnTextureOnly() const {
+            return true;
+        }
+
+        bool TextureNameTagMatcher::matchesTexture(const Assets::Texture& texture) const {
+            return matchesTextureName(texture.name());
+        }
+
         void TextureNameTagMatcher::enable(TagMatcherCallback& callback, MapFacade& facade) const {
             const auto& textureManager = facade.textureManager();
             const auto& allTextures = textureManager.textures();
@@ -121,11 +130,7 @@ namespace TrenchBroom {
                 std::advance(begin, long(pos)+1);
             }
 
-            return StringUtils::matchesPattern(
-                begin, std::end(textureName),
-                std::begin(m_pattern),
-                std::end(m_pattern),
-                StringUtils::CharEqual<StringUtils::CaseInsensitiveCharCompare>());
+            return m_compiledPattern.matches(begin, std::end(textureName));
         }
 
         SurfaceParmTagMatcher::SurfaceParmTagMatcher(String parameter) :
@@ -138,19 +143,22 @@ namespace TrenchBroom {
         bool SurfaceParmTagMatcher::matches(const Taggable& taggable) const {
             BrushFaceMatchVisitor visitor([this](const BrushFace& face) {
                 const auto* texture = face.texture();
-                if (texture != nullptr) {
-                    const auto& surfaceParms = texture->surfaceParms();
-                    if (surfaceParms.count(m_parameter) > 0) {
-                        return true;
-                    }
-                }
-                return false;
+                return texture != nullptr && matchesTexture(*texture);
             });
 
             taggable.accept(visitor);
             return visitor.matches();
         }
 
+        bool SurfaceParmTagMatcher::dependsOnTextureOnly() const {
+            return true;
+        }
+
+        bool SurfaceParmTagMatcher::matchesTexture(const Assets::Texture& texture) const {
+            const auto& surfaceParms = texture.surfaceParms();
+            return surfaceParms.count(m_parameter) > 0;
+        }
+
         FlagsTagMatcher::FlagsTagMatcher(const int flags, GetFlags getFlags, SetFlags setFlags, SetFlags unsetFlags, GetFlagNames getFlagNames) :
         m_flags(flags),
         m_getFlags(std::move(getFlags)),
@@ -249,6 +257,7 @@ namespace TrenchBroom {
 
         EntityClassNameTagMatcher::EntityClassNameTagMatcher(String pattern, String texture) :
         m_pattern(std::move(pattern)),
+        m_compiledPattern(m_pattern, false),
         m_texture(std::move(texture)) {}
 
 
@@ -341,7 +350,7 @@ namespace TrenchBroom {
         }
 
         bool EntityClassNameTagMatcher::matchesClassname(const String& classname) const {
-            return StringUtils::caseInsensitiveMatchesPattern(classname, m_pattern);
+            return m_compiledPattern.matches(classname);
         }
     }
 }
@@ -73,11 +73,14 @@ namespace TrenchBroom {
         class TextureNameTagMatcher : public TagMatcher {
         private:
             String m_pattern;
+            StringUtils::GlobPattern m_compiledPattern;
         public:
             explicit TextureNameTagMatcher(String pattern);
             std::unique_ptr<TagMatcher> clone() const override;
         public:
             bool matches(const Taggable& taggable) const override;
+            bool dependsOnTextureOnly() const override;
+            bool matchesTexture(const Assets::Texture& texture) const override;
             void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
             bool canEnable() const override;
         private:
@@ -92,6 +95,8 @@ namespace TrenchBroom {
             std::unique_ptr<TagMatcher> clone() const override;
         private:
             bool matches(const Taggable& taggable) const override;
+            bool dependsOnTextureOnly() const override;
+            bool matchesTexture(const Assets::Texture& texture) const override;
         };
 
         class FlagsTagMatcher : public TagMatcher {
@@ -130,6 +135,7 @@ namespace TrenchBroom {
         class EntityClassNameTagMatcher : public TagMatcher {
         private:
             String m_pattern;
+            StringUtils::GlobPattern m_compiledPattern;
             /**
              * The texture to set when this tag is enabled.
              */
@@ -35,6 +35,28 @@ namespace TrenchBroom {
             return doClone();
         }
 
+        size_t TexCoordSystemSnapshot::memorySize() const {
+            return doGetMemorySize();
+        }
+
+        bool TexCoordSystemSnapshot::matches(const TexCoordSystem& coordSystem) const {
+            return doMatches(coordSystem);
+        }
+
+        TexCoordProjection::TexCoordProjection(const vm::vec<FloatType,4>& s, const vm::vec<FloatType,4>& t) :
+        m_s(s),
+        m_t(t) {}
+
+        void TexCoordProjection::project(const std::vector<vm::vec3>& points, std::vector<vm::vec2f>& result) const {
+            const auto first = result.size();
+            result.resize(first + points.size());
+
+            auto* out = result.data() + first;
+            for (size_t i = 0; i < points.size(); ++i) {
+                out[i] = (*this)(points[i]);
+            }
+        }
+
         TexCoordSystem::TexCoordSystem() = default;
 
         TexCoordSystem::~TexCoordSystem() = default;
@@ -75,6 +97,17 @@ namespace TrenchBroom {
             return doGetTexCoords(point, attribs);
         }
 
+        TexCoordProjection TexCoordSystem::getTexCoordProjection(const BrushFaceAttributes& attribs) const {
+            // the same mapping as computeTexCoords followed by adding the offset and dividing by the texture size
+            const auto size = vm::vec<FloatType,2>(attribs.textureSize());
+            const auto offset = vm::vec<FloatType,2>(attribs.offset());
+            const auto xAxis = safeScaleAxis(getXAxis(), attribs.scale().x()) / size.x();
+            const auto yAxis = safeScaleAxis(getYAxis(), attribs.scale().y()) / size.y();
+            return TexCoordProjection(
+                vm::vec<FloatType,4>(xAxis, offset.x() / size.x()),
+                vm::vec<FloatType,4>(yAxis, offset.y() / size.y()));
+        }
+
         void TexCoordSystem::setRotation(const vm::vec3& normal, const float oldAngle, const float newAngle) {
             doSetRotation(normal, oldAngle, newAngle);
         }
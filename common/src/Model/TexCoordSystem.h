@@ -26,6 +26,7 @@
 #include <vecmath/vec.h>
 
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -43,8 +44,16 @@ namespace TrenchBroom {
             virtual ~TexCoordSystemSnapshot();
             void restore(TexCoordSystem& coordSystem) const;
             std::unique_ptr<TexCoordSystemSnapshot> clone() const;
+            size_t memorySize() const;
+
+            /**
+             * Indicates whether restoring this snapshot would leave the given coordinate system unchanged.
+             */
+            bool matches(const TexCoordSystem& coordSystem) const;
         private:
             virtual std::unique_ptr<TexCoordSystemSnapshot> doClone() const = 0;
+            virtual size_t doGetMemorySize() const = 0;
+            virtual bool doMatches(const TexCoordSystem& coordSystem) const = 0;
             virtual void doRestore(ParallelTexCoordSystem& coordSystem) const = 0;
             virtual void doRestore(ParaxialTexCoordSystem& coordSystem) const = 0;
 
@@ -52,6 +61,39 @@ namespace TrenchBroom {
             friend class ParaxialTexCoordSystem;
         };
 
+        /**
+         * Maps points to texture coordinates. The mapping is a 2x4 matrix that combines the texture axes, scale and
+         * offset of a face with the size of its texture, so computing the texture coordinates of many vertices of a
+         * face requires neither a virtual call nor the scaling of the texture axes per vertex.
+         */
+        class TexCoordProjection {
+        private:
+            vm::vec<FloatType,4> m_s;
+            vm::vec<FloatType,4> m_t;
+        public:
+            /**
+             * Creates a new projection with the given rows.
+             *
+             * @param s the row that computes the horizontal texture coordinate
+             * @param t the row that computes the vertical texture coordinate
+             */
+            TexCoordProjection(const vm::vec<FloatType,4>& s, const vm::vec<FloatType,4>& t);
+
+            vm::vec2f operator()(const vm::vec3& point) const {
+                return vm::vec2f(
+                    static_cast<float>(m_s[0] * point[0] + m_s[1] * point[1] + m_s[2] * point[2] + m_s[3]),
+                    static_cast<float>(m_t[0] * point[0] + m_t[1] * point[1] + m_t[2] * point[2] + m_t[3]));
+            }
+
+            /**
+             * Computes the texture coordinates of the given points and appends them to the given vector.
+             *
+             * @param points the points to project
+             * @param result the vector to append the texture coordinates to
+             */
+            void project(const std::vector<vm::vec3>& points, std::vector<vm::vec2f>& result) const;
+        };
+
         enum class WrapStyle {
         	Projection,
             Rotation
@@ -74,6 +116,7 @@ namespace TrenchBroom {
             void resetTextureAxesToParallel(const vm::vec3& normal, float angle);
 
             vm::vec2f getTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs) const;
+            TexCoordProjection getTexCoordProjection(const BrushFaceAttributes& attribs) const;
 
             void setRotation(const vm::vec3& normal, float oldAngle, float newAngle);
             void transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, bool lockTexture, const vm::vec3& invariant);
@@ -24,16 +24,23 @@
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/CollectNodesWithDescendantSelectionCountVisitor.h"
+#include "Model/HitQuery.h"
 #include "Model/IssueGenerator.h"
+#include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
 namespace TrenchBroom {
     namespace Model {
         World::World(MapFormat mapFormat, const vm::bbox3& worldBounds) :
         m_factory(mapFormat),
         m_defaultLayer(nullptr),
         m_nodeTree(std::make_unique<NodeTree>()),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_boundsUpdateDeferrals(0) {
             addOrUpdateAttribute(AttributeNames::Classname, AttributeValues::WorldspawnClassname);
             createDefaultLayer(worldBounds);
         }
@@ -67,6 +74,36 @@ namespace TrenchBroom {
             return m_attributableIndex;
         }
 
+        const EntityLinkGraph& World::entityLinkGraph() const {
+            return m_entityLinkGraph;
+        }
+
+        void World::findNodesIntersecting(const vm::bbox3& bounds, NodeList& result) const {
+            m_nodeTree->findMatching([&](const vm::bbox3& nodeBounds) { return nodeBounds.intersects(bounds); }, std::back_inserter(result));
+        }
+
+        void World::pickFirst(const vm::ray3& ray, PickResult& pickResult, const HitQuery& query) const {
+            // A node is never hit before the ray enters its bounds. Once a hit decides the query, only the nodes
+            // entered within the distance that first() considers equal to that hit can still change the result.
+            auto maxDistance = std::numeric_limits<FloatType>::max();
+            PickResult nodeHits;
+            m_nodeTree->visitIntersectorsInOrder(ray, [&](const Node* node, const FloatType distance) {
+                if (distance > maxDistance) {
+                    return false;
+                }
+
+                nodeHits.clear();
+                node->pick(ray, nodeHits);
+                for (const auto& hit : nodeHits.all()) {
+                    pickResult.addHit(hit);
+                    if (query.decides(hit)) {
+                        maxDistance = std::min(maxDistance, hit.distance() + vm::C::almostZero());
+                    }
+                }
+                return true;
+            });
+        }
+
         const IssueGeneratorList& World::registeredIssueGenerators() const {
             return m_issueGeneratorRegistry.registeredGenerators();
         }
@@ -157,6 +194,64 @@ namespace TrenchBroom {
             m_nodeTree->clearAndBuild(collect.nodes(), [](const auto* node){ return node->bounds(); });
         }
 
+        World::DeferBoundsUpdates::DeferBoundsUpdates(World* world) :
+        m_world(world) {
+            if (m_world != nullptr)
+                m_world->deferBoundsUpdates();
+        }
+
+        World::DeferBoundsUpdates::~DeferBoundsUpdates() {
+            if (m_world != nullptr)
+                m_world->applyDeferredBoundsUpdates();
+        }
+
+        void World::deferBoundsUpdates() {
+            ++m_boundsUpdateDeferrals;
+        }
+
+        void World::applyDeferredBoundsUpdates() {
+            ensure(m_boundsUpdateDeferrals > 0, "bounds updates are deferred");
+            if (--m_boundsUpdateDeferrals == 0) {
+                m_deferredBounds.clear();
+                updateDeferredTreeNodes();
+            }
+        }
+
+        class World::ForgetDeferredBoundsUpdates : public NodeVisitor {
+        private:
+            World& m_world;
+        public:
+            explicit ForgetDeferredBoundsUpdates(World& world) :
+            m_world(world) {}
+        private:
+            void doVisit(World* world) override   {}
+            void doVisit(Layer* layer) override   { forget(layer);  }
+            void doVisit(Group* group) override   { forget(group);  }
+            void doVisit(Entity* entity) override { forget(entity); }
+            void doVisit(Brush* brush) override   { forget(brush);  }
+
+            void forget(Node* node) {
+                m_world.m_deferredBounds.erase(node);
+                m_world.m_deferredTreeUpdateSet.erase(node);
+            }
+        };
+
+        void World::updateDeferredTreeNodes() {
+            // Rebuilding the tree is cheaper than removing and reinserting most of its nodes.
+            if (m_deferredTreeUpdateSet.size() > descendantCount() / 4) {
+                rebuildNodeTree();
+            } else {
+                UpdateNodeInNodeTree visitor(*m_nodeTree);
+                for (Node* node : m_deferredTreeUpdates) {
+                    if (m_deferredTreeUpdateSet.erase(node) > 0)
+                        node->accept(visitor);
+                }
+            }
+
+            m_deferredTreeUpdates.clear();
+            m_deferredTreeUpdateSet.clear();
+        }
+
         class World::InvalidateAllIssuesVisitor : public NodeVisitor {
         private:
             void doVisit(World* world) override   { invalidateIssues(world);  }
@@ -259,12 +354,21 @@ namespace TrenchBroom {
                 RemoveNodeFromNodeTree visitor(*m_nodeTree);
                 node->acceptAndRecurse(visitor);
             }
+            if (m_boundsUpdateDeferrals > 0) {
+                ForgetDeferredBoundsUpdates visitor(*this);
+                node->acceptAndRecurse(visitor);
+            }
         }
 
         void World::doDescendantBoundsDidChange(Node* node, const vm::bbox3& oldBounds, const size_t depth) {
             if (m_updateNodeTree && node->shouldAddToSpacialIndex()) {
-                UpdateNodeInNodeTree visitor(*m_nodeTree);
-                node->accept(visitor);
+                if (m_boundsUpdateDeferrals > 0) {
+                    if (m_deferredTreeUpdateSet.insert(node).second)
+                        m_deferredTreeUpdates.push_back(node);
+                } else {
+                    UpdateNodeInNodeTree visitor(*m_nodeTree);
+                    node->accept(visitor);
+                }
             }
         }
 
@@ -310,10 +414,26 @@ namespace TrenchBroom {
 
         void World::doAddToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
             m_attributableIndex.addAttribute(attributable, name, value);
+            m_entityLinkGraph.addAttribute(attributable, name, value);
         }
 
         void World::doRemoveFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
             m_attributableIndex.removeAttribute(attributable, name, value);
+            m_entityLinkGraph.removeAttribute(attributable, name, value);
+        }
+
+        const EntityLinkGraph* World::doFindEntityLinkGraph() const {
+            return &m_entityLinkGraph;
+        }
+
+        const vm::bbox3* World::doDeferBoundsUpdate(Node* node) {
+            if (m_boundsUpdateDeferrals == 0)
+                return nullptr;
+
+            auto it = m_deferredBounds.find(node);
+            if (it == std::end(m_deferredBounds))
+                it = m_deferredBounds.emplace(node, node->bounds()).first;
+            return &it->second;
         }
 
         void World::doAttributesDidChange(const vm::bbox3& oldBounds) {}
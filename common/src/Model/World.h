@@ -23,17 +23,22 @@
 #include "TrenchBroom.h"
 #include "Model/AttributableNode.h"
 #include "Model/AttributableNodeIndex.h"
+#include "Model/EntityLinkGraph.h"
 #include "Model/IssueGeneratorRegistry.h"
 #include "Model/MapFormat.h"
 #include "Model/ModelFactory.h"
 #include "Model/ModelFactoryImpl.h"
 #include "Model/Node.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
 template <typename T, size_t S, typename U>
 class AABBTree;
 
 namespace TrenchBroom {
     namespace Model {
+        class HitQuery;
         class PickResult;
 
         class World : public AttributableNode, public ModelFactory {
@@ -41,11 +46,17 @@ namespace TrenchBroom {
             ModelFactoryImpl m_factory;
             Layer* m_defaultLayer;
             AttributableNodeIndex m_attributableIndex;
+            EntityLinkGraph m_entityLinkGraph;
             IssueGeneratorRegistry m_issueGeneratorRegistry;
 
             using NodeTree = AABBTree<FloatType, 3, Node*>;
             std::unique_ptr<NodeTree> m_nodeTree;
             bool m_updateNodeTree;
+
+            size_t m_boundsUpdateDeferrals;
+            std::unordered_map<Node*, vm::bbox3> m_deferredBounds;
+            NodeList m_deferredTreeUpdates;
+            std::unordered_set<Node*> m_deferredTreeUpdateSet;
         public:
             World(MapFormat mapFormat, const vm::bbox3& worldBounds);
             ~World() override;
@@ -57,6 +68,22 @@ namespace TrenchBroom {
             void createDefaultLayer(const vm::bbox3& worldBounds);
         public: // index
             const AttributableNodeIndex& attributableNodeIndex() const;
+            const EntityLinkGraph& entityLinkGraph() const;
+
+            /**
+             * Appends the nodes in the spatial index whose bounds intersect the given bounds to the given list.
+             */
+            void findNodesIntersecting(const vm::bbox3& bounds, NodeList& result) const;
+
+            /**
+             * Picks the nodes in the spatial index until the hit returned by the given query's first() is known.
+             *
+             * The nodes are picked in the order in which the given ray enters their bounds, and picking stops once a
+             * hit that decides the query has been added and the remaining nodes are further away than that hit. The
+             * query must refer to the hits of the given pick result, and the pick result must order its hits by
+             * distance. Use pick() to collect all hits if the result is queried in other ways.
+             */
+            void pickFirst(const vm::ray3& ray, PickResult& pickResult, const HitQuery& query) const;
         public: // selection
             // issue generator registration
             const IssueGeneratorList& registeredIssueGenerators() const;
@@ -72,6 +99,28 @@ namespace TrenchBroom {
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+        public: // deferred bounds updates
+            /**
+             * Defers the bounds updates of this world's descendants until the outermost deferral ends.
+             *
+             * While bounds updates are deferred, the ancestors of a node whose bounds change only drop their cached
+             * bounds instead of recomputing them, and the node tree is not updated. When the deferral ends, the
+             * changed nodes are updated in the node tree in one pass, or the tree is rebuilt if a large part of it
+             * has changed.
+             */
+            class DeferBoundsUpdates {
+            private:
+                World* m_world;
+            public:
+                explicit DeferBoundsUpdates(World* world);
+                ~DeferBoundsUpdates();
+            };
+
+            void deferBoundsUpdates();
+            void applyDeferredBoundsUpdates();
+        private:
+            class ForgetDeferredBoundsUpdates;
+            void updateDeferredTreeNodes();
         private:
             class InvalidateAllIssuesVisitor;
             void invalidateAllIssues();
@@ -99,6 +148,8 @@ namespace TrenchBroom {
             void doFindAttributableNodesWithNumberedAttribute(const AttributeName& prefix, const AttributeValue& value, AttributableNodeList& result) const override;
             void doAddToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) override;
             void doRemoveFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) override;
+            const EntityLinkGraph* doFindEntityLinkGraph() const override;
+            const vm::bbox3* doDeferBoundsUpdate(Node* node) override;
         private: // implement AttributableNode interface
             void doAttributesDidChange(const vm::bbox3& oldBounds) override;
             bool doIsAttributeNameMutable(const AttributeName& name) const override;
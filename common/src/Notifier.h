@@ -25,11 +25,76 @@
 #include "TemporarilySetAny.h"
 
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
 #include <functional>
 #include <list>
+#include <map>
 #include <memory>
+#include <string>
+#include <typeinfo>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
 
 namespace TrenchBroom {
+    /**
+     * Returns the readable name of the given type. Only the names returned by GCC and Clang need to be demangled.
+     *
+     * @tparam T the type
+     */
+    template <typename T>
+    std::string typeName() {
+        const char* name = typeid(T).name();
+#if defined(__GNUC__)
+        int status = 0;
+        std::unique_ptr<char, void(*)(void*)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free);
+        if (status == 0 && demangled != nullptr) {
+            return demangled.get();
+        }
+#endif
+        return name;
+    }
+
+    /**
+     * Collects the number of callbacks and the time spent in them per observer type. Can be attached to any number of
+     * notifiers to find out which observers are expensive to notify.
+     */
+    class NotifierStatistics {
+    public:
+        struct Entry {
+            size_t callCount = 0;
+            std::chrono::nanoseconds time = std::chrono::nanoseconds(0);
+        };
+        using EntryMap = std::map<std::string, Entry>;
+    private:
+        EntryMap m_entries;
+    public:
+        /**
+         * Records a single callback of an observer of the given type.
+         *
+         * @param observerType the name of the observer type
+         * @param time the time spent in the callback
+         */
+        void record(const std::string& observerType, const std::chrono::nanoseconds time) {
+            auto& entry = m_entries[observerType];
+            ++entry.callCount;
+            entry.time += time;
+        }
+
+        /**
+         * Returns the recorded entries, ordered by observer type.
+         */
+        const EntryMap& entries() const {
+            return m_entries;
+        }
+
+        void clear() {
+            m_entries.clear();
+        }
+    };
+
     /**
      * Encapsulates the internal state of a notifier. Handles adding and removing observers during notification.
      *
@@ -108,18 +173,27 @@ namespace TrenchBroom {
         }
 
         /**
-         * Notifies all registered observers and passes the given arguments.
+         * Notifies all registered observers and passes the given arguments. If the given statistics are not null,
+         * the callbacks are counted and timed.
          *
          * @tparam A the argument types
+         * @param statistics the statistics to record the callbacks in, may be null
          * @param a the arguments
          */
         template <typename... A>
-        void notify(A... a) {
+        void notify(NotifierStatistics* statistics, A... a) {
             const TemporarilySetBool notifying(m_notifying);
 
             for (auto& observer : m_observers) {
                 if (!observer->skip()) {
-                    (*observer)(a...);
+                    if (statistics == nullptr) {
+                        (*observer)(a...);
+                    } else {
+                        const auto start = std::chrono::steady_clock::now();
+                        (*observer)(a...);
+                        const auto end = std::chrono::steady_clock::now();
+                        statistics->record(observer->receiverType(), std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+                    }
                 }
             }
 
@@ -170,6 +244,7 @@ namespace TrenchBroom {
             }
 
             virtual void* receiver() const = 0;
+            virtual std::string receiverType() const = 0;
             virtual void operator()(A... a) = 0;
 
             bool operator==(const Observer& rhs) const {
@@ -199,6 +274,10 @@ namespace TrenchBroom {
                 return static_cast<void*>(m_receiver);
             }
 
+            std::string receiverType() const override {
+                return typeName<R>();
+            }
+
             F function() const {
                 return m_function;
             }
@@ -210,7 +289,11 @@ namespace TrenchBroom {
         };
     private:
         NotifierState<Observer> m_state;
+        NotifierStatistics* m_statistics;
     public:
+        Notifier() :
+        m_statistics(nullptr) {}
+
         /**
          * RAII style helper tht notifies the given notifier immediately, passing the given arguments. This class in and
          * of itself is not very useful and was only added for reasons of symmetry.
@@ -313,13 +396,22 @@ namespace TrenchBroom {
             return removeObserver(&notifier, &Notifier<A...>::operator());
         }
 
+        /**
+         * Sets the statistics in which the callbacks of this notifier's observers are recorded.
+         *
+         * @param statistics the statistics, or null to stop recording
+         */
+        void setStatistics(NotifierStatistics* statistics) {
+            m_statistics = statistics;
+        }
+
         /**
          * Notifies all observers of this notifier with the given arguments.
          *
          * @param a the arguments to pass to each notifier
          */
         void notify(A... a) {
-            m_state.notify(a...);
+            m_state.notify(m_statistics, a...);
         }
 
         /**
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_Parallel
+#define TrenchBroom_Parallel
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    /**
+     * Returns the number of threads that parallel algorithms should use, which is at least 1.
+     */
+    inline size_t parallelThreadCount() {
+        const auto hardwareThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+        return std::max(hardwareThreads, static_cast<size_t>(1));
+    }
+
+    /**
+     * Calls the given function once for every index in [0, count). The indices are handed out to a number of worker
+     * threads in the given chunk size, and the calling thread takes part in the work, too. The function must therefore
+     * be safe to call concurrently; in particular, it must not modify any state that other invocations read or write.
+     *
+     * If any invocation throws an exception, the remaining indices are skipped and the first exception that was thrown
+     * is rethrown on the calling thread once all workers have finished.
+     *
+     * @tparam F the type of the function to call
+     * @param count the number of indices
+     * @param f the function to call, it is passed the index
+     * @param chunkSize the number of consecutive indices that a worker processes at once, 0 is treated as 1
+     */
+    template <typename F>
+    void parallelFor(const size_t count, const F& f, size_t chunkSize = 1) {
+        chunkSize = std::max(chunkSize, static_cast<size_t>(1));
+        const auto chunks = (count + chunkSize - 1) / chunkSize;
+        const auto threadCount = std::min(parallelThreadCount(), chunks);
+        if (threadCount <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> nextChunk(0);
+        std::exception_ptr exception;
+        std::mutex exceptionMutex;
+
+        const auto work = [&]() {
+            try {
+                for (auto chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+                    const auto first = chunk * chunkSize;
+                    const auto last = std::min(first + chunkSize, count);
+                    for (auto i = first; i < last; ++i) {
+                        f(i);
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                nextChunk = chunks;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1);
+        for (size_t i = 1; i < threadCount; ++i) {
+            workers.emplace_back(work);
+        }
+
+        work();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+#endif /* defined(TrenchBroom_Parallel) */
@@ -326,11 +326,21 @@ public: // Constructors
     explicit Polyhedron(const std::vector<V>& positions);
     Polyhedron(const std::vector<V>& positions, Callback& callback);
 
+    /**
+     Creates a polyhedron with the given vertices and faces without computing their convex hull. Each face is given
+     by the indices of its vertices in the order of its boundary. The faces are created in the given order.
+
+     Throws a GeometryException if an index is out of range, if a face has fewer than three vertices or if the faces
+     do not form a closed surface.
+     */
+    Polyhedron(const std::vector<V>& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback);
+
     Polyhedron(const Polyhedron<T,FP,VP>& other);
     Polyhedron(Polyhedron<T,FP,VP>&& other) noexcept;
 private: // Constructor helpers
     void addPoints(const V& p1, const V& p2, const V& p3, const V& p4, Callback& callback);
     void setBounds(const vm::bbox<T,3>& bounds, Callback& callback);
+    void setTopology(const std::vector<V>& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback);
 private: // Copy helper
     class Copy;
 public: // Destructor
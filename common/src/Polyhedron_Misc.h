@@ -21,6 +21,7 @@
 #define TrenchBroom_Polyhedron_Misc_h
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
@@ -29,7 +30,10 @@
 #include <vecmath/scalar.h>
 #include <vecmath/util.h>
 
+#include <algorithm>
 #include <map>
+#include <utility>
+#include <vector>
 
 template <typename T, typename FP, typename VP>
 class Polyhedron<T,FP,VP>::VertexDistanceCmp {
@@ -172,6 +176,11 @@ Polyhedron<T,FP,VP>::Polyhedron(const std::vector<V>& positions, Callback& callb
     addPoints(std::begin(positions), std::end(positions), callback);
 }
 
+template <typename T, typename FP, typename VP>
+Polyhedron<T,FP,VP>::Polyhedron(const std::vector<V>& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback) {
+    setTopology(positions, faces, callback);
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T,FP,VP>::Polyhedron(const Polyhedron<T,FP,VP>& other) {
     Copy copy(other.faces(), other.edges(), other.vertices(), *this);
@@ -316,6 +325,71 @@ void Polyhedron<T,FP,VP>::setBounds(const vm::bbox<T,3>& bounds, Callback& callb
     m_bounds = bounds;
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T,FP,VP>::setTopology(const std::vector<V>& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback) {
+    // Validate the topology before creating anything so that nothing leaks if it is invalid. Every directed edge must
+    // occur exactly once, and so must its reverse. Every vertex must be referenced, otherwise it has no leaving edge.
+    using DirectedEdge = std::pair<size_t, size_t>;
+    std::map<DirectedEdge, HalfEdge*> halfEdges;
+    std::vector<bool> referenced(positions.size(), false);
+    for (const auto& face : faces) {
+        if (face.size() < 3) {
+            throw GeometryException("Polyhedron face has fewer than three vertices");
+        }
+        for (size_t i = 0; i < face.size(); ++i) {
+            const auto origin = face[i];
+            const auto destination = face[(i + 1) % face.size()];
+            if (origin >= positions.size() || destination >= positions.size()) {
+                throw GeometryException("Polyhedron vertex index is out of range");
+            }
+            if (!halfEdges.insert(std::make_pair(DirectedEdge(origin, destination), nullptr)).second) {
+                throw GeometryException("Polyhedron edge occurs more than once");
+            }
+            referenced[origin] = true;
+        }
+    }
+    if (std::find(std::begin(referenced), std::end(referenced), false) != std::end(referenced)) {
+        throw GeometryException("Polyhedron vertex is not referenced by any face");
+    }
+    for (const auto& entry : halfEdges) {
+        const auto& edge = entry.first;
+        if (halfEdges.count(DirectedEdge(edge.second, edge.first)) == 0) {
+            throw GeometryException("Polyhedron is not closed");
+        }
+    }
+
+    std::vector<Vertex*> vertices;
+    vertices.reserve(positions.size());
+    for (const auto& position : positions) {
+        Vertex* vertex = new Vertex(position);
+        m_vertices.append(vertex, 1);
+        vertices.push_back(vertex);
+        callback.vertexWasCreated(vertex);
+    }
+
+    for (const auto& face : faces) {
+        HalfEdgeList boundary;
+        for (size_t i = 0; i < face.size(); ++i) {
+            HalfEdge* halfEdge = new HalfEdge(vertices[face[i]]);
+            halfEdges[DirectedEdge(face[i], face[(i + 1) % face.size()])] = halfEdge;
+            boundary.append(halfEdge, 1);
+        }
+
+        Face* newFace = new Face(boundary);
+        m_faces.append(newFace, 1);
+        callback.faceWasCreated(newFace);
+    }
+
+    for (const auto& entry : halfEdges) {
+        const auto& edge = entry.first;
+        if (edge.first < edge.second) {
+            m_edges.append(new Edge(entry.second, halfEdges[DirectedEdge(edge.second, edge.first)]), 1);
+        }
+    }
+
+    updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 class Polyhedron<T,FP,VP>::Copy {
 private:
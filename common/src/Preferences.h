@@ -120,6 +120,7 @@ namespace TrenchBroom {
 
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
+        extern Preference<bool> WriteMapCache;
 
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
@@ -42,82 +42,151 @@ namespace TrenchBroom {
             return size < other.size;
         }
 
-        static std::vector<AllocationTracker::Block*>::iterator findFirstLargerOrEqualBin(std::vector<AllocationTracker::Block*>& bins, const size_t desiredSize) {
-            return std::lower_bound(bins.begin(),
-                                    bins.end(),
-                                    desiredSize,
-                                    [](const AllocationTracker::Block* a, const size_t b){ return a->size < b; });
+        double AllocationTracker::Statistics::fragmentation() const {
+            if (freeSize == 0) {
+                return 0.0;
+            }
+            return 1.0 - static_cast<double>(largestFreeBlock) / static_cast<double>(freeSize);
         }
 
-        void AllocationTracker::unlinkFromBinList(Block* block) {
-            assert(block->free);
+        /**
+         * Returns the index of the lowest set bit of the given nonzero value.
+         */
+        static size_t lowestSetBit(const uint64_t value) {
+            assert(value != 0);
+            // de Bruijn multiplication, see https://www.chessprogramming.org/BitScan
+            static const size_t Table[64] = {
+                0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+                62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+                63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+                46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+            };
+            const uint64_t lowestBit = value & (~value + 1u);
+            return Table[(lowestBit * UINT64_C(0x03f79d71b4cb0a89)) >> 58];
+        }
 
-            if (block->prevOfSameSize == nullptr) {
-                // slow case: when we are the head of the list
-                // (m_sizeToFreeBlock has a pointer to us)
+        /**
+         * Returns the index of the highest set bit of the given nonzero value.
+         */
+        static size_t highestSetBit(uint64_t value) {
+            assert(value != 0);
+            value |= value >> 1;
+            value |= value >> 2;
+            value |= value >> 4;
+            value |= value >> 8;
+            value |= value >> 16;
+            value |= value >> 32;
+            return lowestSetBit(value ^ (value >> 1));
+        }
 
-                // this means we must be in m_sizeToFreeBlock
-                auto it = findFirstLargerOrEqualBin(m_freeBlockSizeBins, block->size);
-                assert(it != m_freeBlockSizeBins.end());
-                assert(*it == block);
+        size_t AllocationTracker::sizeClass(const Index size) {
+            if (size < SubClassCount) {
+                return size;
+            }
 
-                // make sure we prune empty lists from the map!
-                if (block->nextOfSameSize == nullptr) {
-                    // NOTE: O(n) in the number of bins
-                    m_freeBlockSizeBins.erase(it);
-                } else {
-                    *it = block->nextOfSameSize;
-                    block->nextOfSameSize->prevOfSameSize = nullptr;
-                    block->nextOfSameSize = nullptr;
-                }
-            } else {
-                // "regular" case, not the head of a size bin list.
+            const size_t group = highestSetBit(static_cast<uint64_t>(size));
+            const size_t subClass = (size >> (group - SubClassBits)) & (SubClassCount - 1u);
+            return (group - SubClassBits + 1u) * SubClassCount + subClass;
+        }
 
-                // handle the "previous" side
-                assert(block->prevOfSameSize != nullptr);
-                assert(block->size == block->prevOfSameSize->size);
-                block->prevOfSameSize->nextOfSameSize = block->nextOfSameSize;
+        AllocationTracker::Index AllocationTracker::sizeClassLowerBound(const size_t sizeClass) {
+            if (sizeClass < SubClassCount) {
+                return sizeClass;
+            }
 
-                // handle the "next" side
-                if (block->nextOfSameSize) {
-                    assert(block->size == block->nextOfSameSize->size);
-                    block->nextOfSameSize->prevOfSameSize = block->prevOfSameSize;
-                }
+            const size_t group = sizeClass / SubClassCount + SubClassBits - 1u;
+            const size_t subClass = sizeClass % SubClassCount;
+            return static_cast<Index>(SubClassCount + subClass) << (group - SubClassBits);
+        }
 
-                // clear the nextOfSameSize/prevOfSameSize pointers to mark the block as unlinked from the bin list
-                block->nextOfSameSize = nullptr;
-                block->prevOfSameSize = nullptr;
+        size_t AllocationTracker::findNonEmptySizeClass(const size_t firstSizeClass) const {
+            const size_t firstGroup = firstSizeClass / SubClassCount;
+            const auto sizeClasses = static_cast<unsigned>(m_nonEmptySizeClasses[firstGroup]) & (0xFFu << (firstSizeClass % SubClassCount)) & 0xFFu;
+            if (sizeClasses != 0) {
+                return firstGroup * SubClassCount + lowestSetBit(sizeClasses);
             }
+
+            const uint64_t groups = firstGroup + 1u < 64u ? m_sizeClassGroups & (~UINT64_C(0) << (firstGroup + 1u)) : 0u;
+            if (groups == 0) {
+                return NoSizeClass;
+            }
+
+            const size_t group = lowestSetBit(groups);
+            return group * SubClassCount + lowestSetBit(m_nonEmptySizeClasses[group]);
         }
 
-        void AllocationTracker::linkToBinList(Block* block) {
-            assert(block->free);
-            assert(block->size > 0);
-            assert(block->prevOfSameSize == nullptr);
-            assert(block->nextOfSameSize == nullptr);
+        AllocationTracker::Block* AllocationTracker::findFreeBlock(const Index minSize) const {
+            // every block in the first size class whose lower bound is at least minSize is large enough
+            const size_t minSizeClass = sizeClass(minSize);
+            const size_t firstFittingSizeClass = sizeClassLowerBound(minSizeClass) < minSize ? minSizeClass + 1u : minSizeClass;
+            if (firstFittingSizeClass < SizeClassCount) {
+                const size_t found = findNonEmptySizeClass(firstFittingSizeClass);
+                if (found != NoSizeClass) {
+                    return m_sizeClasses[found];
+                }
+            }
 
-            auto it = findFirstLargerOrEqualBin(m_freeBlockSizeBins, block->size);
+            // no such block, but the size class of minSize may still contain a block that is large enough
+            for (Block* block = m_sizeClasses[minSizeClass]; block != nullptr; block = block->nextInSizeClass) {
+                if (block->size >= minSize) {
+                    return block;
+                }
+            }
+            return nullptr;
+        }
 
-            if (it == m_freeBlockSizeBins.end()) {
-                // All existing bins too small; insert at end.
-                m_freeBlockSizeBins.insert(it, block);
-            } else if ((*it)->size == block->size) {
-                // There is an existing exact match for the bin size, so we don't need to resize the vector.
-                Block* previousListHead = *it;
+        void AllocationTracker::unlinkFromBinList(Block* block) {
+            assert(block->free);
 
-                assert(previousListHead->size == block->size);
-                assert(previousListHead->prevOfSameSize == nullptr);
+            if (block->prevInSizeClass == nullptr) {
+                // we are the head of the list, m_sizeClasses has a pointer to us
+                const size_t index = sizeClass(block->size);
+                assert(m_sizeClasses[index] == block);
+
+                m_sizeClasses[index] = block->nextInSizeClass;
+                if (block->nextInSizeClass == nullptr) {
+                    // the size class is empty now
+                    const size_t group = index / SubClassCount;
+                    m_nonEmptySizeClasses[group] = static_cast<uint8_t>(m_nonEmptySizeClasses[group] & ~(1u << (index % SubClassCount)));
+                    if (m_nonEmptySizeClasses[group] == 0) {
+                        m_sizeClassGroups &= ~(UINT64_C(1) << group);
+                    }
+                } else {
+                    block->nextInSizeClass->prevInSizeClass = nullptr;
+                }
+            } else {
+                // "regular" case, not the head of a size class list.
+                block->prevInSizeClass->nextInSizeClass = block->nextInSizeClass;
+                if (block->nextInSizeClass != nullptr) {
+                    block->nextInSizeClass->prevInSizeClass = block->prevInSizeClass;
+                }
+            }
 
-                // connect block to previousListHead
-                block->nextOfSameSize = previousListHead;
-                previousListHead->prevOfSameSize = block;
+            // clear the nextInSizeClass/prevInSizeClass pointers to mark the block as unlinked from the size class list
+            block->nextInSizeClass = nullptr;
+            block->prevInSizeClass = nullptr;
+            --m_freeBlockCount;
+        }
 
-                // NOTE: inserts into the map
-                *it = block;
+        void AllocationTracker::linkToBinList(Block* block) {
+            assert(block->free);
+            assert(block->size > 0);
+            assert(block->prevInSizeClass == nullptr);
+            assert(block->nextInSizeClass == nullptr);
+
+            const size_t index = sizeClass(block->size);
+            Block* previousListHead = m_sizeClasses[index];
+            if (previousListHead != nullptr) {
+                assert(previousListHead->prevInSizeClass == nullptr);
+                block->nextInSizeClass = previousListHead;
+                previousListHead->prevInSizeClass = block;
             } else {
-                // Slow case: insert a new bin, before `it`.
-                m_freeBlockSizeBins.insert(it, block);
+                const size_t group = index / SubClassCount;
+                m_nonEmptySizeClasses[group] = static_cast<uint8_t>(m_nonEmptySizeClasses[group] | (1u << (index % SubClassCount)));
+                m_sizeClassGroups |= UINT64_C(1) << group;
             }
+            m_sizeClasses[index] = block;
+            ++m_freeBlockCount;
         }
 
         void AllocationTracker::recycle(Block* block) {
@@ -134,38 +203,43 @@ namespace TrenchBroom {
             return new Block();
         }
 
+        void AllocationTracker::mergeWithRight(Block* block) {
+            // the caller is responsible for unlinking and relinking block
+            Block* right = block->right;
+            assert(right != nullptr);
+            assert(right->free);
+
+            unlinkFromBinList(right);
+
+            block->size += right->size;
+            block->right = right->right;
+            if (block->right != nullptr) {
+                block->right->left = block;
+            }
+
+            // update rightmost block
+            if (m_rightmostBlock == right) {
+                m_rightmostBlock = block;
+            }
+
+            recycle(right);
+        }
+
         AllocationTracker::Block* AllocationTracker::allocate(const size_t needed) {
             checkInvariants();
 
             if (needed == 0)
                 throw std::runtime_error("allocate() requires positive nonzero size");
 
-            // find the smallest free block that will fit the allocation
-            auto it = findFirstLargerOrEqualBin(m_freeBlockSizeBins, needed);
-            if (it == m_freeBlockSizeBins.end()) {
+            Block* block = findFreeBlock(needed);
+            if (block == nullptr) {
                 checkInvariants();
                 return nullptr;
             }
 
-            // unlink it from the size bin
-            // (this is a special case of unlinkFromBinList(), duplicated here
-            // to avoid doing a redundant binary search)
-            Block* block = *it;
-            assert(block != nullptr);
-            assert(block->free);
-            assert(block->prevOfSameSize == nullptr);
-            {
-                Block *blockAfter = block->nextOfSameSize;
-                if (blockAfter == nullptr) {
-                    m_freeBlockSizeBins.erase(it);
-                } else {
-                    *it = blockAfter;
-                    blockAfter->prevOfSameSize = nullptr;
-                }
-            }
-
-            block->nextOfSameSize = nullptr;
-            block->prevOfSameSize = nullptr;
+            unlinkFromBinList(block);
+            m_usedSize += needed;
+            ++m_usedBlockCount;
 
             if (block->size == needed) {
                 // lucky case: exact size. we're done
@@ -183,8 +257,8 @@ namespace TrenchBroom {
             Block* newBlock = obtainBlock();
             newBlock->pos= block->pos;
             newBlock->size = needed;
-            newBlock->prevOfSameSize = nullptr;
-            newBlock->nextOfSameSize = nullptr;
+            newBlock->prevInSizeClass = nullptr;
+            newBlock->nextInSizeClass = nullptr;
             newBlock->left = block->left;
             newBlock->right = block;
             newBlock->free = false;
@@ -212,109 +286,49 @@ namespace TrenchBroom {
             checkInvariants();
 
             assert(!block->free);
-            assert(block->prevOfSameSize == nullptr);
-            assert(block->nextOfSameSize == nullptr);
+            assert(block->prevInSizeClass == nullptr);
+            assert(block->nextInSizeClass == nullptr);
+
+            m_usedSize -= block->size;
+            --m_usedBlockCount;
 
             Block* left = block->left;
             Block* right = block->right;
 
-            // 3 possible cases for merging blocks:
-            // a) merge left, block, and right
-            if (left != nullptr && left->free
-                && right != nullptr && right->free) {
-
-                // keep left, delete block and right
-
-                unlinkFromBinList(left);
-                unlinkFromBinList(right);
-
-                left->size += (block->size + right->size);
-
-                Block* newRightNeighbour = right->right;
-                left->right = newRightNeighbour;
-                if (newRightNeighbour) {
-                    newRightNeighbour->left = left;
-                }
-
-                recycle(block);
-                recycle(right);
-
-                linkToBinList(left);
-
-                // update rightmost block
-                if (m_rightmostBlock == right) {
-                    m_rightmostBlock = left;
-                }
-
-                checkInvariants();
-                return;
-            }
-
-            // b) merge left and block
             if (left != nullptr && left->free) {
-                // keep left, delete block
-
+                // keep left, delete block, and possibly merge with right
                 unlinkFromBinList(left);
 
                 left->size += block->size;
                 left->right = right;
-                if (right) {
+                if (right != nullptr) {
                     right->left = left;
                 }
 
-                recycle(block);
-
-                linkToBinList(left);
-
                 // update rightmost block
                 if (m_rightmostBlock == block) {
                     m_rightmostBlock = left;
                 }
 
-                checkInvariants();
-                return;
-            }
-
-            // c) merge block and right
-            if (right != nullptr && right->free) {
-                // keep block, delete right
-
-                unlinkFromBinList(right);
+                recycle(block);
 
-                block->size += right->size;
-                Block* newRightNeighbour = right->right;
-                block->right = newRightNeighbour;
-                if (newRightNeighbour != nullptr) {
-                    newRightNeighbour->left = block;
+                if (right != nullptr && right->free) {
+                    mergeWithRight(left);
                 }
-
-                recycle(right);
-
+                linkToBinList(left);
+            } else {
                 block->free = true;
-                linkToBinList(block);
-
-                // update rightmost block
-                if (m_rightmostBlock == right) {
-                    m_rightmostBlock = block;
+                if (right != nullptr && right->free) {
+                    mergeWithRight(block);
                 }
-
-                checkInvariants();
-                return;
+                linkToBinList(block);
             }
 
-            // no merging possible.
-
-            block->free = true;
-            linkToBinList(block);
-
             checkInvariants();
         }
 
         AllocationTracker::AllocationTracker(const Index initial_capacity)
-                : m_capacity(0),
-                  m_leftmostBlock(nullptr),
-                  m_rightmostBlock(nullptr),
-                  m_recycledBlockList(nullptr) {
+                : AllocationTracker() {
             if (initial_capacity > 0) {
                 expand(initial_capacity);
                 checkInvariants();
@@ -323,9 +337,16 @@ namespace TrenchBroom {
 
         AllocationTracker::AllocationTracker()
                 : m_capacity(0),
+                  m_usedSize(0),
+                  m_usedBlockCount(0),
+                  m_freeBlockCount(0),
                   m_leftmostBlock(nullptr),
                   m_rightmostBlock(nullptr),
-                  m_recycledBlockList(nullptr) {}
+                  m_recycledBlockList(nullptr),
+                  m_sizeClassGroups(0) {
+            m_sizeClasses.fill(nullptr);
+            m_nonEmptySizeClasses.fill(0);
+        }
 
         AllocationTracker::~AllocationTracker() {
             checkInvariants();
@@ -357,8 +378,8 @@ namespace TrenchBroom {
                 Block* newBlock = obtainBlock();
                 newBlock->pos = 0;
                 newBlock->size = m_capacity;
-                newBlock->prevOfSameSize = nullptr;
-                newBlock->nextOfSameSize = nullptr;
+                newBlock->prevInSizeClass = nullptr;
+                newBlock->nextInSizeClass = nullptr;
                 newBlock->left = nullptr;
                 newBlock->right = nullptr;
                 newBlock->free = true;
@@ -391,8 +412,8 @@ namespace TrenchBroom {
                 Block* newBlock = obtainBlock();
                 newBlock->pos = lastBlock->pos + lastBlock->size;
                 newBlock->size = increase;
-                newBlock->prevOfSameSize = nullptr;
-                newBlock->nextOfSameSize = nullptr;
+                newBlock->prevInSizeClass = nullptr;
+                newBlock->nextInSizeClass = nullptr;
                 newBlock->left = lastBlock;
                 newBlock->right = nullptr;
                 newBlock->free = true;
@@ -409,14 +430,78 @@ namespace TrenchBroom {
             checkInvariants();
         }
 
+        AllocationTracker::Index AllocationTracker::freeSizeAtEnd() const {
+            if (m_rightmostBlock == nullptr || !m_rightmostBlock->free) {
+                return 0;
+            }
+            return m_rightmostBlock->size;
+        }
+
         bool AllocationTracker::hasAllocations() const {
-            // NOTE: this loop should execute at most 2 iterations, because adjacent free blocks are always merged
-            for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
-                if (!block->free) {
-                    return true;
+            return m_usedBlockCount > 0;
+        }
+
+        AllocationTracker::Statistics AllocationTracker::statistics() const {
+            return Statistics {
+                m_capacity,
+                m_usedSize,
+                m_capacity - m_usedSize,
+                largestPossibleAllocation(),
+                m_usedBlockCount,
+                m_freeBlockCount
+            };
+        }
+
+        bool AllocationTracker::compact(const size_t maxMoves, const MoveBlock& move) {
+            checkInvariants();
+
+            Block* freeBlock = m_leftmostBlock;
+            while (freeBlock != nullptr && !freeBlock->free) {
+                freeBlock = freeBlock->right;
+            }
+
+            size_t moves = 0;
+            while (freeBlock != nullptr && freeBlock->right != nullptr && moves < maxMoves) {
+                // swap the free block with the used block to its right; since adjacent free blocks are always merged,
+                // the right neighbour must be used
+                Block* usedBlock = freeBlock->right;
+                assert(!usedBlock->free);
+
+                const Index oldPos = usedBlock->pos;
+                usedBlock->pos = freeBlock->pos;
+                freeBlock->pos = usedBlock->pos + usedBlock->size;
+
+                Block* left = freeBlock->left;
+                Block* right = usedBlock->right;
+
+                usedBlock->left = left;
+                usedBlock->right = freeBlock;
+                freeBlock->left = usedBlock;
+                freeBlock->right = right;
+
+                if (left == nullptr) {
+                    m_leftmostBlock = usedBlock;
+                } else {
+                    left->right = usedBlock;
                 }
+
+                if (right == nullptr) {
+                    m_rightmostBlock = freeBlock;
+                } else {
+                    right->left = freeBlock;
+                    if (right->free) {
+                        unlinkFromBinList(freeBlock);
+                        mergeWithRight(freeBlock);
+                        linkToBinList(freeBlock);
+                    }
+                }
+
+                move(usedBlock, oldPos);
+                ++moves;
             }
-            return false;
+
+            checkInvariants();
+            return freeBlock == nullptr || freeBlock->right == nullptr;
         }
 
 // Testing / debugging
@@ -442,11 +527,18 @@ namespace TrenchBroom {
         }
 
         AllocationTracker::Index AllocationTracker::largestPossibleAllocation() const {
-            auto it = m_freeBlockSizeBins.crbegin();
-            if (it == m_freeBlockSizeBins.crend())
+            if (m_sizeClassGroups == 0) {
                 return 0;
+            }
+
+            const size_t group = highestSetBit(m_sizeClassGroups);
+            const size_t index = group * SubClassCount + highestSetBit(m_nonEmptySizeClasses[group]);
 
-            return (*it)->size;
+            Index result = 0;
+            for (Block* block = m_sizeClasses[index]; block != nullptr; block = block->nextInSizeClass) {
+                result = std::max(result, block->size);
+            }
+            return result;
         }
 
         void AllocationTracker::checkInvariants() const {
@@ -454,7 +546,7 @@ namespace TrenchBroom {
             if (m_capacity == 0) {
                 assert(m_leftmostBlock == nullptr);
                 assert(m_rightmostBlock == nullptr);
-                assert(m_freeBlockSizeBins.empty());
+                assert(m_sizeClassGroups == 0);
                 return;
             }
 
@@ -467,6 +559,9 @@ namespace TrenchBroom {
 
             // check the left/right pointers, size, pos
             size_t totalSize = 0;
+            size_t usedSize = 0;
+            size_t usedBlockCount = 0;
+            size_t freeBlockCount = 0;
             for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
                 assert(block->size != 0);
                 totalSize += block->size;
@@ -474,41 +569,53 @@ namespace TrenchBroom {
                 if (block->right != nullptr) {
                     assert(block->right->left == block);
                     assert(block->right->pos == block->pos + block->size);
+                    // adjacent free blocks are always merged
+                    assert(!block->free || !block->right->free);
                 } else {
                     // rightmost block
                     assert(block == m_rightmostBlock);
                 }
 
-                // used blocks aren't in the nextOfSameSize linked list
-                if (!block->free) {
-                    assert(block->prevOfSameSize == nullptr);
-                    assert(block->nextOfSameSize == nullptr);
+                if (block->free) {
+                    ++freeBlockCount;
+                } else {
+                    // used blocks aren't in the size class lists
+                    assert(block->prevInSizeClass == nullptr);
+                    assert(block->nextInSizeClass == nullptr);
+                    usedSize += block->size;
+                    ++usedBlockCount;
                 }
             }
             assert(m_capacity == totalSize);
+            assert(m_usedSize == usedSize);
+            assert(m_usedBlockCount == usedBlockCount);
+            assert(m_freeBlockCount == freeBlockCount);
+
+            // check the size classes
+            size_t linkedBlockCount = 0;
+            for (size_t index = 0; index < SizeClassCount; ++index) {
+                const Block* headBlock = m_sizeClasses[index];
+                const size_t group = index / SubClassCount;
+                const bool nonEmpty = (m_nonEmptySizeClasses[group] & (1u << (index % SubClassCount))) != 0;
+                assert(nonEmpty == (headBlock != nullptr));
+                assert(((m_sizeClassGroups >> group) & 1u) == (m_nonEmptySizeClasses[group] != 0 ? 1u : 0u));
+
+                if (headBlock != nullptr) {
+                    assert(headBlock->prevInSizeClass == nullptr);
+                }
 
-            // check the size map
-            for (const auto& headBlock : m_freeBlockSizeBins) {
-                assert(headBlock != nullptr);
-                assert(headBlock->prevOfSameSize == nullptr);
-
-                // check they all have the correct size
-                for (Block* block = headBlock; block != nullptr; block = block->nextOfSameSize) {
+                // check they all have the correct size class
+                for (const Block* block = headBlock; block != nullptr; block = block->nextInSizeClass) {
                     assert(block->free);
-                    assert(block->size == headBlock->size);
+                    assert(sizeClass(block->size) == index);
+                    ++linkedBlockCount;
 
-                    if (block->nextOfSameSize != nullptr) {
-                        assert(block->nextOfSameSize->prevOfSameSize == block);
+                    if (block->nextInSizeClass != nullptr) {
+                        assert(block->nextInSizeClass->prevInSizeClass == block);
                     }
                 }
             }
-
-            // ensure the size bins are sorted
-            for (size_t i = 0; (i + 1) < m_freeBlockSizeBins.size(); ++i) {
-                const auto& a = m_freeBlockSizeBins.at(i);
-                const auto& b = m_freeBlockSizeBins.at(i + 1);
-                assert(a->size < b->size);
-            }
+            assert(linkedBlockCount == m_freeBlockCount);
 #endif
         }
     }
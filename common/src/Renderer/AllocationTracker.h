@@ -20,14 +20,23 @@
 #ifndef TrenchBroom_AllocationTracker
 #define TrenchBroom_AllocationTracker
 
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <set>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
         /**
          * Implements bookkeeping for dynamic memory allocation (like malloc).
+         *
+         * Free blocks are kept in segregated lists of size classes. The size classes subdivide every power of two
+         * into SubClassCount classes of equal width, and two levels of bitmaps record which lists are non-empty, so
+         * that both allocating and freeing take constant time. Adjacent free blocks are always merged.
          */
         class AllocationTracker {
         public:
@@ -41,11 +50,11 @@ namespace TrenchBroom {
             private:
                 friend class AllocationTracker;
                 /**
-                 * If this is null, it means we're the head of the list in the
-                 * m_freeBlockSizeBins map.
+                 * If this is null, it means we're the head of the list in
+                 * m_sizeClasses.
                  */
-                Block* prevOfSameSize;
-                Block* nextOfSameSize;
+                Block* prevInSizeClass;
+                Block* nextInSizeClass;
                 /**
                  * If this is null it means m_leftmostBlock points to us.
                  * These are used for:
@@ -65,12 +74,46 @@ namespace TrenchBroom {
                 Block* nextRecycledBlock;
             };
 
+            /**
+             * Summarizes how the managed memory is used.
+             */
+            struct Statistics {
+                Index capacity;
+                Index usedSize;
+                Index freeSize;
+                Index largestFreeBlock;
+                size_t usedBlockCount;
+                size_t freeBlockCount;
+
+                /**
+                 * Returns the fraction of free memory that cannot be used for an allocation as large as the largest
+                 * free block, i.e. 0 if all free memory is in one block and close to 1 if it is scattered across many
+                 * small blocks.
+                 */
+                double fragmentation() const;
+            };
+
+            /**
+             * Called for every used block that is moved by compact(). The block's pos has already been updated, and
+             * the caller must move block->size elements from the given old position to block->pos. The new position
+             * is always less than the old position, but the ranges may overlap.
+             */
+            using MoveBlock = std::function<void(const Block* block, Index oldPos)>;
         private:
+            static const size_t SubClassBits = 3;
+            static const size_t SubClassCount = 1u << SubClassBits;
+            static const size_t SizeClassGroupCount = sizeof(Index) * 8 - SubClassBits + 1;
+            static const size_t SizeClassCount = SizeClassGroupCount * SubClassCount;
+            static const size_t NoSizeClass = SizeClassCount;
+
             /**
              * Size of memory managed by this AllocationTracker.
              * Always equal to the sum of `size` of all Blocks.
              */
             Index m_capacity;
+            Index m_usedSize;
+            size_t m_usedBlockCount;
+            size_t m_freeBlockCount;
 
             /**
              * Points to the Block with pos 0. Used to free all of the blocks in the destructor
@@ -89,21 +132,31 @@ namespace TrenchBroom {
             Block* m_recycledBlockList;
 
             /**
-             * A map from Block size to a linked list of Blocks of that exact size
-             * (the linked list is stored in the prevOfSameSize/nextOfSameSize pointers)
-             *
-             * Sorted vector, benchmarks faster than std::map for this use case.
+             * For each size class, a linked list of the free Blocks in that class
+             * (the linked list is stored in the prevInSizeClass/nextInSizeClass pointers).
+             */
+            std::array<Block*, SizeClassCount> m_sizeClasses;
+            /**
+             * Bit i of m_sizeClassGroups is set iff the size class group i has a non-empty size class. Bit j of
+             * m_nonEmptySizeClasses[i] is set iff size class i * SubClassCount + j is non-empty.
              */
-            std::vector<Block*> m_freeBlockSizeBins;
+            uint64_t m_sizeClassGroups;
+            std::array<uint8_t, SizeClassGroupCount> m_nonEmptySizeClasses;
+
+            static size_t sizeClass(Index size);
+            static Index sizeClassLowerBound(size_t sizeClass);
+            size_t findNonEmptySizeClass(size_t firstSizeClass) const;
+            Block* findFreeBlock(Index minSize) const;
 
             /**
-             * Unlinks a Block from m_freeBlockSizeBins. Must be called before modifying Block::size.
+             * Unlinks a Block from m_sizeClasses. Must be called before modifying Block::size.
              */
             void unlinkFromBinList(Block* block);
             void linkToBinList(Block* block);
 
             void recycle(Block* block);
             Block* obtainBlock();
+            void mergeWithRight(Block* block);
 
         public:
             explicit AllocationTracker(Index initial_capacity);
@@ -122,12 +175,30 @@ namespace TrenchBroom {
             void free(Block* block);
             size_t capacity() const;
             void expand(Index newCapacity);
+            /**
+             * @return the size of the free block at the end of the managed memory, which an expansion would enlarge,
+             * or 0 if the managed memory ends with a used block.
+             */
+            Index freeSizeAtEnd() const;
             /**
              * @return whether there are any allocations. i.e. returns false iff the whole range managed by the allocation
              * tracker is free. Returns false if `capacity() == 0`. Constant time.
              */
             bool hasAllocations() const;
 
+            Statistics statistics() const;
+
+            /**
+             * Moves used blocks towards the start of the managed memory so that the free blocks merge into one free
+             * block at the end. At most `maxMoves` blocks are moved, so that a long compaction can be spread over
+             * several calls, e.g. one per frame. The Block objects remain valid, only their positions change.
+             *
+             * @param maxMoves the maximum number of blocks to move
+             * @param move called for every moved block, see MoveBlock
+             * @return true if there is at most one free block left, which is at the end, and false otherwise
+             */
+            bool compact(size_t maxMoves, const MoveBlock& move);
+
             // Testing / debugging
 
             class Range {
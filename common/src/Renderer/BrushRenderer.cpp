@@ -335,11 +335,36 @@ namespace TrenchBroom {
             m_invalidBrushes.clear();
             assert(valid());
 
+            compactIndexArrays();
+
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
         }
 
+        /**
+         * Compacting moves indices, which must be uploaded again, so we only compact an index array once at least
+         * a quarter of it is wasted on zeroed gaps, and we limit the number of moved ranges per validation.
+         */
+        static void compactIfFragmented(BrushIndexArray& indexArray) {
+            static const size_t MaxMovesPerValidation = 256;
+
+            const auto stats = indexArray.statistics();
+            if (stats.freeBlockCount > 1 && 4 * (stats.freeSize - stats.largestFreeBlock) > stats.capacity) {
+                indexArray.compact(MaxMovesPerValidation);
+            }
+        }
+
+        void BrushRenderer::compactIndexArrays() {
+            compactIfFragmented(*m_edgeIndices);
+            for (auto& entry : *m_opaqueFaces) {
+                compactIfFragmented(*entry.second);
+            }
+            for (auto& entry : *m_transparentFaces) {
+                compactIfFragmented(*entry.second);
+            }
+        }
+
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
             assert(vertexCount >= 3);
             const size_t indexCount = 3 * (vertexCount - 2);
@@ -278,6 +278,11 @@ namespace TrenchBroom {
             void addBrush(const Model::Brush* brush);
             void removeBrush(const Model::Brush* brush);
 
+            /**
+             * Incrementally compacts the index arrays in which removed brushes have left too many gaps.
+             */
+            void compactIndexArrays();
+
             /**
              * If the given brush is not currently in the VBO, it's silently ignored.
              * Otherwise, it's removed from the VBO (having its indices zeroed out, causing it to no longer draw).
@@ -130,9 +130,30 @@ namespace TrenchBroom {
             m_indexHolder.zeroRange(pos, size);
         }
 
+        AllocationTracker::Statistics BrushIndexArray::statistics() const {
+            return m_allocationTracker.statistics();
+        }
+
+        bool BrushIndexArray::compact(const size_t maxMoves) {
+            return m_allocationTracker.compact(maxMoves, [&](const AllocationTracker::Block* block, const size_t oldPos) {
+                m_indexHolder.moveElements(oldPos, block->pos, block->size);
+
+                // zero the part of the old range that is not covered by the new one
+                const size_t newEnd = block->pos + block->size;
+                const size_t oldEnd = oldPos + block->size;
+                const size_t zeroPos = std::max(oldPos, newEnd);
+                if (zeroPos < oldEnd) {
+                    m_indexHolder.zeroRange(zeroPos, oldEnd - zeroPos);
+                }
+            });
+        }
+
         void BrushIndexArray::render(const PrimType primType) const {
             assert(m_indexHolder.prepared());
-            m_indexHolder.render(primType, 0, m_indexHolder.size());
+
+            // the free range at the end only contains zeroed indices
+            const size_t count = m_allocationTracker.capacity() - m_allocationTracker.freeSizeAtEnd();
+            m_indexHolder.render(primType, 0, count);
         }
 
         bool BrushIndexArray::prepared() const {
@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <vector>
 #include <cassert>
+#include <cstring>
 #include <unordered_map>
 
 namespace TrenchBroom {
@@ -141,6 +142,17 @@ namespace TrenchBroom {
                 return m_snapshot.data() + offsetWithinBlock;
             }
 
+            /**
+             * Moves the given number of elements within the block. The source and destination ranges may overlap.
+             */
+            void moveElements(const size_t fromOffset, const size_t toOffset, const size_t elementCount) {
+                assert(fromOffset + elementCount <= m_snapshot.size());
+                assert(toOffset + elementCount <= m_snapshot.size());
+
+                m_dirtyRange.markDirty(toOffset, elementCount);
+                std::memmove(m_snapshot.data() + toOffset, m_snapshot.data() + fromOffset, elementCount * sizeof(T));
+            }
+
             bool prepared() const {
                 // NOTE: this returns true if the capacity is 0
                 return m_dirtyRange.clean();
@@ -243,6 +255,17 @@ namespace TrenchBroom {
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
+            AllocationTracker::Statistics statistics() const;
+
+            /**
+             * Moves allocated ranges of indices towards the start of the array so that the zeroed ranges merge at the
+             * end, where they are no longer rendered. The keys returned by getPointerToInsertElementsAt() remain
+             * valid. At most `maxMoves` ranges are moved per call.
+             *
+             * Returns true if the array is fully compacted.
+             */
+            bool compact(size_t maxMoves);
+
             void render(const PrimType primType) const;
             bool prepared() const;
             void prepare(Vbo& vbo);
@@ -66,6 +66,8 @@ namespace TrenchBroom {
 
             for (Model::BrushFace* face : brush->faces()) {
                 const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
+                const auto normal = vm::vec3f(face->boundary().normal);
+                const auto texCoords = face->textureCoordProjection();
 
                 const auto* first = face->geometry()->boundary().front();
                 const auto* current = first;
@@ -80,7 +82,7 @@ namespace TrenchBroom {
                     vertex->setPayload(static_cast<GLuint>(currentIndex));
 
                     const auto& position = vertex->position();
-                    m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face->boundary().normal), face->textureCoords(position));
+                    m_cachedVertices.emplace_back(vm::vec3f(position), normal, texCoords(position));
 
                     // The boundary is in CCW order, but the renderer expects CW order:
                     current = current->previous();
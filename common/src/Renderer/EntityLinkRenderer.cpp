@@ -24,6 +24,7 @@
 #include "Model/CollectMatchingNodesVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
+#include "Model/EntityLinkGraph.h"
 #include "Model/NodeVisitor.h"
 #include "Model/World.h"
 #include "Renderer/Camera.h"
@@ -165,6 +166,14 @@ namespace TrenchBroom {
             arrows.emplace_back(vm::vec3f{0,-3, 0}, color, arrowPosition, lineDir);
         }
 
+        void EntityLinkRenderer::addLink(Vertex::List& links, const Model::AttributableNode* source, const Model::AttributableNode* target, const Color& defaultColor, const Color& selectedColor) {
+            const auto anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
+            const auto& color = anySelected ? selectedColor : defaultColor;
+
+            links.emplace_back(vm::vec3f(source->linkSourceAnchor()), color);
+            links.emplace_back(vm::vec3f(target->linkTargetAnchor()), color);
+        }
+
         class EntityLinkRenderer::MatchEntities {
         public:
             bool operator()(const Model::Entity* entity) { return true; }
@@ -200,32 +209,7 @@ namespace TrenchBroom {
             virtual void visitEntity(Model::Entity* entity) = 0;
         protected:
             void addLink(const Model::AttributableNode* source, const Model::AttributableNode* target) {
-                const auto anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
-                const auto& sourceColor = anySelected ? m_selectedColor : m_defaultColor;
-                const auto targetColor = anySelected ? m_selectedColor : m_defaultColor;
-
-                m_links.emplace_back(vm::vec3f(source->linkSourceAnchor()), sourceColor);
-                m_links.emplace_back(vm::vec3f(target->linkTargetAnchor()), targetColor);
-            }
-        };
-
-        class EntityLinkRenderer::CollectAllLinksVisitor : public CollectLinksVisitor {
-        public:
-            CollectAllLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, Vertex::List& links) :
-            CollectLinksVisitor(editorContext, defaultColor, selectedColor, links) {}
-        private:
-            void visitEntity(Model::Entity* entity) override {
-                if (m_editorContext.visible(entity)) {
-                    addTargets(entity, entity->linkTargets());
-                    addTargets(entity, entity->killTargets());
-                }
-            }
-
-            void addTargets(Model::Entity* source, const Model::AttributableNodeList& targets) {
-                for (const Model::AttributableNode* target : targets) {
-                    if (m_editorContext.visible(target))
-                        addLink(source, target);
-                }
+                EntityLinkRenderer::addLink(m_links, source, target, m_defaultColor, m_selectedColor);
             }
         };
 
@@ -319,11 +303,16 @@ namespace TrenchBroom {
             View::MapDocumentSPtr document = lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
 
-            CollectAllLinksVisitor collectLinks(editorContext, m_defaultColor, m_selectedColor, links);
+            const Model::World* world = document->world();
+            if (world == nullptr)
+                return;
 
-            Model::World* world = document->world();
-            if (world != nullptr)
-                world->acceptAndRecurse(collectLinks);
+            // read the links directly from the world's link graph instead of visiting every entity
+            const auto addVisibleLink = [&](const Model::AttributableNode* source, const Model::AttributableNode* target) {
+                if (source != world && editorContext.visible(source) && editorContext.visible(target))
+                    addLink(links, source, target, m_defaultColor, m_selectedColor);
+            };
+            world->entityLinkGraph().forEachLink(addVisibleLink, addVisibleLink);
         }
 
         void EntityLinkRenderer::getTransitiveSelectedLinks(Vertex::List& links) const {
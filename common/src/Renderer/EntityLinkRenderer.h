@@ -78,12 +78,12 @@ namespace TrenchBroom {
 
             static void getArrows(ArrowVertex::List& arrows, const Vertex::List& links);
             static void addArrow(ArrowVertex::List& arrows, const vm::vec4f& color, const vm::vec3f& arrowPosition, const vm::vec3f& lineDir);
+            static void addLink(Vertex::List& links, const Model::AttributableNode* source, const Model::AttributableNode* target, const Color& defaultColor, const Color& selectedColor);
 
             class MatchEntities;
             class CollectEntitiesVisitor;
 
             class CollectLinksVisitor;
-            class CollectAllLinksVisitor;
             class CollectTransitiveSelectedLinksVisitor;
             class CollectDirectSelectedLinksVisitor;
 
@@ -85,6 +85,7 @@ namespace TrenchBroom {
 
             void addEntity(Model::Entity* entity);
             void updateEntity(Model::Entity* entity);
+            void removeEntity(Model::Entity* entity);
             void clear();
 
             bool applyTinting() const;
@@ -38,6 +38,7 @@
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/TextAnchor.h"
+#include "Renderer/TextRenderer.h"
 #include "Renderer/GLVertexType.h"
 
 #include <vecmath/forward.h>
@@ -46,6 +47,8 @@
 #include <vecmath/mat_ext.h>
 #include <vecmath/scalar.h>
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Renderer {
         class EntityRenderer::EntityClassnameAnchor : public TextAnchor3D {
@@ -56,11 +59,16 @@ namespace TrenchBroom {
             m_entity(entity) {}
         private:
             vm::vec3f basePosition() const override {
-                auto position = vm::vec3f(m_entity->bounds().center());
-                position[2] = float(m_entity->bounds().max.z());
+                return position(m_entity);
+            }
+        public:
+            static vm::vec3f position(const Model::Entity* entity) {
+                auto position = vm::vec3f(entity->bounds().center());
+                position[2] = float(entity->bounds().max.z());
                 position[2] += 2.0f;
                 return position;
             }
+        private:
 
             TextAlignment::Type alignment() const override {
                 return TextAlignment::Bottom;
@@ -70,32 +78,95 @@ namespace TrenchBroom {
         EntityRenderer::EntityRenderer(Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
         m_entityModelManager(entityModelManager),
         m_editorContext(editorContext),
+        m_classnameTreeValid(false),
         m_modelRenderer(m_entityModelManager, m_editorContext),
-        m_boundsValid(false),
         m_showOverlays(true),
         m_showOccludedOverlays(false),
         m_tint(false),
         m_overrideBoundsColor(false),
         m_showOccludedBounds(false),
         m_showAngles(false),
-        m_showHiddenEntities(false) {}
+        m_showHiddenEntities(false) {
+            clearBounds();
+        }
 
         void EntityRenderer::setEntities(const Model::EntityList& entities) {
+            const std::unordered_set<const Model::Entity*> newEntities(std::begin(entities), std::end(entities));
+            for (Model::Entity* entity : m_entities) {
+                if (newEntities.count(entity) == 0) {
+                    removeEntityFromVbo(entity);
+                    m_invalidEntities.erase(entity);
+                    m_modelRenderer.removeEntity(entity);
+                }
+            }
+
+            for (Model::Entity* entity : entities) {
+                if (m_entityInfo.count(entity) == 0 && m_invalidEntities.count(entity) == 0) {
+                    m_invalidEntities.insert(entity);
+                    m_modelRenderer.addEntity(entity);
+                }
+            }
+
             m_entities = entities;
-            m_modelRenderer.setEntities(std::begin(m_entities), std::end(m_entities));
-            invalidate();
+            m_classnameTreeValid = false;
+        }
+
+        void EntityRenderer::addEntities(const Model::EntityList& entities) {
+            for (Model::Entity* entity : entities) {
+                if (m_entityInfo.count(entity) == 0 && m_invalidEntities.count(entity) == 0) {
+                    m_entities.push_back(entity);
+                    m_invalidEntities.insert(entity);
+                    m_modelRenderer.addEntity(entity);
+                }
+            }
+            m_classnameTreeValid = false;
+        }
+
+        void EntityRenderer::removeEntities(const Model::EntityList& entities) {
+            std::unordered_set<const Model::Entity*> toRemove;
+            for (Model::Entity* entity : entities) {
+                if (m_entityInfo.count(entity) != 0 || m_invalidEntities.count(entity) != 0) {
+                    removeEntityFromVbo(entity);
+                    m_invalidEntities.erase(entity);
+                    m_modelRenderer.removeEntity(entity);
+                    toRemove.insert(entity);
+                }
+            }
+
+            if (!toRemove.empty()) {
+                VectorUtils::eraseIf(m_entities, [&](const Model::Entity* entity) { return toRemove.count(entity) != 0; });
+                m_classnameTreeValid = false;
+            }
         }
 
         void EntityRenderer::invalidate() {
-            invalidateBounds();
+            clearBounds();
+            m_invalidEntities = std::unordered_set<const Model::Entity*>(std::begin(m_entities), std::end(m_entities));
             reloadModels();
+            m_classnameTreeValid = false;
+        }
+
+        void EntityRenderer::invalidateEntities(const Model::EntityList& entities) {
+            for (Model::Entity* entity : entities) {
+                if (m_entityInfo.count(entity) != 0) {
+                    removeEntityFromVbo(entity);
+                    m_invalidEntities.insert(entity);
+                    m_modelRenderer.updateEntity(entity);
+                    m_classnameTreeValid = false;
+                }
+            }
+        }
+
+        bool EntityRenderer::valid() const {
+            return m_invalidEntities.empty();
         }
 
         void EntityRenderer::clear() {
             m_entities.clear();
-            m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-            m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-            m_solidBoundsRenderer = TriangleRenderer();
+            m_invalidEntities.clear();
+            m_classnameTree.clear();
+            m_classnameTreeValid = false;
+            clearBounds();
             m_modelRenderer.clear();
         }
 
@@ -128,11 +199,17 @@ namespace TrenchBroom {
         }
 
         void EntityRenderer::setOverrideBoundsColor(const bool overrideBoundsColor) {
-            m_overrideBoundsColor = overrideBoundsColor;
+            if (overrideBoundsColor != m_overrideBoundsColor) {
+                m_overrideBoundsColor = overrideBoundsColor;
+                invalidate();
+            }
         }
 
         void EntityRenderer::setBoundsColor(const Color& boundsColor) {
-            m_boundsColor = boundsColor;
+            if (boundsColor != m_boundsColor) {
+                m_boundsColor = boundsColor;
+                invalidate();
+            }
         }
 
         void EntityRenderer::setShowOccludedBounds(const bool showOccludedBounds) {
@@ -164,9 +241,16 @@ namespace TrenchBroom {
             }
         }
 
+        void EntityRenderer::validate() {
+            for (const Model::Entity* entity : m_invalidEntities) {
+                validateEntity(entity);
+            }
+            m_invalidEntities.clear();
+        }
+
         void EntityRenderer::renderBounds(RenderContext& renderContext, RenderBatch& renderBatch) {
-            if (!m_boundsValid)
-                validateBounds();
+            if (!valid())
+                validate();
 
             if (renderContext.showPointEntityBounds()) {
                 renderPointEntityWireframeBounds(renderBatch);
@@ -215,7 +299,8 @@ namespace TrenchBroom {
                 renderService.setForegroundColor(m_overlayTextColor);
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
 
-                for (const Model::Entity* entity : m_entities) {
+                for (const size_t index : findClassnameCandidates(renderContext)) {
+                    const Model::Entity* entity = m_entities[index];
                     if (m_showHiddenEntities || m_editorContext.visible(entity)) {
                         if (entity->group() == nullptr || entity->group() == m_editorContext.currentGroup()) {
                             if (m_showOccludedOverlays)
@@ -229,6 +314,45 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<size_t> EntityRenderer::findClassnameCandidates(const RenderContext& renderContext) {
+            std::vector<size_t> result;
+
+            // Occluded classnames are rendered on top without a distance limit, otherwise the text renderer culls
+            // the classnames that are too far away or behind the camera, so we can skip them here.
+            if (m_showOccludedOverlays || !renderContext.render3D()) {
+                result.resize(m_entities.size());
+                for (size_t i = 0; i < m_entities.size(); ++i)
+                    result[i] = i;
+                return result;
+            }
+
+            if (!m_classnameTreeValid) {
+                std::vector<size_t> indices(m_entities.size());
+                for (size_t i = 0; i < m_entities.size(); ++i)
+                    indices[i] = i;
+                m_classnameTree.clearAndBuild(indices, [this](const size_t i) {
+                    const auto position = EntityClassnameAnchor::position(m_entities[i]);
+                    return vm::bbox3f(position, position);
+                });
+                m_classnameTreeValid = true;
+            }
+
+            const Camera& camera = renderContext.camera();
+            const auto& origin = camera.position();
+            const auto& direction = camera.direction();
+            const auto absDirection = abs(direction);
+
+            m_classnameTree.findMatching([&](const vm::bbox3f& bounds) {
+                const auto center = dot(bounds.center() - origin, direction);
+                const auto extent = dot(bounds.size() / 2.0f, absDirection);
+                return center + extent > 0.0f && center - extent <= TextRenderer::DefaultMaxViewDistance;
+            }, std::back_inserter(result));
+
+            // keep the order in which the classnames are rendered stable
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        }
+
         void EntityRenderer::renderAngles(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!m_showAngles) {
                 return;
@@ -284,117 +408,91 @@ namespace TrenchBroom {
             return result;
         }
 
-        struct EntityRenderer::BuildColoredSolidBoundsVertices {
-            GLVertexTypes::P3NC4::Vertex::List& vertices;
-            Color color;
-
-            BuildColoredSolidBoundsVertices(GLVertexTypes::P3NC4::Vertex::List& i_vertices, const Color& i_color) :
-            vertices(i_vertices),
-            color(i_color) {}
-
-            void operator()(const vm::vec3& v1, const vm::vec3& v2, const vm::vec3& v3, const vm::vec3& v4, const vm::vec3& n) {
-                vertices.emplace_back(vm::vec3f(v1), vm::vec3f(n), color);
-                vertices.emplace_back(vm::vec3f(v2), vm::vec3f(n), color);
-                vertices.emplace_back(vm::vec3f(v3), vm::vec3f(n), color);
-                vertices.emplace_back(vm::vec3f(v4), vm::vec3f(n), color);
-            }
-        };
-
-        struct EntityRenderer::BuildColoredWireframeBoundsVertices {
-            GLVertexTypes::P3C4::Vertex::List& vertices;
-            Color color;
-
-            BuildColoredWireframeBoundsVertices(GLVertexTypes::P3C4::Vertex::List& i_vertices, const Color& i_color) :
-            vertices(i_vertices),
-            color(i_color) {}
-
-            void operator()(const vm::vec3& v1, const vm::vec3& v2) {
-                vertices.emplace_back(vm::vec3f(v1), color);
-                vertices.emplace_back(vm::vec3f(v2), color);
-            }
-        };
-
-        struct EntityRenderer::BuildWireframeBoundsVertices {
-            GLVertexTypes::P3::Vertex::List& vertices;
-
-            explicit BuildWireframeBoundsVertices(GLVertexTypes::P3::Vertex::List& i_vertices) :
-            vertices(i_vertices) {}
-
-            void operator()(const vm::vec3& v1, const vm::vec3& v2) {
-                vertices.emplace_back(vm::vec3f(v1));
-                vertices.emplace_back(vm::vec3f(v2));
-            }
-        };
+        static AllocationTracker::Block* insertSolidBounds(EntitySolidVertexArray& vertexArray, const vm::bbox3& bounds, const Color& color) {
+            // one quad per face
+            const auto insert = vertexArray.getPointerToInsertVerticesAt(24);
+            auto* dest = insert.second;
+            bounds.forEachFace([&](const vm::vec3& v1, const vm::vec3& v2, const vm::vec3& v3, const vm::vec3& v4, const vm::vec3& n) {
+                *dest++ = GLVertexTypes::P3NC4::Vertex(vm::vec3f(v1), vm::vec3f(n), color);
+                *dest++ = GLVertexTypes::P3NC4::Vertex(vm::vec3f(v2), vm::vec3f(n), color);
+                *dest++ = GLVertexTypes::P3NC4::Vertex(vm::vec3f(v3), vm::vec3f(n), color);
+                *dest++ = GLVertexTypes::P3NC4::Vertex(vm::vec3f(v4), vm::vec3f(n), color);
+            });
+            return insert.first;
+        }
 
-        void EntityRenderer::invalidateBounds() {
-            m_boundsValid = false;
+        static AllocationTracker::Block* insertWireframeBounds(EntityWireframeVertexArray& vertexArray, const vm::bbox3& bounds, const Color& color) {
+            // one line per edge
+            const auto insert = vertexArray.getPointerToInsertVerticesAt(24);
+            auto* dest = insert.second;
+            bounds.forEachEdge([&](const vm::vec3& v1, const vm::vec3& v2) {
+                *dest++ = GLVertexTypes::P3C4::Vertex(vm::vec3f(v1), color);
+                *dest++ = GLVertexTypes::P3C4::Vertex(vm::vec3f(v2), color);
+            });
+            return insert.first;
         }
 
-        void EntityRenderer::validateBounds() {
-            GLVertexTypes::P3NC4::Vertex::List solidVertices;
-            solidVertices.reserve(36 * m_entities.size());
+        void EntityRenderer::clearBounds() {
+            m_entityInfo.clear();
 
-            if (m_overrideBoundsColor) {
-                GLVertexTypes::P3::Vertex::List pointEntityWireframeVertices;
-                GLVertexTypes::P3::Vertex::List brushEntityWireframeVertices;
+            m_pointEntityWireframeBounds = std::make_shared<EntityWireframeVertexArray>();
+            m_brushEntityWireframeBounds = std::make_shared<EntityWireframeVertexArray>();
+            m_solidBounds = std::make_shared<EntitySolidVertexArray>();
 
-                pointEntityWireframeVertices.reserve(24 * m_entities.size());
-                brushEntityWireframeVertices.reserve(24 * m_entities.size());
+            m_pointEntityWireframeBoundsRenderer = EntityEdgeRenderer(m_pointEntityWireframeBounds);
+            m_brushEntityWireframeBoundsRenderer = EntityEdgeRenderer(m_brushEntityWireframeBounds);
+            m_solidBoundsRenderer = EntitySolidRenderer(m_solidBounds);
+        }
 
-                BuildWireframeBoundsVertices pointEntityWireframeBoundsBuilder(pointEntityWireframeVertices);
-                BuildWireframeBoundsVertices brushEntityWireframeBoundsBuilder(brushEntityWireframeVertices);
+        void EntityRenderer::validateEntity(const Model::Entity* entity) {
+            EntityInfo info { nullptr, nullptr, nullptr };
 
-                for (const Model::Entity* entity : m_entities) {
-                    if (m_editorContext.visible(entity)) {
-                        const bool pointEntity = !entity->hasChildren();
-                        if (pointEntity) {
-                            entity->definitionBounds().forEachEdge(pointEntityWireframeBoundsBuilder);
-                        } else {
-                            entity->bounds().forEachEdge(brushEntityWireframeBoundsBuilder);
-                        }
+            if (m_editorContext.visible(entity)) {
+                const bool pointEntity = !entity->hasChildren();
+                const Color& color = boundsColor(entity);
 
-                        if (pointEntity && !entity->hasPointEntityModel()) {
-                            BuildColoredSolidBoundsVertices solidBoundsBuilder(solidVertices, boundsColor(entity));
-                            entity->bounds().forEachFace(solidBoundsBuilder);
-                        }
+                if (m_overrideBoundsColor) {
+                    // the edges are rendered with the override color, so every entity gets wireframe bounds
+                    if (pointEntity) {
+                        info.pointEntityWireframeBoundsKey = insertWireframeBounds(*m_pointEntityWireframeBounds, entity->definitionBounds(), color);
+                    } else {
+                        info.brushEntityWireframeBoundsKey = insertWireframeBounds(*m_brushEntityWireframeBounds, entity->bounds(), color);
                     }
-                }
 
-                m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(pointEntityWireframeVertices)), GL_LINES);
-                m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(brushEntityWireframeVertices)), GL_LINES);
-            } else {
-                GLVertexTypes::P3C4::Vertex::List pointEntityWireframeVertices;
-                GLVertexTypes::P3C4::Vertex::List brushEntityWireframeVertices;
-
-                pointEntityWireframeVertices.reserve(24 * m_entities.size());
-                brushEntityWireframeVertices.reserve(24 * m_entities.size());
-
-                for (const Model::Entity* entity : m_entities) {
-                    if (m_editorContext.visible(entity)) {
-                        const bool pointEntity = !entity->hasChildren();
-
-                        if (pointEntity && !entity->hasPointEntityModel()) {
-                            BuildColoredSolidBoundsVertices solidBoundsBuilder(solidVertices, boundsColor(entity));
-                            entity->definitionBounds().forEachFace(solidBoundsBuilder);
-                        } else {
-                            BuildColoredWireframeBoundsVertices pointEntityWireframeBoundsBuilder(pointEntityWireframeVertices, boundsColor(entity));
-                            BuildColoredWireframeBoundsVertices brushEntityWireframeBoundsBuilder(brushEntityWireframeVertices, boundsColor(entity));
-
-                            if (pointEntity) {
-                                entity->definitionBounds().forEachEdge(pointEntityWireframeBoundsBuilder);
-                            } else {
-                                entity->bounds().forEachEdge(brushEntityWireframeBoundsBuilder);
-                            }
-                        }
+                    if (pointEntity && !entity->hasPointEntityModel()) {
+                        info.solidBoundsKey = insertSolidBounds(*m_solidBounds, entity->bounds(), color);
+                    }
+                } else {
+                    if (pointEntity && !entity->hasPointEntityModel()) {
+                        info.solidBoundsKey = insertSolidBounds(*m_solidBounds, entity->definitionBounds(), color);
+                    } else if (pointEntity) {
+                        info.pointEntityWireframeBoundsKey = insertWireframeBounds(*m_pointEntityWireframeBounds, entity->definitionBounds(), color);
+                    } else {
+                        info.brushEntityWireframeBoundsKey = insertWireframeBounds(*m_brushEntityWireframeBounds, entity->bounds(), color);
                     }
                 }
+            }
+
+            m_entityInfo[entity] = info;
+        }
 
-                m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(pointEntityWireframeVertices)), GL_LINES);
-                m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(brushEntityWireframeVertices)), GL_LINES);
+        void EntityRenderer::removeEntityFromVbo(const Model::Entity* entity) {
+            const auto it = m_entityInfo.find(entity);
+            if (it == std::end(m_entityInfo)) {
+                return;
             }
 
-            m_solidBoundsRenderer = TriangleRenderer(VertexArray::move(std::move(solidVertices)), GL_QUADS);
-            m_boundsValid = true;
+            const EntityInfo& info = it->second;
+            if (info.solidBoundsKey != nullptr) {
+                m_solidBounds->zeroVerticesWithKey(info.solidBoundsKey);
+            }
+            if (info.pointEntityWireframeBoundsKey != nullptr) {
+                m_pointEntityWireframeBounds->zeroVerticesWithKey(info.pointEntityWireframeBoundsKey);
+            }
+            if (info.brushEntityWireframeBoundsKey != nullptr) {
+                m_brushEntityWireframeBounds->zeroVerticesWithKey(info.brushEntityWireframeBoundsKey);
+            }
+            m_entityInfo.erase(it);
         }
 
         AttrString EntityRenderer::entityString(const Model::Entity* entity) const {
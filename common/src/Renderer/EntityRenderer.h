@@ -20,20 +20,23 @@
 #ifndef TrenchBroom_EntityRenderer
 #define TrenchBroom_EntityRenderer
 
+#include "AABBTree.h"
 #include "AttrString.h"
 #include "Color.h"
 #include "Model/ModelTypes.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/EntityModelRenderer.h"
+#include "Renderer/EntityRendererArrays.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/Renderable.h"
-#include "Renderer/TriangleRenderer.h"
 #include "Renderer/Vbo.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -52,16 +55,43 @@ namespace TrenchBroom {
         private:
             class EntityClassnameAnchor;
 
+            /**
+             * Indexes the classname anchor positions by position in m_entities.
+             */
+            using ClassnameTree = AABBTree<float, 3, size_t>;
+
             Assets::EntityModelManager& m_entityModelManager;
             const Model::EditorContext& m_editorContext;
             Model::EntityList m_entities;
-
-            DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
-            DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
-
-            TriangleRenderer m_solidBoundsRenderer;
+            ClassnameTree m_classnameTree;
+            bool m_classnameTreeValid;
+
+            struct EntityInfo {
+                AllocationTracker::Block* solidBoundsKey;
+                AllocationTracker::Block* pointEntityWireframeBoundsKey;
+                AllocationTracker::Block* brushEntityWireframeBoundsKey;
+            };
+            /**
+             * Tracks all entities whose bounds are stored in the vertex arrays, with the information necessary to
+             * remove them from the vertex arrays later.
+             */
+            std::unordered_map<const Model::Entity*, EntityInfo> m_entityInfo;
+
+            /**
+             * Every entity in m_entities is either valid, in which case it has an entry in m_entityInfo, or it is
+             * contained in this set.
+             */
+            std::unordered_set<const Model::Entity*> m_invalidEntities;
+
+            EntityWireframeVertexArrayPtr m_pointEntityWireframeBounds;
+            EntityWireframeVertexArrayPtr m_brushEntityWireframeBounds;
+            EntitySolidVertexArrayPtr m_solidBounds;
+
+            EntityEdgeRenderer m_pointEntityWireframeBoundsRenderer;
+            EntityEdgeRenderer m_brushEntityWireframeBoundsRenderer;
+
+            EntitySolidRenderer m_solidBoundsRenderer;
             EntityModelRenderer m_modelRenderer;
-            bool m_boundsValid;
 
             bool m_showOverlays;
             Color m_overlayTextColor;
@@ -79,8 +109,25 @@ namespace TrenchBroom {
         public:
             EntityRenderer(Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext);
 
+            /**
+             * Entities that are already in the renderer are not invalidated.
+             */
             void setEntities(const Model::EntityList& entities);
+            void addEntities(const Model::EntityList& entities);
+            void removeEntities(const Model::EntityList& entities);
+
+            /**
+             * Marks all entities as invalid, so that their bounds are rebuilt and their models are reloaded.
+             */
             void invalidate();
+
+            /**
+             * Marks the given entities as invalid. Only the bounds of invalid entities are rebuilt when the renderer
+             * is validated, the vertices of all other entities remain untouched.
+             */
+            void invalidateEntities(const Model::EntityList& entities);
+            bool valid() const;
+
             void clear();
             void reloadModels();
 
@@ -104,6 +151,11 @@ namespace TrenchBroom {
             void setShowHiddenEntities(bool showHiddenEntities);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
+
+            /**
+             * Only exposed for benchmarking.
+             */
+            void validate();
         private:
             void renderBounds(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderPointEntityWireframeBounds(RenderBatch& renderBatch);
@@ -111,6 +163,7 @@ namespace TrenchBroom {
             void renderSolidBounds(RenderBatch& renderBatch);
             void renderModels(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch);
+            std::vector<size_t> findClassnameCandidates(const RenderContext& renderContext);
             void renderAngles(RenderContext& renderContext, RenderBatch& renderBatch);
             std::vector<vm::vec3f> arrowHead(float length, float width) const;
 
@@ -118,8 +171,9 @@ namespace TrenchBroom {
             struct BuildColoredWireframeBoundsVertices;
             struct BuildWireframeBoundsVertices;
 
-            void invalidateBounds();
-            void validateBounds();
+            void clearBounds();
+            void validateEntity(const Model::Entity* entity);
+            void removeEntityFromVbo(const Model::Entity* entity);
 
             AttrString entityString(const Model::Entity* entity) const;
             const Color& boundsColor(const Model::Entity* entity) const;
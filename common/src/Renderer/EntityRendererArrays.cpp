@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityRendererArrays.h"
+
+#include "Renderer/Camera.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/Shaders.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/ShaderProgram.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        // EntityEdgeRenderer::Render
+
+        EntityEdgeRenderer::Render::Render(const EdgeRenderer::Params& params, EntityWireframeVertexArrayPtr vertexArray) :
+        RenderBase(params),
+        m_vertexArray(vertexArray) {}
+
+        void EntityEdgeRenderer::Render::doPrepareVertices(Vbo& vertexVbo) {
+            m_vertexArray->prepare(vertexVbo);
+        }
+
+        void EntityEdgeRenderer::Render::doRender(RenderContext& renderContext) {
+            if (!m_vertexArray->hasValidVertices()) {
+                return;
+            }
+            renderEdges(renderContext);
+        }
+
+        void EntityEdgeRenderer::Render::doRenderVertices(RenderContext& renderContext) {
+            m_vertexArray->render(GL_LINES);
+        }
+
+        // EntityEdgeRenderer
+
+        EntityEdgeRenderer::EntityEdgeRenderer() :
+        m_vertexArray(std::make_shared<EntityWireframeVertexArray>()) {}
+
+        EntityEdgeRenderer::EntityEdgeRenderer(EntityWireframeVertexArrayPtr vertexArray) :
+        m_vertexArray(vertexArray) {}
+
+        void EntityEdgeRenderer::doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) {
+            renderBatch.addOneShot(new Render(params, m_vertexArray));
+        }
+
+        // EntitySolidRenderer
+
+        EntitySolidRenderer::EntitySolidRenderer() :
+        m_vertexArray(std::make_shared<EntitySolidVertexArray>()),
+        m_applyTinting(false) {}
+
+        EntitySolidRenderer::EntitySolidRenderer(EntitySolidVertexArrayPtr vertexArray) :
+        m_vertexArray(vertexArray),
+        m_applyTinting(false) {}
+
+        void EntitySolidRenderer::setApplyTinting(const bool applyTinting) {
+            m_applyTinting = applyTinting;
+        }
+
+        void EntitySolidRenderer::setTintColor(const Color& tintColor) {
+            m_tintColor = tintColor;
+        }
+
+        void EntitySolidRenderer::doPrepareVertices(Vbo& vertexVbo) {
+            m_vertexArray->prepare(vertexVbo);
+        }
+
+        void EntitySolidRenderer::doRender(RenderContext& renderContext) {
+            if (!m_vertexArray->hasValidVertices()) {
+                return;
+            }
+
+            ActiveShader shader(renderContext.shaderManager(), Shaders::TriangleShader);
+            shader.set("ApplyTinting", m_applyTinting);
+            shader.set("TintColor", m_tintColor);
+            shader.set("UseColor", false);
+            shader.set("CameraPosition", renderContext.camera().position());
+            m_vertexArray->render(GL_QUADS);
+        }
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EntityRendererArrays
+#define TrenchBroom_EntityRendererArrays
+
+#include "Color.h"
+#include "Renderer/AllocationTracker.h"
+#include "Renderer/BrushRendererArrays.h"
+#include "Renderer/EdgeRenderer.h"
+#include "Renderer/GL.h"
+#include "Renderer/GLVertexType.h"
+#include "Renderer/Renderable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        class RenderBatch;
+        class RenderContext;
+        class Vbo;
+
+        /**
+         * Stores the vertices of many entities in a single VBO block. Each entity writes its vertices into its own
+         * range, so that a changed entity can be replaced without touching the vertices of the other entities.
+         *
+         * The array is rendered without indices, so freed ranges are zeroed out and become degenerate primitives.
+         */
+        template <typename V>
+        class EntityVertexArray {
+        private:
+            VertexHolder<V> m_vertexHolder;
+            AllocationTracker m_allocationTracker;
+        public:
+            EntityVertexArray() :
+            m_vertexHolder(),
+            m_allocationTracker(0) {}
+
+            /**
+             * Returns true if any range is allocated. Ranges freed by zeroVerticesWithKey() do not count.
+             */
+            bool hasValidVertices() const {
+                return m_allocationTracker.hasAllocations();
+            }
+
+            /**
+             * Call this to request writing the given number of vertices.
+             *
+             * The VboBlock will be expanded if needed to accommodate the allocation.
+             *
+             * Returns a AllocationTracker::Block pointer which can be used later in a call to zeroVerticesWithKey(),
+             * and also a Vertex pointer where the caller should write `vertexCount` Vertex objects.
+             */
+            std::pair<AllocationTracker::Block*, V*> getPointerToInsertVerticesAt(const size_t vertexCount) {
+                auto block = m_allocationTracker.allocate(vertexCount);
+                if (block == nullptr) {
+                    const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                    m_allocationTracker.capacity() + vertexCount);
+                    m_allocationTracker.expand(newSize);
+                    m_vertexHolder.resize(newSize);
+
+                    block = m_allocationTracker.allocate(vertexCount);
+                    assert(block != nullptr);
+                }
+
+                V* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+                return { block, dest };
+            }
+
+            /**
+             * Zeroes the vertices with the given key and marks the allocation as free.
+             */
+            void zeroVerticesWithKey(AllocationTracker::Block* key) {
+                const auto pos = key->pos;
+                const auto size = key->size;
+                m_allocationTracker.free(key);
+
+                V* dest = m_vertexHolder.getPointerToWriteElementsTo(pos, size);
+                std::fill(dest, dest + size, V());
+            }
+
+            void render(const PrimType primType) {
+                assert(m_vertexHolder.prepared());
+                if (m_vertexHolder.setupVertices()) {
+                    glAssert(glDrawArrays(primType, 0, static_cast<GLsizei>(m_vertexHolder.size())));
+                    m_vertexHolder.cleanupVertices();
+                }
+            }
+
+            bool prepared() const {
+                return m_vertexHolder.prepared();
+            }
+
+            void prepare(Vbo& vbo) {
+                m_vertexHolder.prepare(vbo);
+                assert(m_vertexHolder.prepared());
+            }
+        };
+
+        using EntityWireframeVertexArray = EntityVertexArray<GLVertexTypes::P3C4::Vertex>;
+        using EntityWireframeVertexArrayPtr = std::shared_ptr<EntityWireframeVertexArray>;
+        using EntitySolidVertexArray = EntityVertexArray<GLVertexTypes::P3NC4::Vertex>;
+        using EntitySolidVertexArrayPtr = std::shared_ptr<EntitySolidVertexArray>;
+
+        /**
+         * Renders the edges stored in an entity vertex array as lines.
+         */
+        class EntityEdgeRenderer : public EdgeRenderer {
+        private:
+            class Render : public RenderBase, public DirectRenderable {
+            private:
+                EntityWireframeVertexArrayPtr m_vertexArray;
+            public:
+                Render(const Params& params, EntityWireframeVertexArrayPtr vertexArray);
+            private:
+                void doPrepareVertices(Vbo& vertexVbo) override;
+                void doRender(RenderContext& renderContext) override;
+                void doRenderVertices(RenderContext& renderContext) override;
+            };
+        private:
+            EntityWireframeVertexArrayPtr m_vertexArray;
+        public:
+            EntityEdgeRenderer();
+            explicit EntityEdgeRenderer(EntityWireframeVertexArrayPtr vertexArray);
+        private:
+            void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
+        };
+
+        /**
+         * Renders the quads stored in an entity vertex array with the triangle shader.
+         */
+        class EntitySolidRenderer : public DirectRenderable {
+        private:
+            EntitySolidVertexArrayPtr m_vertexArray;
+            Color m_tintColor;
+            bool m_applyTinting;
+        public:
+            EntitySolidRenderer();
+            explicit EntitySolidRenderer(EntitySolidVertexArrayPtr vertexArray);
+
+            void setApplyTinting(bool applyTinting);
+            void setTintColor(const Color& tintColor);
+        private:
+            void doPrepareVertices(Vbo& vertexVbo) override;
+            void doRender(RenderContext& renderContext) override;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityRendererArrays) */
@@ -31,6 +31,7 @@
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/Node.h"
+#include "Model/NodeCollection.h"
 #include "Model/NodeVisitor.h"
 #include "Model/Tag.h"
 #include "Model/TagAttribute.h"
@@ -45,6 +46,7 @@
 #include "Renderer/RenderUtils.h"
 #include "View/Selection.h"
 #include "View/MapDocument.h"
+#include "View/NodeChanges.h"
 
 #include <set>
 
@@ -407,6 +409,18 @@ namespace TrenchBroom {
                 m_lockedRenderer->invalidate();
         }
 
+        void MapRenderer::invalidateEntitiesInRenderers(Renderer renderers, const Model::EntityList& entities) {
+            if ((renderers & Renderer_Default) != 0) {
+                m_defaultRenderer->invalidateEntities(entities);
+            }
+            if ((renderers & Renderer_Selection) != 0) {
+                m_selectionRenderer->invalidateEntities(entities);
+            }
+            if ((renderers& Renderer_Locked) != 0) {
+                m_lockedRenderer->invalidateEntities(entities);
+            }
+        }
+
         void MapRenderer::invalidateBrushesInRenderers(Renderer renderers, const Model::BrushList& brushes) {
             if ((renderers & Renderer_Default) != 0) {
                 m_defaultRenderer->invalidateBrushes(brushes);
@@ -435,9 +449,7 @@ namespace TrenchBroom {
             document->documentWasClearedNotifier.addObserver(this, &MapRenderer::documentWasCleared);
             document->documentWasNewedNotifier.addObserver(this, &MapRenderer::documentWasNewedOrLoaded);
             document->documentWasLoadedNotifier.addObserver(this, &MapRenderer::documentWasNewedOrLoaded);
-            document->nodesWereAddedNotifier.addObserver(this, &MapRenderer::nodesWereAdded);
-            document->nodesWereRemovedNotifier.addObserver(this, &MapRenderer::nodesWereRemoved);
-            document->nodesDidChangeNotifier.addObserver(this, &MapRenderer::nodesDidChange);
+            document->nodeChangesWereCommittedNotifier.addObserver(this, &MapRenderer::nodeChangesWereCommitted);
             document->nodeVisibilityDidChangeNotifier.addObserver(this, &MapRenderer::nodeVisibilityDidChange);
             document->nodeLockingDidChangeNotifier.addObserver(this, &MapRenderer::nodeLockingDidChange);
             document->groupWasOpenedNotifier.addObserver(this, &MapRenderer::groupWasOpened);
@@ -460,9 +472,7 @@ namespace TrenchBroom {
                 document->documentWasClearedNotifier.removeObserver(this, &MapRenderer::documentWasCleared);
                 document->documentWasNewedNotifier.removeObserver(this, &MapRenderer::documentWasNewedOrLoaded);
                 document->documentWasLoadedNotifier.removeObserver(this, &MapRenderer::documentWasNewedOrLoaded);
-                document->nodesWereAddedNotifier.removeObserver(this, &MapRenderer::nodesWereAdded);
-                document->nodesWereRemovedNotifier.removeObserver(this, &MapRenderer::nodesWereRemoved);
-                document->nodesDidChangeNotifier.removeObserver(this, &MapRenderer::nodesDidChange);
+                document->nodeChangesWereCommittedNotifier.removeObserver(this, &MapRenderer::nodeChangesWereCommitted);
                 document->nodeVisibilityDidChangeNotifier.removeObserver(this, &MapRenderer::nodeVisibilityDidChange);
                 document->nodeLockingDidChangeNotifier.removeObserver(this, &MapRenderer::nodeLockingDidChange);
                 document->groupWasOpenedNotifier.removeObserver(this, &MapRenderer::groupWasOpened);
@@ -489,17 +499,20 @@ namespace TrenchBroom {
             updateRenderers(Renderer_All);
         }
 
-        void MapRenderer::nodesWereAdded(const Model::NodeList& nodes) {
-            updateRenderers(Renderer_Default);
-        }
+        void MapRenderer::nodeChangesWereCommitted(const View::NodeChanges& changes) {
+            if (!changes.addedNodes().empty() || !changes.removedNodes().empty())
+                updateRenderers(Renderer_Default);
+            if (!changes.changedNodes().empty()) {
+                invalidateRenderers(Renderer_Selection);
 
-        void MapRenderer::nodesWereRemoved(const Model::NodeList& nodes) {
-            updateRenderers(Renderer_Default);
-        }
+                // the entity renderers keep the bounds of entities that remain in them, so entities which changed
+                // without being selected, e.g. because a child was added or removed, must be rebuilt explicitly
+                Model::NodeCollection changedNodes;
+                changedNodes.addNodes(changes.changedNodes());
+                invalidateEntitiesInRenderers(Renderer_Default_Locked, changedNodes.entities());
 
-        void MapRenderer::nodesDidChange(const Model::NodeList& nodes) {
-            invalidateRenderers(Renderer_Selection);
-            invalidateEntityLinkRenderer();
+                invalidateEntityLinkRenderer();
+            }
         }
 
         void MapRenderer::nodeVisibilityDidChange(const Model::NodeList& nodes) {
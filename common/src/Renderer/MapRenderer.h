@@ -32,6 +32,7 @@ namespace TrenchBroom {
     }
 
     namespace View {
+        class NodeChanges;
         class Selection;
     }
 
@@ -105,6 +106,7 @@ namespace TrenchBroom {
              */
             void updateRenderers(Renderer renderers);
             void invalidateRenderers(Renderer renderers);
+            void invalidateEntitiesInRenderers(Renderer renderers, const Model::EntityList& entities);
             void invalidateBrushesInRenderers(Renderer renderers, const Model::BrushList& brushes);
             void invalidateEntityLinkRenderer();
             void reloadEntityModels();
@@ -115,9 +117,7 @@ namespace TrenchBroom {
             void documentWasCleared(View::MapDocument* document);
             void documentWasNewedOrLoaded(View::MapDocument* document);
 
-            void nodesWereAdded(const Model::NodeList& nodes);
-            void nodesWereRemoved(const Model::NodeList& nodes);
-            void nodesDidChange(const Model::NodeList& nodes);
+            void nodeChangesWereCommitted(const View::NodeChanges& changes);
 
             void nodeVisibilityDidChange(const Model::NodeList& nodes);
             void nodeLockingDidChange(const Model::NodeList& nodes);
@@ -37,6 +37,10 @@ namespace TrenchBroom {
             m_brushRenderer.invalidate();
         }
 
+        void ObjectRenderer::invalidateEntities(const Model::EntityList& entities) {
+            m_entityRenderer.invalidateEntities(entities);
+        }
+
         void ObjectRenderer::invalidateBrushes(const Model::BrushList& brushes) {
             m_brushRenderer.invalidateBrushes(brushes);
         }
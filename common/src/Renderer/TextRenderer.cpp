@@ -43,14 +43,11 @@ namespace TrenchBroom {
         const size_t TextRenderer::RectCornerSegments = 3;
         const float TextRenderer::RectCornerRadius = 3.0f;
 
-        TextRenderer::Entry::Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
-        size(i_size),
+        TextRenderer::Entry::Entry(const TextureFont::GlyphRunPtr& i_glyphRun, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
+        glyphRun(i_glyphRun),
         offset(i_offset),
         textColor(i_textColor),
-        backgroundColor(i_backgroundColor) {
-            using std::swap;
-            swap(vertices, i_vertices);
-        }
+        backgroundColor(i_backgroundColor) {}
 
         TextRenderer::EntryCollection::EntryCollection() :
         textVertexCount(0),
@@ -60,7 +57,9 @@ namespace TrenchBroom {
         m_fontDescriptor(fontDescriptor),
         m_maxViewDistance(maxViewDistance),
         m_minZoomFactor(minZoomFactor),
-        m_inset(inset) {}
+        m_inset(inset),
+        m_laidOutCount(0),
+        m_reusedCount(0) {}
 
         void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position) {
             renderString(renderContext, textColor, backgroundColor, string, position, false);
@@ -70,6 +69,14 @@ namespace TrenchBroom {
             renderString(renderContext, textColor, backgroundColor, string, position, true);
         }
 
+        size_t TextRenderer::laidOutCount() const {
+            return m_laidOutCount;
+        }
+
+        size_t TextRenderer::reusedCount() const {
+            return m_reusedCount;
+        }
+
         void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, const bool onTop) {
 
             const Camera& camera = renderContext.camera();
@@ -77,39 +84,50 @@ namespace TrenchBroom {
             if (distance <= 0.0f)
                 return;
 
-            if (!isVisible(renderContext, string, position, distance, onTop))
+            if (!isInRange(renderContext, distance, onTop))
                 return;
 
             FontManager& fontManager = renderContext.fontManager();
             TextureFont& font = fontManager.font(m_fontDescriptor);
 
-            std::vector<vm::vec2f> vertices = font.quads(string, true);
+            bool reused = false;
+            const auto glyphRun = font.layout(string, reused);
+            if (reused)
+                ++m_reusedCount;
+            else
+                ++m_laidOutCount;
+
+            if (!isVisible(renderContext, glyphRun->size, position))
+                return;
+
             const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-            const vm::vec2f size = font.measure(string);
-            const vm::vec3f offset = position.offset(camera, size);
+            const vm::vec3f offset = position.offset(camera, glyphRun->size);
 
             if (onTop)
-                addEntry(m_entriesOnTop, Entry(vertices, size, offset,
+                addEntry(m_entriesOnTop, Entry(glyphRun, offset,
                                                Color(textColor, alphaFactor * textColor.a()),
                                                Color(backgroundColor, alphaFactor * backgroundColor.a())));
             else
-                addEntry(m_entries, Entry(vertices, size, offset,
+                addEntry(m_entries, Entry(glyphRun, offset,
                                           Color(textColor, alphaFactor * textColor.a()),
                                           Color(backgroundColor, alphaFactor * backgroundColor.a())));
         }
 
-        bool TextRenderer::isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, const float distance, const bool onTop) const {
+        bool TextRenderer::isInRange(RenderContext& renderContext, const float distance, const bool onTop) const {
             if (!onTop) {
                 if (renderContext.render3D() && distance > m_maxViewDistance)
                     return false;
                 if (renderContext.render2D() && renderContext.camera().zoom() < m_minZoomFactor)
                     return false;
             }
+            return true;
+        }
 
+        bool TextRenderer::isVisible(RenderContext& renderContext, const vm::vec2f& stringSize, const TextAnchor& position) const {
             const Camera& camera = renderContext.camera();
             const Camera::Viewport& viewport = camera.viewport();
 
-            const vm::vec2f size = stringSize(renderContext, string);
+            const vm::vec2f size = round(stringSize);
             const vm::vec2f offset = vm::vec2f(position.offset(camera, size)) - m_inset;
             const vm::vec2f actualSize = size + 2.0f * m_inset;
 
@@ -136,16 +154,10 @@ namespace TrenchBroom {
 
         void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry) {
             collection.entries.push_back(entry);
-            collection.textVertexCount += entry.vertices.size();
+            collection.textVertexCount += entry.glyphRun->vertices.size();
             collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
         }
 
-        vm::vec2f TextRenderer::stringSize(RenderContext& renderContext, const AttrString& string) const {
-            FontManager& fontManager = renderContext.fontManager();
-            TextureFont& font = fontManager.font(m_fontDescriptor);
-            return round(font.measure(string));
-        }
-
         void TextRenderer::doPrepareVertices(Vbo& vertexVbo) {
             prepare(m_entries, false, vertexVbo);
             prepare(m_entriesOnTop, true, vertexVbo);
@@ -170,8 +182,8 @@ namespace TrenchBroom {
         }
 
         void TextRenderer::addEntry(const Entry& entry, const bool /* onTop */, TextVertex::List& textVertices, RectVertex::List& rectVertices) {
-            const std::vector<vm::vec2f>& stringVertices = entry.vertices;
-            const vm::vec2f& stringSize = entry.size;
+            const std::vector<vm::vec2f>& stringVertices = entry.glyphRun->vertices;
+            const vm::vec2f& stringSize = entry.glyphRun->size;
 
             const vm::vec3f& offset = entry.offset;
 
@@ -23,6 +23,7 @@
 #include "Color.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/TextureFont.h"
 #include "Renderer/VertexArray.h"
 #include "Renderer/GLVertexType.h"
 
@@ -40,21 +41,21 @@ namespace TrenchBroom {
         class TextAnchor;
 
         class TextRenderer : public DirectRenderable {
-        private:
+        public:
             static const float DefaultMaxViewDistance;
+        private:
             static const float DefaultMinZoomFactor;
             static const vm::vec2f DefaultInset;
             static const size_t RectCornerSegments;
             static const float RectCornerRadius;
 
             struct Entry {
-                std::vector<vm::vec2f> vertices;
-                vm::vec2f size;
+                TextureFont::GlyphRunPtr glyphRun;
                 vm::vec3f offset;
                 Color textColor;
                 Color backgroundColor;
 
-                Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
+                Entry(const TextureFont::GlyphRunPtr& i_glyphRun, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
             };
 
             using EntryList = std::vector<Entry>;
@@ -80,19 +81,28 @@ namespace TrenchBroom {
 
             EntryCollection m_entries;
             EntryCollection m_entriesOnTop;
+
+            size_t m_laidOutCount;
+            size_t m_reusedCount;
         public:
             TextRenderer(const FontDescriptor& fontDescriptor, float maxViewDistance = DefaultMaxViewDistance, float minZoomFactor = DefaultMinZoomFactor, const vm::vec2f& inset = DefaultInset);
 
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position);
             void renderStringOnTop(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position);
+
+            /**
+             * The number of strings rendered by this renderer that had to be laid out, and the number of strings
+             * whose cached layout was reused.
+             */
+            size_t laidOutCount() const;
+            size_t reusedCount() const;
         private:
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, bool onTop);
 
-            bool isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, float distance, bool onTop) const;
+            bool isInRange(RenderContext& renderContext, float distance, bool onTop) const;
+            bool isVisible(RenderContext& renderContext, const vm::vec2f& stringSize, const TextAnchor& position) const;
             float computeAlphaFactor(const RenderContext& renderContext, float distance, bool onTop) const;
             void addEntry(EntryCollection& collection, const Entry& entry);
-
-            vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
         private:
             void doPrepareVertices(Vbo& vertexVbo) override;
             void prepare(EntryCollection& collection, bool onTop, Vbo& vbo);
@@ -28,6 +28,8 @@
 
 namespace TrenchBroom {
     namespace Renderer {
+        const size_t TextureFont::MaxCachedGlyphRuns = 8192;
+
         TextureFont::TextureFont(FontTexture* texture, const FontGlyph::List& glyphs, const size_t lineHeight, const unsigned char firstChar, const unsigned char charCount) :
         m_texture(texture),
         m_glyphs(glyphs),
@@ -226,6 +228,26 @@ namespace TrenchBroom {
             return result;
         }
 
+        TextureFont::GlyphRunPtr TextureFont::layout(const AttrString& string, bool& reused) const {
+            const auto it = m_glyphRuns.find(string);
+            if (it != std::end(m_glyphRuns)) {
+                reused = true;
+                return it->second;
+            }
+
+            if (m_glyphRuns.size() >= MaxCachedGlyphRuns) {
+                m_glyphRuns.clear();
+            }
+
+            auto run = std::make_shared<GlyphRun>();
+            run->vertices = quads(string, true);
+            run->size = measure(string);
+
+            reused = false;
+            m_glyphRuns.emplace(string, run);
+            return run;
+        }
+
         void TextureFont::activate() {
             m_texture->activate();
         }
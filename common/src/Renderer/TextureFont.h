@@ -29,6 +29,8 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
@@ -37,6 +39,18 @@ namespace TrenchBroom {
 
         class TextureFont {
         public:
+            /**
+             * A laid out string, consisting of the vertices of its clockwise glyph quads (alternating positions and
+             * texture coordinates) and its size.
+             */
+            struct GlyphRun {
+                std::vector<vm::vec2f> vertices;
+                vm::vec2f size;
+            };
+
+            using GlyphRunPtr = std::shared_ptr<const GlyphRun>;
+
+            static const size_t MaxCachedGlyphRuns;
         private:
             FontTexture* m_texture;
             FontGlyph::List m_glyphs;
@@ -44,6 +58,8 @@ namespace TrenchBroom {
 
             unsigned char m_firstChar;
             unsigned char m_charCount;
+
+            mutable std::map<AttrString, GlyphRunPtr> m_glyphRuns;
         public:
             TextureFont(FontTexture* texture, const FontGlyph::List& glyphs, size_t lineHeight, unsigned char firstChar, unsigned char charCount);
             ~TextureFont();
@@ -54,6 +70,17 @@ namespace TrenchBroom {
             std::vector<vm::vec2f> quads(const String& string, bool clockwise, const vm::vec2f& offset = vm::vec2f::zero) const;
             vm::vec2f measure(const String& string) const;
 
+            /**
+             * Returns the glyph run of the given string. Glyph runs are cached per string so that labels which are
+             * rendered in every frame are only laid out once. The cache is cleared when it exceeds
+             * MaxCachedGlyphRuns entries.
+             *
+             * @param string the string to lay out
+             * @param reused set to true if the glyph run was taken from the cache, and to false otherwise
+             * @return the glyph run
+             */
+            GlyphRunPtr layout(const AttrString& string, bool& reused) const;
+
             void activate();
             void deactivate();
 
@@ -28,12 +28,6 @@
 
 namespace TrenchBroom {
     namespace Renderer {
-        bool CompareVboBlocksByCapacity::operator() (const VboBlock* lhs, const VboBlock* rhs) const {
-            ensure(lhs != nullptr, "lhs is null");
-            ensure(rhs != nullptr, "rhs is null");
-            return lhs->capacity() < rhs->capacity();
-        }
-
         ActivateVbo::ActivateVbo(Vbo& vbo) :
         m_vbo(vbo),
         m_wasActive(m_vbo.active()) {
@@ -49,18 +43,11 @@ namespace TrenchBroom {
         const float Vbo::GrowthFactor = 1.5f;
 
         Vbo::Vbo(const size_t initialCapacity, const GLenum type, const GLenum usage) :
-        m_totalCapacity(initialCapacity),
-        m_freeCapacity(m_totalCapacity),
-        m_firstBlock(nullptr),
-        m_lastBlock(nullptr),
+        m_allocationTracker(initialCapacity),
         m_state(State_Inactive),
         m_type(type),
         m_usage(usage),
-        m_vboId(0) {
-            m_lastBlock = m_firstBlock = new VboBlock(*this, 0, m_totalCapacity, nullptr, nullptr);
-            m_freeBlocks.push_back(m_firstBlock);
-            assert(checkBlockChain());
-        }
+        m_vboId(0) {}
 
         Vbo::~Vbo() {
             if (active()) {
@@ -68,49 +55,35 @@ namespace TrenchBroom {
             }
             free();
 
-            VboBlock* block = m_firstBlock;
-            while (block != nullptr) {
-                VboBlock* next = block->next();
+            for (VboBlock* block : m_blocks) {
                 delete block;
-                block = next;
             }
-
-            m_lastBlock = m_firstBlock = nullptr;
+            m_blocks.clear();
         }
 
         VboBlock* Vbo::allocateBlock(const size_t capacity) {
-            assert(checkBlockChain());
-
             if (!active()) {
                 VboException e;
                 e << "Vbo is inactive";
                 throw e;
             }
 
-            auto it = findFreeBlock(capacity);
-            if (it == std::end(m_freeBlocks)) {
+            auto* allocation = m_allocationTracker.allocate(capacity);
+            if (allocation == nullptr) {
                 increaseCapacityToAccomodate(capacity);
-                it = findFreeBlock(capacity);
+                allocation = m_allocationTracker.allocate(capacity);
             }
+            ensure(allocation != nullptr, "allocation is null");
 
-            assert(it != std::end(m_freeBlocks));
-            VboBlock* block = *it;
-
-            ensure(block != nullptr, "block is null");
-            removeFreeBlock(it);
-
-            if (block->capacity() > capacity) {
-                VboBlock* remainder = block->split(capacity);
-                if (m_lastBlock == block) {
-                    m_lastBlock = remainder;
-                }
-                insertFreeBlock(remainder);
-            }
-
-            assert(checkBlockChain());
+            auto* block = new VboBlock(*this, allocation);
+            m_blocks.insert(block);
             return block;
         }
 
+        AllocationTracker::Statistics Vbo::statistics() const {
+            return m_allocationTracker.statistics();
+        }
+
         bool Vbo::active() const {
             return m_state > State_Inactive;
         }
@@ -121,7 +94,7 @@ namespace TrenchBroom {
             if (m_vboId == 0) {
                 glAssert(glGenBuffers(1, &m_vboId));
                 glAssert(glBindBuffer(m_type, m_vboId));
-                glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_totalCapacity), nullptr, m_usage));
+                glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_allocationTracker.capacity()), nullptr, m_usage));
             } else {
                 glAssert(glBindBuffer(m_type, m_vboId));
             }
@@ -149,58 +122,24 @@ namespace TrenchBroom {
 
         void Vbo::freeBlock(VboBlock* block) {
             ensure(block != nullptr, "block is null");
-            assert(!block->isFree());
-            assert(checkBlockChain());
-
-            VboBlock* previous = block->previous();
-            VboBlock* next = block->next();
-
-            if (previous != nullptr && previous->isFree() &&
-                next != nullptr && next->isFree()) {
-                removeFreeBlock(previous);
-                removeFreeBlock(next);
-                previous->mergeWithSuccessor();
-                previous->mergeWithSuccessor();
-                if (m_lastBlock == next) {
-                    m_lastBlock = previous;
-                }
-                delete block;
-                delete next;
-                insertFreeBlock(previous);
-            } else if (previous != nullptr && previous->isFree()) {
-                removeFreeBlock(previous);
-                previous->mergeWithSuccessor();
-                if (m_lastBlock == block) {
-                    m_lastBlock = previous;
-                }
-                delete block;
-                insertFreeBlock(previous);
-            } else if (next != nullptr && next->isFree()) {
-                removeFreeBlock(next);
-                block->mergeWithSuccessor();
-                if (m_lastBlock == next) {
-                    m_lastBlock = block;
-                }
-                delete next;
-                insertFreeBlock(block);
-            } else {
-                insertFreeBlock(block);
-            }
-            assert(checkBlockChain());
+            assert(m_blocks.count(block) == 1);
+
+            m_allocationTracker.free(block->m_allocation);
+            m_blocks.erase(block);
+            delete block;
         }
 
         void Vbo::increaseCapacityToAccomodate(const size_t capacity) {
-            auto newMinCapacity = m_totalCapacity + capacity;
-            if (m_lastBlock->isFree()) {
-                newMinCapacity -= m_lastBlock->capacity();
-            }
+            const auto totalCapacity = m_allocationTracker.capacity();
+            const auto newMinCapacity = totalCapacity + capacity - m_allocationTracker.freeSizeAtEnd();
 
-            auto newCapacity = m_totalCapacity;
+            auto newCapacity = std::max(totalCapacity, capacity);
             while (newCapacity < newMinCapacity) {
-                newCapacity = static_cast<size_t>(static_cast<float>(newCapacity) * GrowthFactor);
+                // make sure that very small buffers grow, too
+                newCapacity = std::max(newCapacity + 1, static_cast<size_t>(static_cast<float>(newCapacity) * GrowthFactor));
             }
 
-            increaseCapacity(newCapacity - m_totalCapacity);
+            increaseCapacity(newCapacity - totalCapacity);
         }
 
         void Vbo::increaseCapacity(const size_t delta) {
@@ -208,30 +147,16 @@ namespace TrenchBroom {
             assert(!partiallyMapped());
             assert(!fullyMapped());
             assert(delta > 0);
-            assert(checkBlockChain());
-
-            const auto begin = (m_firstBlock->isFree() ?  m_firstBlock->capacity() : 0);
-            const auto end = m_totalCapacity - (m_lastBlock->isFree() ? m_lastBlock->capacity() : 0);
-
-            if (m_lastBlock->isFree()) {
-                removeFreeBlock(m_lastBlock);
-                m_lastBlock->setCapacity(m_lastBlock->capacity() + delta);
-                insertFreeBlock(m_lastBlock);
-            } else {
-                auto block = m_lastBlock->createSuccessor(delta);
-                m_lastBlock = block;
-                insertFreeBlock(m_lastBlock);
-            }
 
-            m_totalCapacity += delta;
-            m_freeCapacity += delta;
-            assert(checkBlockChain());
+            const auto oldCapacity = m_allocationTracker.capacity();
+            const auto hadAllocations = m_allocationTracker.hasAllocations();
+            m_allocationTracker.expand(oldCapacity + delta);
 
-            if (begin < end) {
+            if (hadAllocations) {
                 unsigned char* buffer = map();
 
-                auto temp = std::make_unique<unsigned char[]>(end - begin);
-                memcpy(temp.get(), buffer + begin, end - begin);
+                auto temp = std::make_unique<unsigned char[]>(oldCapacity);
+                memcpy(temp.get(), buffer, oldCapacity);
 
                 unmap();
                 deactivate();
@@ -239,7 +164,7 @@ namespace TrenchBroom {
                 activate();
                 buffer = map();
 
-                memcpy(buffer + begin, temp.get(), end - begin);
+                memcpy(buffer, temp.get(), oldCapacity);
 
                 unmap();
             } else {
@@ -249,43 +174,6 @@ namespace TrenchBroom {
             }
         }
 
-        Vbo::VboBlockList::iterator Vbo::findFreeBlock(const size_t minCapacity) {
-            const VboBlock query(*this, 0, minCapacity, nullptr, nullptr);
-            return std::lower_bound(std::begin(m_freeBlocks), std::end(m_freeBlocks), &query, CompareVboBlocksByCapacity());
-        }
-
-        void Vbo::insertFreeBlock(VboBlock* block) {
-            auto it = std::lower_bound(std::begin(m_freeBlocks), std::end(m_freeBlocks), block, CompareVboBlocksByCapacity());
-            if (it == std::end(m_freeBlocks)) {
-                m_freeBlocks.push_back(block);
-            } else {
-                m_freeBlocks.insert(it, block);
-            }
-            block->setFree(true);
-            m_freeCapacity += block->capacity();
-        }
-
-        void Vbo::removeFreeBlock(VboBlock* block) {
-            auto it = std::lower_bound(std::begin(m_freeBlocks), std::end(m_freeBlocks), block, CompareVboBlocksByCapacity());
-            assert(it != std::end(m_freeBlocks));
-            if (*it != block) {
-                const auto end = std::upper_bound(std::begin(m_freeBlocks), std::end(m_freeBlocks), block, CompareVboBlocksByCapacity());
-                while (it != end && *it != block) {
-                    ++it;
-                }
-                assert(it != end);
-            }
-            assert(*it == block);
-            removeFreeBlock(it);
-        }
-
-        void Vbo::removeFreeBlock(const VboBlockList::iterator it) {
-            VboBlock* block = *it;
-            m_freeBlocks.erase(it);
-            block->setFree(false);
-            m_freeCapacity -= block->capacity();
-        }
-
         bool Vbo::partiallyMapped() const {
             return m_state == State_PartiallyMapped;
         }
@@ -328,33 +216,5 @@ namespace TrenchBroom {
             glAssert(glUnmapBuffer(m_type));
             m_state = State_Active;
         }
-
-        bool Vbo::checkBlockChain() const {
-            VboBlock* block = m_firstBlock;
-            ensure(block != nullptr, "block is null");
-
-            auto count = 0u;
-            VboBlock* next = block->next();
-            while (next != nullptr) {
-                assert(next->previous() == block);
-                assert(!block->isFree() || !next->isFree());
-                block = next;
-                next = next->next();
-                ++count;
-            }
-
-            assert(block == m_lastBlock);
-
-            VboBlock* previous = block->previous();
-            while (previous != nullptr) {
-                assert(previous->next() == block);
-                block = previous;
-                previous = previous->previous();
-                --count;
-            }
-            assert(count == 0);
-
-            return true;
-        }
     }
 }
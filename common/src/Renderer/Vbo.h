@@ -21,21 +21,17 @@
 #define TrenchBroom_Vbo
 
 #include "SharedPointer.h"
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/GL.h"
 
 #include <cassert>
 #include <cstring>
-#include <vector>
+#include <unordered_set>
 
 namespace TrenchBroom {
     namespace Renderer {
         class VboBlock;
 
-        class CompareVboBlocksByCapacity {
-        public:
-            bool operator() (const VboBlock* lhs, const VboBlock* rhs) const;
-        };
-
         class Vbo;
         class ActivateVbo {
         private:
@@ -57,14 +53,10 @@ namespace TrenchBroom {
                 State_FullyMapped = 3
             } State;
         private:
-            using VboBlockList = std::vector<VboBlock*>;
             static const float GrowthFactor;
 
-            size_t m_totalCapacity;
-            size_t m_freeCapacity;
-            VboBlockList m_freeBlocks;
-            VboBlock* m_firstBlock;
-            VboBlock* m_lastBlock;
+            AllocationTracker m_allocationTracker;
+            std::unordered_set<VboBlock*> m_blocks;
             State m_state;
 
             GLenum m_type;
@@ -76,6 +68,11 @@ namespace TrenchBroom {
 
             VboBlock* allocateBlock(size_t capacity);
 
+            /**
+             * Returns statistics about the usage and fragmentation of this VBO's memory.
+             */
+            AllocationTracker::Statistics statistics() const;
+
             bool active() const;
             void activate();
             void deactivate();
@@ -90,10 +87,6 @@ namespace TrenchBroom {
 
             void increaseCapacityToAccomodate(size_t capacity);
             void increaseCapacity(size_t delta);
-            VboBlockList::iterator findFreeBlock(size_t minCapacity);
-            void insertFreeBlock(VboBlock* block);
-            void removeFreeBlock(VboBlock* block);
-            void removeFreeBlock(VboBlockList::iterator it);
 
             bool partiallyMapped() const;
             void mapPartially();
@@ -102,8 +95,6 @@ namespace TrenchBroom {
             bool fullyMapped() const;
             unsigned char* map();
             void unmap();
-
-            bool checkBlockChain() const;
         };
     }
 }
@@ -33,25 +33,23 @@ namespace TrenchBroom {
             m_block->unmap();
         }
 
-        VboBlock::VboBlock(Vbo& vbo, const size_t offset, const size_t capacity, VboBlock* previous, VboBlock* next) :
+        VboBlock::VboBlock(Vbo& vbo, AllocationTracker::Block* allocation) :
         m_vbo(vbo),
-        m_free(true),
-        m_offset(offset),
-        m_capacity(capacity),
-        m_previous(previous),
-        m_next(next),
-        m_mapped(false) {}
+        m_allocation(allocation),
+        m_mapped(false) {
+            ensure(m_allocation != nullptr, "allocation is null");
+        }
 
         Vbo& VboBlock::vbo() const {
             return m_vbo;
         }
 
         size_t VboBlock::offset() const {
-            return m_offset;
+            return m_allocation->pos;
         }
 
         size_t VboBlock::capacity() const {
-            return m_capacity;
+            return m_allocation->size;
         }
 
         void VboBlock::free() {
@@ -73,63 +71,5 @@ namespace TrenchBroom {
             m_mapped = false;
             m_vbo.unmapPartially();
         }
-
-        VboBlock* VboBlock::previous() const {
-            return m_previous;
-        }
-
-        void VboBlock::setPrevious(VboBlock* previous) {
-            m_previous = previous;
-        }
-
-        VboBlock* VboBlock::next() const {
-            return m_next;
-        }
-
-        void VboBlock::setNext(VboBlock* next) {
-            m_next = next;
-        }
-
-        bool VboBlock::isFree() const {
-            return m_free;
-        }
-
-        void VboBlock::setFree(const bool free) {
-            m_free = free;
-        }
-
-        void VboBlock::setCapacity(const size_t capacity) {
-            m_capacity = capacity;
-        }
-
-        VboBlock* VboBlock::mergeWithSuccessor() {
-            ensure(m_next != nullptr, "next is null");
-
-            VboBlock* next = m_next;
-            VboBlock* nextNext = next->next();
-            m_next = nextNext;
-            if (m_next != nullptr)
-                m_next->setPrevious(this);
-            m_capacity += next->capacity();
-            return next;
-        }
-
-        VboBlock* VboBlock::split(const size_t capacity) {
-            assert(m_capacity > capacity);
-            const size_t remainderCapacity = m_capacity - capacity;
-            m_capacity = capacity;
-
-            VboBlock* remainder = createSuccessor(remainderCapacity);
-            remainder->setFree(m_free);
-            return remainder;
-        }
-
-        VboBlock* VboBlock::createSuccessor(const size_t capacity) {
-            VboBlock* successor = new VboBlock(m_vbo, m_offset + m_capacity, capacity, this, m_next);
-            if (m_next != nullptr)
-                m_next->setPrevious(successor);
-            m_next = successor;
-            return m_next;
-        }
     }
 }
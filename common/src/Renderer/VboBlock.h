@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_VboBlock
 #define TrenchBroom_VboBlock
 
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/Vbo.h"
 
 #include <cstring>
@@ -45,15 +46,11 @@ namespace TrenchBroom {
             friend class MapVboBlock;
 
             Vbo& m_vbo;
-            bool m_free;
-            size_t m_offset;
-            size_t m_capacity;
-            VboBlock* m_previous;
-            VboBlock* m_next;
+            AllocationTracker::Block* m_allocation;
 
             bool m_mapped;
         public:
-            VboBlock(Vbo& vbo, const size_t offset, const size_t capacity, VboBlock* previous, VboBlock* next);
+            VboBlock(Vbo& vbo, AllocationTracker::Block* allocation);
 
             Vbo& vbo() const;
             size_t offset() const;
@@ -83,13 +80,13 @@ namespace TrenchBroom {
                 assert(mapped());
 
                 const size_t size = count * sizeof(T);
-                assert(address + size <= m_capacity);
+                assert(address + size <= capacity());
 
                 static_assert(std::is_trivially_copyable<T>::value);
                 static_assert(std::is_standard_layout<T>::value);
 
                 const GLvoid* ptr = static_cast<const GLvoid*>(array);
-                const GLintptr offset = static_cast<GLintptr>(m_offset + address);
+                const GLintptr offset = static_cast<GLintptr>(this->offset() + address);
                 const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
                 glAssert(glBufferSubData(m_vbo.type(), offset, sizei, ptr));
 
@@ -101,19 +98,6 @@ namespace TrenchBroom {
             bool mapped() const;
             void map();
             void unmap();
-        private:
-            VboBlock* previous() const;
-            void setPrevious(VboBlock* previous);
-            VboBlock* next() const;
-            void setNext(VboBlock* next);
-
-            bool isFree() const;
-            void setFree(const bool free);
-            void setCapacity(const size_t capacity);
-
-            VboBlock* mergeWithSuccessor();
-            VboBlock* split(const size_t capacity);
-            VboBlock* createSuccessor(const size_t capacity);
         };
     }
 }
@@ -173,6 +173,86 @@ namespace StringUtils {
         return matchesPattern(std::begin(str), std::end(str), std::begin(pattern), std::end(pattern), StringUtils::CharEqual<StringUtils::CaseInsensitiveCharCompare>());
     }
 
+    GlobPattern::GlobPattern(const String& pattern, const bool caseSensitive) :
+    m_caseSensitive(caseSensitive) {
+        for (auto cur = std::begin(pattern), end = std::end(pattern); cur != end; ++cur) {
+            const char c = *cur;
+            if (c == '\\' && (cur + 1) != end) {
+                const char e = *++cur;
+                if (e == '*' || e == '?' || e == '\\') {
+                    m_tokens.push_back({ TokenType::EscapedChar, e });
+                } else {
+                    // Invalid escape sequence, the pattern cannot match anything.
+                    m_tokens.push_back({ TokenType::Invalid, e });
+                }
+            } else if (c == '*') {
+                // consecutive stars are equivalent to a single one
+                if (m_tokens.empty() || m_tokens.back().type != TokenType::AnyString) {
+                    m_tokens.push_back({ TokenType::AnyString, c });
+                }
+            } else if (c == '?') {
+                m_tokens.push_back({ TokenType::AnyChar, c });
+            } else {
+                m_tokens.push_back({ TokenType::Char, m_caseSensitive ? c : static_cast<char>(std::tolower(c, std::locale::classic())) });
+            }
+        }
+    }
+
+    bool GlobPattern::matches(const String& str) const {
+        return matches(std::begin(str), std::end(str));
+    }
+
+    bool GlobPattern::matches(String::const_iterator strCur, const String::const_iterator strEnd) const {
+        const auto patEnd = std::end(m_tokens);
+        auto patCur = std::begin(m_tokens);
+
+        // the pattern position after the most recent star and the string position where that star's match ends
+        auto haveStar = false;
+        auto starPat = patEnd;
+        auto starStr = strCur;
+
+        while (strCur != strEnd) {
+            if (patCur != patEnd && patCur->type == TokenType::AnyString) {
+                starPat = ++patCur;
+                if (starPat == patEnd) {
+                    // a trailing star matches the remainder of the string
+                    return true;
+                }
+                starStr = strCur;
+                haveStar = true;
+            } else if (patCur != patEnd && matches(*patCur, *strCur)) {
+                ++patCur;
+                ++strCur;
+            } else if (haveStar) {
+                // let the most recent star consume one more character and retry
+                patCur = starPat;
+                strCur = ++starStr;
+            } else {
+                return false;
+            }
+        }
+
+        while (patCur != patEnd && patCur->type == TokenType::AnyString) {
+            ++patCur;
+        }
+        return patCur == patEnd;
+    }
+
+    bool GlobPattern::matches(const Token& token, const char c) const {
+        switch (token.type) {
+            case TokenType::Char:
+                return token.c == (m_caseSensitive ? c : static_cast<char>(std::tolower(c, std::locale::classic())));
+            case TokenType::EscapedChar:
+                return token.c == c;
+            case TokenType::AnyChar:
+                return true;
+            case TokenType::AnyString:
+            case TokenType::Invalid:
+                return false;
+            switchDefault()
+        }
+    }
+
     long makeHash(const String& str) {
         long hash = 0;
         for (size_t i = 0; i < str.size(); ++i)
@@ -294,6 +294,47 @@ namespace StringUtils {
     bool caseSensitiveMatchesPattern(const String& str, const String& pattern);
     bool caseInsensitiveMatchesPattern(const String& str, const String& pattern);
 
+    /**
+     * A pattern in the syntax accepted by matchesPattern that is parsed once so that it can be matched against many
+     * strings cheaply.
+     *
+     * Matching scans the string once and only ever returns to the position after the most recent '*', so it never
+     * takes more than O(n * m) steps for a string of length n and a pattern of length m.
+     *
+     * Unlike matchesPattern, an unescaped '*' in the pattern is always a wildcard, even if the string contains a
+     * '*' at the corresponding position.
+     */
+    class GlobPattern {
+    private:
+        enum class TokenType {
+            /** Matches the token's character, ignoring case if the pattern is case insensitive. */
+            Char,
+            /** Matches exactly the token's character, created by an escape sequence. */
+            EscapedChar,
+            /** Matches any single character ('?'). */
+            AnyChar,
+            /** Matches any sequence of characters ('*'). */
+            AnyString,
+            /** Matches nothing, created by an invalid escape sequence. */
+            Invalid
+        };
+
+        struct Token {
+            TokenType type;
+            char c;
+        };
+
+        std::vector<Token> m_tokens;
+        bool m_caseSensitive;
+    public:
+        GlobPattern(const String& pattern, bool caseSensitive);
+
+        bool matches(const String& str) const;
+        bool matches(String::const_iterator strCur, String::const_iterator strEnd) const;
+    private:
+        bool matches(const Token& token, char c) const;
+    };
+
     long makeHash(const String& str);
     String toLower(const String& str);
     String toUpper(const String& str);
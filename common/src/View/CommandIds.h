@@ -115,8 +115,9 @@ namespace TrenchBroom {
                 const int DebugCrashReportDialog                     = DebugClipWithFace + 1;
                 const int DebugSetWindowSize                         = DebugCrashReportDialog + 1;
                 const int DebugThrowExceptionDuringCommand           = DebugSetWindowSize + 1;
+                const int DebugToggleNotifierStatistics              = DebugThrowExceptionDuringCommand + 1;
 
-                const int Highest                                    = DebugThrowExceptionDuringCommand + 200;
+                const int Highest                                    = DebugToggleNotifierStatistics + 200;
             }
 
             namespace Actions {
@@ -21,6 +21,7 @@
 
 #include "Exceptions.h"
 #include "TemporarilySetAny.h"
+#include "Model/World.h"
 #include "View/MapDocumentCommandFacade.h"
 
 #include <wx/time.h>
@@ -98,6 +99,13 @@ namespace TrenchBroom {
             return false;
         }
 
+        size_t CommandGroup::doGetMemorySize() const {
+            size_t result = 0;
+            for (const auto& command : m_commands)
+                result += command->memorySize();
+            return result;
+        }
+
         const wxLongLong CommandProcessor::CollationInterval(1000);
 
         struct CommandProcessor::SubmitAndStoreResult {
@@ -244,6 +252,15 @@ namespace TrenchBroom {
             m_clearRepeatableCommandStack = false;
         }
 
+        size_t CommandProcessor::undoMemorySize() const {
+            size_t result = 0;
+            for (const auto& command : m_lastCommandStack)
+                result += command->memorySize();
+            for (const auto& command : m_nextCommandStack)
+                result += command->memorySize();
+            return result;
+        }
+
         void CommandProcessor::clear() {
             assert(m_groupLevel == 0);
 
@@ -269,7 +286,7 @@ namespace TrenchBroom {
 
         bool CommandProcessor::doCommand(Command::Ptr command) {
             commandDoNotifier(command);
-            if (command->performDo(m_document)) {
+            if (performDo(command)) {
                 commandDoneNotifier(command);
                 return true;
             } else {
@@ -280,7 +297,7 @@ namespace TrenchBroom {
 
         bool CommandProcessor::undoCommand(UndoableCommand::Ptr command) {
             commandUndoNotifier(command);
-            if (command->performUndo(m_document)) {
+            if (performUndo(command)) {
                 commandUndoneNotifier(command);
                 return true;
             } else {
@@ -289,6 +306,17 @@ namespace TrenchBroom {
             }
         }
 
+        bool CommandProcessor::performDo(Command::Ptr command) {
+            // the node tree and the bounds of the changed nodes' ancestors are updated once the command is done
+            const Model::World::DeferBoundsUpdates deferBoundsUpdates(m_document->world());
+            return command->performDo(m_document);
+        }
+
+        bool CommandProcessor::performUndo(UndoableCommand::Ptr command) {
+            const Model::World::DeferBoundsUpdates deferBoundsUpdates(m_document->world());
+            return command->performUndo(m_document);
+        }
+
         bool CommandProcessor::storeCommand(UndoableCommand::Ptr command, const bool collate) {
             if (m_groupLevel == 0) {
                 return pushLastCommand(command, collate);
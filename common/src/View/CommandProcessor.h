@@ -62,6 +62,7 @@ namespace TrenchBroom {
             UndoableCommand::Ptr doRepeat(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+            size_t doGetMemorySize() const override;
         };
 
         class CommandProcessor {
@@ -110,11 +111,18 @@ namespace TrenchBroom {
             bool repeatLastCommands();
             void clearRepeatableCommands();
 
+            /**
+             * Returns the approximate number of bytes used by the undo and redo state of the stored commands.
+             */
+            size_t undoMemorySize() const;
+
             void clear();
         private:
             SubmitAndStoreResult submitAndStoreCommand(UndoableCommand::Ptr command, bool collate);
             bool doCommand(Command::Ptr command);
             bool undoCommand(UndoableCommand::Ptr command);
+            bool performDo(Command::Ptr command);
+            bool performUndo(UndoableCommand::Ptr command);
             bool storeCommand(UndoableCommand::Ptr command, bool collate);
 
             void beginGroup(const String& name, bool undoable);
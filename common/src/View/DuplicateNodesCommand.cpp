@@ -19,6 +19,7 @@
 
 #include "DuplicateNodesCommand.h"
 
+#include "Model/CloneNodesInParallel.h"
 #include "Model/Node.h"
 #include "Model/NodeVisitor.h"
 #include "View/MapDocumentCommandFacade.h"
@@ -48,9 +49,11 @@ namespace TrenchBroom {
 
                 const vm::bbox3& worldBounds = document->worldBounds();
                 m_previouslySelectedNodes = document->selectedNodes().nodes();
+                const Model::NodeList clones = Model::cloneRecursivelyInParallel(worldBounds, m_previouslySelectedNodes);
 
-                for (const Model::Node* original : m_previouslySelectedNodes) {
-                    Model::Node* clone = original->cloneRecursively(worldBounds);
+                for (size_t i = 0; i < m_previouslySelectedNodes.size(); ++i) {
+                    const Model::Node* original = m_previouslySelectedNodes[i];
+                    Model::Node* clone = clones[i];
 
                     Model::Node* parent = original->parent();
                     if (cloneParent(parent)) {
@@ -23,6 +23,7 @@
 #include "View/EntityAttributeSelectedCommand.h"
 #include "View/ViewConstants.h"
 #include "View/MapDocument.h"
+#include "View/NodeChanges.h"
 #include "View/SmartAttributeEditorManager.h"
 #include "View/SplitterWindow2.h"
 #include "Model/AttributableNode.h"
@@ -63,14 +64,14 @@ namespace TrenchBroom {
         void EntityAttributeEditor::bindObservers() {
             MapDocumentSPtr document = lock(m_document);
             document->selectionDidChangeNotifier.addObserver(this, &EntityAttributeEditor::selectionDidChange);
-            document->nodesDidChangeNotifier.addObserver(this, &EntityAttributeEditor::nodesDidChange);
+            document->nodeChangesWereCommittedNotifier.addObserver(this, &EntityAttributeEditor::nodeChangesWereCommitted);
         }
 
         void EntityAttributeEditor::unbindObservers() {
             if (!expired(m_document)) {
                 MapDocumentSPtr document = lock(m_document);
                 document->selectionDidChangeNotifier.removeObserver(this, &EntityAttributeEditor::selectionDidChange);
-                document->nodesDidChangeNotifier.removeObserver(this, &EntityAttributeEditor::nodesDidChange);
+                document->nodeChangesWereCommittedNotifier.removeObserver(this, &EntityAttributeEditor::nodeChangesWereCommitted);
             }
         }
 
@@ -78,7 +79,7 @@ namespace TrenchBroom {
             updateIfSelectedEntityDefinitionChanged();
         }
 
-        void EntityAttributeEditor::nodesDidChange(const Model::NodeList& nodes) {
+        void EntityAttributeEditor::nodeChangesWereCommitted(const NodeChanges& changes) {
             updateIfSelectedEntityDefinitionChanged();
         }
 
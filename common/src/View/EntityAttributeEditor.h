@@ -35,6 +35,7 @@ namespace TrenchBroom {
     }
 
     namespace View {
+        class NodeChanges;
         class Selection;
         class SplitterWindow2;
         class EntityAttributeGrid;
@@ -64,7 +65,7 @@ namespace TrenchBroom {
             void unbindObservers();
 
             void selectionDidChange(const Selection& selection);
-            void nodesDidChange(const Model::NodeList& nodes);
+            void nodeChangesWereCommitted(const NodeChanges& changes);
 
             void updateIfSelectedEntityDefinitionChanged();
             void updateDocumentationAndSmartEditor();
@@ -27,6 +27,7 @@
 #include "View/FlagsPopupEditor.h"
 #include "View/IssueBrowserView.h"
 #include "View/MapDocument.h"
+#include "View/NodeChanges.h"
 #include "View/ViewConstants.h"
 
 #include <wx/checkbox.h>
@@ -89,9 +90,7 @@ namespace TrenchBroom {
             document->documentWasSavedNotifier.addObserver(this, &IssueBrowser::documentWasSaved);
             document->documentWasNewedNotifier.addObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
             document->documentWasLoadedNotifier.addObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
-            document->nodesWereAddedNotifier.addObserver(this, &IssueBrowser::nodesWereAdded);
-            document->nodesWereRemovedNotifier.addObserver(this, &IssueBrowser::nodesWereRemoved);
-            document->nodesDidChangeNotifier.addObserver(this, &IssueBrowser::nodesDidChange);
+            document->nodeChangesWereCommittedNotifier.addObserver(this, &IssueBrowser::nodeChangesWereCommitted);
             document->brushFacesDidChangeNotifier.addObserver(this, &IssueBrowser::brushFacesDidChange);
         }
 
@@ -101,9 +100,7 @@ namespace TrenchBroom {
                 document->documentWasSavedNotifier.removeObserver(this, &IssueBrowser::documentWasSaved);
                 document->documentWasNewedNotifier.removeObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
                 document->documentWasLoadedNotifier.removeObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
-                document->nodesWereAddedNotifier.removeObserver(this, &IssueBrowser::nodesWereAdded);
-                document->nodesWereRemovedNotifier.removeObserver(this, &IssueBrowser::nodesWereRemoved);
-                document->nodesDidChangeNotifier.removeObserver(this, &IssueBrowser::nodesDidChange);
+                document->nodeChangesWereCommittedNotifier.removeObserver(this, &IssueBrowser::nodeChangesWereCommitted);
                 document->brushFacesDidChangeNotifier.removeObserver(this, &IssueBrowser::brushFacesDidChange);
             }
         }
@@ -122,15 +119,7 @@ namespace TrenchBroom {
             m_view->Refresh();
         }
 
-        void IssueBrowser::nodesWereAdded(const Model::NodeList& nodes) {
-            m_view->reload();
-        }
-
-        void IssueBrowser::nodesWereRemoved(const Model::NodeList& nodes) {
-            m_view->reload();
-        }
-
-        void IssueBrowser::nodesDidChange(const Model::NodeList& nodes) {
+        void IssueBrowser::nodeChangesWereCommitted(const NodeChanges& changes) {
             m_view->reload();
         }
 
@@ -40,6 +40,7 @@ namespace TrenchBroom {
         class FlagChangedCommand;
         class FlagsPopupEditor;
         class IssueBrowserView;
+        class NodeChanges;
 
         class IssueBrowser : public TabBookPage {
         private:
@@ -65,9 +66,7 @@ namespace TrenchBroom {
             void unbindObservers();
             void documentWasNewedOrLoaded(MapDocument* document);
             void documentWasSaved(MapDocument* document);
-            void nodesWereAdded(const Model::NodeList& nodes);
-            void nodesWereRemoved(const Model::NodeList& nodes);
-            void nodesDidChange(const Model::NodeList& nodes);
+            void nodeChangesWereCommitted(const NodeChanges& changes);
             void brushFacesDidChange(const Model::BrushFaceList& faces);
             void issueIgnoreChanged(Model::Issue* issue);
 
@@ -26,10 +26,10 @@
 
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
-#include <vecmath/plane.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
-#include <vecmath/intersection.h>
+
+#include <cassert>
 
 namespace TrenchBroom {
     namespace View {
@@ -38,6 +38,11 @@ namespace TrenchBroom {
         m_distance(distance),
         m_transform(vm::coordinateSystemMatrix(m_camera.right(), m_camera.up(), -m_camera.direction(),
                                                m_camera.defaultPoint(static_cast<float>(m_distance)))),
+        m_position(m_camera.position()),
+        m_direction(m_camera.direction()),
+        m_right(m_camera.right()),
+        m_up(m_camera.up()),
+        m_perspective(m_camera.perspectiveProjection()),
         m_start(point),
         m_cur(m_start) {}
 
@@ -45,28 +50,32 @@ namespace TrenchBroom {
             m_cur = point;
         }
 
-        bool Lasso::selects(const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const {
-            const auto projected = project(point, plane);
-            return !isNaN(projected) && box.contains(vm::vec2(projected));
+        bool Lasso::selects(const vm::vec3& point, const vm::bbox2& box) const {
+            const auto projected = project(point);
+            return !isNaN(projected) && box.contains(projected);
         }
 
-        bool Lasso::selects(const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const {
-            return selects(edge.center(), plane, box);
+        bool Lasso::selects(const vm::segment3& edge, const vm::bbox2& box) const {
+            return selects(edge.center(), box);
         }
 
-        bool Lasso::selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const {
-            return selects(polygon.center(), plane, box);
+        bool Lasso::selects(const vm::polygon3& polygon, const vm::bbox2& box) const {
+            return selects(polygon.center(), box);
         }
 
-        vm::vec3 Lasso::project(const vm::vec3& point, const vm::plane3& plane) const {
-            const auto ray = vm::ray3(m_camera.pickRay(vm::vec3f(point)));
-            const auto hitDistance = vm::intersectRayAndPlane(ray, plane);;
-            if (vm::isnan(hitDistance)) {
-                return vm::vec3::NaN;
+        vm::vec2 Lasso::project(const vm::vec3& point) const {
+            const auto v = point - m_position;
+            const auto x = dot(v, m_right);
+            const auto y = dot(v, m_up);
+            if (!m_perspective) {
+                return vm::vec2(x, y);
             }
 
-            const auto hitPoint = ray.pointAtDistance(hitDistance);
-            return m_transform * hitPoint;
+            const auto z = dot(v, m_direction);
+            if (z <= 0.0) {
+                return vm::vec2::NaN;
+            }
+            return vm::vec2(m_distance * x / z, m_distance * y / z);
         }
 
         void Lasso::render(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) const {
@@ -89,10 +98,6 @@ namespace TrenchBroom {
             renderService.renderFilledPolygon(polygon);
         }
 
-        vm::plane3 Lasso::plane() const {
-            return vm::plane3(vm::vec3(m_camera.defaultPoint(static_cast<float>(m_distance))), vm::vec3(m_camera.direction()));
-        }
-
         vm::bbox2 Lasso::box() const {
             const auto start = m_transform * m_start;
             const auto cur   = m_transform * m_cur;
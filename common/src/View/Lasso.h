@@ -22,7 +22,9 @@
 
 #include "TrenchBroom.h"
 
-#include <vecmath/plane.h>
+#include <vecmath/bbox.h>
+#include <vecmath/polygon.h>
+#include <vecmath/segment.h>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -37,6 +39,11 @@ namespace TrenchBroom {
             const Renderer::Camera& m_camera;
             const FloatType m_distance;
             const vm::mat4x4 m_transform;
+            const vm::vec3 m_position;
+            const vm::vec3 m_direction;
+            const vm::vec3 m_right;
+            const vm::vec3 m_up;
+            const bool m_perspective;
             const vm::vec3 m_start;
             vm::vec3 m_cur;
         public:
@@ -46,10 +53,9 @@ namespace TrenchBroom {
 
             template <typename I, typename O>
             void selected(I cur, I end, O out) const {
-                const vm::plane3 plane = this->plane();
                 const vm::bbox2 box = this->box();
                 while (cur != end) {
-                    if (selects(*cur, plane, box))
+                    if (selects(*cur, box))
                         out = *cur;
                     ++cur;
                 }
@@ -57,17 +63,21 @@ namespace TrenchBroom {
 
             template <typename H>
             bool selects(const H& h) const {
-                return selects(h, plane(), box());
+                return selects(h, box());
             }
         private:
-            bool selects(const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const;
-            bool selects(const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const;
-            bool selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const;
-            vm::vec3 project(const vm::vec3& point, const vm::plane3& plane) const;
+            bool selects(const vm::vec3& point, const vm::bbox2& box) const;
+            bool selects(const vm::segment3& edge, const vm::bbox2& box) const;
+            bool selects(const vm::polygon3& polygon, const vm::bbox2& box) const;
+
+            /**
+             * Projects the given point onto the lasso plane along the pick ray through it, returning its lasso
+             * coordinates, or NaN if the pick ray does not hit the plane.
+             */
+            vm::vec2 project(const vm::vec3& point) const;
         public:
             void render(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) const;
         private:
-            vm::plane3 plane() const;
             vm::bbox2 box() const;
         };
     }
@@ -37,14 +37,13 @@
 #include "Model/BrushGeometry.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/CollectAttributableNodesVisitor.h"
-#include "Model/CollectContainedNodesVisitor.h"
 #include "Model/CollectMatchingBrushFacesVisitor.h"
+#include "Model/CollectMatchingNodesInParallel.h"
 #include "Model/CollectNodesVisitor.h"
 #include "Model/CollectNodesByVisibilityVisitor.h"
 #include "Model/CollectSelectableNodesVisitor.h"
 #include "Model/CollectSelectableNodesWithFilePositionVisitor.h"
 #include "Model/CollectSelectedNodesVisitor.h"
-#include "Model/CollectTouchingNodesVisitor.h"
 #include "Model/CollectUniqueNodesVisitor.h"
 #include "Model/ComputeNodeBoundsVisitor.h"
 #include "Model/EditorContext.h"
@@ -116,6 +115,7 @@
 
 #include <vecmath/util.h>
 
+#include <algorithm>
 #include <cassert>
 #include <numeric>
 #include <type_traits>
@@ -149,7 +149,8 @@ namespace TrenchBroom {
         m_currentTextureName(Model::BrushFace::NoTextureName),
         m_lastSelectionBounds(0.0, 32.0),
         m_selectionBoundsValid(true),
-        m_viewEffectsService(nullptr) {
+        m_viewEffectsService(nullptr),
+        m_collectNotifierStatistics(false) {
                 bindObservers();
         }
 
@@ -285,6 +286,14 @@ namespace TrenchBroom {
             ensure(m_game.get() != nullptr, "game is null");
             ensure(m_world != nullptr, "world is null");
             m_game->writeMap(*m_world, path);
+
+            if (pref(Preferences::WriteMapCache)) {
+                try {
+                    m_game->writeMapCache(*m_world, m_worldBounds, path);
+                } catch (const FileSystemException& e) {
+                    warn("Could not write map cache: %s", e.what());
+                }
+            }
         }
 
         void MapDocument::exportDocumentAs(const Model::ExportFormat format, const IO::Path& path) {
@@ -541,12 +550,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::selectTouching(const bool del) {
-            const Model::BrushList& brushes = m_selectedNodes.brushes();
-
-            Model::CollectTouchingNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-
-            const Model::NodeList nodes = visitor.nodes();
+            const Model::NodeList nodes = Model::findTouchingNodes(m_world.get(), m_selectedNodes.brushes(), *m_editorContext);
 
             Transaction transaction(this, "Select Touching");
             if (del)
@@ -557,12 +561,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::selectInside(const bool del) {
-            const Model::BrushList& brushes = m_selectedNodes.brushes();
-
-            Model::CollectContainedNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-
-            const Model::NodeList nodes = visitor.nodes();
+            const Model::NodeList nodes = Model::findContainedNodes(m_world.get(), m_selectedNodes.brushes(), *m_editorContext);
 
             Transaction transaction(this, "Select Inside");
             if (del)
@@ -1446,15 +1445,37 @@ namespace TrenchBroom {
             return doGetNextCommandName();
         }
 
+        /**
+         * Records the node changes made while an instance of this class is alive and commits them when the
+         * outermost instance is destroyed.
+         */
+        class MapDocument::RecordNodeChanges {
+        private:
+            MapDocument* m_document;
+        public:
+            explicit RecordNodeChanges(MapDocument* document) :
+            m_document(document) {
+                m_document->m_nodeChangeJournal.beginCommand();
+            }
+
+            ~RecordNodeChanges() {
+                if (m_document->m_nodeChangeJournal.endCommand())
+                    m_document->commitNodeChanges();
+            }
+        };
+
         void MapDocument::undoLastCommand() {
+            const RecordNodeChanges recordNodeChanges(this);
             doUndoLastCommand();
         }
 
         void MapDocument::redoNextCommand() {
+            const RecordNodeChanges recordNodeChanges(this);
             doRedoNextCommand();
         }
 
         bool MapDocument::repeatLastCommands() {
+            const RecordNodeChanges recordNodeChanges(this);
             return doRepeatLastCommands();
         }
 
@@ -1462,6 +1483,10 @@ namespace TrenchBroom {
             doClearRepeatableCommands();
         }
 
+        size_t MapDocument::undoMemorySize() const {
+            return doGetUndoMemorySize();
+        }
+
         void MapDocument::beginTransaction(const String& name) {
             debug("Starting transaction '" + name + "'");
             doBeginTransaction(name);
@@ -1469,6 +1494,7 @@ namespace TrenchBroom {
 
         void MapDocument::rollbackTransaction() {
             debug("Rolling back transaction");
+            const RecordNodeChanges recordNodeChanges(this);
             doRollbackTransaction();
         }
 
@@ -1479,18 +1505,92 @@ namespace TrenchBroom {
 
         void MapDocument::cancelTransaction() {
             debug("Cancelling transaction");
+            const RecordNodeChanges recordNodeChanges(this);
             doRollbackTransaction();
             doEndTransaction();
         }
 
         bool MapDocument::submit(Command::Ptr command) {
+            const RecordNodeChanges recordNodeChanges(this);
             return doSubmit(command);
         }
 
         bool MapDocument::submitAndStore(UndoableCommand::Ptr command) {
+            const RecordNodeChanges recordNodeChanges(this);
             return doSubmitAndStore(command);
         }
 
+        void MapDocument::recordNodesWereAdded(const Model::NodeList& nodes) {
+            m_nodeChangeJournal.nodesWereAdded(nodes);
+            if (!m_nodeChangeJournal.recording())
+                commitNodeChanges();
+        }
+
+        void MapDocument::recordNodesWereRemoved(const Model::NodeList& nodes) {
+            m_nodeChangeJournal.nodesWereRemoved(nodes);
+            if (!m_nodeChangeJournal.recording())
+                commitNodeChanges();
+        }
+
+        void MapDocument::recordNodesDidChange(const Model::NodeList& nodes) {
+            m_nodeChangeJournal.nodesDidChange(nodes);
+            if (!m_nodeChangeJournal.recording())
+                commitNodeChanges();
+        }
+
+        void MapDocument::commitNodeChanges() {
+            const size_t notificationCount = m_nodeChangeJournal.notificationCount();
+            const NodeChanges changes = m_nodeChangeJournal.takeChanges();
+            if (!changes.empty()) {
+                if (m_collectNotifierStatistics && notificationCount > 1)
+                    debug() << "Coalesced " << notificationCount << " node change notifications";
+                nodeChangesWereCommittedNotifier(changes);
+            }
+        }
+
+        bool MapDocument::collectsNotifierStatistics() const {
+            return m_collectNotifierStatistics;
+        }
+
+        void MapDocument::setCollectNotifierStatistics(const bool collectNotifierStatistics) {
+            m_collectNotifierStatistics = collectNotifierStatistics;
+            NotifierStatistics* statistics = collectNotifierStatistics ? &m_notifierStatistics : nullptr;
+            nodesWereAddedNotifier.setStatistics(statistics);
+            nodesWillBeRemovedNotifier.setStatistics(statistics);
+            nodesWereRemovedNotifier.setStatistics(statistics);
+            nodesWillChangeNotifier.setStatistics(statistics);
+            nodesDidChangeNotifier.setStatistics(statistics);
+            nodeChangesWereCommittedNotifier.setStatistics(statistics);
+            brushFacesDidChangeNotifier.setStatistics(statistics);
+            selectionDidChangeNotifier.setStatistics(statistics);
+        }
+
+        const NotifierStatistics& MapDocument::notifierStatistics() const {
+            return m_notifierStatistics;
+        }
+
+        void MapDocument::clearNotifierStatistics() {
+            m_notifierStatistics.clear();
+        }
+
+        void MapDocument::printNotifierStatistics() {
+            using Entry = NotifierStatistics::EntryMap::value_type;
+            std::vector<const Entry*> entries;
+            for (const Entry& entry : m_notifierStatistics.entries())
+                entries.push_back(&entry);
+
+            // the most expensive observers first
+            std::sort(std::begin(entries), std::end(entries), [](const Entry* lhs, const Entry* rhs) {
+                return lhs->second.time > rhs->second.time;
+            });
+
+            info() << "Notifier statistics (" << entries.size() << " observer types):";
+            for (const Entry* entry : entries) {
+                const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(entry->second.time);
+                info() << entry->first << ": " << entry->second.callCount << " calls, " << milliseconds.count() << " ms";
+            }
+        }
+
         void MapDocument::commitPendingAssets() {
             m_textureManager->commitChanges();
         }
@@ -1500,6 +1600,11 @@ namespace TrenchBroom {
                 m_world->pick(pickRay, pickResult);
         }
 
+        void MapDocument::pickFirst(const vm::ray3& pickRay, Model::PickResult& pickResult, const Model::HitQuery& query) const {
+            if (m_world != nullptr)
+                m_world->pickFirst(pickRay, pickResult, query);
+        }
+
         Model::NodeList MapDocument::findNodesContaining(const vm::vec3& point) const {
             Model::NodeList result;
             if (m_world != nullptr) {
@@ -2019,6 +2124,11 @@ namespace TrenchBroom {
             commandDoneNotifier.addObserver(this, &MapDocument::commandDone);
             commandUndoneNotifier.addObserver(this, &MapDocument::commandUndone);
 
+            // node change journal
+            nodesWereAddedNotifier.addObserver(this, &MapDocument::recordNodesWereAdded);
+            nodesWereRemovedNotifier.addObserver(this, &MapDocument::recordNodesWereRemoved);
+            nodesDidChangeNotifier.addObserver(this, &MapDocument::recordNodesDidChange);
+
             // tag management
             documentWasNewedNotifier.addObserver(this, &MapDocument::initializeNodeTags);
             documentWasLoadedNotifier.addObserver(this, &MapDocument::initializeNodeTags);
@@ -2038,6 +2148,11 @@ namespace TrenchBroom {
             commandDoneNotifier.removeObserver(this, &MapDocument::commandDone);
             commandUndoneNotifier.removeObserver(this, &MapDocument::commandUndone);
 
+            // node change journal
+            nodesWereAddedNotifier.removeObserver(this, &MapDocument::recordNodesWereAdded);
+            nodesWereRemovedNotifier.removeObserver(this, &MapDocument::recordNodesWereRemoved);
+            nodesDidChangeNotifier.removeObserver(this, &MapDocument::recordNodesDidChange);
+
             // tag management
             documentWasNewedNotifier.removeObserver(this, &MapDocument::initializeNodeTags);
             documentWasLoadedNotifier.removeObserver(this, &MapDocument::initializeNodeTags);
@@ -32,6 +32,7 @@
 #include "Model/NodeCollection.h"
 #include "Model/TexCoordSystem.h"
 #include "View/CachingLogger.h"
+#include "View/NodeChangeJournal.h"
 #include "View/UndoableCommand.h"
 #include "View/ViewTypes.h"
 
@@ -55,6 +56,7 @@ namespace TrenchBroom {
         class ChangeBrushFaceAttributesRequest;
         class EditorContext;
         class Group;
+        class HitQuery;
         class PickResult;
         class PointFile;
         class PortalFile;
@@ -66,6 +68,7 @@ namespace TrenchBroom {
         class Command;
         class Grid;
         class MapViewConfig;
+        class NodeChanges;
         class Selection;
         class UndoableCommand;
         class ViewEffectsService;
@@ -108,6 +111,10 @@ namespace TrenchBroom {
             mutable bool m_selectionBoundsValid;
 
             ViewEffectsService* m_viewEffectsService;
+
+            NodeChangeJournal m_nodeChangeJournal;
+            bool m_collectNotifierStatistics;
+            NotifierStatistics m_notifierStatistics;
         public: // notification
             Notifier<Command::Ptr> commandDoNotifier;
             Notifier<Command::Ptr> commandDoneNotifier;
@@ -137,6 +144,13 @@ namespace TrenchBroom {
             Notifier<const Model::NodeList&> nodesWillChangeNotifier;
             Notifier<const Model::NodeList&> nodesDidChangeNotifier;
 
+            /**
+             * Notifies observers once per command with the coalesced node additions, removals and changes of that
+             * command. Observers that only need to invalidate cached state should prefer this over the notifiers
+             * above, which fire for every individual change.
+             */
+            Notifier<const NodeChanges&> nodeChangesWereCommittedNotifier;
+
             Notifier<const Model::NodeList&> nodeVisibilityDidChangeNotifier;
             Notifier<const Model::NodeList&> nodeLockingDidChangeNotifier;
 
@@ -368,6 +382,7 @@ namespace TrenchBroom {
             void redoNextCommand();
             bool repeatLastCommands();
             void clearRepeatableCommands();
+            size_t undoMemorySize() const;
         public: // transactions
             void beginTransaction(const String& name = "");
             void rollbackTransaction();
@@ -376,6 +391,18 @@ namespace TrenchBroom {
         private:
             bool submit(Command::Ptr command);
             bool submitAndStore(UndoableCommand::Ptr command);
+
+            class RecordNodeChanges;
+            void recordNodesWereAdded(const Model::NodeList& nodes);
+            void recordNodesWereRemoved(const Model::NodeList& nodes);
+            void recordNodesDidChange(const Model::NodeList& nodes);
+            void commitNodeChanges();
+        public: // notification statistics
+            bool collectsNotifierStatistics() const;
+            void setCollectNotifierStatistics(bool collectNotifierStatistics);
+            const NotifierStatistics& notifierStatistics() const;
+            void clearNotifierStatistics();
+            void printNotifierStatistics();
         private: // subclassing interface for command processing
             virtual bool doCanUndoLastCommand() const = 0;
             virtual bool doCanRedoNextCommand() const = 0;
@@ -385,6 +412,7 @@ namespace TrenchBroom {
             virtual void doRedoNextCommand() = 0;
             virtual bool doRepeatLastCommands() = 0;
             virtual void doClearRepeatableCommands() = 0;
+            virtual size_t doGetUndoMemorySize() const = 0;
 
             virtual void doBeginTransaction(const String& name) = 0;
             virtual void doEndTransaction() = 0;
@@ -396,6 +424,7 @@ namespace TrenchBroom {
             void commitPendingAssets();
         public: // picking
             void pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const;
+            void pickFirst(const vm::ray3& pickRay, Model::PickResult& pickResult, const Model::HitQuery& query) const;
             Model::NodeList findNodesContaining(const vm::vec3& point) const;
         private: // world management
             void createWorld(Model::MapFormat mapFormat, const vm::bbox3& worldBounds, Model::GameSPtr game);
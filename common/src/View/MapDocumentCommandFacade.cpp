@@ -30,7 +30,7 @@
 #include "Model/CollectNodesWithDescendantSelectionCountVisitor.h"
 #include "Model/CollectRecursivelySelectedNodesVisitor.h"
 #include "Model/CollectSelectableBrushFacesVisitor.h"
-#include "Model/CollectSelectableNodesVisitor.h"
+#include "Model/CollectMatchingNodesInParallel.h"
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Model/Game.h"
@@ -123,15 +123,16 @@ namespace TrenchBroom {
         void MapDocumentCommandFacade::performSelectAllNodes() {
             performDeselectAll();
 
-            Model::CollectSelectableNodesVisitor visitor(*m_editorContext);
-
             Model::Node* target = currentGroup();
             if (target == nullptr) {
                 target = m_world.get();
             }
 
-            target->recurse(visitor);
-            performSelect(visitor.nodes());
+            const Model::EditorContext& editorContext = *m_editorContext;
+            const auto nodes = Model::collectMatchingNodesInParallel(target->children(),
+                [](const Model::Node*) { return true; },
+                [&](const Model::Node* node) { return editorContext.selectable(node); });
+            performSelect(nodes);
         }
 
         void MapDocumentCommandFacade::performSelectAllBrushFaces() {
@@ -725,9 +726,7 @@ namespace TrenchBroom {
             Notifier<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
 
-            for (Model::Brush* brush : brushes) {
-                brush->findIntegerPlanePoints(m_worldBounds);
-            }
+            Model::Brush::findIntegerPlanePoints(brushes, m_worldBounds);
 
             return true;
         }
@@ -1011,6 +1010,10 @@ namespace TrenchBroom {
             m_commandProcessor.clearRepeatableCommands();
         }
 
+        size_t MapDocumentCommandFacade::doGetUndoMemorySize() const {
+            return m_commandProcessor.undoMemorySize();
+        }
+
         void MapDocumentCommandFacade::doBeginTransaction(const String& name) {
             m_commandProcessor.beginGroup(name);
         }
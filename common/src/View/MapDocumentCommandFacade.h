@@ -131,6 +131,7 @@ namespace TrenchBroom {
             void doRedoNextCommand() override;
             bool doRepeatLastCommands() override;
             void doClearRepeatableCommands() override;
+            size_t doGetUndoMemorySize() const override;
 
             void doBeginTransaction(const String& name) override;
             void doEndTransaction() override;
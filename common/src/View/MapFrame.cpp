@@ -67,6 +67,7 @@
 #include <wx/clipbrd.h>
 #include <wx/display.h>
 #include <wx/filedlg.h>
+#include <wx/filename.h>
 #include <wx/textdlg.h>
 #include <wx/msgdlg.h>
 #include <wx/persist.h>
@@ -97,6 +98,7 @@ namespace TrenchBroom {
         m_lastFocus(nullptr),
         m_gridChoice(nullptr),
         m_statusBar(nullptr),
+        m_undoMemorySizeValid(false),
         m_compilationDialog(nullptr),
         m_updateLocker(nullptr) {}
 
@@ -114,6 +116,7 @@ namespace TrenchBroom {
         m_lastFocus(nullptr),
         m_gridChoice(nullptr),
         m_statusBar(nullptr),
+        m_undoMemorySizeValid(false),
         m_compilationDialog(nullptr),
         m_updateLocker(nullptr) {
             Create(frameManager, document);
@@ -490,7 +493,10 @@ namespace TrenchBroom {
         }
 
         void MapFrame::createStatusBar() {
-            m_statusBar = CreateStatusBar();
+            m_statusBar = CreateStatusBar(2);
+
+            const int widths[] = { -1, 160 };
+            m_statusBar->SetStatusWidths(2, widths);
         }
 
         static Model::AttributableNode* commonEntityForBrushList(const Model::BrushList& list) {
@@ -617,6 +623,19 @@ namespace TrenchBroom {
             m_statusBar->SetStatusText(describeSelection(m_document.get()));
         }
 
+        void MapFrame::invalidateUndoMemorySize() {
+            m_undoMemorySizeValid = false;
+        }
+
+        void MapFrame::updateUndoMemorySize() {
+            if (!m_undoMemorySizeValid) {
+                m_undoMemorySizeValid = true;
+
+                const wxULongLong size(m_document->undoMemorySize());
+                m_statusBar->SetStatusText("Undo: " + wxFileName::GetHumanReadableSize(size), 1);
+            }
+        }
+
         void MapFrame::bindObservers() {
             PreferenceManager& prefs = PreferenceManager::instance();
             prefs.preferenceDidChangeNotifier.addObserver(this, &MapFrame::preferenceDidChange);
@@ -655,15 +674,19 @@ namespace TrenchBroom {
 
         void MapFrame::documentWasCleared(View::MapDocument* document) {
             updateTitle();
+            invalidateUndoMemorySize();
         }
 
         void MapFrame::documentDidChange(View::MapDocument* document) {
             updateTitle();
             updateRecentDocumentsMenu();
+            invalidateUndoMemorySize();
         }
 
         void MapFrame::documentModificationStateDidChange() {
             updateTitle();
+            // the command is only stored after the notification, so the size is updated once the frame is idle
+            invalidateUndoMemorySize();
         }
 
         void MapFrame::preferenceDidChange(const IO::Path& path) {
@@ -786,6 +809,7 @@ namespace TrenchBroom {
             Bind(wxEVT_MENU, &MapFrame::OnDebugCopyJSShortcutMap, this, CommandIds::Menu::DebugCopyJSShortcuts);
             Bind(wxEVT_MENU, &MapFrame::OnDebugCrash, this, CommandIds::Menu::DebugCrash);
             Bind(wxEVT_MENU, &MapFrame::OnDebugThrowExceptionDuringCommand, this, CommandIds::Menu::DebugThrowExceptionDuringCommand);
+            Bind(wxEVT_MENU, &MapFrame::OnDebugToggleNotifierStatistics, this, CommandIds::Menu::DebugToggleNotifierStatistics);
             Bind(wxEVT_MENU, &MapFrame::OnDebugSetWindowSize, this, CommandIds::Menu::DebugSetWindowSize);
 
             Bind(wxEVT_MENU, &MapFrame::OnFlipObjectsHorizontally, this, CommandIds::Actions::FlipObjectsHorizontally);
@@ -807,6 +831,7 @@ namespace TrenchBroom {
 
             Bind(wxEVT_CLOSE_WINDOW, &MapFrame::OnClose, this);
             Bind(wxEVT_TIMER, &MapFrame::OnAutosaveTimer, this);
+            Bind(wxEVT_IDLE, &MapFrame::OnIdle, this);
 			Bind(wxEVT_CHILD_FOCUS, &MapFrame::OnChildFocus, this);
 
 #if defined(_WIN32)
@@ -1545,6 +1570,18 @@ namespace TrenchBroom {
             m_document->throwExceptionDuringCommand();
         }
 
+        void MapFrame::OnDebugToggleNotifierStatistics(wxCommandEvent& event) {
+            if (IsBeingDeleted()) return;
+
+            if (m_document->collectsNotifierStatistics()) {
+                m_document->setCollectNotifierStatistics(false);
+                m_document->printNotifierStatistics();
+            } else {
+                m_document->clearNotifierStatistics();
+                m_document->setCollectNotifierStatistics(true);
+            }
+        }
+
         void MapFrame::OnDebugSetWindowSize(wxCommandEvent& event) {
             wxTextEntryDialog dialog(this, "Enter Size (W H)", "Window Size", "1920 1080");
             if (dialog.ShowModal() == wxID_OK) {
@@ -1860,6 +1897,10 @@ namespace TrenchBroom {
                 case CommandIds::Menu::DebugClipWithFace:
                     event.Enable(m_document->selectedNodes().hasOnlyBrushes());
                     break;
+                case CommandIds::Menu::DebugToggleNotifierStatistics:
+                    event.Enable(true);
+                    event.Check(m_document->collectsNotifierStatistics());
+                    break;
                 case CommandIds::Actions::FlipObjectsHorizontally:
                 case CommandIds::Actions::FlipObjectsVertically:
                     event.Enable(m_mapView->canFlipObjects());
@@ -2083,6 +2124,13 @@ namespace TrenchBroom {
             m_autosaver->triggerAutosave(logger());
         }
 
+        void MapFrame::OnIdle(wxIdleEvent& event) {
+            if (IsBeingDeleted()) return;
+
+            updateUndoMemorySize();
+            event.Skip();
+        }
+
         int MapFrame::indexForGridSize(const int gridSize) {
             return gridSize - Grid::MinSize;
         }
@@ -73,6 +73,7 @@ namespace TrenchBroom {
             wxChoice* m_gridChoice;
 
             wxStatusBar* m_statusBar;
+            bool m_undoMemorySizeValid;
 
             wxDialog* m_compilationDialog;
 
@@ -118,6 +119,8 @@ namespace TrenchBroom {
         private: // status bar
             void createStatusBar();
             void updateStatusBar();
+            void invalidateUndoMemorySize();
+            void updateUndoMemorySize();
         private: // gui creation
             void createGui();
         private: // notification handlers
@@ -241,6 +244,7 @@ namespace TrenchBroom {
             void OnDebugCopyJSShortcutMap(wxCommandEvent& event);
             void OnDebugCrash(wxCommandEvent& event);
             void OnDebugThrowExceptionDuringCommand(wxCommandEvent& event);
+            void OnDebugToggleNotifierStatistics(wxCommandEvent& event);
             void OnDebugSetWindowSize(wxCommandEvent& event);
 
             void OnFlipObjectsHorizontally(wxCommandEvent& event);
@@ -291,6 +295,7 @@ namespace TrenchBroom {
         private: // other event handlers
             void OnClose(wxCloseEvent& event);
             void OnAutosaveTimer(wxTimerEvent& event);
+            void OnIdle(wxIdleEvent& event);
         private: // grid helpers
             static int indexForGridSize(const int gridSize);
             static int gridSizeForIndex(const int index);
@@ -152,6 +152,7 @@ namespace TrenchBroom {
             const auto& editorContext = document->editorContext();
             const auto axis = firstComponent(pickRay.direction);
 
+            // the hits are ordered by size, so there is no first hit to stop at
             auto pickResult = Model::PickResult::bySize(editorContext, axis);
             document->pick(pickRay, pickResult);
 
@@ -312,6 +312,8 @@ namespace TrenchBroom {
             const Model::EditorContext& editorContext = document->editorContext();
             Model::PickResult pickResult = Model::PickResult::byDistance(editorContext);
 
+            // This result is shared by every tool in the chain and reused for the following click, drag and scroll
+            // events, which query it with different filters or for all hits, so we cannot stop at the first hit here.
             document->pick(pickRay, pickResult);
             return pickResult;
         }
@@ -332,9 +334,10 @@ namespace TrenchBroom {
 
                 const auto& editorContext = document->editorContext();
                 auto pickResult = Model::PickResult::byDistance(editorContext);
+                const auto query = pickResult.query().pickable().type(Model::Brush::BrushHit);
 
-                document->pick(pickRay, pickResult);
-                const auto& hit = pickResult.query().pickable().type(Model::Brush::BrushHit).first();
+                document->pickFirst(pickRay, pickResult, query);
+                const auto& hit = query.first();
 
                 if (hit.isMatch()) {
                     const auto* face = Model::hitToFace(hit);
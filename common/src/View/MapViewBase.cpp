@@ -57,6 +57,7 @@
 #include "View/FlyModeHelper.h"
 #include "View/Grid.h"
 #include "View/MapDocument.h"
+#include "View/NodeChanges.h"
 #include "View/MapViewConfig.h"
 #include "View/MapViewToolBox.h"
 #include "View/ToolBoxDropTarget.h"
@@ -121,9 +122,7 @@ namespace TrenchBroom {
 
         void MapViewBase::bindObservers() {
             MapDocumentSPtr document = lock(m_document);
-            document->nodesWereAddedNotifier.addObserver(this, &MapViewBase::nodesDidChange);
-            document->nodesWereRemovedNotifier.addObserver(this, &MapViewBase::nodesDidChange);
-            document->nodesDidChangeNotifier.addObserver(this, &MapViewBase::nodesDidChange);
+            document->nodeChangesWereCommittedNotifier.addObserver(this, &MapViewBase::nodeChangesWereCommitted);
             document->nodeVisibilityDidChangeNotifier.addObserver(this, &MapViewBase::nodesDidChange);
             document->nodeLockingDidChangeNotifier.addObserver(this, &MapViewBase::nodesDidChange);
             document->commandDoneNotifier.addObserver(this, &MapViewBase::commandDone);
@@ -155,9 +154,7 @@ namespace TrenchBroom {
         void MapViewBase::unbindObservers() {
             if (!expired(m_document)) {
                 MapDocumentSPtr document = lock(m_document);
-                document->nodesWereAddedNotifier.removeObserver(this, &MapViewBase::nodesDidChange);
-                document->nodesWereRemovedNotifier.removeObserver(this, &MapViewBase::nodesDidChange);
-                document->nodesDidChangeNotifier.removeObserver(this, &MapViewBase::nodesDidChange);
+                document->nodeChangesWereCommittedNotifier.removeObserver(this, &MapViewBase::nodeChangesWereCommitted);
                 document->nodeVisibilityDidChangeNotifier.removeObserver(this, &MapViewBase::nodesDidChange);
                 document->nodeLockingDidChangeNotifier.removeObserver(this, &MapViewBase::nodesDidChange);
                 document->commandDoneNotifier.removeObserver(this, &MapViewBase::commandDone);
@@ -192,6 +189,11 @@ namespace TrenchBroom {
             Refresh();
         }
 
+        void MapViewBase::nodeChangesWereCommitted(const NodeChanges& changes) {
+            updatePickResult();
+            Refresh();
+        }
+
         void MapViewBase::toolChanged(Tool* tool) {
             updatePickResult();
             updateAcceleratorTable(HasFocus());
@@ -62,6 +62,7 @@ namespace TrenchBroom {
         class GLContextManager;
         class MapViewToolBox;
         class MovementRestriction;
+        class NodeChanges;
         class Selection;
         class Tool;
 
@@ -93,6 +94,7 @@ namespace TrenchBroom {
             void unbindObservers();
 
             void nodesDidChange(const Model::NodeList& nodes);
+            void nodeChangesWereCommitted(const NodeChanges& changes);
             void toolChanged(Tool* tool);
             void commandDone(Command::Ptr command);
             void commandUndone(UndoableCommand::Ptr command);
@@ -0,0 +1,125 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeChangeJournal.h"
+
+#include "Ensure.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace View {
+        NodeChangeJournal::NodeChangeJournal() :
+        m_commandLevel(0),
+        m_notificationCount(0) {}
+
+        void NodeChangeJournal::beginCommand() {
+            ++m_commandLevel;
+        }
+
+        bool NodeChangeJournal::endCommand() {
+            ensure(m_commandLevel > 0, "command level must be positive");
+            return --m_commandLevel == 0;
+        }
+
+        bool NodeChangeJournal::recording() const {
+            return m_commandLevel > 0;
+        }
+
+        void NodeChangeJournal::nodesWereAdded(const Model::NodeList& nodes) {
+            ++m_notificationCount;
+            for (Model::Node* node : nodes)
+                record(node, Change_Added);
+        }
+
+        void NodeChangeJournal::nodesWereRemoved(const Model::NodeList& nodes) {
+            ++m_notificationCount;
+            for (Model::Node* node : nodes)
+                record(node, Change_Removed);
+        }
+
+        void NodeChangeJournal::nodesDidChange(const Model::NodeList& nodes) {
+            ++m_notificationCount;
+            for (Model::Node* node : nodes)
+                record(node, Change_Changed);
+        }
+
+        size_t NodeChangeJournal::notificationCount() const {
+            return m_notificationCount;
+        }
+
+        NodeChanges NodeChangeJournal::takeChanges() {
+            NodeChanges result;
+            for (Model::Node* node : m_order) {
+                const auto it = m_changes.find(node);
+                if (it == std::end(m_changes))
+                    continue; // the node was added and removed again
+
+                switch (it->second) {
+                    case Change_Added:
+                        result.addAddedNode(node);
+                        break;
+                    case Change_Removed:
+                        result.addRemovedNode(node);
+                        break;
+                    case Change_Changed:
+                        result.addChangedNode(node);
+                        break;
+                    switchDefault()
+                }
+                m_changes.erase(it);
+            }
+
+            assert(m_changes.empty());
+            m_changes.clear();
+            m_order.clear();
+            m_notificationCount = 0;
+            return result;
+        }
+
+        void NodeChangeJournal::record(Model::Node* node, const Change change) {
+            const auto result = m_changes.emplace(node, change);
+            if (result.second) {
+                m_order.push_back(node);
+                return;
+            }
+
+            auto it = result.first;
+            const Change previous = it->second;
+            switch (change) {
+                case Change_Added:
+                    // a node that was removed and added again, e.g. when reparenting, has only changed
+                    if (previous == Change_Removed)
+                        it->second = Change_Changed;
+                    break;
+                case Change_Removed:
+                    // a node that was added and removed again was never visible to observers
+                    if (previous == Change_Added)
+                        m_changes.erase(it);
+                    else
+                        it->second = Change_Removed;
+                    break;
+                case Change_Changed:
+                    // added or removed nodes need no further change notification
+                    break;
+                switchDefault()
+            }
+        }
+    }
+}
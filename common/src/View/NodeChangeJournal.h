@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_NodeChangeJournal
+#define TrenchBroom_NodeChangeJournal
+
+#include "Macros.h"
+#include "Model/ModelTypes.h"
+#include "View/NodeChanges.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * Records the nodes that are added, removed or changed while commands are executed and coalesces them so
+         * that each node is reported only once per command, with its net change.
+         *
+         * Commands may be nested, e.g. when a command group is undone. The recorded changes are only handed out once
+         * the outermost command has ended.
+         */
+        class NodeChangeJournal {
+        private:
+            typedef enum {
+                Change_Added,
+                Change_Removed,
+                Change_Changed
+            } Change;
+
+            std::unordered_map<Model::Node*, Change> m_changes;
+            Model::NodeList m_order;
+            size_t m_commandLevel;
+            size_t m_notificationCount;
+        public:
+            NodeChangeJournal();
+
+            /**
+             * Starts recording the changes of a command.
+             */
+            void beginCommand();
+
+            /**
+             * Ends the current command.
+             *
+             * @return true if the outermost command has ended and the recorded changes should be committed
+             */
+            bool endCommand();
+
+            /**
+             * Indicates whether a command is currently being executed.
+             */
+            bool recording() const;
+
+            void nodesWereAdded(const Model::NodeList& nodes);
+            void nodesWereRemoved(const Model::NodeList& nodes);
+            void nodesDidChange(const Model::NodeList& nodes);
+
+            /**
+             * Returns the number of notifications that were recorded since the changes were last taken.
+             */
+            size_t notificationCount() const;
+
+            /**
+             * Returns the consolidated changes recorded so far and clears this journal.
+             */
+            NodeChanges takeChanges();
+        private:
+            void record(Model::Node* node, Change change);
+
+            deleteCopyAndMove(NodeChangeJournal)
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_NodeChangeJournal) */
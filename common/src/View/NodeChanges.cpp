@@ -0,0 +1,52 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeChanges.h"
+
+namespace TrenchBroom {
+    namespace View {
+        const Model::NodeList& NodeChanges::addedNodes() const {
+            return m_addedNodes;
+        }
+
+        const Model::NodeList& NodeChanges::removedNodes() const {
+            return m_removedNodes;
+        }
+
+        const Model::NodeList& NodeChanges::changedNodes() const {
+            return m_changedNodes;
+        }
+
+        bool NodeChanges::empty() const {
+            return m_addedNodes.empty() && m_removedNodes.empty() && m_changedNodes.empty();
+        }
+
+        void NodeChanges::addAddedNode(Model::Node* node) {
+            m_addedNodes.push_back(node);
+        }
+
+        void NodeChanges::addRemovedNode(Model::Node* node) {
+            m_removedNodes.push_back(node);
+        }
+
+        void NodeChanges::addChangedNode(Model::Node* node) {
+            m_changedNodes.push_back(node);
+        }
+    }
+}
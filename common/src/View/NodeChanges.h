@@ -0,0 +1,49 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_NodeChanges
+#define TrenchBroom_NodeChanges
+
+#include "Model/ModelTypes.h"
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * The consolidated node changes of a single command. Every node is contained in at most one of the lists.
+         */
+        class NodeChanges {
+        private:
+            Model::NodeList m_addedNodes;
+            Model::NodeList m_removedNodes;
+            Model::NodeList m_changedNodes;
+        public:
+            const Model::NodeList& addedNodes() const;
+            const Model::NodeList& removedNodes() const;
+            const Model::NodeList& changedNodes() const;
+
+            bool empty() const;
+
+            void addAddedNode(Model::Node* node);
+            void addRemovedNode(Model::Node* node);
+            void addChangedNode(Model::Node* node);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_NodeChanges) */
@@ -57,5 +57,17 @@ namespace TrenchBroom {
         bool ReparentNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t ReparentNodesCommand::doGetMemorySize() const {
+            // the nodes are moved between parents, so only the maps need to be kept
+            return memorySize(m_nodesToAdd) + memorySize(m_nodesToRemove);
+        }
+
+        size_t ReparentNodesCommand::memorySize(const Model::ParentChildrenMap& nodes) {
+            size_t result = 0;
+            for (const auto& entry : nodes)
+                result += sizeof(entry) + entry.second.capacity() * sizeof(Model::Node*);
+            return result;
+        }
     }
 }
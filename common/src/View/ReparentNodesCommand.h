@@ -44,6 +44,9 @@ namespace TrenchBroom {
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+
+            size_t doGetMemorySize() const override;
+            static size_t memorySize(const Model::ParentChildrenMap& nodes);
         };
     }
 }
@@ -37,6 +37,7 @@ namespace TrenchBroom {
         bool SnapshotCommand::performDo(MapDocumentCommandFacade *document) {
             takeSnapshot(document);
             if (DocumentCommand::performDo(document)) {
+                m_snapshot->compact();
                 return true;
             } else {
                 deleteSnapshot();
@@ -48,6 +49,19 @@ namespace TrenchBroom {
             return restoreSnapshot(document);
         }
 
+        bool SnapshotCommand::collateWith(UndoableCommand::Ptr command) {
+            if (!DocumentCommand::collateWith(command)) {
+                return false;
+            }
+
+            // the snapshot now has to restore the state before this command from the state after the other command
+            SnapshotCommand* other = static_cast<SnapshotCommand*>(command.get());
+            if (m_snapshot != nullptr && other->m_snapshot != nullptr) {
+                m_snapshot->collate(*other->m_snapshot);
+            }
+            return true;
+        }
+
         void SnapshotCommand::takeSnapshot(MapDocumentCommandFacade *document) {
             assert(m_snapshot == nullptr);
             m_snapshot = doTakeSnapshot(document);
@@ -66,6 +80,10 @@ namespace TrenchBroom {
             m_snapshot = nullptr;
         }
 
+        size_t SnapshotCommand::doGetMemorySize() const {
+            return m_snapshot != nullptr ? m_snapshot->memorySize() : 0;
+        }
+
         Model::Snapshot *SnapshotCommand::doTakeSnapshot(MapDocumentCommandFacade *document) const {
             const auto& nodes = document->selectedNodes().nodes();
             return new Model::Snapshot(std::begin(nodes), std::end(nodes));
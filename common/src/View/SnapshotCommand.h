@@ -37,10 +37,13 @@ namespace TrenchBroom {
         public:
             bool performDo(MapDocumentCommandFacade* document) override;
             bool doPerformUndo(MapDocumentCommandFacade* document) override;
+            bool collateWith(UndoableCommand::Ptr command) override;
         private:
             void takeSnapshot(MapDocumentCommandFacade* document);
             bool restoreSnapshot(MapDocumentCommandFacade* document);
             void deleteSnapshot();
+
+            size_t doGetMemorySize() const override;
         private:
             virtual Model::Snapshot* doTakeSnapshot(MapDocumentCommandFacade* document) const;
         };
@@ -222,11 +222,12 @@ namespace TrenchBroom {
                 const auto pos3 = +w2 * r -h2 * u + p;
                 const auto pos4 = -w2 * r -h2 * u + p;
 
+                const auto texCoords = face->textureCoordProjection();
                 return Vertex::List({
-                    Vertex(pos1, normal, face->textureCoords(vm::vec3(pos1))),
-                    Vertex(pos2, normal, face->textureCoords(vm::vec3(pos2))),
-                    Vertex(pos3, normal, face->textureCoords(vm::vec3(pos3))),
-                    Vertex(pos4, normal, face->textureCoords(vm::vec3(pos4)))
+                    Vertex(pos1, normal, texCoords(vm::vec3(pos1))),
+                    Vertex(pos2, normal, texCoords(vm::vec3(pos2))),
+                    Vertex(pos3, normal, texCoords(vm::vec3(pos3))),
+                    Vertex(pos4, normal, texCoords(vm::vec3(pos4)))
                 });
             }
         private:
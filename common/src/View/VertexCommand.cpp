@@ -131,7 +131,12 @@ namespace TrenchBroom {
                 }
 
                 takeSnapshot();
-                return doVertexOperation(document);
+                if (!doVertexOperation(document)) {
+                    return false;
+                }
+
+                m_snapshot->compact();
+                return true;
             }
         }
 
@@ -140,12 +145,30 @@ namespace TrenchBroom {
             return true;
         }
 
+        size_t VertexCommand::doGetMemorySize() const {
+            return m_snapshot != nullptr ? m_snapshot->memorySize() : 0;
+        }
+
         void VertexCommand::restoreAndTakeNewSnapshot(MapDocumentCommandFacade* document) {
             ensure(m_snapshot != nullptr, "snapshot is null");
 
             auto snapshot = std::move(m_snapshot);
             takeSnapshot();
             document->restoreSnapshot(snapshot.get());
+            m_snapshot->compact();
+        }
+
+        bool VertexCommand::collateWith(UndoableCommand::Ptr command) {
+            if (!DocumentCommand::collateWith(command)) {
+                return false;
+            }
+
+            // the snapshot now has to restore the state before this command from the state after the other command
+            VertexCommand* other = static_cast<VertexCommand*>(command.get());
+            if (m_snapshot != nullptr && other->m_snapshot != nullptr) {
+                m_snapshot->collate(*other->m_snapshot);
+            }
+            return true;
         }
 
         bool VertexCommand::doIsRepeatable(MapDocumentCommandFacade*) const {
@@ -42,6 +42,8 @@ namespace TrenchBroom {
             VertexCommand(CommandType type, const String& name, const Model::BrushList& brushes);
         public:
             ~VertexCommand() override;
+
+            bool collateWith(UndoableCommand::Ptr command) override;
         protected:
             template <typename H, typename C>
             static void extract(const std::map<H, Model::BrushSet, C>& handleToBrushes, Model::BrushList& brushes, std::map<Model::Brush*, std::vector<H>>& brushToHandles, std::vector<H>& handles) {
@@ -72,6 +74,7 @@ namespace TrenchBroom {
         private:
             bool doPerformDo(MapDocumentCommandFacade* document) override;
             bool doPerformUndo(MapDocumentCommandFacade* document) override;
+            size_t doGetMemorySize() const override;
             void restoreAndTakeNewSnapshot(MapDocumentCommandFacade* document);
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
         private:
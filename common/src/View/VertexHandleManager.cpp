@@ -32,29 +32,63 @@ namespace TrenchBroom {
     namespace View {
         VertexHandleManagerBase::~VertexHandleManagerBase() {}
 
+        vm::bbox3 VertexHandleManagerBase::bounds(const vm::vec3& handle) {
+            return vm::bbox3(handle, handle);
+        }
+
+        vm::bbox3 VertexHandleManagerBase::bounds(const vm::segment3& handle) {
+            return vm::bbox3(min(handle.start(), handle.end()), max(handle.start(), handle.end()));
+        }
+
+        vm::bbox3 VertexHandleManagerBase::bounds(const vm::polygon3& handle) {
+            vm::bbox3::builder builder;
+            builder.add(std::begin(handle), std::end(handle));
+            return builder.bounds();
+        }
+
+        std::function<bool(const vm::bbox3&)> VertexHandleManagerBase::makeRayTest(const vm::ray3& pickRay, const Renderer::Camera& camera, const FloatType handleRadius) {
+            // the gradient of the scaling factor is the same everywhere, so it is sampled at the camera position
+            static const auto step = 1024.0f;
+            const auto origin = camera.position();
+            const auto originScaling = camera.perspectiveScalingFactor(origin);
+            const auto gradient = vm::vec3(
+                camera.perspectiveScalingFactor(origin + step * vm::vec3f::pos_x) - originScaling,
+                camera.perspectiveScalingFactor(origin + step * vm::vec3f::pos_y) - originScaling,
+                camera.perspectiveScalingFactor(origin + step * vm::vec3f::pos_z) - originScaling) / static_cast<FloatType>(step);
+            const auto maxScalingChange = length(gradient);
+
+            return [=, &camera](const vm::bbox3& box) {
+                const auto center = box.center();
+                const auto radius = length(box.size()) / FloatType(2.0);
+                const auto scaling = std::abs(static_cast<FloatType>(camera.perspectiveScalingFactor(vm::vec3f(center)))) + maxScalingChange * radius;
+                const auto maxDistance = radius + FloatType(2.0) * handleRadius * scaling;
+                return vm::squaredDistance(pickRay, center).distance <= maxDistance * maxDistance;
+            };
+        }
+
         const Model::Hit::HitType VertexHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void VertexHandleManager::pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const auto& entry : m_handles) {
-                const auto& position = entry.first;
-                const auto distance = camera.pickPointHandle(pickRay, position, pref(Preferences::HandleRadius));
+            const auto handleRadius = pref(Preferences::HandleRadius);
+            forEachHandle(makeRayTest(pickRay, camera, handleRadius), [&](const vm::vec3& position) {
+                const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
                 if (!vm::isnan(distance)) {
                     const auto hitPoint = pickRay.pointAtDistance(distance);
                     const auto error = vm::squaredDistance(pickRay, position).distance;
                     pickResult.addHit(Model::Hit::hit(HandleHit, distance, hitPoint, position, error));
                 }
-            }
+            });
         }
 
-        void VertexHandleManager::addHandles(const Model::Brush* brush) {
+        void VertexHandleManager::addHandles(Model::Brush* brush) {
             for (const Model::BrushVertex* vertex : brush->vertices()) {
-                add(vertex->position());
+                add(vertex->position(), brush);
             }
         }
 
-        void VertexHandleManager::removeHandles(const Model::Brush* brush) {
+        void VertexHandleManager::removeHandles(Model::Brush* brush) {
             for (const Model::BrushVertex* vertex : brush->vertices()) {
-                assertResult(remove(vertex->position()));
+                assertResult(remove(vertex->position(), brush));
             }
         }
 
@@ -62,49 +96,45 @@ namespace TrenchBroom {
             return HandleHit;
         }
 
-        bool VertexHandleManager::isIncident(const Handle& handle, const Model::Brush* brush) const {
-            return brush->hasVertex(handle);
-        }
-
         const Model::Hit::HitType EdgeHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void EdgeHandleManager::pickGridHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const vm::segment3& position = entry.first;
-                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, pref(Preferences::HandleRadius));
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            forEachHandle(makeRayTest(pickRay, camera, handleRadius), [&](const vm::segment3& position) {
+                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, handleRadius);
                 if (!vm::isnan(edgeDist)) {
                     const vm::vec3 pointHandle = grid.snap(pickRay.pointAtDistance(edgeDist), position);
-                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                     if (!vm::isnan(pointDist)) {
                         const vm::vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                         pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void EdgeHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const vm::segment3& position = entry.first;
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            forEachHandle(makeRayTest(pickRay, camera, handleRadius), [&](const vm::segment3& position) {
                 const vm::vec3 pointHandle = position.center();
 
-                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::isnan(pointDist)) {
                     const vm::vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
-        void EdgeHandleManager::addHandles(const Model::Brush* brush) {
+        void EdgeHandleManager::addHandles(Model::Brush* brush) {
             for (const Model::BrushEdge* edge : brush->edges()) {
-                add(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()));
+                add(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()), brush);
             }
         }
 
-        void EdgeHandleManager::removeHandles(const Model::Brush* brush) {
+        void EdgeHandleManager::removeHandles(Model::Brush* brush) {
             for (const Model::BrushEdge* edge : brush->edges()) {
-                assertResult(remove(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position())));
+                assertResult(remove(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()), brush));
             }
         }
 
@@ -112,19 +142,18 @@ namespace TrenchBroom {
             return HandleHit;
         }
 
-        bool EdgeHandleManager::isIncident(const Handle& handle, const Model::Brush* brush) const {
-            return brush->hasEdge(handle);
-        }
-
         const Model::Hit::HitType FaceHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void FaceHandleManager::pickGridHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const auto& entry : m_handles) {
-                const auto& position = entry.first;
+            // the ray must hit the polygon, so it must hit its bounds
+            const auto rayTest = [&](const vm::bbox3& box) {
+                return box.contains(pickRay.origin) || !vm::isnan(vm::intersectRayAndBBox(pickRay, box));
+            };
 
+            forEachHandle(rayTest, [&](const vm::polygon3& position) {
                 const auto [valid, plane] = vm::fromPoints(std::begin(position), std::end(position));
                 if (!valid) {
-                    continue;
+                    return;
                 }
 
                 const auto distance = vm::intersectRayAndPolygon(pickRay, plane, std::begin(position), std::end(position));
@@ -137,40 +166,36 @@ namespace TrenchBroom {
                         pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void FaceHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const auto& position = entry.first;
+            const auto handleRadius = pref(Preferences::HandleRadius);
+            forEachHandle(makeRayTest(pickRay, camera, handleRadius), [&](const vm::polygon3& position) {
                 const auto pointHandle = position.center();
 
-                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::isnan(pointDist)) {
                     const auto hitPoint = pickRay.pointAtDistance(pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
-        void FaceHandleManager::addHandles(const Model::Brush* brush) {
+        void FaceHandleManager::addHandles(Model::Brush* brush) {
             for (const Model::BrushFace* face : brush->faces()) {
-                add(face->polygon());
+                add(face->polygon(), brush);
             }
         }
 
-        void FaceHandleManager::removeHandles(const Model::Brush* brush) {
+        void FaceHandleManager::removeHandles(Model::Brush* brush) {
             for (const Model::BrushFace* face : brush->faces()) {
-                assertResult(remove(face->polygon()));
+                assertResult(remove(face->polygon(), brush));
             }
         }
 
         Model::Hit::HitType FaceHandleManager::hitType() const {
             return HandleHit;
         }
-
-        bool FaceHandleManager::isIncident(const Handle& handle, const Model::Brush* brush) const {
-            return brush->hasFace(handle);
-        }
     }
 }
@@ -20,6 +20,7 @@
 #ifndef VertexHandleManager_h
 #define VertexHandleManager_h
 
+#include "AABBTree.h"
 #include "TrenchBroom.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
@@ -28,12 +29,15 @@
 #include "Renderer/Camera.h"
 #include "View/ViewTypes.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/distance.h>
+#include <vecmath/intersection.h>
 
 #include <algorithm>
 #include <functional>
 #include <iterator>
 #include <map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -61,7 +65,7 @@ namespace TrenchBroom {
              */
             template <typename I>
             void addHandles(I begin, I end) {
-                std::for_each(begin, end, [this](const Model::Brush* brush) { addHandles(brush); });
+                std::for_each(begin, end, [this](Model::Brush* brush) { addHandles(brush); });
             }
 
             /**
@@ -69,7 +73,7 @@ namespace TrenchBroom {
              *
              * @param brush the brush whose handles to add
              */
-            virtual void addHandles(const Model::Brush* brush) = 0;
+            virtual void addHandles(Model::Brush* brush) = 0;
 
             /**
              * Removes all handles of the given range of brushes from this handle manager.
@@ -80,7 +84,7 @@ namespace TrenchBroom {
              */
             template <typename I>
             void removeHandles(I begin, I end) {
-                std::for_each(begin, end, [this](const Model::Brush* brush) { removeHandles(brush); });
+                std::for_each(begin, end, [this](Model::Brush* brush) { removeHandles(brush); });
             }
 
             /**
@@ -88,7 +92,29 @@ namespace TrenchBroom {
              *
              * @param brush the brush whose handles to remove
              */
-            virtual void removeHandles(const Model::Brush* brush) = 0;
+            virtual void removeHandles(Model::Brush* brush) = 0;
+        protected:
+            /**
+             * Returns the bounds of the given handle, which are used to find handles in the spatial index.
+             */
+            static vm::bbox3 bounds(const vm::vec3& handle);
+            static vm::bbox3 bounds(const vm::segment3& handle);
+            static vm::bbox3 bounds(const vm::polygon3& handle);
+
+            /**
+             * Returns a conservative test that accepts any bounding box containing a point handle that may be hit by
+             * the given pick ray in the context of the given camera.
+             *
+             * The pick radius of a point handle grows with the perspective scaling factor of the camera at the handle's
+             * position. This factor is an affine function of the position (up to its sign), so it can be bounded for
+             * all points within a bounding box by its value at the center and its gradient.
+             *
+             * @param pickRay the picking ray
+             * @param camera the camera
+             * @param handleRadius the handle radius
+             * @return the test
+             */
+            static std::function<bool(const vm::bbox3&)> makeRayTest(const vm::ray3& pickRay, const Renderer::Camera& camera, FloatType handleRadius);
         };
 
         template <typename H>
@@ -99,15 +125,14 @@ namespace TrenchBroom {
         private:
         protected:
             /**
-             * Represents the status of a handle, i.e., how many duplicates exist at the same coordinates and whether
+             * Represents the status of a handle, i.e., which brushes have a handle at the same coordinates and whether
              * or not all of these are selected.
              */
             struct HandleInfo {
-                size_t count;
+                Model::BrushList brushes;
                 bool selected;
 
                 HandleInfo() :
-                count(0),
                 selected(false) {}
 
                 /**
@@ -143,34 +168,50 @@ namespace TrenchBroom {
                 }
 
                 /**
-                 * Increments the number of handles at the same coordinates.
+                 * Adds the given brush to the brushes that have a handle at the same coordinates.
                  */
-                void inc() {
-                    ++count;
+                void inc(Model::Brush* brush) {
+                    brushes.push_back(brush);
                 }
 
                 /**
-                 * Deccrements the number of handles at the same coordinates.
+                 * Removes the given brush from the brushes that have a handle at the same coordinates.
+                 *
+                 * @return true if and only if the given brush was removed
                  */
-                void dec() {
-                    --count;
+                bool dec(Model::Brush* brush) {
+                    const auto it = std::find(std::begin(brushes), std::end(brushes), brush);
+                    if (it == std::end(brushes))
+                        return false;
+                    brushes.erase(it);
+                    return true;
                 }
             };
 
             using HandleMap = std::map<H, HandleInfo>;
             using HandleEntry = typename HandleMap::value_type;
+            using HandleTree = AABBTree<FloatType, 3, const H*>;
 
             /**
              * Maps a handle position to its info.
              */
             HandleMap m_handles;
 
+            /**
+             * Spatial index of the handles in m_handles. The handles are referenced by pointers to the keys of
+             * m_handles, which remain valid until the entries are erased. The index is built lazily when it is first
+             * queried and kept up to date afterwards.
+             */
+            mutable HandleTree m_handleTree;
+            mutable bool m_handleTreeValid;
+
             /**
              * The total number of selected handles, not counting duplicates.
              */
             size_t m_selectedHandleCount;
         public:
             VertexHandleManagerBaseT() :
+            m_handleTreeValid(false),
             m_selectedHandleCount(0) {}
 
             virtual ~VertexHandleManagerBaseT() {}
@@ -296,28 +337,40 @@ namespace TrenchBroom {
             }
         public:
             /**
-             * Adds the given handle to this manager.
+             * Adds the given handle of the given brush to this manager.
              *
              * @param handle the handle to add
+             * @param brush the brush that the handle belongs to
              */
-            void add(const Handle& handle) {
-                MapUtils::findOrInsert(m_handles, handle, HandleInfo())->second.inc();
+            void add(const Handle& handle, Model::Brush* brush) {
+                const auto size = m_handles.size();
+                const auto it = MapUtils::findOrInsert(m_handles, handle, HandleInfo());
+                it->second.inc(brush);
+
+                if (m_handleTreeValid && m_handles.size() > size) {
+                    m_handleTree.insert(bounds(it->first), &it->first);
+                }
             }
 
             /**
-             * Removes the given handle from this manager.
+             * Removes the given handle of the given brush from this manager.
              *
              * @param handle the handle to remove
-             * @return true if the given handle was contained in this manager (and therefore removed) and false otherwise
+             * @param brush the brush that the handle belongs to
+             * @return true if the given handle of the given brush was contained in this manager (and therefore removed)
+             * and false otherwise
              */
-            bool remove(const Handle& handle) {
+            bool remove(const Handle& handle, Model::Brush* brush) {
                 const auto it = m_handles.find(handle);
                 if (it != std::end(m_handles)) {
                     HandleInfo& info = it->second;
-                    info.dec();
+                    if (!info.dec(brush))
+                        return false;
 
-                    if (info.count == 0) {
+                    if (info.brushes.empty()) {
                         deselect(info);
+                        if (m_handleTreeValid)
+                            m_handleTree.remove(&it->first);
                         m_handles.erase(it);
                     }
                     return true;
@@ -330,6 +383,8 @@ namespace TrenchBroom {
              * Removes all handles from this manager.
              */
             void clear() {
+                m_handleTree.clear();
+                m_handleTreeValid = false;
                 m_handles.clear();
                 m_selectedHandleCount = 0;
             }
@@ -411,11 +466,14 @@ namespace TrenchBroom {
         private:
             void forEachCloseHandle(const H& handle, std::function<void(HandleInfo&)> fun) {
                 static const auto epsilon = 0.001 * 0.001;
-                for (auto& entry : m_handles) {
-                    if (compare(handle, entry.first, epsilon) == 0) {
-                        fun(entry.second);
+
+                // the handles are compared component wise, so close handles have overlapping bounds
+                const auto handleBounds = bounds(handle).expand(epsilon);
+                forEachHandle([&](const vm::bbox3& box) { return box.intersects(handleBounds); }, [&](const H& candidate) {
+                    if (compare(handle, candidate, epsilon) == 0) {
+                        fun(m_handles.find(candidate)->second);
                     }
-                }
+                });
             }
 
             void select(HandleInfo& info) {
@@ -441,6 +499,38 @@ namespace TrenchBroom {
                     --m_selectedHandleCount;
                 }
             }
+        protected:
+            /**
+             * Calls the given function for every handle whose bounds pass the given test, see AABBTree::findMatching.
+             *
+             * @tparam T the type of the bounds test
+             * @tparam F the type of the function to call
+             * @param test the conservative bounds test
+             * @param f the function to call, it is passed the handle
+             */
+            template <typename T, typename F>
+            void forEachHandle(const T& test, const F& f) const {
+                validateHandleTree();
+
+                std::vector<const H*> candidates;
+                m_handleTree.findMatching(test, std::back_inserter(candidates));
+                for (const H* candidate : candidates) {
+                    f(*candidate);
+                }
+            }
+        private:
+            void validateHandleTree() const {
+                if (!m_handleTreeValid) {
+                    std::vector<const H*> handles;
+                    handles.reserve(m_handles.size());
+                    for (const auto& entry : m_handles) {
+                        handles.push_back(&entry.first);
+                    }
+
+                    m_handleTree.clearAndBuild(handles, [](const H* handle) { return bounds(*handle); });
+                    m_handleTreeValid = true;
+                }
+            }
         public:
             /**
              * Applies the given picking test to all handles in this manager and adds all hits to the given picking
@@ -460,65 +550,51 @@ namespace TrenchBroom {
             }
         public:
             /**
-             * Finds and returns all brushes in the given range which are incident to the given handle.
+             * Returns all brushes which are incident to the given handle, i.e., all brushes whose handles were added to
+             * this manager and which have a handle at the same coordinates.
              *
-             * @tparam I the type of the range iterators
              * @param handle the handle
-             * @param begin the beginning of the range of brushes
-             * @param end the end of the range of brushes
              * @return a set of all brushes that are incident to the given handle
              */
-            template <typename I>
-            Model::BrushSet findIncidentBrushes(const Handle& handle, I begin, I end) const {
+            Model::BrushSet findIncidentBrushes(const Handle& handle) const {
                 Model::BrushSet result;
-                findIncidentBrushes(handle, begin, end, std::inserter(result, result.end()));
+                findIncidentBrushes(handle, std::inserter(result, std::end(result)));
                 return result;
             }
 
             /**
-             * Finds and returns all brushes in the given range which are incident to any handle in the given range.
+             * Finds and returns all brushes which are incident to any handle in the given range.
              *
-             * @tparam I1 the type of range iterators for the range of handles
-             * @tparam I2 the type of range iterators for the range of brushes
-             * @param hBegin the beginning of the range of handles
-             * @param hEnd the end of the range of handles
-             * @param bBegin the beginning of the range of brushes
-             * @param bEnd the end of the range of brushes
+             * @tparam I the type of range iterators for the range of handles
+             * @param begin the beginning of the range of handles
+             * @param end the end of the range of handles
              * @return a set containing all incident brushes
              */
-            template <typename I1, typename I2>
-            Model::BrushSet findIncidentBrushes(I1 hBegin, I1 hEnd, I2 bBegin, I2 bEnd) const {
+            template <typename I>
+            Model::BrushSet findIncidentBrushes(I begin, I end) const {
                 Model::BrushSet result;
                 auto out = std::inserter(result, std::end(result));
-                std::for_each(hBegin, hEnd, [this, bBegin, bEnd, out](const Handle& handle) {
-                    findIncidentBrushes(handle, bBegin, bEnd, out);
+                std::for_each(begin, end, [this, &out](const Handle& handle) {
+                    findIncidentBrushes(handle, out);
                 });
                 return result;
             }
 
             /**
-             * Finds all brushes in the given range which are incident to the given handle.
+             * Finds all brushes which are incident to the given handle.
              *
-             * @tparam I the type of the range iterators
              * @tparam O an output iterator to append the resulting brushes to
              * @param handle the handle
-             * @param begin the beginning of the range of brushes
-             * @param end the end of the range of brushes
              * @param out an output iterator that accepts the incident brushes
              */
-            template <typename I, typename O>
-            void findIncidentBrushes(const Handle& handle, I begin, I end, O out) const {
-                std::copy_if(begin, end, out, [this, &handle](const Model::Brush* brush) { return this->isIncident(handle, brush); });
+            template <typename O>
+            void findIncidentBrushes(const Handle& handle, O out) const {
+                const auto it = m_handles.find(handle);
+                if (it != std::end(m_handles)) {
+                    const auto& brushes = it->second.brushes;
+                    std::copy(std::begin(brushes), std::end(brushes), out);
+                }
             }
-        private:
-            /**
-             * Checks whether the given brush is incident to the given handle.
-             *
-             * @param handle the handle to check
-             * @param brush the brush to check
-             * @return true if and only if the given brush is incident to the given handle
-             */
-            virtual bool isIncident(const Handle& handle, const Model::Brush* brush) const = 0;
         };
 
         /**
@@ -541,12 +617,10 @@ namespace TrenchBroom {
              */
             void pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::Brush* brush) override;
-            void removeHandles(const Model::Brush* brush) override;
+            void addHandles(Model::Brush* brush) override;
+            void removeHandles(Model::Brush* brush) override;
 
             Model::Hit::HitType hitType() const override;
-        private:
-            bool isIncident(const Handle& handle, const Model::Brush* brush) const override;
         };
 
         /**
@@ -586,12 +660,10 @@ namespace TrenchBroom {
              */
             void pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::Brush* brush) override;
-            void removeHandles(const Model::Brush* brush) override;
+            void addHandles(Model::Brush* brush) override;
+            void removeHandles(Model::Brush* brush) override;
 
             Model::Hit::HitType hitType() const override;
-        private:
-            bool isIncident(const Handle& handle, const Model::Brush* brush) const override;
         };
 
         /**
@@ -632,12 +704,10 @@ namespace TrenchBroom {
              */
             void pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::Brush* brush) override;
-            void removeHandles(const Model::Brush* brush) override;
+            void addHandles(Model::Brush* brush) override;
+            void removeHandles(Model::Brush* brush) override;
 
             Model::Hit::HitType hitType() const override;
-        private:
-            bool isIncident(const Handle& handle, const Model::Brush* brush) const override;
         };
     }
 }
@@ -114,21 +114,13 @@ namespace TrenchBroom {
 
             template <typename M, typename H2>
             Model::BrushSet findIncidentBrushes(const M& manager, const H2& handle) const {
-                const Model::BrushList& brushes = selectedBrushes();
-                return manager.findIncidentBrushes(handle, std::begin(brushes), std::end(brushes));
+                // the handle managers only contain the handles of the selected brushes
+                return manager.findIncidentBrushes(handle);
             }
 
             template <typename M, typename I>
             Model::BrushSet findIncidentBrushes(const M& manager, I cur, I end) const {
-                const Model::BrushList& brushes = selectedBrushes();
-                Model::BrushSet result;
-                auto out = std::inserter(result, std::end(result));
-
-                std::for_each(cur, end, [&manager, &brushes, &out](const auto& handle) {
-                    manager.findIncidentBrushes(handle, std::begin(brushes), std::end(brushes), out);
-                });
-
-                return result;
+                return manager.findIncidentBrushes(cur, end);
             }
 
             virtual void pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const = 0;
@@ -23,6 +23,8 @@
 #include <vecmath/ray.h>
 #include "AABBTree.h"
 
+#include <vector>
+
 using AABB = AABBTree<double, 3, size_t>;
 using BOX = AABB::Box;
 using RAY = vm::ray<AABB::FloatType, AABB::Components>;
@@ -439,6 +441,25 @@ BOX makeBounds(const K min, const K max) {
     return BOX(VEC(static_cast<double>(min), -1.0, -1.0), VEC(static_cast<double>(max), 1.0, 1.0));
 }
 
+TEST(AABBTreeTest, clearAndRebuildNonEmptyTree) {
+    const BOX bounds1(VEC(0.0, 0.0, 0.0), VEC(2.0, 1.0, 1.0));
+    const BOX bounds2(VEC(4.0, 0.0, 0.0), VEC(6.0, 1.0, 1.0));
+
+    AABB tree;
+    tree.insert(bounds1, 1u);
+    tree.insert(bounds2, 2u);
+
+    const std::vector<size_t> data { 1u, 2u };
+    tree.clearAndBuild(data, [&](const size_t d) { return d == 1u ? bounds2 : bounds1; });
+
+    assertTreeContains(tree, bounds2, 1u);
+    assertTreeContains(tree, bounds1, 2u);
+
+    tree.clear();
+    ASSERT_TRUE(tree.empty());
+    ASSERT_FALSE(tree.contains(1u));
+}
+
 TEST(AABBTreeTest, findIntersectorsOfEmptyTree) {
     AABB tree;
     assertIntersectors(tree, RAY(VEC::zero, VEC::pos_x), {});
@@ -483,6 +504,45 @@ TEST(AABBTreeTest, findIntersectorsFromInsideRootBBox) {
     assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x), { 2u });
 }
 
+TEST(AABBTreeTest, visitIntersectorsInOrder) {
+    AABB tree;
+    tree.insert(BOX(VEC(+5.0, -1.0, -1.0), VEC(+6.0, +1.0, +1.0)), 3u);
+    tree.insert(BOX(VEC(-2.0, -1.0, -1.0), VEC(-1.0, +1.0, +1.0)), 1u);
+    tree.insert(BOX(VEC(+1.0, -1.0, -1.0), VEC(+2.0, +1.0, +1.0)), 2u);
+    tree.insert(BOX(VEC(-4.0, +2.0, -1.0), VEC(+4.0, +3.0, +1.0)), 4u);
+    tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 5u);
+
+    std::vector<AABB::DataType> items;
+    std::vector<AABB::FloatType> distances;
+    tree.visitIntersectorsInOrder(RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x), [&](const AABB::DataType item, const AABB::FloatType distance) {
+        items.push_back(item);
+        distances.push_back(distance);
+        return true;
+    });
+
+    ASSERT_EQ(std::vector<AABB::DataType>({ 5u, 1u, 2u, 3u }), items);
+    ASSERT_EQ(std::vector<AABB::FloatType>({ 0.0, 1.0, 4.0, 8.0 }), distances);
+
+    items.clear();
+    tree.visitIntersectorsInOrder(RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x), [&](const AABB::DataType item, const AABB::FloatType distance) {
+        if (distance > 2.0) {
+            return false;
+        }
+        items.push_back(item);
+        return true;
+    });
+
+    ASSERT_EQ(std::vector<AABB::DataType>({ 5u, 1u }), items);
+}
+
+TEST(AABBTreeTest, visitIntersectorsInOrderOfEmptyTree) {
+    AABB tree;
+    tree.visitIntersectorsInOrder(RAY(VEC::zero, VEC::pos_x), [](const AABB::DataType, const AABB::FloatType) {
+        ADD_FAILURE();
+        return true;
+    });
+}
+
 void assertTree(const std::string& exp, const AABB& actual) {
     std::stringstream str;
     actual.print(str);
@@ -0,0 +1,76 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Allocator.h"
+
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    class PooledObject : public Allocator<PooledObject, 8, 16> {
+    public:
+        size_t value;
+
+        explicit PooledObject(const size_t i_value) :
+        value(i_value) {}
+    };
+
+    TEST(AllocatorTest, deleteOnOtherThreads) {
+        const size_t threadCount = 4;
+        const size_t objectCount = 1000;
+
+        // every thread allocates its own objects, which are then deleted by the next thread
+        std::vector<std::vector<PooledObject*>> objects(threadCount);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&objects, i]() {
+                for (size_t j = 0; j < objectCount; ++j)
+                    objects[i].push_back(new PooledObject(i * objectCount + j));
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            for (size_t j = 0; j < objectCount; ++j)
+                ASSERT_EQ(i * objectCount + j, objects[i][j]->value);
+        }
+
+        threads.clear();
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&objects, i]() {
+                for (PooledObject* object : objects[(i + 1) % threadCount])
+                    delete object;
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        // the blocks can be reused afterwards
+        std::vector<PooledObject*> reused;
+        for (size_t i = 0; i < objectCount; ++i)
+            reused.push_back(new PooledObject(i));
+        for (size_t i = 0; i < objectCount; ++i) {
+            ASSERT_EQ(i, reused[i]->value);
+            delete reused[i];
+        }
+    }
+}
@@ -0,0 +1,204 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "StringUtils.h"
+#include "Assets/AttributeDefinition.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/EntityDefinitionTestUtils.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const String Definitions(R"(
+@baseclass = Targetname [ targetname(target_source) : "Name" ]
+@baseclass = Appearflags [
+    spawnflags(Flags) =
+    [
+        256 : "Not on Easy" : 0
+        512 : "Not on Normal" : 1
+    ]
+]
+
+@SolidClass color(255 0 0) = func_door : "A door that opens"
+[
+    speed(integer) : "Speed" : 100
+    wait(float) : "Wait" : "3.5"
+    message(string) readonly : "Message"
+    locked(boolean) : "Locked"
+    sounds(choices) : "Sounds" : 1 =
+    [
+        1 : "Stone"
+        2 : "Machine"
+    ]
+    target(target_destination) : "Target"
+    strange(unknown) : "Strange" : "value"
+]
+
+@PointClass base(Targetname, Appearflags) size(-16 -16 -24, 16 16 32) model({ 'path': 'progs/armor.mdl', 'skin': skin, 'frame': 1 }) = item_armor : "Armor" []
+@PointClass base(Targetname, Appearflags) size(-8 -8 -8, 8 8 8) model(":progs/light.mdl") = light : "Light" []
+@PointClass base(Targetname) = info_null : "Nothing" []
+)");
+
+        static const Color DefaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+
+        static String readCache(const Path& path) {
+            std::ifstream stream(path.asString().c_str(), std::ios::in | std::ios::binary);
+            return String(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+
+        static uint64_t hashDefinitions(const Path& path) {
+            if (path != Path("/defs/host.fgd"))
+                throw FileNotFoundException(path.asString());
+            return EntityDefinitionCache::hash(Definitions.data(), Definitions.data() + Definitions.size());
+        }
+
+        static String writeCache(const Assets::EntityDefinitionList& definitions) {
+            const EntityDefinitionCache::SourceFileList sourceFiles = {
+                { Path("/defs/host.fgd"), hashDefinitions(Path("/defs/host.fgd")) }
+            };
+
+            const Path path("entity_definition_cache_test.tbcache");
+            EntityDefinitionCache::write(definitions, sourceFiles, DefaultColor, path);
+            const String cache = readCache(path);
+            std::remove(path.asString().c_str());
+            return cache;
+        }
+
+        static void assertAttributeDefinitionsEqual(const Assets::AttributeDefinition* expected, const Assets::AttributeDefinition* actual) {
+            ASSERT_EQ(typeid(*expected), typeid(*actual));
+            ASSERT_TRUE(expected->equals(actual));
+            ASSERT_EQ(expected->shortDescription(), actual->shortDescription());
+            ASSERT_EQ(expected->longDescription(), actual->longDescription());
+            ASSERT_EQ(expected->readOnly(), actual->readOnly());
+            ASSERT_EQ(Assets::AttributeDefinition::defaultValue(*expected), Assets::AttributeDefinition::defaultValue(*actual));
+        }
+
+        static void assertEntityDefinitionsEqual(const Assets::EntityDefinition* expected, const Assets::EntityDefinition* actual) {
+            ASSERT_EQ(expected->type(), actual->type());
+            ASSERT_EQ(expected->name(), actual->name());
+            ASSERT_EQ(expected->color(), actual->color());
+            ASSERT_EQ(expected->description(), actual->description());
+
+            const auto& expectedAttributes = expected->attributeDefinitions();
+            const auto& actualAttributes = actual->attributeDefinitions();
+            ASSERT_EQ(expectedAttributes.size(), actualAttributes.size());
+            for (size_t i = 0; i < expectedAttributes.size(); ++i)
+                assertAttributeDefinitionsEqual(expectedAttributes[i].get(), actualAttributes[i].get());
+
+            if (expected->type() == Assets::EntityDefinition::Type_PointEntity) {
+                const auto* expectedPoint = static_cast<const Assets::PointEntityDefinition*>(expected);
+                const auto* actualPoint = static_cast<const Assets::PointEntityDefinition*>(actual);
+                ASSERT_EQ(expectedPoint->bounds(), actualPoint->bounds());
+                ASSERT_EQ(expectedPoint->modelDefinition().expression().asString(), actualPoint->modelDefinition().expression().asString());
+            }
+        }
+
+        TEST(EntityDefinitionCacheTest, readDefinitions) {
+            TestParserStatus status;
+            FgdParser parser(Definitions, DefaultColor);
+            auto expected = parser.parseDefinitions(status);
+            ASSERT_EQ(4u, expected.size());
+
+            const String cache = writeCache(expected);
+
+            Assets::EntityDefinitionList actual;
+            ASSERT_TRUE(EntityDefinitionCache::read(cache.data(), cache.data() + cache.size(), DefaultColor, hashDefinitions, actual));
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+                assertEntityDefinitionsEqual(expected[i], actual[i]);
+
+            // attribute definitions shared between entity definitions remain shared
+            ASSERT_EQ(expected[1]->attributeDefinition("targetname") == expected[2]->attributeDefinition("targetname"),
+                      actual[1]->attributeDefinition("targetname") == actual[2]->attributeDefinition("targetname"));
+
+            const Assets::EntityDefinition* armor = actual[1];
+            ASSERT_EQ("item_armor", armor->name());
+            Assets::assertModelDefinition(Assets::ModelSpecification(Path("progs/armor.mdl"), 0, 1), armor);
+            Assets::assertModelDefinition(Assets::ModelSpecification(Path("progs/armor.mdl"), 2, 1), armor, "{ 'skin': 2 }");
+
+            const Assets::EntityDefinition* light = actual[2];
+            ASSERT_EQ("light", light->name());
+            Assets::assertModelDefinition(Assets::ModelSpecification(Path("progs/light.mdl")), light);
+
+            VectorUtils::clearAndDelete(expected);
+            VectorUtils::clearAndDelete(actual);
+        }
+
+        TEST(EntityDefinitionCacheTest, rejectMismatchingCache) {
+            TestParserStatus status;
+            FgdParser parser(Definitions, DefaultColor);
+            auto definitions = parser.parseDefinitions(status);
+            const String cache = writeCache(definitions);
+            VectorUtils::clearAndDelete(definitions);
+
+            const char* begin = cache.data();
+            const char* end = begin + cache.size();
+
+            Assets::EntityDefinitionList result;
+            ASSERT_FALSE(EntityDefinitionCache::read(begin, end, Color(1.0f, 0.0f, 0.0f, 1.0f), hashDefinitions, result));
+            ASSERT_FALSE(EntityDefinitionCache::read(begin, end, DefaultColor, [](const Path& path) { return hashDefinitions(path) + 1u; }, result));
+            ASSERT_FALSE(EntityDefinitionCache::read(begin, end, DefaultColor, [](const Path& path) -> uint64_t { throw FileNotFoundException(path.asString()); }, result));
+            ASSERT_FALSE(EntityDefinitionCache::read(begin, end - 1, DefaultColor, hashDefinitions, result));
+
+            const String trailing = cache + "x";
+            ASSERT_FALSE(EntityDefinitionCache::read(trailing.data(), trailing.data() + trailing.size(), DefaultColor, hashDefinitions, result));
+
+            // corrupt counts must be rejected instead of being used to allocate memory
+            const auto assertRejectsCorruptCount = [&](const size_t offset) {
+                String corrupt = cache;
+                const uint32_t count = 0xFFFFFFFF;
+                std::memcpy(&corrupt[offset], &count, sizeof(count));
+                ASSERT_FALSE(EntityDefinitionCache::read(corrupt.data(), corrupt.data() + corrupt.size(), DefaultColor, hashDefinitions, result));
+            };
+
+            // the length of the source file path follows the header and the source file count
+            const size_t pathOffset = 4 + sizeof(uint32_t) + 4 * sizeof(float) + sizeof(uint32_t);
+            assertRejectsCorruptCount(pathOffset);
+
+            // the attribute count follows the source file path and its hash
+            const size_t attributeCountOffset = pathOffset + sizeof(uint32_t) + String("/defs/host.fgd").size() + sizeof(uint64_t);
+            assertRejectsCorruptCount(attributeCountOffset);
+
+            // the length of the name of the first attribute follows its kind and type
+            assertRejectsCorruptCount(attributeCountOffset + sizeof(uint32_t) + 2);
+            ASSERT_TRUE(result.empty());
+        }
+
+        TEST(EntityDefinitionCacheTest, cachePath) {
+            const Path cacheDirectory("/cache");
+            const Path path1 = EntityDefinitionCache::cachePath(cacheDirectory, Path("/games/Quake/Quake.fgd"));
+            const Path path2 = EntityDefinitionCache::cachePath(cacheDirectory, Path("/mods/Quake/Quake.fgd"));
+
+            ASSERT_EQ(cacheDirectory, path1.deleteLastComponent());
+            ASSERT_TRUE(StringUtils::isPrefix(path1.lastComponent().asString(), "Quake.fgd-"));
+            ASSERT_NE(path1, path2);
+        }
+    }
+}
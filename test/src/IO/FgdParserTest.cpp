@@ -797,6 +797,12 @@ decor_goddess_statue : "Goddess Statue" [])";
             ASSERT_TRUE(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "info_player_start"; }));
             ASSERT_TRUE(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "info_player_coop"; }));
 
+            const auto& includedFiles = parser.includedFiles();
+            ASSERT_EQ(2u, includedFiles.size());
+            ASSERT_EQ(Path("include.fgd"), includedFiles[0].lastComponent());
+            ASSERT_EQ(Path("nested.fgd"), includedFiles[1].lastComponent());
+            ASSERT_TRUE(parser.allIncludesFound());
+
             VectorUtils::clearAndDelete(defs);
         }
 
@@ -812,6 +818,7 @@ decor_goddess_statue : "Goddess Statue" [])";
             auto defs = parser.parseDefinitions(status);
             ASSERT_EQ(1u, defs.size());
             ASSERT_TRUE(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "worldspawn"; }));
+            ASSERT_EQ(Path::List{ file->path() }, parser.includedFiles());
 
             VectorUtils::clearAndDelete(defs);
         }
@@ -0,0 +1,174 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Exceptions.h"
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/FileSystemIndex.h"
+#include "IO/ImageFileSystem.h"
+#include "IO/Path.h"
+
+#include <map>
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        using FileSizes = std::map<String, size_t>;
+
+        static std::shared_ptr<File> createFile(const String& path, const size_t size) {
+            return std::make_shared<OwningBufferFile>(Path(path), std::make_unique<char[]>(size), size);
+        }
+
+        class TestImageFileSystem : public ImageFileSystemBase {
+        private:
+            FileSizes m_files;
+        public:
+            TestImageFileSystem(std::shared_ptr<FileSystem> next, const FileSizes& files) :
+            ImageFileSystemBase(std::move(next), Path("/test")),
+            m_files(files) {
+                initialize();
+            }
+
+            void setFiles(const FileSizes& files) {
+                m_files = files;
+            }
+        private:
+            void doReadDirectory() override {
+                for (const auto& entry : m_files) {
+                    m_root.addFile(Path(entry.first), createFile(entry.first, entry.second));
+                }
+            }
+        };
+
+        class TestDiskFileSystem : public FileSystem {
+        private:
+            FileSizes m_files;
+        public:
+            TestDiskFileSystem(std::shared_ptr<FileSystem> next, const FileSizes& files) :
+            FileSystem(std::move(next)),
+            m_files(files) {}
+
+            void addFile(const String& path, const size_t size) {
+                m_files[path] = size;
+            }
+        private:
+            bool doDirectoryExists(const Path& path) const override {
+                return false;
+            }
+
+            bool doFileExists(const Path& path) const override {
+                return m_files.count(path.asString('/')) > 0;
+            }
+
+            Path::List doGetDirectoryContents(const Path& path) const override {
+                return Path::List();
+            }
+
+            std::shared_ptr<File> doOpenFile(const Path& path) const override {
+                const auto it = m_files.find(path.asString('/'));
+                if (it == std::end(m_files)) {
+                    throw FileSystemException("File not found: '" + path.asString() + "'");
+                }
+                return createFile(it->first, it->second);
+            }
+        };
+
+        TEST(FileSystemIndexTest, preservesPrecedence) {
+            auto base = std::make_shared<TestImageFileSystem>(nullptr, FileSizes {
+                { "textures/a.wal", 1 },
+                { "textures/b.wal", 2 },
+                { "textures/c.wal", 3 }
+            });
+            auto disk = std::make_shared<TestDiskFileSystem>(base, FileSizes {
+                { "textures/b.wal", 4 }
+            });
+            TestImageFileSystem mod(disk, FileSizes {
+                { "TEXTURES/A.WAL", 5 }
+            });
+            mod.buildIndex();
+
+            ASSERT_EQ(5u, mod.openFile(Path("textures/a.wal"))->size());
+            ASSERT_EQ(4u, mod.openFile(Path("textures/b.wal"))->size());
+            ASSERT_EQ(3u, mod.openFile(Path("Textures/C.wal"))->size());
+            ASSERT_TRUE(mod.fileExists(Path("textures/../textures/c.wal")));
+            ASSERT_FALSE(mod.fileExists(Path("textures/d.wal")));
+            ASSERT_THROW(mod.openFile(Path("textures/d.wal")), FileSystemException);
+
+            // the contents of unindexed file systems are queried directly
+            disk->addFile("textures/c.wal", 6);
+            disk->addFile("textures/d.wal", 7);
+            ASSERT_EQ(6u, mod.openFile(Path("textures/c.wal"))->size());
+            ASSERT_EQ(7u, mod.openFile(Path("textures/d.wal"))->size());
+        }
+
+        TEST(FileSystemIndexTest, updateReloadedFileSystem) {
+            auto base = std::make_shared<TestImageFileSystem>(nullptr, FileSizes {
+                { "textures/a.wal", 1 },
+                { "textures/b.wal", 2 }
+            });
+            auto mod = std::make_shared<TestImageFileSystem>(base, FileSizes {
+                { "textures/a.wal", 3 }
+            });
+            TestDiskFileSystem head(mod, FileSizes());
+            head.buildIndex();
+            ASSERT_EQ(3u, head.openFile(Path("textures/a.wal"))->size());
+
+            mod->setFiles(FileSizes {
+                { "textures/b.wal", 4 },
+                { "textures/c.wal", 5 }
+            });
+            mod->reload();
+            head.updateIndex(*mod);
+
+            ASSERT_EQ(1u, head.openFile(Path("textures/a.wal"))->size());
+            ASSERT_EQ(4u, head.openFile(Path("textures/b.wal"))->size());
+            ASSERT_EQ(5u, head.openFile(Path("textures/c.wal"))->size());
+        }
+
+        TEST(FileSystemIndexTest, openFiles) {
+            auto base = std::make_shared<TestImageFileSystem>(nullptr, FileSizes {
+                { "textures/a.wal", 1 },
+                { "textures/b.wal", 2 },
+                { "textures/c.wal", 3 }
+            });
+            auto disk = std::make_shared<TestDiskFileSystem>(base, FileSizes {
+                { "textures/b.wal", 4 }
+            });
+            TestImageFileSystem mod(disk, FileSizes {
+                { "textures/c.wal", 5 }
+            });
+
+            const auto paths = Path::List({ Path("textures/c.wal"), Path("textures/a.wal"), Path("textures/b.wal") });
+            for (const auto indexed : { false, true }) {
+                if (indexed) {
+                    mod.buildIndex();
+                }
+
+                const auto files = mod.openFiles(paths);
+                ASSERT_EQ(3u, files.size());
+                ASSERT_EQ(5u, files[0]->size());
+                ASSERT_EQ(1u, files[1]->size());
+                ASSERT_EQ(4u, files[2]->size());
+                ASSERT_THROW(mod.openFiles(Path::List({ Path("textures/a.wal"), Path("textures/d.wal") })), FileSystemException);
+            }
+        }
+    }
+}
@@ -0,0 +1,279 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "StringUtils.h"
+#include "IO/MapCache.h"
+#include "IO/NodeWriter.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const String MapWithLayersAndGroups(R"(
+{
+"classname" "worldspawn"
+"message" "cached"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+{
+( -712 1280 -448 ) ( -904 1280 -448 ) ( -904 992 -448 ) rtz/c_mf_v3c 56 -32 0 1 1 1 2 3
+( -904 992 -416 ) ( -904 1280 -416 ) ( -712 1280 -416 ) rtz/b_rc_v16w 32 32 0 1 1
+( -832 968 -416 ) ( -832 1256 -416 ) ( -832 1256 -448 ) rtz/c_mf_v3c 16 96 0 1 1
+( -920 1088 -448 ) ( -920 1088 -416 ) ( -680 1088 -416 ) rtz/c_mf_v3c 56 96 0 1 1
+( -968 1152 -448 ) ( -920 1152 -448 ) ( -944 1152 -416 ) rtz/c_mf_v3c 56 96 0 1 1
+( -896 1056 -416 ) ( -896 1056 -448 ) ( -896 1344 -448 ) rtz/c_mf_v3c 16 96 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "func_door"
+"_tb_layer" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "2"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Subgroup"
+"_tb_id" "3"
+"_tb_group" "2"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+})");
+
+        static const String ValveMap(R"(
+{
+"classname" "worldspawn"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 0.7071 0.7071 0 32 ] [ 0 -1 0 0 ] 15 1 1
+}
+})");
+
+        static String readCache(const Path& path) {
+            std::ifstream stream(path.asString().c_str(), std::ios::in | std::ios::binary);
+            return String(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+
+        static std::unique_ptr<Model::World> roundTrip(const String& data, const Model::MapFormat format, const vm::bbox3& worldBounds, String& cache) {
+            TestParserStatus status;
+            WorldReader reader(data);
+            auto world = reader.read(format, worldBounds, status);
+
+            const uint64_t mapHash = MapCache::hash(data.data(), data.data() + data.size());
+            const Path path("map_cache_test.tbcache");
+            MapCache::write(*world, worldBounds, mapHash, path);
+            cache = readCache(path);
+            std::remove(path.asString().c_str());
+
+            return MapCache::read(cache.data(), cache.data() + cache.size(), mapHash, format, worldBounds);
+        }
+
+        /**
+         * Writes the given world as text without the layer and group ids, which are assigned anew every time.
+         */
+        static String writeWithoutIds(Model::World& world) {
+            StringStream str;
+            NodeWriter writer(world, str);
+            writer.writeMap();
+
+            StringStream result;
+            for (const String& line : StringUtils::split(str.str(), '\n')) {
+                if (line.find("\"_tb_id\"") == String::npos &&
+                    line.find("\"_tb_layer\"") == String::npos &&
+                    line.find("\"_tb_group\"") == String::npos) {
+                    result << line << "\n";
+                }
+            }
+            return result.str();
+        }
+
+        static void assertNodesEqual(const Model::Node* expected, const Model::Node* actual) {
+            ASSERT_EQ(expected->name(), actual->name());
+            ASSERT_EQ(expected->lineNumber(), actual->lineNumber());
+            ASSERT_EQ(expected->lineCount(), actual->lineCount());
+            ASSERT_EQ(expected->bounds(), actual->bounds());
+            ASSERT_EQ(expected->childCount(), actual->childCount());
+            for (size_t i = 0; i < expected->childCount(); ++i)
+                assertNodesEqual(expected->children()[i], actual->children()[i]);
+        }
+
+        TEST(MapCacheTest, readWorldWithLayersAndGroups) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader reader(MapWithLayersAndGroups);
+            auto expected = reader.read(Model::MapFormat::Quake2, worldBounds, status);
+
+            String cache;
+            auto actual = roundTrip(MapWithLayersAndGroups, Model::MapFormat::Quake2, worldBounds, cache);
+            ASSERT_NE(nullptr, actual);
+
+            assertNodesEqual(expected.get(), actual.get());
+            ASSERT_EQ(writeWithoutIds(*expected), writeWithoutIds(*actual));
+        }
+
+        TEST(MapCacheTest, readValveBrush) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader reader(ValveMap);
+            auto expected = reader.read(Model::MapFormat::Valve, worldBounds, status);
+
+            String cache;
+            auto actual = roundTrip(ValveMap, Model::MapFormat::Valve, worldBounds, cache);
+            ASSERT_NE(nullptr, actual);
+
+            assertNodesEqual(expected.get(), actual.get());
+            ASSERT_EQ(writeWithoutIds(*expected), writeWithoutIds(*actual));
+
+            const auto* expectedBrush = static_cast<const Model::Brush*>(expected->defaultLayer()->children().front());
+            const auto* actualBrush = static_cast<const Model::Brush*>(actual->defaultLayer()->children().front());
+            ASSERT_EQ(expectedBrush->faceCount(), actualBrush->faceCount());
+            for (size_t i = 0; i < expectedBrush->faceCount(); ++i) {
+                const Model::BrushFace* expectedFace = expectedBrush->faces()[i];
+                const Model::BrushFace* actualFace = actualBrush->faces()[i];
+                ASSERT_EQ(expectedFace->boundary(), actualFace->boundary());
+                ASSERT_EQ(expectedFace->textureXAxis(), actualFace->textureXAxis());
+                ASSERT_EQ(expectedFace->textureYAxis(), actualFace->textureYAxis());
+                ASSERT_EQ(expectedFace->vertexPositions(), actualFace->vertexPositions());
+            }
+        }
+
+        TEST(MapCacheTest, rejectMismatchingCache) {
+            const vm::bbox3 worldBounds(8192.0);
+            const uint64_t mapHash = MapCache::hash(ValveMap.data(), ValveMap.data() + ValveMap.size());
+
+            String cache;
+            ASSERT_NE(nullptr, roundTrip(ValveMap, Model::MapFormat::Valve, worldBounds, cache));
+
+            const char* begin = cache.data();
+            const char* end = begin + cache.size();
+            ASSERT_EQ(nullptr, MapCache::read(begin, end, mapHash + 1u, Model::MapFormat::Valve, worldBounds));
+            ASSERT_EQ(nullptr, MapCache::read(begin, end, mapHash, Model::MapFormat::Standard, worldBounds));
+            ASSERT_EQ(nullptr, MapCache::read(begin, end, mapHash, Model::MapFormat::Valve, vm::bbox3(4096.0)));
+            ASSERT_EQ(nullptr, MapCache::read(begin, end - 1, mapHash, Model::MapFormat::Valve, worldBounds));
+
+            String trailing = cache + "x";
+            ASSERT_EQ(nullptr, MapCache::read(trailing.data(), trailing.data() + trailing.size(), mapHash, Model::MapFormat::Valve, worldBounds));
+
+            // corrupt counts must be rejected instead of being used to allocate memory
+            const auto readCount = [](const String& data, const size_t offset) {
+                uint32_t count;
+                std::memcpy(&count, data.data() + offset, sizeof(count));
+                return static_cast<size_t>(count);
+            };
+            const auto assertRejectsCorruptCount = [&](const size_t offset) {
+                String corrupt = cache;
+                const uint32_t count = 0xFFFFFFFF;
+                std::memcpy(&corrupt[offset], &count, sizeof(count));
+                ASSERT_EQ(nullptr, MapCache::read(corrupt.data(), corrupt.data() + corrupt.size(), mapHash, Model::MapFormat::Valve, worldBounds));
+            };
+
+            // the string table follows the header
+            size_t offset = 4 + 2 * sizeof(uint32_t) + sizeof(uint64_t) + 6 * sizeof(double);
+            assertRejectsCorruptCount(offset);
+
+            // the length of the first string
+            assertRejectsCorruptCount(offset + sizeof(uint32_t));
+
+            // skip the string table, the world node and its attributes, the layer count and the default layer to reach
+            // the vertex count of the first brush
+            const size_t stringCount = readCount(cache, offset);
+            offset += sizeof(uint32_t);
+            for (size_t i = 0; i < stringCount; ++i)
+                offset += sizeof(uint32_t) + readCount(cache, offset);
+            offset += 1 + 2 * sizeof(uint32_t);
+            offset += sizeof(uint32_t) + 2 * sizeof(uint32_t) * readCount(cache, offset);
+            offset += sizeof(uint32_t);
+            offset += 1 + 2 * sizeof(uint32_t) + 2 * sizeof(uint32_t);
+            offset += 1 + 2 * sizeof(uint32_t);
+            assertRejectsCorruptCount(offset);
+
+            // the face count follows the vertices
+            offset += sizeof(uint32_t) + 3 * sizeof(double) * readCount(cache, offset);
+            assertRejectsCorruptCount(offset);
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "StringUtils.h"
+#include "IO/NodeWriter.h"
+#include "IO/ObjSerializer.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+
+namespace TrenchBroom {
+    namespace IO {
+        static String writeObj(Model::World& world) {
+            FILE* stream = std::tmpfile();
+            NodeWriter(world, new ObjFileSerializer(stream)).writeMap();
+
+            String result(static_cast<size_t>(std::ftell(stream)), '\0');
+            std::rewind(stream);
+            std::fread(&result[0], 1, result.size(), stream);
+            std::fclose(stream);
+            return result;
+        }
+
+        struct ObjStats {
+            size_t vertices = 0;
+            size_t texCoords = 0;
+            size_t normals = 0;
+            size_t faces = 0;
+            StringList objects;
+        };
+
+        /**
+         * Counts the elements of the given OBJ file and checks that every face only refers to elements that were
+         * declared before it.
+         */
+        static ObjStats parseObj(const String& obj) {
+            ObjStats stats;
+            for (const String& line : StringUtils::splitAndTrim(obj, "\n")) {
+                const StringList tokens = StringUtils::splitAndTrim(line, " ");
+                if (tokens.front() == "v") {
+                    ++stats.vertices;
+                } else if (tokens.front() == "vt") {
+                    ++stats.texCoords;
+                } else if (tokens.front() == "vn") {
+                    ++stats.normals;
+                } else if (tokens.front() == "o") {
+                    stats.objects.push_back(tokens[1]);
+                } else if (tokens.front() == "f") {
+                    ++stats.faces;
+                    EXPECT_EQ(5u, tokens.size());
+                    for (size_t i = 1; i < tokens.size(); ++i) {
+                        const StringList indices = StringUtils::split(tokens[i], '/');
+                        EXPECT_EQ(3u, indices.size());
+                        EXPECT_LE(std::stoul(indices[0]), stats.vertices);
+                        EXPECT_LE(std::stoul(indices[1]), stats.texCoords);
+                        EXPECT_LE(std::stoul(indices[2]), stats.normals);
+                    }
+                }
+            }
+            return stats;
+        }
+
+        TEST(ObjSerializerTest, writeAdjacentBrushes) {
+            const vm::bbox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, worldBounds);
+
+            Model::BrushBuilder builder(&world, worldBounds);
+            world.defaultLayer()->addChild(builder.createCuboid(vm::bbox3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(16.0, 16.0, 16.0)), "texture"));
+            world.defaultLayer()->addChild(builder.createCuboid(vm::bbox3(vm::vec3(16.0, 0.0, 0.0), vm::vec3(32.0, 16.0, 16.0)), "texture"));
+
+            const ObjStats stats = parseObj(writeObj(world));
+
+            // the shared vertices and all normals are only written once
+            ASSERT_EQ(12u, stats.vertices);
+            ASSERT_EQ(6u, stats.normals);
+            ASSERT_EQ(12u, stats.faces);
+            ASSERT_EQ(StringList({ "entity0_brush0", "entity0_brush1" }), stats.objects);
+        }
+
+        TEST(ObjSerializerTest, writeMultipleChunks) {
+            const vm::bbox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, worldBounds);
+
+            const size_t brushCount = 2 * ObjFileSerializer::ChunkSize + 3;
+            Model::BrushBuilder builder(&world, worldBounds);
+            for (size_t i = 0; i < brushCount; ++i) {
+                const auto x = static_cast<FloatType>(i % 64) * 32.0;
+                const auto y = static_cast<FloatType>(i / 64) * 32.0;
+                world.defaultLayer()->addChild(builder.createCuboid(vm::bbox3(vm::vec3(x, y, 0.0), vm::vec3(x + 16.0, y + 16.0, 16.0)), "texture"));
+            }
+
+            const ObjStats stats = parseObj(writeObj(world));
+
+            ASSERT_EQ(8u * brushCount, stats.vertices);
+            ASSERT_EQ(6u, stats.normals);
+            ASSERT_EQ(6u * brushCount, stats.faces);
+            ASSERT_EQ(brushCount, stats.objects.size());
+            for (size_t i = 0; i < brushCount; ++i)
+                ASSERT_EQ("entity0_brush" + std::to_string(i), stats.objects[i]);
+        }
+    }
+}
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "Logger.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/Brush.h"
@@ -929,6 +930,55 @@ common/caulk
             ASSERT_STREQ("vm::line1\\nvm::line2", world->attribute("message").c_str());
         }
 
+        static String makeBrushes(const size_t count, const size_t invalidIndex) {
+            StringStream str;
+            for (size_t i = 0; i < count; ++i) {
+                const auto x0 = static_cast<int>(i) * 64, x1 = x0 + 32;
+                str << "{\n";
+                str << "( " << x0 << " 0 0 ) ( " << x0 << " 0 32 ) ( " << x1 << " 0 0 ) none 0 0 0 1 1\n";
+                str << "( " << x0 << " 0 0 ) ( " << x0 << " 32 0 ) ( " << x0 << " 0 32 ) none 0 0 0 1 1\n";
+                str << "( " << x0 << " 0 0 ) ( " << x1 << " 0 0 ) ( " << x0 << " 32 0 ) none 0 0 0 1 1\n";
+                str << "( " << x1 << " 32 32 ) ( " << x0 << " 32 32 ) ( " << x1 << " 32 0 ) none 0 0 0 1 1\n";
+                str << "( " << x1 << " 32 32 ) ( " << x1 << " 32 0 ) ( " << x1 << " 0 32 ) none 0 0 0 1 1\n";
+                str << "( " << x1 << " 32 32 ) ( " << x1 << " 0 32 ) ( " << x0 << " 32 32 ) none 0 0 0 1 1\n";
+                if (i == invalidIndex) {
+                    // the inverse of the first face, which leaves nothing of the brush
+                    str << "( " << x0 << " 0 0 ) ( " << x1 << " 0 0 ) ( " << x0 << " 0 32 ) none 0 0 0 1 1\n";
+                }
+                str << "}\n";
+            }
+            return str.str();
+        }
+
+        static void assertIncreasingLineNumbers(const Model::NodeList& nodes) {
+            for (size_t i = 1; i < nodes.size(); ++i)
+                ASSERT_LT(nodes[i - 1]->lineNumber(), nodes[i]->lineNumber());
+        }
+
+        TEST(WorldReaderTest, parseManyBrushesInFileOrder) {
+            const size_t brushCount = 1000;
+            const String data =
+                "{\n\"classname\" \"worldspawn\"\n" + makeBrushes(brushCount, 500) + "}\n" +
+                "{\n\"classname\" \"func_door\"\n" + makeBrushes(brushCount, brushCount) + "}\n";
+
+            const vm::bbox3 worldBounds(65536.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data);
+
+            auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            ASSERT_EQ(1u, status.countStatus(Logger::LogLevel_Error));
+
+            const Model::NodeList& defaultLayerChildren = world->defaultLayer()->children();
+            ASSERT_EQ(brushCount, defaultLayerChildren.size());
+            assertIncreasingLineNumbers(Model::NodeList(std::begin(defaultLayerChildren), std::end(defaultLayerChildren) - 1));
+
+            Model::Node* entity = defaultLayerChildren.back();
+            ASSERT_EQ(brushCount, entity->childCount());
+            assertIncreasingLineNumbers(entity->children());
+            ASSERT_LT(defaultLayerChildren[brushCount - 2]->lineNumber(), entity->children().front()->lineNumber());
+        }
+
         /*
         TEST(WorldReaderTest, parseIssueIgnoreFlags) {
             const String data("{"
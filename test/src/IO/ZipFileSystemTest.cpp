@@ -20,11 +20,16 @@
 #include <gtest/gtest.h>
 
 #include "IO/DiskFileSystem.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/Reader.h"
+#include "IO/ZipFileCache.h"
 #include "IO/ZipFileSystem.h"
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
+#include <string>
 
 namespace TrenchBroom {
     namespace IO {
@@ -138,5 +143,108 @@ namespace TrenchBroom {
 
             ASSERT_TRUE(fs.openFile(Path("amnet.cfg")) != nullptr);
         }
+
+        static std::string readContents(const File& file) {
+            const auto reader = file.reader().buffer();
+            return std::string(std::begin(reader), std::end(reader));
+        }
+
+        TEST(ZipFileSystemTest, openFiles) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const ZipFileSystem fs(zipPath);
+            ASSERT_THROW(fs.openFiles(Path::List({ Path("/amnet.cfg") })), FileSystemException);
+            ASSERT_THROW(fs.openFiles(Path::List({ Path("amnet.cfg"), Path("asdf.cfg") })), FileSystemException);
+
+            const auto paths = Path::List({
+                Path("amnet.cfg"),
+                Path("pics/tag1.pcx"),
+                Path("textures/e1u1/box1_3.wal"),
+                Path("textures/e1u3/stflr1_5.wal"),
+                Path("bear.cfg")
+            });
+            const auto files = fs.openFiles(paths);
+            ASSERT_EQ(paths.size(), files.size());
+
+            // compare with the files opened one by one from an uncached file system
+            const ZipFileSystem uncachedFS(zipPath, 0u);
+            for (size_t i = 0; i < paths.size(); ++i) {
+                const auto expected = uncachedFS.openFile(paths[i]);
+                ASSERT_EQ(expected->path(), files[i]->path());
+                ASSERT_EQ(readContents(*expected), readContents(*files[i]));
+            }
+            ASSERT_EQ(0u, uncachedFS.cacheSize());
+        }
+
+        TEST(ZipFileSystemTest, cacheDecompressedFiles) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const ZipFileSystem fs(zipPath);
+            ASSERT_EQ(0u, fs.cacheSize());
+
+            const auto file = fs.openFile(Path("amnet.cfg"));
+            ASSERT_EQ(file->size(), fs.cacheSize());
+            ASSERT_EQ(file, fs.openFile(Path("amnet.cfg")));
+            ASSERT_EQ(file, fs.openFiles(Path::List({ Path("amnet.cfg") })).front());
+        }
+
+        TEST(ZipFileSystemTest, evictLeastRecentlyUsedFiles) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const auto amnetPath = Path("amnet.cfg");
+            const auto bearPath = Path("bear.cfg");
+            const auto tagPath = Path("pics/tag1.pcx");
+
+            const ZipFileSystem uncachedFS(zipPath, 0u);
+            const auto amnetSize = uncachedFS.openFile(amnetPath)->size();
+            const auto bearSize = uncachedFS.openFile(bearPath)->size();
+            const auto tagSize = uncachedFS.openFile(tagPath)->size();
+
+            // room for the two larger files, but not for all three
+            const auto capacity = amnetSize + bearSize + tagSize - std::min({ amnetSize, bearSize, tagSize });
+            const ZipFileSystem fs(zipPath, capacity);
+
+            const auto amnet = fs.openFile(amnetPath);
+            const auto bear = fs.openFile(bearPath);
+            ASSERT_EQ(amnet, fs.openFile(amnetPath));
+            ASSERT_EQ(amnetSize + bearSize, fs.cacheSize());
+
+            // bear.cfg is the least recently used file now and must be evicted to make room
+            fs.openFile(tagPath);
+            ASSERT_LE(fs.cacheSize(), capacity);
+            ASSERT_EQ(amnet, fs.openFile(amnetPath));
+            ASSERT_NE(bear, fs.openFile(bearPath));
+        }
+
+        TEST(ZipFileSystemTest, shareCacheBetweenFileSystems) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const auto amnetPath = Path("amnet.cfg");
+            const auto bearPath = Path("bear.cfg");
+
+            const ZipFileSystem uncachedFS(zipPath, 0u);
+            const auto amnetSize = uncachedFS.openFile(amnetPath)->size();
+            const auto bearSize = uncachedFS.openFile(bearPath)->size();
+
+            // room for both files, but not for a third one
+            auto cache = std::make_shared<ZipFileCache>(amnetSize + bearSize);
+            const ZipFileSystem fs1(nullptr, zipPath, cache);
+            {
+                const ZipFileSystem fs2(nullptr, zipPath, cache);
+
+                const auto amnet = fs1.openFile(amnetPath);
+                ASSERT_NE(amnet, fs2.openFile(bearPath));
+                ASSERT_EQ(amnetSize + bearSize, cache->size());
+                ASSERT_EQ(cache->size(), fs1.cacheSize());
+
+                // the files of both file systems count against the same budget
+                fs2.openFile(amnetPath);
+                ASSERT_LE(cache->size(), amnetSize + bearSize);
+                ASSERT_NE(amnet, fs1.openFile(amnetPath));
+            }
+
+            // the files of a destroyed file system are removed from the cache
+            ASSERT_EQ(amnetSize, cache->size());
+        }
     }
 }
@@ -347,5 +347,51 @@ namespace TrenchBroom {
 
             delete target;
         }
+
+        TEST(AttributableNodeLinkTest, testUpdateLinksByRenamingTargetname) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            Entity* source = world.createEntity();
+            Entity* target1 = world.createEntity();
+            Entity* target2 = world.createEntity();
+            world.defaultLayer()->addChild(source);
+            world.defaultLayer()->addChild(target1);
+            world.defaultLayer()->addChild(target2);
+
+            source->addOrUpdateAttribute(AttributeNames::Target, "target_name");
+            target1->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+            target2->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+            ASSERT_EQ(2u, source->linkTargets().size());
+
+            target1->addOrUpdateAttribute(AttributeNames::Targetname, "other_name");
+
+            const AttributableNodeList& targets = source->linkTargets();
+            ASSERT_EQ(1u, targets.size());
+            ASSERT_EQ(target2, targets.front());
+            ASSERT_TRUE(target1->linkSources().empty());
+            ASSERT_TRUE(target1->hasMissingSources());
+            ASSERT_FALSE(target2->hasMissingSources());
+
+            target2->addOrUpdateAttribute(AttributeNames::Targetname, "other_name");
+            ASSERT_TRUE(source->linkTargets().empty());
+            ASSERT_EQ(AttributeNameList{ AttributeNames::Target }, source->findMissingLinkTargets());
+        }
+
+        TEST(AttributableNodeLinkTest, testCreateLinkBySettingAttributes) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            Entity* source = world.createEntity();
+            Entity* target = world.createEntity();
+            world.defaultLayer()->addChild(source);
+            world.defaultLayer()->addChild(target);
+
+            target->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+            source->setAttributes({ EntityAttribute(AttributeNames::Target, "target_name"), EntityAttribute(AttributeNames::Killtarget, "target_name") });
+
+            ASSERT_EQ(AttributableNodeList{ target }, source->linkTargets());
+            ASSERT_EQ(AttributableNodeList{ target }, source->killTargets());
+            ASSERT_EQ(AttributableNodeList{ source }, target->linkSources());
+            ASSERT_EQ(AttributableNodeList{ source }, target->killSources());
+        }
     }
 }
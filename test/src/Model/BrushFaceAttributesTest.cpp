@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/BrushFaceAttributes.h"
+
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(BrushFaceAttributesTest, copyOnWrite) {
+            BrushFaceAttributes original("texture");
+            original.setOffset(vm::vec2f(1.0f, 2.0f));
+
+            BrushFaceAttributes copy(original);
+            ASSERT_EQ(&original.offset(), &copy.offset());
+
+            copy.setXOffset(3.0f);
+            ASSERT_NE(&original.offset(), &copy.offset());
+            ASSERT_EQ(vm::vec2f(1.0f, 2.0f), original.offset());
+            ASSERT_EQ(vm::vec2f(3.0f, 2.0f), copy.offset());
+            ASSERT_EQ("texture", copy.textureName());
+        }
+
+        TEST(BrushFaceAttributesTest, internEqualAttributes) {
+            const size_t internedCount = BrushFaceAttributes::internedCount();
+            {
+                BrushFaceAttributes first("interned_texture");
+                first.setRotation(45.0f);
+                first.intern();
+
+                BrushFaceAttributes second("interned_texture");
+                second.setRotation(45.0f);
+                second.intern();
+
+                BrushFaceAttributes third("interned_texture");
+                third.intern();
+
+                ASSERT_EQ(&first.offset(), &second.offset());
+                ASSERT_NE(&first.offset(), &third.offset());
+                ASSERT_EQ(internedCount + 2, BrushFaceAttributes::internedCount());
+
+                // modifying an interned instance must not affect the others
+                second.setRotation(90.0f);
+                ASSERT_FLOAT_EQ(45.0f, first.rotation());
+                ASSERT_FLOAT_EQ(90.0f, second.rotation());
+                ASSERT_EQ(internedCount + 2, BrushFaceAttributes::internedCount());
+            }
+            ASSERT_EQ(internedCount, BrushFaceAttributes::internedCount());
+        }
+
+        TEST(BrushFaceAttributesTest, releaseInternedAttributesWithNaN) {
+            const size_t internedCount = BrushFaceAttributes::internedCount();
+            {
+                BrushFaceAttributes attributes("interned_texture");
+                attributes.setRotation(vm::nan<float>());
+                attributes.intern();
+                ASSERT_EQ(internedCount + 1, BrushFaceAttributes::internedCount());
+            }
+            ASSERT_EQ(internedCount, BrushFaceAttributes::internedCount());
+        }
+    }
+}
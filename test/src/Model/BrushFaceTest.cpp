@@ -474,6 +474,46 @@ namespace TrenchBroom {
             delete cube;
         }
 
+        static void checkTextureCoordProjection(const MapFormat format) {
+            const vm::bbox3 worldBounds(8192.0);
+            Assets::Texture texture("testTexture", 64, 32);
+            World world(format, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            const Brush* cube = builder.createCube(128.0, "");
+            for (BrushFace* face : cube->faces()) {
+                face->setTexture(&texture);
+                face->setXOffset(12.0f);
+                face->setYOffset(-3.0f);
+                face->setXScale(0.5f);
+                face->setYScale(0.0f);
+                face->setRotation(30.0f);
+
+                std::vector<vm::vec3> positions = face->vertexPositions();
+                positions.push_back(vm::vec3(1000.0, -2000.0, 3000.0));
+
+                std::vector<vm::vec2f> texCoords;
+                face->textureCoordProjection().project(positions, texCoords);
+                ASSERT_EQ(positions.size(), texCoords.size());
+
+                for (size_t i = 0; i < positions.size(); ++i) {
+                    const vm::vec2f expected = face->textureCoords(positions[i]);
+                    EXPECT_NEAR(expected.x(), texCoords[i].x(), 0.0001f);
+                    EXPECT_NEAR(expected.y(), texCoords[i].y(), 0.0001f);
+                }
+            }
+
+            delete cube;
+        }
+
+        TEST(BrushFaceTest, testTextureCoordProjection_Paraxial) {
+            checkTextureCoordProjection(MapFormat::Standard);
+        }
+
+        TEST(BrushFaceTest, testTextureCoordProjection_Parallel) {
+            checkTextureCoordProjection(MapFormat::Valve);
+        }
+
         TEST(BrushFaceTest, testBrushFaceSnapshot) {
             const vm::bbox3 worldBounds(8192.0);
             Assets::Texture texture("testTexture", 64, 64);
@@ -31,10 +31,13 @@
 #include "Model/Hit.h"
 #include "Model/MapFormat.h"
 #include "Model/ModelFactoryImpl.h"
+#include "Model/NodeSnapshot.h"
 #include "Model/PickResult.h"
 #include "Model/World.h"
 
 #include <vecmath/vec.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
 
@@ -3381,6 +3384,108 @@ namespace TrenchBroom {
             delete cube;
         }
 
+        TEST(BrushTest, snapshotRestoresTransformedBrush) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Valve, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "texture");
+            BrushFace* topFace = cube->findFace(vm::vec3::pos_z);
+            topFace->setXOffset(12.0f);
+            topFace->select();
+
+            std::vector<vm::vec3> points;
+            std::vector<vm::vec3> xAxes;
+            for (const BrushFace* face : cube->faces()) {
+                points.insert(std::end(points), std::begin(face->points()), std::end(face->points()));
+                xAxes.push_back(face->textureXAxis());
+            }
+
+            NodeSnapshot* snapshot = cube->takeSnapshot();
+            ASSERT_LT(0u, snapshot->memorySize());
+
+            cube->transform(vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(30.0)), true, worldBounds);
+            cube->findFace(vm::vec3::pos_z)->setXOffset(0.0f);
+
+            snapshot->restore(worldBounds);
+
+            std::vector<vm::vec3> restoredPoints;
+            std::vector<vm::vec3> restoredXAxes;
+            for (const BrushFace* face : cube->faces()) {
+                restoredPoints.insert(std::end(restoredPoints), std::begin(face->points()), std::end(face->points()));
+                restoredXAxes.push_back(face->textureXAxis());
+            }
+            ASSERT_EQ(points, restoredPoints);
+            ASSERT_EQ(xAxes, restoredXAxes);
+
+            const BrushFace* restoredTopFace = cube->findFace(vm::vec3::pos_z);
+            ASSERT_FLOAT_EQ(12.0f, restoredTopFace->attribs().xOffset());
+            ASSERT_EQ("texture", restoredTopFace->textureName());
+            ASSERT_TRUE(restoredTopFace->selected());
+
+            delete snapshot;
+            delete cube;
+        }
+
+        static std::vector<vm::vec3> facePoints(const Brush* brush) {
+            std::vector<vm::vec3> result;
+            for (const BrushFace* face : brush->faces())
+                result.insert(std::end(result), std::begin(face->points()), std::end(face->points()));
+            return result;
+        }
+
+        TEST(BrushTest, compactedSnapshotRecordsOnlyChangedFaces) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Valve, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "texture");
+            const std::vector<vm::vec3> points = facePoints(cube);
+
+            NodeSnapshot* snapshot = cube->takeSnapshot();
+            const size_t fullSize = snapshot->memorySize();
+
+            cube->moveBoundary(worldBounds, cube->findFace(vm::vec3::pos_z), vm::vec3(0, 0, 16), false);
+            snapshot->compact();
+            ASSERT_LT(snapshot->memorySize(), fullSize);
+
+            snapshot->restore(worldBounds);
+            ASSERT_EQ(points, facePoints(cube));
+
+            delete snapshot;
+            delete cube;
+        }
+
+        TEST(BrushTest, collatedSnapshotRestoresStateBeforeBothChanges) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Valve, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "texture");
+            const std::vector<vm::vec3> points = facePoints(cube);
+
+            NodeSnapshot* first = cube->takeSnapshot();
+            cube->moveBoundary(worldBounds, cube->findFace(vm::vec3::pos_z), vm::vec3(0, 0, 16), false);
+            first->compact();
+
+            NodeSnapshot* second = cube->takeSnapshot();
+            cube->moveBoundary(worldBounds, cube->findFace(vm::vec3::neg_x), vm::vec3(-16, 0, 0), false);
+            cube->findFace(vm::vec3::pos_z)->setXOffset(8.0f);
+            second->compact();
+
+            NodeSnapshot::BrushSnapshotMap nextSnapshots;
+            second->collectBrushSnapshots(nextSnapshots);
+            first->collate(nextSnapshots);
+            delete second;
+
+            first->restore(worldBounds);
+            ASSERT_EQ(points, facePoints(cube));
+            ASSERT_FLOAT_EQ(0.0f, cube->findFace(vm::vec3::pos_z)->attribs().xOffset());
+
+            delete first;
+            delete cube;
+        }
+
         TEST(BrushTest, resizePastWorldBounds) {
             const vm::bbox3 worldBounds(8192.0);
             World world(MapFormat::Standard, worldBounds);
@@ -3471,6 +3576,98 @@ namespace TrenchBroom {
             ASSERT_TRUE(cube->intersects(pipe));
         }
 
+        TEST(BrushTest, intersectsBrush) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            std::unique_ptr<Brush> brush(builder.createCube(64.0, "texture"));
+            std::unique_ptr<Brush> overlapping(builder.createCuboid(vm::bbox3(vm::vec3(16, 16, 16), vm::vec3(64, 64, 64)), "texture"));
+            std::unique_ptr<Brush> touching(builder.createCuboid(vm::bbox3(vm::vec3(32, -32, -32), vm::vec3(64, 32, 32)), "texture"));
+            std::unique_ptr<Brush> separate(builder.createCuboid(vm::bbox3(vm::vec3(48, 48, 48), vm::vec3(64, 64, 64)), "texture"));
+
+            // a wedge whose bounds overlap the cube, but which is separated from it by its slanted face
+            std::unique_ptr<Brush> wedge(builder.createCuboid(vm::bbox3(vm::vec3(16, 16, -16), vm::vec3(48, 48, 16)), "texture"));
+            ASSERT_TRUE(wedge->clip(worldBounds, BrushFace::createParaxial(vm::vec3(36, 36, 0), vm::vec3(36, 36, 16), vm::vec3(52, 20, 0))));
+
+            EXPECT_TRUE(brush->intersectsBrush(overlapping.get()));
+            EXPECT_TRUE(overlapping->intersectsBrush(brush.get()));
+            EXPECT_FALSE(brush->intersectsBrush(touching.get()));
+            EXPECT_FALSE(touching->intersectsBrush(brush.get()));
+            EXPECT_FALSE(brush->intersectsBrush(separate.get()));
+            EXPECT_TRUE(brush->intersectsBrush(brush.get()));
+
+            ASSERT_TRUE(brush->bounds().intersects(wedge->bounds()));
+            EXPECT_FALSE(brush->intersectsBrush(wedge.get()));
+            EXPECT_FALSE(wedge->intersectsBrush(brush.get()));
+
+            // the cached planes and vertices follow changes to the geometry
+            wedge->transform(vm::translationMatrix(vm::vec3(-8, -8, 0)), false, worldBounds);
+            EXPECT_TRUE(brush->intersectsBrush(wedge.get()));
+            EXPECT_TRUE(wedge->intersectsBrush(brush.get()));
+        }
+
+        TEST(BrushTest, intersectsBrushMatchesGeometry) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            std::unique_ptr<Brush> brush(builder.createCube(64.0, "texture"));
+            const BrushGeometry geometry(brush->vertexPositions());
+
+            // the rotated cube's edges are skew to the cube's edges, so some positions are only separated by an
+            // axis perpendicular to two edges
+            std::unique_ptr<Brush> rotated(builder.createCube(32.0, "texture"));
+            rotated->transform(vm::rotationMatrix(vm::normalize(vm::vec3(1, 1, 0)), vm::toRadians(45.0)), false, worldBounds);
+            rotated->transform(vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(30.0)), false, worldBounds);
+
+            const vm::vec3 offset = vm::vec3(-72.3, -72.3, -72.3);
+            vm::vec3 previous = vm::vec3::zero;
+            for (size_t x = 0; x < 9; ++x) {
+                for (size_t y = 0; y < 9; ++y) {
+                    for (size_t z = 0; z < 9; ++z) {
+                        const vm::vec3 position = offset + 18.1 * vm::vec3(static_cast<FloatType>(x), static_cast<FloatType>(y), static_cast<FloatType>(z));
+                        rotated->transform(vm::translationMatrix(position - previous), false, worldBounds);
+                        previous = position;
+
+                        const BrushGeometry rotatedGeometry(rotated->vertexPositions());
+                        const bool expected = geometry.intersects(rotatedGeometry);
+                        EXPECT_EQ(expected, brush->intersectsBrush(rotated.get())) << "at " << position;
+                        EXPECT_EQ(expected, rotated->intersectsBrush(brush.get())) << "at " << position;
+                        EXPECT_EQ(expected, brush->intersects(rotated.get())) << "at " << position;
+                    }
+                }
+            }
+        }
+
+        TEST(BrushTest, containsBrush) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            std::unique_ptr<Brush> brush(builder.createCube(64.0, "texture"));
+            std::unique_ptr<Brush> inside(builder.createCuboid(vm::bbox3(vm::vec3(-16, -16, -16), vm::vec3(32, 32, 32)), "texture"));
+            std::unique_ptr<Brush> overlapping(builder.createCuboid(vm::bbox3(vm::vec3(16, 16, 16), vm::vec3(64, 64, 64)), "texture"));
+
+            EXPECT_TRUE(brush->containsBrush(inside.get()));
+            EXPECT_TRUE(brush->containsBrush(brush.get()));
+            EXPECT_FALSE(inside->containsBrush(brush.get()));
+            EXPECT_FALSE(brush->containsBrush(overlapping.get()));
+
+            // the rotated cube fits into the bounds of the brush, but its corners stick out of the brush
+            std::unique_ptr<Brush> rotated(builder.createCube(56.0, "texture"));
+            rotated->transform(vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(45.0)), false, worldBounds);
+            rotated->transform(vm::rotationMatrix(vm::vec3::pos_x, vm::toRadians(45.0)), false, worldBounds);
+            ASSERT_FALSE(brush->bounds().contains(rotated->bounds()));
+            EXPECT_FALSE(brush->containsBrush(rotated.get()));
+
+            inside->transform(vm::translationMatrix(vm::vec3(32, 0, 0)), false, worldBounds);
+            EXPECT_FALSE(brush->containsBrush(inside.get()));
+            inside->transform(vm::translationMatrix(vm::vec3(-32, 0, 0)), false, worldBounds);
+            EXPECT_TRUE(brush->containsBrush(inside.get()));
+            EXPECT_TRUE(brush->contains(inside.get()));
+        }
+
         TEST(BrushTest, removeVertexWithCorrectTextures) {
             // see https://github.com/kduske/TrenchBroom/issues/2082
 
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/CloneNodesInParallel.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class CompareClonesVisitor : public ConstNodeVisitor {
+        private:
+            const Node* m_clone;
+        public:
+            explicit CompareClonesVisitor(const Node* clone) :
+            m_clone(clone) {}
+        private:
+            void doVisit(const World* world) override   { compareNodes(world); }
+            void doVisit(const Layer* layer) override   { compareNodes(layer); }
+            void doVisit(const Group* group) override   { compareNodes(group); }
+            void doVisit(const Entity* entity) override { compareNodes(entity); }
+
+            void doVisit(const Brush* brush) override {
+                compareNodes(brush);
+
+                const Brush* clone = static_cast<const Brush*>(m_clone);
+                ASSERT_EQ(brush->fullySpecified(), clone->fullySpecified());
+                ASSERT_EQ(brush->vertexCount(), clone->vertexCount());
+                ASSERT_EQ(brush->edgeCount(), clone->edgeCount());
+                ASSERT_EQ(brush->faceCount(), clone->faceCount());
+                for (size_t i = 0; i < brush->faceCount(); ++i) {
+                    const BrushFace* face = brush->faces()[i];
+                    const BrushFace* faceClone = clone->faces()[i];
+                    ASSERT_NE(face, faceClone);
+                    ASSERT_EQ(clone, faceClone->brush());
+                    ASSERT_EQ(face->boundary(), faceClone->boundary());
+                    ASSERT_EQ(face->textureName(), faceClone->textureName());
+                    ASSERT_EQ(face->vertexPositions(), faceClone->vertexPositions());
+                }
+            }
+
+            void compareNodes(const Node* node) {
+                ASSERT_NE(node, m_clone);
+                ASSERT_EQ(node->name(), m_clone->name());
+                ASSERT_EQ(node->bounds(), m_clone->bounds());
+                ASSERT_EQ(node->childCount(), m_clone->childCount());
+                for (size_t i = 0; i < node->childCount(); ++i) {
+                    ASSERT_EQ(m_clone, m_clone->children()[i]->parent());
+                    CompareClonesVisitor visitor(m_clone->children()[i]);
+                    node->children()[i]->accept(visitor);
+                }
+            }
+        };
+
+        static void assertClonesEqual(const NodeList& originals, const NodeList& clones) {
+            ASSERT_EQ(originals.size(), clones.size());
+            for (size_t i = 0; i < originals.size(); ++i) {
+                ASSERT_EQ(nullptr, clones[i]->parent());
+                CompareClonesVisitor visitor(clones[i]);
+                originals[i]->accept(visitor);
+            }
+        }
+
+        TEST(CloneNodesInParallelTest, cloneNestedNodes) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+
+            Group* outer = world.createGroup("outer");
+            Group* inner = world.createGroup("inner");
+            Entity* entity = world.createEntity();
+            entity->addOrUpdateAttribute("classname", "func_door");
+            outer->addChild(inner);
+            inner->addChild(entity);
+
+            for (size_t i = 0; i < 64; ++i) {
+                const auto x = static_cast<FloatType>(i) * 32.0;
+                Brush* brush = builder.createCuboid(vm::bbox3(vm::vec3(x, 0.0, 0.0), vm::vec3(x + 16.0, 16.0, 16.0)), "texture");
+                switch (i % 3) {
+                    case 0:
+                        outer->addChild(brush);
+                        break;
+                    case 1:
+                        inner->addChild(brush);
+                        break;
+                    default:
+                        entity->addChild(brush);
+                        break;
+                }
+            }
+
+            const std::vector<vm::vec3> points {
+                vm::vec3(0.0, 0.0, 64.0), vm::vec3(32.0, 0.0, 0.0), vm::vec3(0.0, 32.0, 0.0),
+                vm::vec3(-32.0, 0.0, 0.0), vm::vec3(0.0, -32.0, 0.0), vm::vec3(8.0, 8.0, -48.0)
+            };
+            Brush* irregular = builder.createBrush(points, "other");
+
+            const NodeList originals { outer, irregular, entity };
+            NodeList clones = cloneRecursivelyInParallel(worldBounds, originals);
+            assertClonesEqual(originals, clones);
+            VectorUtils::clearAndDelete(clones);
+
+            world.defaultLayer()->addChild(outer);
+            world.defaultLayer()->addChild(irregular);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/CollectMatchingNodesInParallel.h"
+#include "Model/CollectSelectableNodesVisitor.h"
+#include "Model/CollectTouchingNodesVisitor.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Model {
+        class CollectMatchingNodesInParallelTest : public ::testing::Test {
+        protected:
+            const vm::bbox3 worldBounds = vm::bbox3(8192.0);
+            World world = World(MapFormat::Standard, worldBounds);
+            EditorContext editorContext;
+            BrushList queries;
+
+            void SetUp() override {
+                BrushBuilder builder(&world, worldBounds);
+
+                // a row of brushes in the default layer, every other one in a group or a brush entity
+                for (size_t i = 0; i < 16; ++i) {
+                    const auto x = static_cast<FloatType>(i) * 24.0;
+                    Brush* brush = builder.createCuboid(vm::bbox3(vm::vec3(x, 0.0, 0.0), vm::vec3(x + 16.0, 16.0, 16.0)), "texture");
+                    if (i % 4 == 1) {
+                        Group* group = world.createGroup("group");
+                        group->addChild(brush);
+                        world.defaultLayer()->addChild(group);
+                    } else if (i % 4 == 3) {
+                        Entity* entity = world.createEntity();
+                        entity->addChild(brush);
+                        world.defaultLayer()->addChild(entity);
+                    } else {
+                        world.defaultLayer()->addChild(brush);
+                    }
+                }
+
+                Entity* pointEntity = world.createEntity();
+                world.defaultLayer()->addChild(pointEntity);
+
+                queries.push_back(builder.createCuboid(vm::bbox3(vm::vec3(20.0, -8.0, -8.0), vm::vec3(140.0, 24.0, 24.0)), "texture"));
+                queries.push_back(builder.createCuboid(vm::bbox3(vm::vec3(-64.0, -64.0, -64.0), vm::vec3(64.0, 64.0, 64.0)), "texture"));
+                queries.push_back(builder.createCuboid(vm::bbox3(vm::vec3(300.0, 4.0, 4.0), vm::vec3(340.0, 12.0, 12.0)), "texture"));
+                for (Brush* query : queries)
+                    world.defaultLayer()->addChild(query);
+            }
+        };
+
+        TEST_F(CollectMatchingNodesInParallelTest, flattenNodes) {
+            const NodeList roots = world.children();
+            const NodeSequence sequence = flattenNodes(roots);
+
+            ASSERT_EQ(sequence.nodes.size(), sequence.subtreeEnds.size());
+            ASSERT_EQ(world.defaultLayer(), sequence.nodes.front());
+            ASSERT_EQ(sequence.nodes.size(), sequence.subtreeEnds.front());
+            ASSERT_EQ(world.defaultLayer()->descendantCount() + 1u, sequence.nodes.size());
+
+            for (size_t i = 0; i < sequence.nodes.size(); ++i)
+                ASSERT_EQ(i + sequence.nodes[i]->descendantCount() + 1u, sequence.subtreeEnds[i]);
+        }
+
+        TEST_F(CollectMatchingNodesInParallelTest, collectSelectableNodes) {
+            CollectSelectableNodesVisitor visitor(editorContext);
+            world.recurse(visitor);
+
+            const NodeList actual = collectMatchingNodesInParallel(world.children(),
+                [](const Node*) { return true; },
+                [&](const Node* node) { return editorContext.selectable(node); });
+            ASSERT_EQ(visitor.nodes(), actual);
+        }
+
+        TEST_F(CollectMatchingNodesInParallelTest, findTouchingNodes) {
+            CollectTouchingNodesVisitor<BrushList::const_iterator> visitor(std::begin(queries), std::end(queries), editorContext);
+            world.acceptAndRecurse(visitor);
+
+            const NodeList actual = findTouchingNodes(&world, queries, editorContext);
+            ASSERT_FALSE(actual.empty());
+            ASSERT_EQ(visitor.nodes(), actual);
+        }
+
+        TEST_F(CollectMatchingNodesInParallelTest, findContainedNodes) {
+            CollectContainedNodesVisitor<BrushList::const_iterator> visitor(std::begin(queries), std::end(queries), editorContext);
+            world.acceptAndRecurse(visitor);
+
+            const NodeList actual = findContainedNodes(&world, queries, editorContext);
+            ASSERT_FALSE(actual.empty());
+            ASSERT_EQ(visitor.nodes(), actual);
+        }
+    }
+}
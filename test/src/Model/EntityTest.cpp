@@ -22,6 +22,10 @@
 
 #include <memory>
 
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "IO/ELParser.h"
+#include "IO/Path.h"
 #include "Model/Entity.h"
 #include "Model/EntityAttributes.h"
 #include "Model/MapFormat.h"
@@ -122,5 +126,66 @@ namespace TrenchBroom {
             m_entity->transform(vm::translationMatrix(vm::vec3d(100.0, 0.0, 0.0)), true, m_worldBounds);
             EXPECT_EQ(rotMat, m_entity->rotation());
         }
+
+        TEST_F(EntityTest, typedAttributes) {
+            m_entity->addOrUpdateAttribute(AttributeNames::Origin, "1 2 3");
+            m_entity->addOrUpdateAttribute(AttributeNames::Angle, "90");
+            m_entity->addOrUpdateAttribute("_color", "0.5 0.25 1");
+
+            EXPECT_EQ(vm::vec3(1, 2, 3), m_entity->vectorAttribute(AttributeNames::Origin, vm::vec3::zero));
+            EXPECT_EQ(90.0, m_entity->numberAttribute(AttributeNames::Angle, 0.0));
+            EXPECT_EQ(vm::vec3(0.5, 0.25, 1), m_entity->vectorAttribute("_color", vm::vec3::zero));
+
+            // missing attributes and values that are not vectors yield the default value
+            EXPECT_EQ(vm::vec3::one, m_entity->vectorAttribute(AttributeNames::Angles, vm::vec3::one));
+            EXPECT_EQ(-1.0, m_entity->numberAttribute(AttributeNames::Angles, -1.0));
+            EXPECT_EQ(vm::vec3::one, m_entity->vectorAttribute(AttributeNames::Angle, vm::vec3::one));
+
+            // the cached values are updated when the attributes change
+            m_entity->addOrUpdateAttribute(AttributeNames::Origin, "4 5 6");
+            m_entity->addOrUpdateAttribute(AttributeNames::Angle, "abc");
+            EXPECT_EQ(vm::vec3(4, 5, 6), m_entity->vectorAttribute(AttributeNames::Origin, vm::vec3::zero));
+            EXPECT_EQ(0.0, m_entity->numberAttribute(AttributeNames::Angle, 1.0));
+
+            m_entity->renameAttribute(AttributeNames::Origin, AttributeNames::Angles);
+            EXPECT_EQ(vm::vec3::one, m_entity->vectorAttribute(AttributeNames::Origin, vm::vec3::one));
+            EXPECT_EQ(vm::vec3(4, 5, 6), m_entity->vectorAttribute(AttributeNames::Angles, vm::vec3::zero));
+
+            m_entity->removeAttribute(AttributeNames::Angles);
+            EXPECT_EQ(vm::vec3::one, m_entity->vectorAttribute(AttributeNames::Angles, vm::vec3::one));
+
+            m_entity->setAttributes({ EntityAttribute(AttributeNames::Origin, "7 8 9"), EntityAttribute(AttributeNames::Mangle, "10 20 30") });
+            EXPECT_EQ(vm::vec3(7, 8, 9), m_entity->origin());
+            EXPECT_EQ(vm::vec3(10, 20, 30), m_entity->vectorAttribute(AttributeNames::Mangle, vm::vec3::zero));
+        }
+
+        TEST_F(EntityTest, findAttributesByPrefix) {
+            m_entity->addOrUpdateAttribute("target", "a");
+            m_entity->addOrUpdateAttribute("target2", "b");
+            m_entity->addOrUpdateAttribute("targetname", "c");
+            m_entity->addOrUpdateAttribute("killtarget", "a");
+
+            EXPECT_TRUE(m_entity->hasAttributeWithPrefix("target", "c"));
+            EXPECT_FALSE(m_entity->hasAttributeWithPrefix("kill", "b"));
+            EXPECT_TRUE(m_entity->hasNumberedAttribute("target", "b"));
+            EXPECT_FALSE(m_entity->hasNumberedAttribute("target", "c"));
+
+            EXPECT_EQ(3u, m_entity->attributesWithPrefix("target").size());
+            EXPECT_EQ(2u, m_entity->numberedAttributes("target").size());
+            EXPECT_EQ(1u, m_entity->attributeWithName("killtarget").size());
+            EXPECT_TRUE(m_entity->attributeWithName("kill").empty());
+        }
+
+        TEST_F(EntityTest, modelSpecificationUpdatesWithAttributes) {
+            Assets::PointEntityDefinition definition(TestClassname, Color(), vm::bbox3(16.0), "", Assets::AttributeDefinitionList(), Assets::ModelDefinition(IO::ELParser::parseStrict("{ 'path': 'model.mdl', 'skin': skin }")));
+            m_entity->setDefinition(&definition);
+            EXPECT_EQ(Assets::ModelSpecification(IO::Path("model.mdl"), 0, 0), m_entity->modelSpecification());
+
+            m_entity->addOrUpdateAttribute("skin", "2");
+            EXPECT_EQ(Assets::ModelSpecification(IO::Path("model.mdl"), 2, 0), m_entity->modelSpecification());
+
+            m_entity->setDefinition(nullptr);
+            EXPECT_EQ(Assets::ModelSpecification(), m_entity->modelSpecification());
+        }
     }
 }
@@ -22,6 +22,9 @@
 #include <vecmath/vec.h>
 #include <vecmath/plane.h>
 #include <vecmath/scalar.h>
+
+#include <vector>
+
 #include "TestUtils.h"
 #include "Model/PlanePointFinder.h"
 
@@ -68,3 +71,49 @@ TEST(PlaneTest, planePointFinder) {
         ASSERT_LT(dist, 0.01);
     }
 }
+
+TEST(PlaneTest, planePointFinderSecondPointOnFirstPoint) {
+    // the search for the second point initially lands on the first point, so it must be repeated
+    const vm::vec3 normal(0.37850743685502958, -0.8394523633403087, -0.38993826425192757);
+    const vm::plane3 plane(3247.1565057344706, normal);
+
+    vm::vec3 points[3] = {
+        vm::vec3(1845.1479029875998, -3041.9092622695125, 12.267626343090441),
+        vm::vec3(1845.7855986112447, -3041.9781052604449, 13.03483226993383),
+        vm::vec3(1845.8187803324474, -3041.3702071959979, 11.758368828773357)
+    };
+
+    TrenchBroom::Model::PlanePointFinder::findPoints(plane, points, 3);
+
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(isIntegral(points[i]));
+        ASSERT_LT(vm::abs(plane.pointDistance(points[i])), 1.0);
+    }
+    ASSERT_NE(points[0], points[1]);
+    ASSERT_NE(points[0], points[2]);
+}
+
+TEST(PlaneTest, planePointFinderBatch) {
+    const vm::vec3 points[6] = {
+        vm::vec3(48, 16, 28), vm::vec3(16.0, 16.0, 27.9980487823486328125), vm::vec3(48, 18, 22),
+        vm::vec3(1845.1479029875998, -3041.9092622695125, 12.267626343090441), vm::vec3(1845.7855986112447, -3041.9781052604449, 13.03483226993383), vm::vec3(1845.8187803324474, -3041.3702071959979, 11.758368828773357)
+    };
+
+    std::vector<vm::plane3> planes;
+    for (size_t i = 0; i < 2; ++i) {
+        const auto [valid, plane] = fromPoints(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+        ASSERT_TRUE(valid);
+        planes.push_back(plane);
+    }
+
+    std::vector<vm::vec3> batchPoints(std::begin(points), std::end(points));
+    TrenchBroom::Model::PlanePointFinder::findPoints(planes, batchPoints);
+
+    for (size_t i = 0; i < 2; ++i) {
+        vm::vec3 planePoints[3] = { points[3 * i], points[3 * i + 1], points[3 * i + 2] };
+        TrenchBroom::Model::PlanePointFinder::findPoints(planes[i], planePoints, 3);
+        for (size_t j = 0; j < 3; ++j) {
+            ASSERT_EQ(planePoints[j], batchPoints[3 * i + j]);
+        }
+    }
+}
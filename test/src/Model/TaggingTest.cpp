@@ -19,10 +19,13 @@
 
 #include <gtest/gtest.h>
 
+#include "Assets/Texture.h"
 #include "Model/Tag.h"
 #include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
 #include "Model/Layer.h"
 #include "Model/MapFormat.h"
 #include "Model/World.h"
@@ -59,5 +62,78 @@ namespace TrenchBroom {
             ASSERT_FALSE(brush->hasTag(tag1));
             ASSERT_FALSE(brush->hasTag(tag2));
         }
+
+        TEST(TaggingTest, testUpdateTextureTags) {
+            Assets::Texture caulk("common/caulk", 16, 16);
+            Assets::Texture clip("common/weapclip", 16, 16);
+            Assets::Texture wall("base_wall/concrete", 16, 16);
+            clip.setSurfaceParms({ "playerclip" });
+
+            const vm::bbox3 worldBounds{4096.0};
+            World world{MapFormat::Quake3, worldBounds};
+
+            BrushBuilder builder{&world, worldBounds};
+            Brush* brush = builder.createCube(64.0, "common/caulk", "common/weapclip", "base_wall/concrete", "base_wall/concrete", "missing", "missing");
+            world.defaultLayer()->addChild(brush);
+
+            BrushFaceList faces;
+            for (const auto* textureName : { "common/caulk", "common/weapclip", "base_wall/concrete", "missing" }) {
+                for (BrushFace* face : brush->faces()) {
+                    if (face->textureName() == textureName) {
+                        faces.push_back(face);
+                    }
+                }
+            }
+            ASSERT_EQ(6u, faces.size());
+
+            faces[0]->setTexture(&caulk);
+            faces[1]->setTexture(&clip);
+            faces[2]->setTexture(&wall);
+            faces[3]->setTexture(&wall);
+
+            TagManager tagManager;
+            tagManager.registerSmartTag(SmartTag("Caulk", {}, std::make_unique<TextureNameTagMatcher>("caulk")));
+            tagManager.registerSmartTag(SmartTag("Clip", {}, std::make_unique<SurfaceParmTagMatcher>("playerclip")));
+            tagManager.registerSmartTag(SmartTag("Missing", {}, std::make_unique<TextureNameTagMatcher>("miss*")));
+            tagManager.registerSmartTag(SmartTag("Detail", {}, std::make_unique<ContentFlagsTagMatcher>(1 << 27)));
+
+            const auto& caulkTag = tagManager.smartTag("Caulk");
+            const auto& clipTag = tagManager.smartTag("Clip");
+            const auto& missingTag = tagManager.smartTag("Missing");
+            const auto& detailTag = tagManager.smartTag("Detail");
+
+            faces[3]->setSurfaceContents(1 << 27);
+            brush->initializeTags(tagManager);
+
+            ASSERT_TRUE(faces[0]->hasTag(caulkTag));
+            ASSERT_FALSE(faces[0]->hasTag(clipTag));
+            ASSERT_FALSE(faces[1]->hasTag(caulkTag));
+            ASSERT_TRUE(faces[1]->hasTag(clipTag));
+            ASSERT_FALSE(faces[2]->hasAnyTag());
+            ASSERT_TRUE(faces[3]->hasTag(detailTag));
+            ASSERT_FALSE(faces[3]->hasTag(caulkTag));
+            ASSERT_TRUE(faces[4]->hasTag(missingTag));
+            ASSERT_TRUE(faces[5]->hasTag(missingTag));
+
+            // changing the surface parameters invalidates the tags cached on the texture
+            wall.setSurfaceParms({ "playerclip" });
+            faces[3]->setSurfaceContents(0);
+            brush->initializeTags(tagManager);
+
+            ASSERT_TRUE(faces[2]->hasTag(clipTag));
+            ASSERT_TRUE(faces[3]->hasTag(clipTag));
+            ASSERT_FALSE(faces[3]->hasTag(detailTag));
+
+            // so does changing the smart tags
+            tagManager.clearSmartTags();
+            tagManager.registerSmartTag(SmartTag("Concrete", {}, std::make_unique<TextureNameTagMatcher>("conc*")));
+            const auto& concreteTag = tagManager.smartTag("Concrete");
+            brush->initializeTags(tagManager);
+
+            ASSERT_FALSE(faces[0]->hasAnyTag());
+            ASSERT_FALSE(faces[1]->hasAnyTag());
+            ASSERT_TRUE(faces[2]->hasTag(concreteTag));
+            ASSERT_TRUE(faces[3]->hasTag(concreteTag));
+        }
     }
 }
@@ -84,6 +84,8 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
+        void TestGame::doWriteMapCache(const World& world, const vm::bbox3& worldBounds, const IO::Path& path) const {}
+
         void TestGame::doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const {}
 
         NodeList TestGame::doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const {
@@ -0,0 +1,195 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitQuery.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(WorldTest, deferBoundsUpdates) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            Group* outer = world.createGroup("outer");
+            Group* inner = world.createGroup("inner");
+            world.defaultLayer()->addChild(outer);
+            outer->addChild(inner);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush1 = builder.createCuboid(vm::bbox3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(16.0, 16.0, 16.0)), "texture");
+            Brush* brush2 = builder.createCuboid(vm::bbox3(vm::vec3(32.0, 0.0, 0.0), vm::vec3(48.0, 16.0, 16.0)), "texture");
+            inner->addChild(brush1);
+            inner->addChild(brush2);
+
+            ASSERT_EQ(vm::bbox3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(48.0, 16.0, 16.0)), outer->bounds());
+
+            {
+                const World::DeferBoundsUpdates deferBoundsUpdates(&world);
+                brush1->transform(vm::translationMatrix(vm::vec3(0.0, 0.0, 64.0)), false, worldBounds);
+                brush2->transform(vm::translationMatrix(vm::vec3(0.0, 0.0, 64.0)), false, worldBounds);
+
+                // bounds are revalidated lazily while updates are deferred
+                ASSERT_EQ(vm::bbox3(vm::vec3(0.0, 0.0, 64.0), vm::vec3(48.0, 16.0, 80.0)), inner->bounds());
+                ASSERT_EQ(inner->bounds(), outer->bounds());
+
+                brush1->transform(vm::translationMatrix(vm::vec3(0.0, 0.0, 64.0)), false, worldBounds);
+            }
+
+            ASSERT_EQ(vm::bbox3(vm::vec3(0.0, 0.0, 64.0), vm::vec3(48.0, 16.0, 144.0)), inner->bounds());
+            ASSERT_EQ(inner->bounds(), outer->bounds());
+
+            NodeList containers;
+            world.findNodesContaining(vm::vec3(8.0, 8.0, 136.0), containers);
+            ASSERT_TRUE(VectorUtils::contains(containers, outer));
+            ASSERT_TRUE(VectorUtils::contains(containers, inner));
+            ASSERT_TRUE(VectorUtils::contains(containers, brush1));
+            ASSERT_FALSE(VectorUtils::contains(containers, brush2));
+
+            containers.clear();
+            world.findNodesContaining(vm::vec3(8.0, 8.0, 8.0), containers);
+            ASSERT_TRUE(containers.empty());
+        }
+
+        TEST(WorldTest, removeNodeWhileBoundsUpdatesAreDeferred) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            Group* group = world.createGroup("group");
+            world.defaultLayer()->addChild(group);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush1 = builder.createCube(16.0, "texture");
+            Brush* brush2 = builder.createCube(16.0, "texture");
+            group->addChild(brush1);
+            group->addChild(brush2);
+
+            {
+                const World::DeferBoundsUpdates deferBoundsUpdates(&world);
+                brush1->transform(vm::translationMatrix(vm::vec3(64.0, 0.0, 0.0)), false, worldBounds);
+                group->removeChild(brush1);
+                delete brush1;
+            }
+
+            ASSERT_EQ(brush2->bounds(), group->bounds());
+
+            NodeList containers;
+            world.findNodesContaining(vm::vec3(64.0, 0.0, 0.0), containers);
+            ASSERT_TRUE(containers.empty());
+        }
+
+        TEST(WorldTest, addChildToGroup) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            Group* group = world.createGroup("group");
+            world.defaultLayer()->addChild(group);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush1 = builder.createCube(16.0, "texture");
+            Brush* brush2 = builder.createCube(16.0, "texture");
+            Brush* brush3 = builder.createCube(16.0, "texture");
+            brush2->transform(vm::translationMatrix(vm::vec3(64.0, 0.0, 0.0)), false, worldBounds);
+            group->addChild(brush1);
+            group->addChild(brush2);
+
+            ASSERT_EQ(vm::merge(brush1->bounds(), brush2->bounds()), group->bounds());
+
+            // a child within the bounds does not change them
+            group->addChild(brush3);
+            ASSERT_EQ(vm::merge(brush1->bounds(), brush2->bounds()), group->bounds());
+
+            // the group must have been updated in the node tree
+            NodeList containers;
+            world.findNodesContaining(vm::vec3(64.0, 0.0, 0.0), containers);
+            ASSERT_TRUE(VectorUtils::contains(containers, group));
+            ASSERT_TRUE(VectorUtils::contains(containers, brush2));
+        }
+
+        TEST(WorldTest, pickFirst) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            // a row of cubes along the X axis with an entity between the sixth and the seventh cube
+            BrushBuilder builder(&world, worldBounds);
+            std::vector<Brush*> brushes;
+            for (size_t i = 0; i < 10; ++i) {
+                Brush* brush = builder.createCube(16.0, "texture");
+                brush->transform(vm::translationMatrix(vm::vec3(32.0 * static_cast<FloatType>(i), 0.0, 0.0)), false, worldBounds);
+                world.defaultLayer()->addChild(brush);
+                brushes.push_back(brush);
+            }
+
+            Entity* entity = world.createEntity();
+            entity->addOrUpdateAttribute(AttributeNames::Origin, "176 0 0");
+            world.defaultLayer()->addChild(entity);
+
+            brushes[0]->setVisibilityState(Visibility_Hidden);
+
+            const EditorContext editorContext;
+            const vm::ray3 ray(vm::vec3(-64.0, 0.0, 0.0), vm::vec3::pos_x);
+
+            auto allHits = PickResult::byDistance(editorContext);
+            world.pick(ray, allHits);
+
+            const auto assertPickFirst = [&](const auto& buildQuery, const Node* expectedNode) {
+                auto someHits = PickResult::byDistance(editorContext);
+                const auto query = buildQuery(someHits.query());
+                world.pickFirst(ray, someHits, query);
+
+                const Hit& expected = buildQuery(allHits.query()).first();
+                const Hit& actual = query.first();
+                ASSERT_EQ(expectedNode, expected.isMatch() ? hitToNode(expected) : nullptr);
+                ASSERT_EQ(expected.isMatch(), actual.isMatch());
+                if (expected.isMatch()) {
+                    ASSERT_EQ(hitToNode(expected), hitToNode(actual));
+                    ASSERT_DOUBLE_EQ(expected.distance(), actual.distance());
+                }
+                ASSERT_LT(someHits.size(), allHits.size());
+            };
+
+            // the hidden first cube is skipped
+            assertPickFirst([](HitQuery query) { return query.pickable().type(Brush::BrushHit); }, brushes[1]);
+
+            // the second cube occludes the entity unless brushes are excluded from occluding
+            assertPickFirst([](HitQuery query) { return query.pickable().type(Entity::EntityHit); }, nullptr);
+            assertPickFirst([](HitQuery query) { return query.pickable().type(Entity::EntityHit).occluded(); }, entity);
+
+            assertPickFirst([](HitQuery query) { return query.pickable().type(Brush::BrushHit).minDistance(200.0); }, nullptr);
+            assertPickFirst([](HitQuery query) { return query.pickable().type(Brush::BrushHit).minDistance(200.0).occluded(); }, brushes[5]);
+        }
+    }
+}
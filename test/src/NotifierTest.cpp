@@ -114,4 +114,27 @@ namespace TrenchBroom {
         obs.notify1(2);
         obs.notify2(1, 2);
     }
+
+    TEST(NotifierTest, testStatisticsUseReadableTypeNames) {
+        Observer o1;
+
+        Observed obs;
+        obs.oneArgNotifier.addObserver(&o1, &Observer::notify1);
+
+        NotifierStatistics statistics;
+        obs.oneArgNotifier.setStatistics(&statistics);
+
+        EXPECT_CALL(o1, notify1(1));
+        EXPECT_CALL(o1, notify1(2));
+
+        obs.notify1(1);
+        obs.notify1(2);
+
+        ASSERT_EQ(1u, statistics.entries().size());
+        const auto& entry = *std::begin(statistics.entries());
+#if defined(__GNUC__)
+        ASSERT_EQ("TrenchBroom::Observer", entry.first);
+#endif
+        ASSERT_EQ(2u, entry.second.callCount);
+    }
 }
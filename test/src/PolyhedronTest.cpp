@@ -29,7 +29,9 @@
 #include <vecmath/scalar.h>
 
 #include <iterator>
+#include <map>
 #include <tuple>
+#include <vector>
 
 using Polyhedron3d = Polyhedron<double, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
 using PVertex = Polyhedron3d::Vertex;
@@ -148,6 +150,46 @@ TEST(PolyhedronTest, swap) {
     ASSERT_EQ(original.bounds(), rhs.bounds());
 }
 
+TEST(PolyhedronTest, initWithTopology) {
+    const Polyhedron3d original(vm::bbox3d(vm::vec3d(-8.0, -8.0, -8.0), vm::vec3d(8.0, 8.0, 8.0)));
+
+    std::vector<vm::vec3d> positions;
+    std::map<const PVertex*, size_t> indices;
+    for (const PVertex* vertex : original.vertices()) {
+        indices[vertex] = positions.size();
+        positions.push_back(vertex->position());
+    }
+
+    std::vector<std::vector<size_t>> faces;
+    for (const PFace* face : original.faces()) {
+        std::vector<size_t> faceIndices;
+        for (const PHalfEdge* halfEdge : face->boundary())
+            faceIndices.push_back(indices[halfEdge->origin()]);
+        faces.push_back(faceIndices);
+    }
+
+    Polyhedron3d::Callback callback;
+    const Polyhedron3d copy(positions, faces, callback);
+    ASSERT_EQ(original, copy);
+    ASSERT_EQ(original.bounds(), copy.bounds());
+    ASSERT_EQ(original.edgeCount(), copy.edgeCount());
+
+    // add a vertex that no face references
+    positions.push_back(vm::vec3d(16.0, 16.0, 16.0));
+    ASSERT_THROW(Polyhedron3d(positions, faces, callback), GeometryException);
+    positions.pop_back();
+
+    // remove a face so that the surface is not closed anymore
+    faces.pop_back();
+    ASSERT_THROW(Polyhedron3d(positions, faces, callback), GeometryException);
+
+    faces.push_back({ 0, 1 });
+    ASSERT_THROW(Polyhedron3d(positions, faces, callback), GeometryException);
+
+    faces.back() = { 0, 1, positions.size() };
+    ASSERT_THROW(Polyhedron3d(positions, faces, callback), GeometryException);
+}
+
 TEST(PolyhedronTest, convexHullWithFailingPoints) {
     const vm::vec3d p1(-64.0,    -45.5049, -34.4752);
     const vm::vec3d p2(-64.0,    -43.6929, -48.0);
@@ -244,6 +244,88 @@ namespace TrenchBroom {
             }
         }
 
+        TEST(AllocationTrackerTest, allocateFromSizeClassOfRequest) {
+            AllocationTracker t(1000);
+
+            AllocationTracker::Block* first = t.allocate(310);
+            ASSERT_NE(nullptr, t.allocate(10));
+            ASSERT_NE(nullptr, t.allocate(600));
+            t.free(first);
+            EXPECT_EQ((std::set<AllocationTracker::Range>{{0, 310}, {920, 80}}), t.freeBlocks());
+
+            // 301 and 310 are in the same size class, so not every free block in that class fits the request
+            AllocationTracker::Block* block = t.allocate(301);
+            ASSERT_NE(nullptr, block);
+            EXPECT_EQ(0, block->pos);
+            EXPECT_EQ(nullptr, t.allocate(81));
+            EXPECT_EQ((std::set<AllocationTracker::Range>{{301, 9}, {920, 80}}), t.freeBlocks());
+        }
+
+        TEST(AllocationTrackerTest, statistics) {
+            AllocationTracker t(500);
+
+            AllocationTracker::Block* blocks[5];
+            for (size_t i = 0; i < 5; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+
+            t.free(blocks[1]);
+            t.free(blocks[3]);
+
+            const auto stats = t.statistics();
+            EXPECT_EQ(500, stats.capacity);
+            EXPECT_EQ(300, stats.usedSize);
+            EXPECT_EQ(200, stats.freeSize);
+            EXPECT_EQ(100, stats.largestFreeBlock);
+            EXPECT_EQ(3u, stats.usedBlockCount);
+            EXPECT_EQ(2u, stats.freeBlockCount);
+            EXPECT_DOUBLE_EQ(0.5, stats.fragmentation());
+
+            t.free(blocks[2]);
+            EXPECT_DOUBLE_EQ(0.0, t.statistics().fragmentation());
+            EXPECT_EQ(1u, t.statistics().freeBlockCount);
+        }
+
+        TEST(AllocationTrackerTest, compact) {
+            AllocationTracker t(500);
+
+            AllocationTracker::Block* blocks[5];
+            for (size_t i = 0; i < 5; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+
+            t.free(blocks[0]);
+            t.free(blocks[2]);
+            blocks[2] = t.allocate(50);
+            EXPECT_EQ((std::set<AllocationTracker::Range>{{0, 100}, {250, 50}}), t.freeBlocks());
+
+            std::vector<std::pair<AllocationTracker::Index, AllocationTracker::Index>> moves;
+            const auto move = [&](const AllocationTracker::Block* block, const AllocationTracker::Index oldPos) {
+                moves.emplace_back(oldPos, block->pos);
+            };
+
+            EXPECT_FALSE(t.compact(1, move));
+            EXPECT_EQ((std::vector<std::pair<AllocationTracker::Index, AllocationTracker::Index>>{{100, 0}}), moves);
+            EXPECT_EQ(0, blocks[1]->pos);
+            EXPECT_EQ((std::set<AllocationTracker::Range>{{100, 100}, {250, 50}}), t.freeBlocks());
+
+            moves.clear();
+            EXPECT_TRUE(t.compact(10, move));
+            EXPECT_EQ((std::vector<std::pair<AllocationTracker::Index, AllocationTracker::Index>>{{200, 100}, {300, 150}, {400, 250}}), moves);
+            EXPECT_EQ((std::set<AllocationTracker::Range>{{0, 100}, {100, 50}, {150, 100}, {250, 100}}), t.usedBlocks());
+            EXPECT_EQ((std::set<AllocationTracker::Range>{{350, 150}}), t.freeBlocks());
+            EXPECT_EQ(150, t.largestPossibleAllocation());
+            EXPECT_EQ(100, blocks[2]->pos);
+            EXPECT_EQ(250, blocks[4]->pos);
+
+            moves.clear();
+            EXPECT_TRUE(t.compact(10, move));
+            EXPECT_TRUE(moves.empty());
+
+            t.free(blocks[4]);
+            EXPECT_EQ((std::set<AllocationTracker::Range>{{250, 250}}), t.freeBlocks());
+        }
+
         static constexpr size_t NumBrushes = 64'000;
 
         // between 12 and 140, inclusive.
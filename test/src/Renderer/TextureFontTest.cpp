@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "AttrString.h"
+#include "StringUtils.h"
+#include "Renderer/FontGlyph.h"
+#include "Renderer/FontTexture.h"
+#include "Renderer/TextureFont.h"
+
+#include <vecmath/vec.h>
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static TextureFont* createFont() {
+            const unsigned char firstChar = 32;
+            const unsigned char charCount = 96;
+
+            FontGlyph::List glyphs;
+            for (size_t i = 0; i < charCount; ++i) {
+                glyphs.push_back(FontGlyph((i % 16) * 8, (i / 16) * 12, 8, 12, 6 + i % 3));
+            }
+            return new TextureFont(new FontTexture(charCount, 12, 2), glyphs, 12, firstChar, charCount);
+        }
+
+        TEST(TextureFontTest, layoutMatchesQuadsAndMeasure) {
+            std::unique_ptr<TextureFont> font(createFont());
+
+            AttrString string;
+            string.appendLeftJustified("info_player_start");
+            string.appendCentered("targetname");
+
+            bool reused = true;
+            const auto glyphRun = font->layout(string, reused);
+            ASSERT_FALSE(reused);
+            ASSERT_EQ(font->quads(string, true), glyphRun->vertices);
+            ASSERT_EQ(font->measure(string), glyphRun->size);
+        }
+
+        TEST(TextureFontTest, reuseCachedLayouts) {
+            std::unique_ptr<TextureFont> font(createFont());
+
+            bool reused = true;
+            const auto first = font->layout(AttrString("light"), reused);
+            ASSERT_FALSE(reused);
+
+            const auto second = font->layout(AttrString("light"), reused);
+            ASSERT_TRUE(reused);
+            ASSERT_EQ(first, second);
+
+            font->layout(AttrString("lights"), reused);
+            ASSERT_FALSE(reused);
+        }
+
+        TEST(TextureFontTest, clearCacheWhenFull) {
+            std::unique_ptr<TextureFont> font(createFont());
+
+            bool reused = true;
+            const auto first = font->layout(AttrString("light"), reused);
+            for (size_t i = 1; i < TextureFont::MaxCachedGlyphRuns; ++i) {
+                font->layout(AttrString(StringUtils::toString(i)), reused);
+                ASSERT_FALSE(reused);
+            }
+
+            font->layout(AttrString("light"), reused);
+            ASSERT_TRUE(reused);
+
+            // the cache is full now
+            font->layout(AttrString("info_null"), reused);
+            ASSERT_FALSE(reused);
+
+            // the previously laid out strings are still valid, but they must be laid out again
+            const auto second = font->layout(AttrString("light"), reused);
+            ASSERT_FALSE(reused);
+            ASSERT_EQ(first->vertices, second->vertices);
+        }
+    }
+}
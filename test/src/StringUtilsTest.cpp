@@ -267,6 +267,50 @@ namespace StringUtils {
 
     }
 
+    TEST(StringUtilsTest, caseSensitiveGlobPattern) {
+        ASSERT_TRUE(GlobPattern("", true).matches(""));
+        ASSERT_TRUE(GlobPattern("*", true).matches(""));
+        ASSERT_FALSE(GlobPattern("?", true).matches(""));
+        ASSERT_TRUE(GlobPattern("asdf", true).matches("asdf"));
+        ASSERT_FALSE(GlobPattern("asdf", true).matches("asdF"));
+        ASSERT_FALSE(GlobPattern("asdf", true).matches("asd"));
+        ASSERT_TRUE(GlobPattern("*", true).matches("asdf"));
+        ASSERT_TRUE(GlobPattern("a??f", true).matches("asdf"));
+        ASSERT_FALSE(GlobPattern("a?f", true).matches("asdf"));
+        ASSERT_TRUE(GlobPattern("*f", true).matches("asdf"));
+        ASSERT_TRUE(GlobPattern("a*f", true).matches("asdf"));
+        ASSERT_TRUE(GlobPattern("?s?f", true).matches("asdf"));
+        ASSERT_TRUE(GlobPattern("a*f*l", true).matches("asdfjkl"));
+        ASSERT_TRUE(GlobPattern("*a*f*l*", true).matches("asdfjkl"));
+        ASSERT_TRUE(GlobPattern("*a*f*l*", true).matches("asd*fjkl"));
+        ASSERT_TRUE(GlobPattern("asd\\*fjkl", true).matches("asd*fjkl"));
+        ASSERT_TRUE(GlobPattern("asd\\*\\?fj\\\\kl", true).matches("asd*?fj\\kl"));
+        ASSERT_TRUE(GlobPattern("\\**", true).matches("*water"));
+        ASSERT_FALSE(GlobPattern("\\**", true).matches("water"));
+        ASSERT_FALSE(GlobPattern("a\\b", true).matches("ab"));
+        ASSERT_FALSE(GlobPattern("a\\b", true).matches("a\\b"));
+        ASSERT_TRUE(GlobPattern("a\\", true).matches("a\\"));
+        ASSERT_FALSE(GlobPattern("*_color", true).matches("classname"));
+        ASSERT_TRUE(GlobPattern("*aab", true).matches("aaaab"));
+        ASSERT_FALSE(GlobPattern("*a*a*a*a*a*a*a*a*a*a*b", true).matches(String(100, 'a')));
+    }
+
+    TEST(StringUtilsTest, caseInsensitiveGlobPattern) {
+        ASSERT_TRUE(GlobPattern("asdf", false).matches("ASdf"));
+        ASSERT_TRUE(GlobPattern("ASDF", false).matches("asdf"));
+        ASSERT_TRUE(GlobPattern("*", false).matches("AsdF"));
+        ASSERT_TRUE(GlobPattern("a??f", false).matches("ASdf"));
+        ASSERT_FALSE(GlobPattern("a?f", false).matches("AsDF"));
+        ASSERT_TRUE(GlobPattern("*f", false).matches("asdF"));
+        ASSERT_TRUE(GlobPattern("a*f", false).matches("aSDF"));
+        ASSERT_TRUE(GlobPattern("?s?f", false).matches("ASDF"));
+        ASSERT_TRUE(GlobPattern("a*f*l", false).matches("AsDfjkl"));
+        ASSERT_TRUE(GlobPattern("*a*f*l*", false).matches("AsDfjkl"));
+        ASSERT_TRUE(GlobPattern("*a*f*l*", false).matches("ASd*fjKl"));
+        ASSERT_TRUE(GlobPattern("asd\\*fjkl", false).matches("ASd*fjKl"));
+        ASSERT_TRUE(GlobPattern("asd\\*\\?fj\\\\kl", false).matches("aSD*?fJ\\kL"));
+    }
+
     TEST(StringUtilsTest, escape) {
         ASSERT_EQ(String(""), StringUtils::escape("", ""));
         ASSERT_EQ(String(""), StringUtils::escape("", ";"));
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/Lasso.h"
+
+#include <vecmath/intersection.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/plane.h>
+#include <vecmath/ray.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * Selects the given handles by intersecting the pick ray through each of them with the lasso plane.
+         */
+        template <typename H>
+        static std::vector<H> pickRaySelect(const Renderer::Camera& camera, const std::vector<H>& handles, const FloatType distance, const vm::bbox2& box) {
+            const auto plane = vm::plane3(vm::vec3(camera.defaultPoint(static_cast<float>(distance))), vm::vec3(camera.direction()));
+            const vm::mat4x4 transform(vm::coordinateSystemMatrix(camera.right(), camera.up(), -camera.direction(), camera.defaultPoint(static_cast<float>(distance))));
+
+            std::vector<H> result;
+            for (const auto& handle : handles) {
+                const auto ray = vm::ray3(camera.pickRay(vm::vec3f(handle.center())));
+                const auto hitDistance = vm::intersectRayAndPlane(ray, plane);
+                if (!vm::isnan(hitDistance) && box.contains(vm::vec2(transform * ray.pointAtDistance(hitDistance)))) {
+                    result.push_back(handle);
+                }
+            }
+            return result;
+        }
+
+        TEST(LassoTest, selectionMatchesPickRayProjection) {
+            std::mt19937 random(0);
+            std::uniform_real_distribution<FloatType> coord(-1024.0, 1024.0);
+
+            std::vector<vm::segment3> edges;
+            for (size_t i = 0; i < 5000; ++i) {
+                const auto point = vm::vec3(coord(random), coord(random), coord(random));
+                edges.push_back(vm::segment3(point, point + vm::vec3(16.0, 0.0, 0.0)));
+            }
+
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::PerspectiveCamera perspectiveCamera(90.0f, 1.0f, 8000.0f, viewport, vm::vec3f(-256.0f, -256.0f, 512.0f), normalize(vm::vec3f(1.0f, 1.0f, -1.0f)), vm::vec3f::pos_z);
+            const Renderer::OrthographicCamera orthographicCamera(1.0f, 8000.0f, viewport, vm::vec3f(0.0f, 0.0f, 1024.0f), vm::vec3f::neg_z, vm::vec3f::pos_y);
+
+            // keep the boxes away from the handles' projections so that rounding cannot decide their selection
+            const std::vector<std::pair<vm::vec2, vm::vec2>> boxes({
+                { vm::vec2(-10.0, -10.0), vm::vec2(10.0, 10.0) },
+                { vm::vec2(5.0, -20.0), vm::vec2(-30.0, 3.0) },
+                { vm::vec2(-1000.0, -1000.0), vm::vec2(1000.0, 1000.0) },
+                { vm::vec2(2000.0, 2000.0), vm::vec2(3000.0, 3000.0) }
+            });
+
+            const FloatType distance = 64.0;
+            const std::vector<const Renderer::Camera*> cameras({ &perspectiveCamera, &orthographicCamera });
+            for (const auto* camera : cameras) {
+                const auto origin = vm::vec3(camera->defaultPoint(static_cast<float>(distance)));
+                const auto right = vm::vec3(camera->right());
+                const auto up = vm::vec3(camera->up());
+
+                for (const auto& box : boxes) {
+                    Lasso lasso(*camera, distance, origin + box.first.x() * right + box.first.y() * up);
+                    lasso.update(origin + box.second.x() * right + box.second.y() * up);
+
+                    std::vector<vm::segment3> actual;
+                    lasso.selected(std::begin(edges), std::end(edges), std::back_inserter(actual));
+
+                    const auto expected = pickRaySelect(*camera, edges, distance, vm::bbox2(vm::min(box.first, box.second), vm::max(box.first, box.second)));
+                    ASSERT_EQ(expected.size(), actual.size());
+                    for (size_t i = 0; i < expected.size(); ++i) {
+                        ASSERT_EQ(expected[i].start(), actual[i].start());
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/Brush.h"
+#include "CollectionUtils.h"
+#include "Model/Entity.h"
+#include "View/MapDocumentTest.h"
+#include "View/MapDocument.h"
+#include "View/NodeChangeJournal.h"
+#include "View/NodeChanges.h"
+
+namespace TrenchBroom {
+    namespace View {
+        TEST(NodeChangeJournalTest, commitsOncePerOutermostCommand) {
+            NodeChangeJournal journal;
+            ASSERT_FALSE(journal.recording());
+
+            journal.beginCommand();
+            journal.beginCommand();
+            ASSERT_TRUE(journal.recording());
+            ASSERT_FALSE(journal.endCommand());
+            ASSERT_TRUE(journal.recording());
+            ASSERT_TRUE(journal.endCommand());
+            ASSERT_FALSE(journal.recording());
+        }
+
+        TEST(NodeChangeJournalTest, coalesceChanges) {
+            Model::Entity added, removed, changed, addedAndRemoved, removedAndAdded;
+
+            NodeChangeJournal journal;
+            journal.beginCommand();
+            journal.nodesWereAdded(Model::NodeList { &added, &addedAndRemoved });
+            journal.nodesDidChange(Model::NodeList { &added, &changed, &removed });
+            journal.nodesDidChange(Model::NodeList { &changed });
+            journal.nodesWereRemoved(Model::NodeList { &removed, &addedAndRemoved, &removedAndAdded });
+            journal.nodesWereAdded(Model::NodeList { &removedAndAdded });
+            ASSERT_EQ(5u, journal.notificationCount());
+            ASSERT_TRUE(journal.endCommand());
+
+            const NodeChanges changes = journal.takeChanges();
+            ASSERT_EQ(Model::NodeList { &added }, changes.addedNodes());
+            ASSERT_EQ(Model::NodeList { &removed }, changes.removedNodes());
+            ASSERT_EQ((Model::NodeList { &changed, &removedAndAdded }), changes.changedNodes());
+
+            ASSERT_EQ(0u, journal.notificationCount());
+            ASSERT_TRUE(journal.takeChanges().empty());
+        }
+
+        class NodeChangeObserver {
+        public:
+            size_t commitCount;
+            NodeChanges lastChanges;
+        public:
+            NodeChangeObserver() :
+            commitCount(0) {}
+
+            void nodeChangesWereCommitted(const NodeChanges& changes) {
+                ++commitCount;
+                lastChanges = changes;
+            }
+        };
+
+        class NodeChangeJournalDocumentTest : public MapDocumentTest {};
+
+        TEST_F(NodeChangeJournalDocumentTest, notifyOncePerCommand) {
+            Model::Brush* brush1 = createBrush();
+            Model::Brush* brush2 = createBrush();
+            document->addNode(brush1, document->currentParent());
+            document->addNode(brush2, document->currentParent());
+            document->select(Model::NodeList { brush1, brush2 });
+
+            NodeChangeObserver observer;
+            document->nodeChangesWereCommittedNotifier.addObserver(&observer, &NodeChangeObserver::nodeChangesWereCommitted);
+
+            ASSERT_TRUE(document->translateObjects(vm::vec3(16.0, 0.0, 0.0)));
+            ASSERT_EQ(1u, observer.commitCount);
+            ASSERT_TRUE(VectorUtils::contains(observer.lastChanges.changedNodes(), brush1));
+            ASSERT_TRUE(VectorUtils::contains(observer.lastChanges.changedNodes(), brush2));
+            ASSERT_TRUE(observer.lastChanges.addedNodes().empty());
+
+            document->undoLastCommand();
+            ASSERT_EQ(2u, observer.commitCount);
+            ASSERT_TRUE(VectorUtils::contains(observer.lastChanges.changedNodes(), brush1));
+
+            document->nodeChangesWereCommittedNotifier.removeObserver(&observer, &NodeChangeObserver::nodeChangesWereCommitted);
+        }
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static const vm::bbox3 WorldBounds(8192.0);
+
+        static Model::Brush* createBrush(Model::World& world, const vm::bbox3& bounds) {
+            Model::BrushBuilder builder(&world, WorldBounds);
+            Model::Brush* brush = builder.createCuboid(bounds, "texture");
+            world.defaultLayer()->addChild(brush);
+            return brush;
+        }
+
+        static std::vector<vm::vec3> pickedHandles(const Model::PickResult& pickResult) {
+            std::vector<vm::vec3> result;
+            for (const auto& hit : pickResult.all()) {
+                result.push_back(hit.target<vm::vec3>());
+            }
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        }
+
+        static std::vector<vm::vec3> pickAll(const VertexHandleManager& manager, const vm::ray3& pickRay, const Renderer::Camera& camera) {
+            std::vector<vm::vec3> result;
+            for (const auto& handle : manager.allHandles()) {
+                if (!vm::isnan(camera.pickPointHandle(pickRay, handle, pref(Preferences::HandleRadius)))) {
+                    result.push_back(handle);
+                }
+            }
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        }
+
+        TEST(VertexHandleManagerTest, findIncidentBrushes) {
+            Model::World world(Model::MapFormat::Standard, WorldBounds);
+            auto* brush1 = createBrush(world, vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)));
+            auto* brush2 = createBrush(world, vm::bbox3(vm::vec3(64, 0, 0), vm::vec3(128, 64, 64)));
+
+            VertexHandleManager vertexHandles;
+            vertexHandles.addHandles(brush1);
+            vertexHandles.addHandles(brush2);
+            ASSERT_EQ(12u, vertexHandles.totalHandleCount());
+            ASSERT_EQ(Model::BrushSet({ brush1 }), vertexHandles.findIncidentBrushes(vm::vec3(0, 0, 0)));
+            ASSERT_EQ(Model::BrushSet({ brush1, brush2 }), vertexHandles.findIncidentBrushes(vm::vec3(64, 0, 0)));
+            ASSERT_EQ(Model::BrushSet({ brush2 }), vertexHandles.findIncidentBrushes(vm::vec3(128, 64, 64)));
+            ASSERT_TRUE(vertexHandles.findIncidentBrushes(vm::vec3(32, 0, 0)).empty());
+
+            const auto handles = std::vector<vm::vec3>({ vm::vec3(0, 0, 0), vm::vec3(128, 0, 0) });
+            ASSERT_EQ(Model::BrushSet({ brush1, brush2 }), vertexHandles.findIncidentBrushes(std::begin(handles), std::end(handles)));
+
+            vertexHandles.removeHandles(brush1);
+            ASSERT_EQ(8u, vertexHandles.totalHandleCount());
+            ASSERT_EQ(Model::BrushSet({ brush2 }), vertexHandles.findIncidentBrushes(vm::vec3(64, 0, 0)));
+            ASSERT_TRUE(vertexHandles.findIncidentBrushes(vm::vec3(0, 0, 0)).empty());
+
+            EdgeHandleManager edgeHandles;
+            edgeHandles.addHandles(brush1);
+            edgeHandles.addHandles(brush2);
+            ASSERT_EQ(20u, edgeHandles.totalHandleCount());
+            ASSERT_EQ(Model::BrushSet({ brush1, brush2 }), edgeHandles.findIncidentBrushes(vm::segment3(vm::vec3(64, 0, 0), vm::vec3(64, 64, 0))));
+        }
+
+        TEST(VertexHandleManagerTest, selectCloseHandles) {
+            Model::World world(Model::MapFormat::Standard, WorldBounds);
+            auto* brush = createBrush(world, vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)));
+
+            VertexHandleManager manager;
+            manager.addHandles(brush);
+
+            manager.select(vm::vec3(64.0, 0.0, 0.0000001));
+            ASSERT_TRUE(manager.selected(vm::vec3(64, 0, 0)));
+            ASSERT_EQ(1u, manager.selectedHandleCount());
+
+            manager.select(vm::vec3(64.0, 0.0, 1.0));
+            ASSERT_EQ(1u, manager.selectedHandleCount());
+
+            // the handle stays selected when it is added again
+            auto* other = createBrush(world, vm::bbox3(vm::vec3(64, 0, 0), vm::vec3(128, 64, 64)));
+            manager.addHandles(other);
+            ASSERT_TRUE(manager.selected(vm::vec3(64, 0, 0)));
+
+            manager.removeHandles(brush);
+            manager.removeHandles(other);
+            ASSERT_EQ(0u, manager.totalHandleCount());
+            ASSERT_EQ(0u, manager.selectedHandleCount());
+        }
+
+        TEST(VertexHandleManagerTest, pickMatchesLinearSearch) {
+            Model::World world(Model::MapFormat::Standard, WorldBounds);
+
+            VertexHandleManager manager;
+            for (size_t x = 0; x < 8; ++x) {
+                for (size_t y = 0; y < 8; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 96.0, static_cast<FloatType>(y) * 96.0, 0.0);
+                    manager.addHandles(createBrush(world, vm::bbox3(min, min + vm::vec3(64, 64, 64))));
+                }
+            }
+
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::PerspectiveCamera perspectiveCamera(90.0f, 1.0f, 8000.0f, viewport, vm::vec3f(-256.0f, -256.0f, 512.0f), normalize(vm::vec3f(1.0f, 1.0f, -1.0f)), vm::vec3f::pos_z);
+            Renderer::OrthographicCamera orthographicCamera(1.0f, 8000.0f, viewport, vm::vec3f(0.0f, 0.0f, 1024.0f), vm::vec3f::neg_z, vm::vec3f::pos_y);
+            orthographicCamera.setZoom(0.25f);
+
+            const std::vector<const Renderer::Camera*> cameras({ &perspectiveCamera, &orthographicCamera });
+            for (const auto* camera : cameras) {
+                const auto origin = vm::vec3(camera->position());
+
+                size_t hitCount = 0;
+                for (const auto& handle : manager.allHandles()) {
+                    // aim at the handle and slightly beside it
+                    for (const auto& offset : { vm::vec3::zero, vm::vec3(1.0, 1.0, 0.0), vm::vec3(8.0, 0.0, 0.0) }) {
+                        const auto target = handle + offset;
+                        const auto pickRay = camera == &perspectiveCamera ? vm::ray3(origin, normalize(target - origin)) : vm::ray3(vm::vec3(target.x(), target.y(), origin.z()), vm::vec3::neg_z);
+
+                        Model::PickResult pickResult;
+                        manager.pick(pickRay, *camera, pickResult);
+
+                        const auto expected = pickAll(manager, pickRay, *camera);
+                        ASSERT_EQ(expected, pickedHandles(pickResult));
+                        hitCount += expected.size();
+                    }
+                }
+                ASSERT_LT(0u, hitCount);
+            }
+        }
+    }
+}